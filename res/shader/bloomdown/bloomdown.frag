@@ -0,0 +1,95 @@
+#version 410 core
+
+/**
+ * Bloom Downsample Shader.
+ *
+ * Verkleinert eine Stufe der Bloom-Mip-Kette auf die halbe Auflösung. Dazu
+ * werden 13 bilinear gefilterte Abtastungen zu fünf überlappenden 2x2-Blöcken
+ * zusammengefasst, was Treppeneffekte und Flimmern beim Verkleinern vermeidet.
+ *
+ * Beim ersten Schritt wird statt der vorherigen Stufe das finale Bild samt
+ * Emission gelesen und der Schwellenwert angewandt. Die Blöcke werden dann
+ * nach ihrer Helligkeit gewichtet, damit einzelne sehr helle Pixel bei
+ * Bewegung nicht aufblitzen.
+ *
+ * Autor: stud105751, stud104645
+ */
+
+layout (location = 0) out vec3 FragColor; // Ausgabe der verkleinerten Farbe
+
+in vec2 TexCoords; // Eingabe der Texturkoordinaten vom Vertex-Shader
+
+uniform sampler2D u_image; // vorherige Stufe der Mip-Kette
+uniform sampler2D u_final; // Textur der finalen gerenderten Szene
+uniform sampler2D u_emission; // Emissionstextur
+
+uniform bool u_prefilter; // true beim ersten Schritt aus dem finalen Bild
+uniform float u_colorWeight; // Gewichtung für die finale Farbe
+uniform float u_emissionWeight; // Gewichtung für die Emissionsfarbe
+uniform float u_threshold; // Schwellenwert für den Bloom-Effekt
+uniform vec2 u_sourceSize; // genutzter Bereich der Quelle in Texeln
+
+// Liest die Quelle an einer Stelle, beim ersten Schritt mit Schwellenwert
+vec3 FetchSource(vec2 uv)
+{
+    // Nur im genutzten Bereich der Quelle filtern, dahinter liegen bei
+    // verringerter Auflösung veraltete Texel.
+    vec2 sourceTexel = clamp(uv * u_sourceSize, vec2(0.5), u_sourceSize - 0.5);
+    if (!u_prefilter) {
+        return texture(u_image, sourceTexel / vec2(textureSize(u_image, 0))).rgb;
+    }
+
+    uv = sourceTexel / vec2(textureSize(u_final, 0));
+    vec3 bloomColor = texture(u_final, uv).rgb * u_colorWeight + texture(u_emission, uv).rgb * u_emissionWeight;
+    float brightest = max(max(bloomColor.r, bloomColor.g), bloomColor.b);
+    return brightest > u_threshold ? bloomColor : vec3(0.0);
+}
+
+// Gewicht eines Blocks, das mit seiner Helligkeit abnimmt
+float KarisWeight(vec3 color)
+{
+    return 1.0 / (1.0 + dot(color, vec3(0.2126, 0.7152, 0.0722)));
+}
+
+void main()
+{
+    vec2 texel = 1.0 / u_sourceSize;
+
+    // Äußeres 5x5-Raster in Abständen von zwei Texeln
+    vec3 a = FetchSource(TexCoords + texel * vec2(-2.0,  2.0));
+    vec3 b = FetchSource(TexCoords + texel * vec2( 0.0,  2.0));
+    vec3 c = FetchSource(TexCoords + texel * vec2( 2.0,  2.0));
+    vec3 d = FetchSource(TexCoords + texel * vec2(-2.0,  0.0));
+    vec3 e = FetchSource(TexCoords);
+    vec3 f = FetchSource(TexCoords + texel * vec2( 2.0,  0.0));
+    vec3 g = FetchSource(TexCoords + texel * vec2(-2.0, -2.0));
+    vec3 h = FetchSource(TexCoords + texel * vec2( 0.0, -2.0));
+    vec3 i = FetchSource(TexCoords + texel * vec2( 2.0, -2.0));
+
+    // Inneres Quadrat um den Mittelpunkt
+    vec3 j = FetchSource(TexCoords + texel * vec2(-1.0,  1.0));
+    vec3 k = FetchSource(TexCoords + texel * vec2( 1.0,  1.0));
+    vec3 l = FetchSource(TexCoords + texel * vec2(-1.0, -1.0));
+    vec3 m = FetchSource(TexCoords + texel * vec2( 1.0, -1.0));
+
+    // Die fünf Blöcke, der innere zählt zur Hälfte, die äußeren je ein Achtel
+    vec3 inner = (j + k + l + m) * 0.25;
+    vec3 topLeft = (a + b + d + e) * 0.25;
+    vec3 topRight = (b + c + e + f) * 0.25;
+    vec3 bottomLeft = (d + e + g + h) * 0.25;
+    vec3 bottomRight = (e + f + h + i) * 0.25;
+
+    if (u_prefilter) {
+        float wInner = KarisWeight(inner) * 0.5;
+        float wTopLeft = KarisWeight(topLeft) * 0.125;
+        float wTopRight = KarisWeight(topRight) * 0.125;
+        float wBottomLeft = KarisWeight(bottomLeft) * 0.125;
+        float wBottomRight = KarisWeight(bottomRight) * 0.125;
+
+        FragColor = (inner * wInner + topLeft * wTopLeft + topRight * wTopRight
+                     + bottomLeft * wBottomLeft + bottomRight * wBottomRight)
+                    / (wInner + wTopLeft + wTopRight + wBottomLeft + wBottomRight);
+    } else {
+        FragColor = inner * 0.5 + (topLeft + topRight + bottomLeft + bottomRight) * 0.125;
+    }
+}
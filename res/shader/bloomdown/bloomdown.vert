@@ -1,9 +1,8 @@
 #version 410 core
 
 /**
- * Fog Shader.
+ * Bloom Downsample Shader.
  *
- * Copyright (C) 2020, FH Wedel
  * Autor: stud105751, stud104645
  */
 
@@ -14,5 +13,5 @@ out vec2 TexCoords; // Ausgabe der Texturkoordinaten an den Fragment-Shader
 
 void main() {
     TexCoords = aTexCoords; // Übergabe der Texturkoordinaten an den Fragment-Shader
-    gl_Position = vec4(aPos, 0.0, 1.0); // Setzen der Position des Vertex
+    gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0); // Setzen der Position des Vertex
 }
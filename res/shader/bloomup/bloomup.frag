@@ -0,0 +1,44 @@
+#version 410 core
+
+/**
+ * Bloom Upsample Shader.
+ *
+ * Vergrößert eine Stufe der Bloom-Mip-Kette mit einem 3x3-Tent-Filter auf die
+ * nächst größere Stufe. Die Ausgabe wird additiv auf deren Inhalt gemischt,
+ * sodass die größte Stufe am Ende die Summe aller Stufen enthält.
+ *
+ * Autor: stud105751, stud104645
+ */
+
+layout (location = 0) out vec3 FragColor; // Ausgabe der vergrößerten Farbe
+
+in vec2 TexCoords; // Eingabe der Texturkoordinaten vom Vertex-Shader
+
+uniform sampler2D u_image; // kleinere Stufe der Mip-Kette
+uniform float u_filterRadius; // Radius des Filters in Texeln der kleineren Stufe
+uniform vec2 u_sourceSize; // genutzter Bereich der kleineren Stufe in Texeln
+
+// Liest die kleinere Stufe, ohne über ihren genutzten Bereich hinaus zu filtern
+vec3 FetchSource(vec2 uv)
+{
+    vec2 sourceTexel = clamp(uv * u_sourceSize, vec2(0.5), u_sourceSize - 0.5);
+    return texture(u_image, sourceTexel / vec2(textureSize(u_image, 0))).rgb;
+}
+
+void main()
+{
+    vec2 offset = u_filterRadius / u_sourceSize;
+
+    // Gewichte 1-2-1 in beide Richtungen, zusammen 16
+    vec3 result = FetchSource(TexCoords) * 4.0;
+    result += (FetchSource(TexCoords + vec2(-offset.x, 0.0))
+               + FetchSource(TexCoords + vec2( offset.x, 0.0))
+               + FetchSource(TexCoords + vec2(0.0, -offset.y))
+               + FetchSource(TexCoords + vec2(0.0,  offset.y))) * 2.0;
+    result += FetchSource(TexCoords + vec2(-offset.x, -offset.y))
+              + FetchSource(TexCoords + vec2( offset.x, -offset.y))
+              + FetchSource(TexCoords + vec2(-offset.x,  offset.y))
+              + FetchSource(TexCoords + vec2( offset.x,  offset.y));
+
+    FragColor = result / 16.0;
+}
@@ -1,7 +1,7 @@
 #version 410 core
 
 /**
- * Threshold Shader.
+ * Bloom Upsample Shader.
  *
  * Autor: stud105751, stud104645
  */
@@ -14,4 +14,4 @@ out vec2 TexCoords; // Ausgabe der Texturkoordinaten an den Fragment-Shader
 void main() {
     TexCoords = aTexCoords; // Übergabe der Texturkoordinaten an den Fragment-Shader
     gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0); // Setzen der Position des Vertex
-}
\ No newline at end of file
+}
@@ -3,10 +3,19 @@
 /**
  * Dirlight Shader.
  *
+ * Die Schatten stammen aus mehreren Kaskaden, die den Sichtbereich der Kamera
+ * nach Entfernung aufteilen. Jedes Fragment nutzt die erste Kaskade, deren
+ * Ende hinter ihm liegt.
+ *
+ * Varianten: SHADOWS wertet die Kaskaden aus, PCF filtert die Schatten dabei
+ * weich.
+ *
  * Copyright (C) 2020, FH Wedel
  * Autor: stud105751, stud104645
  */
 
+#define DIR_SHADOW_MAX_CASCADES 4
+
 layout (location = 0) out vec3 gFinal; // Ausgabe der finalen Farbe
 
 in vec2 TexCoords; // UV-Koordinaten des Fullscreen-Quads
@@ -21,22 +30,46 @@ struct DirLight
     vec3 specular; // Spekularlicht
 };
 
-uniform sampler2D u_position; // Textur mit den Positionen der Fragmente
-uniform sampler2D u_normal; // Textur mit den Normalen der Fragmente
+uniform sampler2D u_depth; // Tiefe, aus der die Positionen rekonstruiert werden
+uniform sampler2D u_normal; // Textur mit den oktaedrisch kodierten Normalen
 uniform sampler2D u_albedoSpec; // Textur mit Albedo- und Spekularinformationen
-uniform sampler2D u_ambientShi; // Textur mit Ambient- und Shininessinformationen
+uniform sampler2D u_material; // Textur mit Ambient-Faktor und Shininess
 uniform sampler2D u_emission; // Textur mit Emissionsinformationen
-uniform sampler2D u_shadowMap;
+uniform sampler2DArray u_shadowMap; // Schattenkarten, eine Schicht pro Kaskade
 
 uniform DirLight u_dirLight; // Richtungslichtquelle
 
-uniform mat4 u_lightSpace;
+uniform mat4 u_lightSpaces[DIR_SHADOW_MAX_CASCADES]; // Licht-Raum-Matrizen der Kaskaden
+uniform vec4 u_cascades[DIR_SHADOW_MAX_CASCADES]; // Ende im View Space, Tiefenbereich und Texelgröße
+uniform int u_cascadeCount;
+uniform mat4 u_view; // View-Matrix, zu der die Kaskaden passen
 
 uniform vec3 u_cameraPos; // Position der Kamera
 
-uniform bool u_isActive;
-uniform bool u_showShadows;
-uniform bool u_usePCF;
+uniform mat4 u_invViewProjection; // Inverse View-Projektions-Matrix der Kamera
+
+// Rekonstruiert die Weltposition aus Texturkoordinaten und Tiefe
+vec3 ReconstructPosition(vec2 uv, float depth)
+{
+    vec4 position = u_invViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    return position.xyz / position.w;
+}
+
+// Dekodiert eine oktaedrisch kodierte Normale
+vec3 DecodeNormal(vec2 encoded)
+{
+    vec2 f = encoded * 2.0 - 1.0;
+    vec3 n = vec3(f, 1.0 - abs(f.x) - abs(f.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+// Dekodiert Ambient-Faktor und Shininess (siehe model.frag)
+vec2 DecodeMaterial(vec2 encoded)
+{
+    return vec2(encoded.x * 2.0, exp2(encoded.y * 11.0) - 1.0);
+}
 
 // Berechnung des Lichts für die Richtungslichtquelle
 vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, vec3 ambientMap, vec3 diffuseMap, vec3 specularMap, float shininess, float shadow)
@@ -55,60 +88,100 @@ vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, vec3 ambientMap, ve
     return (1.0 - shadow) * (diffuse + specular); // Summe der Lichtanteile
 }
 
+// Wählt die Kaskade für ein Fragment, -1 hinter der letzten Kaskade
+int SelectCascade(vec3 fragPos)
+{
+    float viewDepth = -(u_view * vec4(fragPos, 1.0)).z;
+    for (int i = 0; i < u_cascadeCount; ++i) {
+        if (viewDepth < u_cascades[i].x) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 //https://learnopengl.com/Advanced-Lighting/Shadows/Shadow-Mapping
-float CalcShadows(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir, bool usePCF)
+float CalcShadows(vec3 fragPos, vec3 normal, vec3 lightDir)
 {
+    int cascade = SelectCascade(fragPos);
+    if (cascade < 0) {
+        return 0.0;
+    }
+
+    vec4 fragPosLightSpace = u_lightSpaces[cascade] * vec4(fragPos, 1.0);
     // perform perspective divide
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
     // transform to [0,1] range
     projCoords = projCoords * 0.5 + 0.5;
-    // get closest depth value from light's perspective (using [0,1] range fragPosLight as coords)
-    float closestDepth = texture(u_shadowMap, projCoords.xy).r;
+
+    if (projCoords.z > 1.0) {
+        return 0.0;
+    }
+
     // get depth of current fragment from light's perspective
     float currentDepth = projCoords.z;
 
-    float bias = max(.0005 * (1.0 - dot(normal, lightDir)), .00025);
+    // Der Bias wächst mit der Texelgröße der Kaskade und wird auf deren
+    // Tiefenbereich normiert.
+    float bias = max(1.5 * (1.0 - dot(normal, lightDir)), 0.75) * u_cascades[cascade].z / u_cascades[cascade].y;
 
     float shadow = 0;
-    if (usePCF) {
-        vec2 texelSize = 1.0 / textureSize(u_shadowMap, 0);
+#ifdef PCF
+    {
+        vec2 texelSize = 1.0 / vec2(textureSize(u_shadowMap, 0).xy);
         for(int x = -1; x <= 1; ++x)
         {
             for(int y = -1; y <= 1; ++y)
             {
-                float pcfDepth = texture(u_shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
+                float pcfDepth = texture(u_shadowMap, vec3(projCoords.xy + vec2(x, y) * texelSize, cascade)).r;
                 shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
             }
         }
         shadow /= 9.0;
-    } else {
-        shadow  = currentDepth - bias > closestDepth  ? 1.0 : 0.0;
     }
-
-    if (projCoords.z > 1.0) {
-        shadow = 0.0;
+#else
+    {
+        // get closest depth value from light's perspective (using [0,1] range fragPosLight as coords)
+        float closestDepth = texture(u_shadowMap, vec3(projCoords.xy, cascade)).r;
+        shadow  = currentDepth - bias > closestDepth  ? 1.0 : 0.0;
     }
+#endif
 
     return shadow;
 }
 
 void main()
 {
-    vec3 fragPos    = texture(u_position, TexCoords).rgb; // Fragmentposition
-    vec3 normal     = normalize(texture(u_normal, TexCoords).rgb); // Normalenvektor
-    vec3 albedo     = texture(u_albedoSpec, TexCoords).rgb; // Albedo-Informationen
-    vec3 ambient    = texture(u_ambientShi, TexCoords).rgb;
-    vec3 specular   = texture(u_albedoSpec, TexCoords).aaa; // Spekularinformationen
-    vec3 emission   = texture(u_emission, TexCoords).rgb; // Emissionsinformationen
-    vec3 lightDir   = normalize(u_dirLight.direction);
+    // Bei verringerter Auflösung wird nur ein Teil des G-Buffers genutzt. Die
+    // Pixel werden daher direkt gelesen, die Texturkoordinaten des Quads
+    // überspannen den genutzten Bereich und dienen nur der Rekonstruktion.
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+    // Pixel ohne Geometrie erhalten kein Licht, nur ihre Emission.
+    float depth = texelFetch(u_depth, pixel, 0).r;
+    if (depth >= 1.0) {
+        gFinal = texelFetch(u_emission, pixel, 0).rgb;
+        return;
+    }
 
-    vec4 fragPosLightSpace = u_lightSpace * vec4(fragPos, 1.0);
+    vec3 fragPos    = ReconstructPosition(TexCoords, depth); // Fragmentposition
+    vec3 normal     = DecodeNormal(texelFetch(u_normal, pixel, 0).rg); // Normalenvektor
+    vec3 albedo     = texelFetch(u_albedoSpec, pixel, 0).rgb; // Albedo-Informationen
+    vec3 specular   = texelFetch(u_albedoSpec, pixel, 0).aaa; // Spekularinformationen
+    vec3 emission   = texelFetch(u_emission, pixel, 0).rgb; // Emissionsinformationen
+    vec2 material   = DecodeMaterial(texelFetch(u_material, pixel, 0).rg);
+    vec3 lightDir   = normalize(u_dirLight.direction);
 
-    float shininess = texture(u_ambientShi, TexCoords).a;
+    vec3 ambient    = albedo * material.x;
+    float shininess = material.y;
 
     vec3 viewDir = normalize(u_cameraPos - fragPos); // Blickrichtung
 
-    float shadow = u_showShadows ? CalcShadows(fragPosLightSpace, normal, lightDir, u_usePCF) : 0;
-    vec3 light = u_isActive ? CalcDirLight(u_dirLight, normal, viewDir, ambient, albedo, specular, shininess, shadow) : vec3(0.0);
+#ifdef SHADOWS
+    float shadow = CalcShadows(fragPos, normal, lightDir);
+#else
+    float shadow = 0.0;
+#endif
+    vec3 light = CalcDirLight(u_dirLight, normal, viewDir, ambient, albedo, specular, shininess, shadow);
     gFinal = (emission != vec3(0.0) ? emission : light);
 }
@@ -3,6 +3,13 @@
 /**
  * Depth Of Field Shader.
  *
+ * Setzt das scharfe Bild in voller Auflösung mit dem verkleinert
+ * weichgezeichneten Bild zusammen. Das scharfe Bild entsteht direkt hier aus
+ * der Nachbearbeitung (siehe postprocess.glsl). Das unscharfe Bild wird bilateral
+ * vergrößert: Von den vier umliegenden Texeln zählen nur die, deren
+ * Entfernung zur Kamera zu der des Pixels passt. Der Zerstreuungskreis
+ * (Circle of Confusion) ergibt sich aus dem Abstand zur Fokusdistanz.
+ *
  * Copyright (C) 2020, FH Wedel
  * Autor: stud105751, stud104645
  */
@@ -11,40 +18,62 @@ layout (location = 0) out vec3 gFinal; // Ausgabe der finalen Farbe
 
 in vec2 TexCoords; // UV-Koordinaten des Fullscreen-Quads
 
-uniform sampler2D u_position; // Textur mit den Positionen der Fragmente
-uniform sampler2D u_final; // Textur mit der finalen Farbe
-uniform sampler2D u_finalBlur;
+uniform sampler2D u_dofColor; // verkleinertes Bild, Entfernung zur Kamera im Alpha-Kanal
+uniform sampler2D u_dofBlur; // verkleinertes, weichgezeichnetes Bild
+uniform vec2 u_dofSize; // genutzter Bereich der verkleinerten Bilder in Texeln
 
-uniform vec3 u_cameraPos; // Position der Kamera
 uniform float u_focusDistance = 15;
 uniform float u_depthOfField = 12;
-uniform bool u_useDoF;
 
-void main()
+// Relative Entfernungsabweichung, ab der ein Texel kaum noch zählt
+const float DEPTH_TOLERANCE = 0.05;
+
+#include "../postprocess/postprocess.glsl"
+
+// Vergrößert das unscharfe Bild und gewichtet die vier umliegenden Texel nach
+// ihrer Entfernung zur Kamera
+vec3 BilateralUpsample(vec2 uv, float dist)
 {
-    vec3 position = texture(u_position, TexCoords).rgb; // Fragmentposition
+    ivec2 size = ivec2(u_dofSize);
+    vec2 coord = uv * vec2(size) - 0.5;
+    ivec2 base = ivec2(floor(coord));
+    vec2 f = fract(coord);
 
-    // Lies die Farben aus der scharfen und der geblurten Textur
-    vec3 sharpColor = texture(u_final,     TexCoords).rgb;
-    vec3 blurColor  = texture(u_finalBlur, TexCoords).rgb;
+    vec3 result = vec3(0.0);
+    float weightSum = 0.0;
+    for (int y = 0; y <= 1; ++y) {
+        for (int x = 0; x <= 1; ++x) {
+            ivec2 texel = clamp(base + ivec2(x, y), ivec2(0), size - 1);
+            float bilinear = (x == 0 ? 1.0 - f.x : f.x) * (y == 0 ? 1.0 - f.y : f.y);
 
-    // Entfernungsberechnung zwischen Kamera und Fragment
-    float dist = distance(u_cameraPos, position);
+            float texelDist = texelFetch(u_dofColor, texel, 0).a;
+            float difference = abs(texelDist - dist) / max(dist, 1.0e-3);
+            float weight = bilinear / (1.0 + difference / DEPTH_TOLERANCE);
 
-    // Wie stark sind wir von der Fokusdistanz entfernt?
-    float diff = abs(dist - u_focusDistance);
+            result += texelFetch(u_dofBlur, texel, 0).rgb * weight;
+            weightSum += weight;
+        }
+    }
 
-    // "Halbe" DoF-Spanne zur weichen Transition
-    float halfRange = u_depthOfField * 0.5;
+    return result / max(weightSum, 1.0e-5);
+}
 
-    // Faktor für Mischung zwischen Sharp/Blur:
-    //  - Ist diff < halfRange, sind wir (annähernd) im Fokus => factor ~ 0
-    //  - Ist diff >> halfRange, sind wir sehr unscharf => factor ~ 1
-    float factor = clamp(diff / halfRange, 0.0, 1.0);
+void main()
+{
+    // Scharfe Farbe und Entfernung zwischen Kamera und Fragment
+    float dist;
+    vec3 sharpColor = PostprocessPixel(ivec2(gl_FragCoord.xy), TexCoords, dist);
+
+    // Zerstreuungskreis: 0 im Fokus, 1 ab der halben Schärfentiefe davor
+    // oder dahinter
+    float halfRange = u_depthOfField * 0.5;
+    float coc = clamp(abs(dist - u_focusDistance) / halfRange, 0.0, 1.0);
 
-    // Mische die scharfe Farbe mit der Blur-Farbe
-    vec3 finalColor = mix(sharpColor, blurColor, factor);
+    if (coc <= 0.0) {
+        gFinal = sharpColor;
+        return;
+    }
 
-    // Schreibe das Ergebnis ins Ausgabefragment
-    gFinal = u_useDoF ? finalColor : sharpColor;
+    // Mische die scharfe Farbe mit der bilateral vergrößerten Blur-Farbe
+    gFinal = mix(sharpColor, BilateralUpsample(TexCoords, dist), coc);
 }
@@ -0,0 +1,44 @@
+#version 410 core
+
+/**
+ * Depth Of Field Downsample Shader.
+ *
+ * Verkleinert das nachbearbeitete Bild für die Tiefenunschärfe um u_divisor.
+ * Die Nachbearbeitung wird dabei pro Pixel des Blocks ausgewertet, statt sie
+ * vorher in einem eigenen Pass in die finale Textur zu schreiben. Jeder Texel
+ * mittelt die Farbe seines Blocks und speichert im Alpha-Kanal die kleinste
+ * Entfernung zur Kamera darin, damit Vordergrund beim bilateralen Vergrößern
+ * nicht dem Hintergrund zugeschlagen wird.
+ *
+ * Autor: stud105751, stud104645
+ */
+
+layout (location = 0) out vec4 FragColor; // Farbe und Entfernung zur Kamera
+
+in vec2 TexCoords; // UV-Koordinaten des Fullscreen-Quads
+
+uniform int u_divisor; // Kantenlänge eines Blocks in Pixeln des Bildschirms
+
+#include "../postprocess/postprocess.glsl"
+
+void main()
+{
+    ivec2 size = ivec2(u_renderSize);
+    ivec2 origin = ivec2(gl_FragCoord.xy) * u_divisor;
+
+    vec3 color = vec3(0.0);
+    float nearest = 1.0e20;
+
+    for (int y = 0; y < u_divisor; ++y) {
+        for (int x = 0; x < u_divisor; ++x) {
+            ivec2 pixel = min(origin + ivec2(x, y), size - 1);
+            vec2 uv = (vec2(pixel) + 0.5) / u_renderSize;
+
+            float dist;
+            color += PostprocessPixel(pixel, uv, dist);
+            nearest = min(nearest, dist);
+        }
+    }
+
+    FragColor = vec4(color / float(u_divisor * u_divisor), nearest);
+}
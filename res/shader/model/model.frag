@@ -3,18 +3,40 @@
 /**
  * 3D Modell Shader.
  *
+ * Varianten: DIFFUSE_MAP, SPECULAR_MAP, NORMAL_MAP und EMISSION_MAP lesen die
+ * jeweilige Textur des Materials, TWO_CHANNEL_NORMAL_MAP rekonstruiert dabei
+ * die Z-Komponente der Normale. TESSELLATION und DISPLACEMENT stehen für die
+ * Tessellation-Stufen davor. VELOCITY schreibt zusätzlich die Bewegungsvektoren
+ * für die temporale Rekonstruktion.
+ *
  * Copyright (C) 2020, FH Wedel
  * Autor: Nicolas Hollmann, stud105751, stud104645
  */
 
-layout (location = 0) out vec3 gPosition;
-layout (location = 1) out vec3 gNormal;
-layout (location = 2) out vec4 gAlbedoSpec;
-layout (location = 3) out vec4 gAmbientShi;
-layout (location = 4) out vec3 gEmission;
-
-// Eigenschaften, die von dem Vertextshader weitergegeben wurden.
-in TESE_OUT {
+// Die Position wird nicht gespeichert, sondern später aus der Tiefe
+// rekonstruiert.
+layout (location = 0) out vec2 gNormal;     // oktaedrisch kodierte Normale
+layout (location = 1) out vec4 gAlbedoSpec; // Albedo (sRGB) und Metalness
+layout (location = 2) out vec2 gMaterial;   // Ambient-Faktor und Shininess
+layout (location = 3) out vec3 gEmission;
+#ifdef VELOCITY
+layout (location = 4) out vec2 gVelocity;   // Bewegung seit dem letzten Frame
+#endif
+
+// Größter Ambient-Faktor relativ zur Albedo, der gespeichert werden kann
+#define MAX_AMBIENT_FACTOR 2.0
+
+// Die Shininess wird logarithmisch bis 2^SHININESS_LOG_RANGE gespeichert.
+#define SHININESS_LOG_RANGE 11.0
+
+// Eigenschaften, die von dem Vertextshader weitergegeben wurden. Ohne
+// Tessellation kommen sie direkt aus dem Vertex Shader.
+#if defined(TESSELLATION) || defined(DISPLACEMENT)
+#define FS_IN TESE_OUT
+#else
+#define FS_IN VS_OUT
+#endif
+in FS_IN {
     vec3 CameraPos;
     vec2 TexCoords;
     vec3 Normal;
@@ -23,6 +45,11 @@ in TESE_OUT {
     mat3 TBN;
     vec3 TangentCameraPos;
     vec3 TangentFragPos;
+#ifdef VELOCITY
+    vec4 PreviousPosition;
+    vec4 CurrentClip;
+    vec4 PreviousClip;
+#endif
 } fs_in;
 
 // Struktur für Materialeigenschaften.
@@ -33,16 +60,12 @@ struct Material {
     vec3 emission;
     float shininess;
 
-    bool useDiffuseMap;
     sampler2D diffuseMap;
 
-    bool useSpecularMap;
     sampler2D specularMap;
 
-    bool useNormalMap;
     sampler2D normalMap;
 
-    bool useEmissionMap;
     sampler2D emissionMap;
 
     sampler2D displacementMap;
@@ -57,9 +80,19 @@ uniform int u_renderMode;
 // Alpha Clipping
 uniform float u_clipping;
 
-// Normal Mapping
-uniform bool u_useNormalMapping;
-uniform bool u_useTwoChannelNormalMaps;
+// Faltet die untere Hälfte des Oktaeders nach außen
+vec2 OctWrap(vec2 v)
+{
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// Kodiert eine normalisierte Normale oktaedrisch in [0, 1]^2
+vec2 EncodeNormal(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    n.xy = n.z >= 0.0 ? n.xy : OctWrap(n.xy);
+    return n.xy * 0.5 + 0.5;
+}
 
 /**
  * Hauptfunktion des Fragment-Shaders.
@@ -69,47 +102,69 @@ void main()
 {
     // Erstes Alpha-Clipping: Wenn die diffuse Textur verwendet wird und die Alpha-Komponente
     // des Texturwerts unterhalb des Clipping-Schwellenwerts liegt, wird das Fragment verworfen.
-    if (u_material.useDiffuseMap && texture(u_material.diffuseMap, fs_in.TexCoords).a < u_clipping)
+#ifdef DIFFUSE_MAP
+    if (texture(u_material.diffuseMap, fs_in.TexCoords).a < u_clipping)
     {
         discard;
     }
+#endif
 
+#ifdef NORMAL_MAP
     vec3 normal = vec3(0);
-    if (u_material.useNormalMap && u_useNormalMapping)
     {
         // After sampling the normal map
         normal = texture(u_material.normalMap, fs_in.TexCoords).rgb;
         normal = normal * 2.0 - 1.0;
 
         // Z-Komponente berechnen, falls wir einen zweikanaligen Normal Map verwenden
-        if (u_useTwoChannelNormalMaps)
-        {
-            normal.z = sqrt(1.0 - dot(normal.xy, normal.xy));
-        }
+#ifdef TWO_CHANNEL_NORMAL_MAP
+        normal.z = sqrt(1.0 - dot(normal.xy, normal.xy));
+#endif
 
         // Transformation von Tangent Space nach World Space
         normal = normalize(fs_in.TBN * normal);
     }
-    else
-    {
-        normal = normalize(fs_in.Normal);
-    }
+#else
+    vec3 normal = normalize(fs_in.Normal);
+#endif
 
-    vec3 albedo = (u_material.useDiffuseMap ? texture(u_material.diffuseMap, fs_in.TexCoords).rgb : vec3(1.0, 0.0, 1.0)) * u_material.diffuse;
+#ifdef DIFFUSE_MAP
+    vec3 diffuseTex = texture(u_material.diffuseMap, fs_in.TexCoords).rgb;
+#else
+    vec3 diffuseTex = vec3(1.0, 0.0, 1.0);
+#endif
+    vec3 albedo = diffuseTex * u_material.diffuse;
 
     //- Specular
     //    Red channel: Occlusion
     //    Green channel: Roughness
     //    Blue channel: Metalness
-    float metalness = (u_material.useSpecularMap ? texture(u_material.specularMap, fs_in.TexCoords).b : 0.0) * u_material.specular.b;
+#ifdef SPECULAR_MAP
+    float metalness = texture(u_material.specularMap, fs_in.TexCoords).b * u_material.specular.b;
+#else
+    float metalness = 0.0;
+#endif
 
-    vec3 ambient = (u_material.useDiffuseMap ? texture(u_material.diffuseMap, fs_in.TexCoords).rgb : vec3(1.0, 0.0, 1.0)) * u_material.ambient;
+    // Das Ambient ergibt sich aus derselben Textur wie die Albedo, daher
+    // genügt das Verhältnis der Materialfarben, um es wiederherzustellen.
+    float ambientFactor = dot(u_material.ambient, vec3(1.0 / 3.0)) / max(dot(u_material.diffuse, vec3(1.0 / 3.0)), 1e-4);
 
     float shininess = u_material.shininess;
 
-    gPosition = fs_in.Position.xyz;
-    gNormal = normal;
+    gNormal = EncodeNormal(normal);
     gAlbedoSpec = vec4(albedo, metalness);
-    gAmbientShi = vec4(ambient, shininess);
-    gEmission = (u_material.useEmissionMap ? texture(u_material.emissionMap, fs_in.TexCoords).rgb : vec3(0.0)) * u_material.emission;
+    gMaterial = vec2(ambientFactor / MAX_AMBIENT_FACTOR, log2(shininess + 1.0) / SHININESS_LOG_RANGE);
+#ifdef EMISSION_MAP
+    gEmission = texture(u_material.emissionMap, fs_in.TexCoords).rgb * u_material.emission;
+#else
+    gEmission = vec3(0.0);
+#endif
+
+#ifdef VELOCITY
+    // Bewegung in Texturkoordinaten, die temporale Rekonstruktion findet damit
+    // die Stelle des Pixels im letzten Bild
+    vec2 currentPosition = fs_in.CurrentClip.xy / fs_in.CurrentClip.w;
+    vec2 previousPosition = fs_in.PreviousClip.xy / fs_in.PreviousClip.w;
+    gVelocity = (currentPosition - previousPosition) * 0.5;
+#endif
 }
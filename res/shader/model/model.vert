@@ -22,6 +22,11 @@ out VS_OUT {
     mat3 TBN;
     vec3 TangentCameraPos;
     vec3 TangentFragPos;
+#ifdef VELOCITY
+    vec4 PreviousPosition;
+    vec4 CurrentClip;
+    vec4 PreviousClip;
+#endif
 } vs_out;
 
 uniform mat4 u_projection;
@@ -30,6 +35,14 @@ uniform mat4 u_model;
 
 uniform vec3 u_cameraPos;
 
+#ifdef VELOCITY
+// Für die Bewegungsvektoren: View-Projektion dieses und des letzten Frames
+// ohne Jitter sowie die Modellmatrix des letzten Frames
+uniform mat4 u_viewProjection;
+uniform mat4 u_prevViewProjection;
+uniform mat4 u_prevModel;
+#endif
+
 /**
  * Hauptfunktion des Vertex-Shaders.
  * Hier werden die Daten weiter gereicht.
@@ -69,6 +82,13 @@ void main()
     mat4 mvp = u_projection * mv;
     gl_Position = mvp * vec4(position, 1.0);
 
+#ifdef VELOCITY
+    // Position in diesem und im letzten Frame für die Bewegungsvektoren
+    vs_out.PreviousPosition = u_prevModel * vec4(position, 1.0);
+    vs_out.CurrentClip = u_viewProjection * vs_out.Position;
+    vs_out.PreviousClip = u_prevViewProjection * vs_out.PreviousPosition;
+#endif
+
     vs_out.TangentCameraPos = vs_out.TBN * vs_out.CameraPos;
     vs_out.TangentFragPos = vs_out.TBN * vs_out.Position.xyz;
 
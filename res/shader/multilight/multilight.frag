@@ -0,0 +1,274 @@
+#version 410 core
+
+/**
+ * Multi Light Shader.
+ *
+ * Wertet in einem einzigen Pass alle Punkt- und Richtungslichter aus, die als
+ * Uniform Buffer übergeben werden (siehe lightbuffer.c). Jedes Texel des
+ * G-Buffers wird dadurch nur einmal gelesen und das Ergebnis ohne Blending
+ * geschrieben. Nur wenn die Punktlichter nicht in einen Buffer passen, werden
+ * weitere Durchgänge additiv darauf gerechnet.
+ *
+ * Varianten: POINT_LIGHTS und DIR_LIGHTS schalten die jeweilige Lichtart ein,
+ * SHADOWS und PCF die Schatten der Richtungslichter.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: stud105751, stud104645
+ */
+
+#define MAX_POINT_LIGHTS 240
+#define MAX_DIR_LIGHTS 8
+#define DIR_SHADOW_MAX_CASCADES 4
+
+layout (location = 0) out vec3 gFinal; // Ausgabe der finalen Farbe
+
+// Struktur für die Eigenschaften eines Punktlichts
+struct PointLight
+{
+    vec3 position; // Position des Punktlichts
+    float radius; // Radius des Lichtvolumens
+
+    vec3 ambient; // Umgebungslichtanteil
+    vec3 diffuse; // Diffuses Licht
+    vec3 specular; // Spekulares Licht
+
+    float constant; // Konstante Abschwächung
+    float linear; // Lineare Abschwächung
+    float quadratic; // Quadratische Abschwächung
+};
+
+// Struktur für die Richtungslichtquelle
+struct DirLight
+{
+    vec3 direction; // Richtung des Lichts
+
+    vec3 ambient; // Umgebungslichtanteil
+    vec3 diffuse; // Diffuses Licht
+    vec3 specular; // Spekularlicht
+};
+
+// Alle Lichter des aktuellen Durchgangs, je vier vec4 pro Licht
+layout (std140) uniform Lights
+{
+    ivec4 u_lightCounts; // x = Punktlichter, y = Richtungslichter
+    vec4 u_pointLights[MAX_POINT_LIGHTS * 4];
+    vec4 u_dirLights[MAX_DIR_LIGHTS * 4];
+};
+
+uniform sampler2D u_depth; // Tiefe, aus der die Positionen rekonstruiert werden
+uniform sampler2D u_normal; // Textur mit den oktaedrisch kodierten Normalen
+uniform sampler2D u_albedoSpec; // Textur mit Albedo- und Spekularinformationen
+uniform sampler2D u_material; // Textur mit Ambient-Faktor und Shininess
+uniform sampler2D u_emission; // Emissionstextur
+uniform sampler2DArray u_shadowMap; // Schattenkarten der Richtungslichter, eine Schicht pro Kaskade
+
+uniform mat4 u_lightSpaces[DIR_SHADOW_MAX_CASCADES]; // Licht-Raum-Matrizen der Kaskaden
+uniform vec4 u_cascades[DIR_SHADOW_MAX_CASCADES]; // Ende im View Space, Tiefenbereich und Texelgröße
+uniform int u_cascadeCount;
+uniform mat4 u_view; // View-Matrix, zu der die Kaskaden passen
+
+uniform vec3 u_cameraPos; // Position der Kamera
+
+uniform bool u_writeEmission; // false für weitere additive Durchgänge
+
+uniform mat4 u_invViewProjection; // Inverse View-Projektions-Matrix der Kamera
+uniform vec2 u_renderSize; // Bereich des G-Buffers in Pixeln, in den gerendert wird
+
+// Rekonstruiert die Weltposition aus Texturkoordinaten und Tiefe
+vec3 ReconstructPosition(vec2 uv, float depth)
+{
+    vec4 position = u_invViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    return position.xyz / position.w;
+}
+
+// Dekodiert eine oktaedrisch kodierte Normale
+vec3 DecodeNormal(vec2 encoded)
+{
+    vec2 f = encoded * 2.0 - 1.0;
+    vec3 n = vec3(f, 1.0 - abs(f.x) - abs(f.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+// Dekodiert Ambient-Faktor und Shininess (siehe model.frag)
+vec2 DecodeMaterial(vec2 encoded)
+{
+    return vec2(encoded.x * 2.0, exp2(encoded.y * 11.0) - 1.0);
+}
+
+// Liest ein Punktlicht aus dem Uniform Buffer
+PointLight FetchPointLight(int index)
+{
+    PointLight light;
+    light.position = u_pointLights[index * 4 + 0].xyz;
+    light.radius = u_pointLights[index * 4 + 0].w;
+    light.ambient = u_pointLights[index * 4 + 1].rgb;
+    light.constant = u_pointLights[index * 4 + 1].a;
+    light.diffuse = u_pointLights[index * 4 + 2].rgb;
+    light.linear = u_pointLights[index * 4 + 2].a;
+    light.specular = u_pointLights[index * 4 + 3].rgb;
+    light.quadratic = u_pointLights[index * 4 + 3].a;
+    return light;
+}
+
+// Liest ein Richtungslicht aus dem Uniform Buffer
+DirLight FetchDirLight(int index)
+{
+    DirLight light;
+    light.direction = u_dirLights[index * 4 + 0].xyz;
+    light.ambient = u_dirLights[index * 4 + 1].rgb;
+    light.diffuse = u_dirLights[index * 4 + 2].rgb;
+    light.specular = u_dirLights[index * 4 + 3].rgb;
+    return light;
+}
+
+// Berechnet die Beleuchtung durch ein Punktlicht
+vec3 CalcPointLight(PointLight light, vec3 fragPos, vec3 normal, vec3 viewDir, vec3 ambientMap, vec3 diffuseMap, vec3 specularMap, float shininess)
+{
+    vec3 lightDir = normalize(light.position - fragPos);// Richtung zum Licht
+
+    float diff = max(dot(normal, lightDir), 0.0);// Diffuse Beleuchtung
+
+    vec3 reflectDir = reflect(-lightDir, normal);// Reflektierte Richtung
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);// Spekulare Beleuchtung
+
+    float distance = length(light.position - fragPos);// Entfernung zum Licht
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));// Abschwächung
+
+    vec3 ambient  = light.ambient         * ambientMap;// Umgebungslicht
+    vec3 diffuse  = light.diffuse  * diff * diffuseMap;// Diffuses Licht
+    vec3 specular = light.specular * spec * specularMap;// Spekulares Licht
+
+    return (ambient + diffuse + specular) * attenuation; // Gesamte Beleuchtung
+}
+
+// Berechnung des Lichts für die Richtungslichtquelle
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir, vec3 diffuseMap, vec3 specularMap, float shininess, float shadow)
+{
+    vec3 lightDir   = normalize(light.direction);
+
+    float diff = max(dot(lightDir, normal), 0.0); // Berechnung des diffusen Anteils
+
+    vec3 reflectDir = reflect(-lightDir, normal); // Berechnung der Reflexionsrichtung
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess); // Berechnung des spekularen Anteils
+
+    vec3 diffuse  = light.diffuse  * diff * diffuseMap; // Berechnung des diffusen Lichts
+    vec3 specular = light.specular * spec * specularMap; // Berechnung des spekularen Lichts
+
+    return (1.0 - shadow) * (diffuse + specular); // Summe der Lichtanteile
+}
+
+// Wählt die Kaskade für ein Fragment, -1 hinter der letzten Kaskade
+int SelectCascade(vec3 fragPos)
+{
+    float viewDepth = -(u_view * vec4(fragPos, 1.0)).z;
+    for (int i = 0; i < u_cascadeCount; ++i) {
+        if (viewDepth < u_cascades[i].x) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Schattenberechnung wie im Dirlight Shader
+float CalcShadows(int cascade, vec3 fragPos, vec3 normal, vec3 lightDir)
+{
+    if (cascade < 0) {
+        return 0.0;
+    }
+
+    vec4 fragPosLightSpace = u_lightSpaces[cascade] * vec4(fragPos, 1.0);
+    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
+    projCoords = projCoords * 0.5 + 0.5;
+
+    if (projCoords.z > 1.0) {
+        return 0.0;
+    }
+
+    float currentDepth = projCoords.z;
+    float bias = max(1.5 * (1.0 - dot(normal, lightDir)), 0.75) * u_cascades[cascade].z / u_cascades[cascade].y;
+
+    float shadow = 0.0;
+#ifdef PCF
+    {
+        vec2 texelSize = 1.0 / vec2(textureSize(u_shadowMap, 0).xy);
+        for (int x = -1; x <= 1; ++x) {
+            for (int y = -1; y <= 1; ++y) {
+                float pcfDepth = texture(u_shadowMap, vec3(projCoords.xy + vec2(x, y) * texelSize, cascade)).r;
+                shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
+            }
+        }
+        shadow /= 9.0;
+    }
+#else
+    {
+        float closestDepth = texture(u_shadowMap, vec3(projCoords.xy, cascade)).r;
+        shadow = currentDepth - bias > closestDepth ? 1.0 : 0.0;
+    }
+#endif
+
+    return shadow;
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+    vec3 emission = texelFetch(u_emission, pixel, 0).rgb; // Emission
+    if (emission != vec3(0.0)) {
+        gFinal = u_writeEmission ? emission : vec3(0.0);
+        return;
+    }
+
+    // Pixel ohne Geometrie erhalten kein Licht und behalten die Clear Color.
+    float depth = texelFetch(u_depth, pixel, 0).r;
+    if (depth >= 1.0) {
+        discard;
+    }
+
+    vec2 uv         = gl_FragCoord.xy / u_renderSize;
+    vec3 fragPos    = ReconstructPosition(uv, depth); // Fragmentposition
+    vec3 normal     = DecodeNormal(texelFetch(u_normal, pixel, 0).rg); // Normalenvektor
+    vec4 albedoSpec = texelFetch(u_albedoSpec, pixel, 0); // Albedo und Spekularanteil
+    vec2 material   = DecodeMaterial(texelFetch(u_material, pixel, 0).rg); // Ambient-Faktor und Shininess
+
+    vec3 viewDir = normalize(u_cameraPos - fragPos); // Blickrichtung
+
+    vec3 light = vec3(0.0);
+
+#ifdef POINT_LIGHTS
+    {
+        for (int i = 0; i < u_lightCounts.x; ++i) {
+            PointLight pointLight = FetchPointLight(i);
+
+            // Lichter, deren Kugel das Fragment nicht erreicht, überspringen.
+            if (distance(pointLight.position, fragPos) > pointLight.radius) {
+                continue;
+            }
+
+            light += CalcPointLight(pointLight, fragPos, normal, viewDir, albedoSpec.rgb * material.x, albedoSpec.rgb, albedoSpec.aaa, material.y);
+        }
+    }
+#endif
+
+#ifdef DIR_LIGHTS
+    {
+        int cascade = SelectCascade(fragPos);
+
+        for (int i = 0; i < u_lightCounts.y; ++i) {
+            DirLight dirLight = FetchDirLight(i);
+            vec3 lightDir = normalize(dirLight.direction);
+
+#ifdef SHADOWS
+            float shadow = CalcShadows(cascade, fragPos, normal, lightDir);
+#else
+            float shadow = 0.0;
+#endif
+            light += CalcDirLight(dirLight, normal, viewDir, albedoSpec.rgb, albedoSpec.aaa, material.y, shadow);
+        }
+    }
+#endif
+
+    gFinal = light;
+}
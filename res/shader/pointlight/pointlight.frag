@@ -3,6 +3,9 @@
 /**
  * Pointlight Shader.
  *
+ * Varianten: SHADOWS wertet den Schatten-Atlas aus (shadowatlas.glsl), PCF
+ * filtert die Schatten dabei weich.
+ *
  * Copyright (C) 2020, FH Wedel
  * Autor: stud105751, stud104645
  */
@@ -23,35 +26,45 @@ struct PointLight
     float quadratic; // Quadratische Abschwächung
 };
 
-in vec2 TexCoords;
-
-uniform sampler2D u_position; // Textur mit den Positionen der Fragmente
-uniform sampler2D u_normal; // Textur mit den Normalen der Fragmente
+uniform sampler2D u_depth; // Tiefe, aus der die Positionen rekonstruiert werden
+uniform sampler2D u_normal; // Textur mit den oktaedrisch kodierten Normalen
 uniform sampler2D u_albedoSpec; // Textur mit Albedo- und Spekularinformationen
-uniform sampler2D u_ambientShi; // Textur mit Ambient- und Shininessinformationen
+uniform sampler2D u_material; // Textur mit Ambient-Faktor und Shininess
 uniform sampler2D u_emission; // Emissionstextur
-uniform samplerCube u_shadowMap;
+
+uniform int u_shadowSlot; // Slot des aktuellen Lichts im Schatten-Atlas
 
 uniform PointLight u_pointLight; // Punktlicht-Uniform
 
 uniform vec3 u_cameraPos; // Position der Kamera
 
-uniform float u_zFar;
-uniform bool u_showShadows;
-uniform bool u_usePCF;
+uniform mat4 u_invViewProjection; // Inverse View-Projektions-Matrix der Kamera
+uniform vec2 u_renderSize; // Bereich des G-Buffers in Pixeln, in den gerendert wird
+
+#include "shadowatlas.glsl"
 
+// Rekonstruiert die Weltposition aus Texturkoordinaten und Tiefe
+vec3 ReconstructPosition(vec2 uv, float depth)
+{
+    vec4 position = u_invViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    return position.xyz / position.w;
+}
 
-uniform bool u_isActive;
+// Dekodiert eine oktaedrisch kodierte Normale
+vec3 DecodeNormal(vec2 encoded)
+{
+    vec2 f = encoded * 2.0 - 1.0;
+    vec3 n = vec3(f, 1.0 - abs(f.x) - abs(f.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
 
-// Array aus Offset Richtungen für das Samplen, jedes zeigt in eine
-// komplett andere Richtung (weniger Redundanz)
-vec3 gridsamplingDisk[20] = vec3[] (
-    vec3(1, 1, 1), vec3(1, -1, 1), vec3(-1, -1, 1), vec3(-1, 1, 1),
-    vec3(1, 1, -1), vec3(1, -1, -1), vec3(-1, -1, -1), vec3(-1, 1, -1),
-    vec3(1, 1, 0), vec3(1, -1, 0), vec3(-1, -1, 0), vec3(-1, 1, 0),
-    vec3(1, 0, 1), vec3(-1, 0, 1), vec3(1, 0, -1), vec3(-1, 0, -1),
-    vec3(0, 1, 1), vec3(0, -1, 1), vec3(0, -1, -1), vec3(0, 1, -1)
-);
+// Dekodiert Ambient-Faktor und Shininess (siehe model.frag)
+vec2 DecodeMaterial(vec2 encoded)
+{
+    return vec2(encoded.x * 2.0, exp2(encoded.y * 11.0) - 1.0);
+}
 
 // Berechnet die Beleuchtung durch ein Punktlicht
 vec3 CalcPointLight(PointLight light, vec3 fragPos, vec3 normal, vec3 viewDir, vec3 ambientMap, vec3 diffuseMap, vec3 specularMap, float shininess, float shadow)
@@ -79,59 +92,39 @@ vec3 CalcPointLight(PointLight light, vec3 fragPos, vec3 normal, vec3 viewDir, v
     return (ambient + (1.0 - shadow) * (diffuse + specular)); // Gesamte Beleuchtung
 }
 
-//https://learnopengl.com/Advanced-Lighting/Shadows/Point-Shadows
-float CalcShadows(vec3 fragPos, vec3 lightPos, bool usePCF)
-{
-    // get vector between fragment position and light position
-    vec3 fragToLight = fragPos - lightPos;
-
-    // now get current linear depth as the length between the fragment and light position
-    float currentDepth = length(fragToLight);
-
-    float bias = 0.05;
-    float shadow = 0;
-    if (usePCF) {
-        int samples  = 20;
-
-        float viewDistance = length(u_cameraPos - fragPos);
-        float diskRadius = (1.0 + (viewDistance / u_zFar)) / 25.0;
-
-        for(int i = 0; i < samples; ++i)
-        {
-            float closestDepth = texture(u_shadowMap, fragToLight + gridsamplingDisk[i] * diskRadius).r;
-            closestDepth *= u_zFar;
-            if(currentDepth - bias > closestDepth) {
-                shadow += 1.0;
-            }
-        }
-        shadow /= float(samples);
-    } else {
-        // use the light to fragment vector to sample from the depth map
-        float closestDepth = texture(u_shadowMap, fragToLight).r;
-        // it is currently in linear range between [0,1]. Re-transform back to original value
-        closestDepth *= u_zFar;
-
-        shadow = currentDepth - bias > closestDepth ? 1.0 : 0.0;
-    }
-
-    return shadow;
-}
-
 void main()
 {
+    // Die Texturkoordinaten ergeben sich aus der Bildschirmposition, damit
+    // Fullscreen-Quad und Lichtvolumen gleich behandelt werden können. Bei
+    // verringerter Auflösung wird nur ein Teil des G-Buffers genutzt, die
+    // Position wird daher über den genutzten Bereich rekonstruiert.
+    vec2 TexCoords = gl_FragCoord.xy / vec2(textureSize(u_depth, 0));
+    vec2 screenUV  = gl_FragCoord.xy / u_renderSize;
+
+    // Pixel ohne Geometrie erhalten kein Licht, nur ihre Emission.
+    float depth = texture(u_depth, TexCoords).r;
+    if (depth >= 1.0) {
+        gFinal = texture(u_emission, TexCoords).rgb;
+        return;
+    }
 
-    vec3 fragPos    = texture(u_position, TexCoords).rgb; // Fragmentposition
-    vec3 normal     = normalize(texture(u_normal, TexCoords).rgb); // Normalenvektor
+    vec3 fragPos    = ReconstructPosition(screenUV, depth); // Fragmentposition
+    vec3 normal     = DecodeNormal(texture(u_normal, TexCoords).rg); // Normalenvektor
     vec3 albedo     = texture(u_albedoSpec, TexCoords).rgb; // Albedo
-    vec3 ambient    = texture(u_ambientShi, TexCoords).rgb;
     vec3 specular   = texture(u_albedoSpec, TexCoords).aaa; // Spekularanteil
     vec3 emission   = texture(u_emission, TexCoords).rgb; // Emission
+    vec2 material   = DecodeMaterial(texture(u_material, TexCoords).rg);
 
-    float shininess = texture(u_ambientShi, TexCoords).a;
+    vec3 ambient    = albedo * material.x;
+    float shininess = material.y;
 
     vec3 viewDir = normalize(u_cameraPos - fragPos); // Blickrichtung
 
-    float shadow = u_showShadows ? CalcShadows(fragPos, u_pointLight.position, u_usePCF) : 0;
-    vec3 light = u_isActive ? CalcPointLight(u_pointLight, fragPos, normal, viewDir, ambient, albedo, specular, shininess, shadow) : vec3(0.0);
+#ifdef SHADOWS
+    float shadow = CalcShadows(fragPos, u_pointLight.position, u_cameraPos, u_shadowSlot);
+#else
+    float shadow = 0.0;
+#endif
+    vec3 light = CalcPointLight(u_pointLight, fragPos, normal, viewDir, ambient, albedo, specular, shininess, shadow);
     gFinal = emission != vec3(0.0) ? emission : light;
 }
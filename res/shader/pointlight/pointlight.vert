@@ -7,12 +7,18 @@
  * Autor: stud105751, stud104645
  */
 
-layout (location = 0) in vec2 aPos; // Vertex-Positionsattribut
-layout (location = 1) in vec2 aTexCoords; // Texturkoordinaten-Attribut
+layout (location = 0) in vec3 aPos; // Vertex-Position (Quad: xy, Lichtvolumen: xyz)
 
-out vec2 TexCoords; // Ausgabe der Texturkoordinaten an den Fragment-Shader
+uniform mat4 u_projection; // Projektionsmatrix
+uniform mat4 u_view; // View-Matrix
+uniform mat4 u_model; // Model-Matrix des Lichtvolumens
+
+uniform bool u_useLightVolume; // Kugel statt Fullscreen-Quad zeichnen
 
 void main() {
-    TexCoords = aTexCoords; // Übergabe der Texturkoordinaten an den Fragment-Shader
-    gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0); // Setzen der Position des Vertex
+    if (u_useLightVolume) {
+        gl_Position = u_projection * u_view * u_model * vec4(aPos, 1.0); // Lichtvolumen transformieren
+    } else {
+        gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0); // Setzen der Position des Vertex
+    }
 }
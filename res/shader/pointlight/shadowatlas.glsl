@@ -0,0 +1,121 @@
+/**
+ * Schatten der Punktlichter aus dem gemeinsamen Schatten-Atlas (siehe
+ * shadowatlas.c).
+ *
+ * Wird per #include vom Punktlicht-Shader und vom Shader des gekachelten bzw.
+ * geclusterten Modus eingebunden, damit beide Verfahren dieselben Schatten
+ * werfen.
+ *
+ * Varianten: PCF filtert die Schatten weich.
+ *
+ * Autor: stud105751, stud104645
+ */
+
+#define SHADOWATLAS_MAX_SLOTS 64
+
+uniform sampler2D u_shadowAtlas; // Schatten-Atlas aller Punktlichter (siehe shadowatlas.c)
+
+// Slots des Atlas: x = Z-Order-Index der ersten Würfelseite, y = Kantenlänge
+// einer Seite in Texeln, z = Entfernung, auf die die Tiefe normiert ist
+uniform vec4 u_shadowSlots[SHADOWATLAS_MAX_SLOTS];
+
+// Array aus Offset Richtungen für das Samplen, jedes zeigt in eine
+// komplett andere Richtung (weniger Redundanz)
+vec3 gridsamplingDisk[20] = vec3[] (
+    vec3(1, 1, 1), vec3(1, -1, 1), vec3(-1, -1, 1), vec3(-1, 1, 1),
+    vec3(1, 1, -1), vec3(1, -1, -1), vec3(-1, -1, -1), vec3(-1, 1, -1),
+    vec3(1, 1, 0), vec3(1, -1, 0), vec3(-1, -1, 0), vec3(-1, 1, 0),
+    vec3(1, 0, 1), vec3(-1, 0, 1), vec3(1, 0, -1), vec3(-1, 0, -1),
+    vec3(0, 1, 1), vec3(0, -1, 1), vec3(0, -1, -1), vec3(0, 1, -1)
+);
+
+// Blickrichtung, rechter und oberer Vektor der sechs Würfelseiten in der
+// Reihenfolge +X, -X, +Y, -Y, +Z, -Z, wie sie glm_lookat beim Rendern der
+// Schatten aus Blickrichtung und Up-Vektor erzeugt
+const vec3 FACE_FORWARD[6] = vec3[] (
+    vec3(1, 0, 0), vec3(-1, 0, 0), vec3(0, 1, 0), vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1)
+);
+const vec3 FACE_RIGHT[6] = vec3[] (
+    vec3(0, 0, -1), vec3(0, 0, 1), vec3(1, 0, 0), vec3(1, 0, 0), vec3(1, 0, 0), vec3(-1, 0, 0)
+);
+const vec3 FACE_UP[6] = vec3[] (
+    vec3(0, -1, 0), vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1), vec3(0, -1, 0), vec3(0, -1, 0)
+);
+
+// Liefert jedes zweite Bit eines Z-Order-Index (siehe shadowatlas.c)
+uint CompactBits(uint v)
+{
+    v &= 0x55555555u;
+    v = (v | (v >> 1)) & 0x33333333u;
+    v = (v | (v >> 2)) & 0x0F0F0F0Fu;
+    v = (v | (v >> 4)) & 0x00FF00FFu;
+    v = (v | (v >> 8)) & 0x0000FFFFu;
+    return v;
+}
+
+// Liest die normierte Tiefe in einer Richtung vom Licht aus dem Atlas. Die
+// Würfelseite ergibt sich aus der größten Komponente, die Position darin aus
+// der Projektion mit 90 Grad Öffnungswinkel.
+float SampleShadowAtlas(vec4 slot, vec3 direction)
+{
+    vec3 a = abs(direction);
+    int face = a.x >= a.y && a.x >= a.z ? (direction.x > 0.0 ? 0 : 1)
+             : a.y >= a.z               ? (direction.y > 0.0 ? 2 : 3)
+             :                            (direction.z > 0.0 ? 4 : 5);
+
+    vec2 ndc = vec2(dot(FACE_RIGHT[face], direction), dot(FACE_UP[face], direction))
+             / dot(FACE_FORWARD[face], direction);
+
+    // Die Seiten eines Slots liegen hintereinander auf der Z-Order-Kurve.
+    uint tile = uint(slot.x) + uint(face);
+    vec2 origin = vec2(CompactBits(tile), CompactBits(tile >> 1u)) * slot.y;
+
+    // Innerhalb der Kachel bleiben, damit PCF nicht in Nachbarn liest.
+    vec2 texel = clamp((ndc * 0.5 + 0.5) * slot.y, vec2(0.5), vec2(slot.y - 0.5));
+    return texture(u_shadowAtlas, (origin + texel) / vec2(textureSize(u_shadowAtlas, 0))).r;
+}
+
+//https://learnopengl.com/Advanced-Lighting/Shadows/Point-Shadows
+float CalcShadows(vec3 fragPos, vec3 lightPos, vec3 cameraPos, int slotIndex)
+{
+    // get vector between fragment position and light position
+    vec3 fragToLight = fragPos - lightPos;
+
+    // now get current linear depth as the length between the fragment and light position
+    float currentDepth = length(fragToLight);
+
+    vec4 slot = u_shadowSlots[slotIndex];
+    float zFar = slot.z;
+
+    float bias = 0.05;
+    float shadow = 0;
+#ifdef PCF
+    {
+        int samples  = 20;
+
+        float viewDistance = length(cameraPos - fragPos);
+        float diskRadius = (1.0 + (viewDistance / zFar)) / 25.0;
+
+        for(int i = 0; i < samples; ++i)
+        {
+            float closestDepth = SampleShadowAtlas(slot, fragToLight + gridsamplingDisk[i] * diskRadius);
+            closestDepth *= zFar;
+            if(currentDepth - bias > closestDepth) {
+                shadow += 1.0;
+            }
+        }
+        shadow /= float(samples);
+    }
+#else
+    {
+        // use the light to fragment vector to sample from the depth map
+        float closestDepth = SampleShadowAtlas(slot, fragToLight);
+        // it is currently in linear range between [0,1]. Re-transform back to original value
+        closestDepth *= zFar;
+
+        shadow = currentDepth - bias > closestDepth ? 1.0 : 0.0;
+    }
+#endif
+
+    return shadow;
+}
@@ -3,27 +3,19 @@
 /**
  * Postprocess Shader.
  *
+ * Schreibt das fertige Bild in einem einzigen Pass, wenn keine
+ * Tiefenunschärfe aktiv ist (siehe postprocess.glsl).
+ *
  * Autor: stud105751, stud104645
  */
 
-in vec2 TexCoords; // Eingabe der Texturkoordinaten vom Vertex-Shader
+layout (location = 0) out vec4 FragColor; // Ausgabe der finalen Farbe
 
-uniform sampler2D u_bloom; // Bloom-Textur
-uniform sampler2D u_final; // Textur der finalen gerenderten Szene
+in vec2 TexCoords; // Eingabe der Texturkoordinaten vom Vertex-Shader
 
-uniform float u_exposure; // Belichtungswert
-uniform float u_gamma; // Gamma-Wert
+#include "postprocess.glsl"
 
 void main() {
-    // Abtasten der finalen Farbe und der Bloom-Farbe aus den Texturen
-    vec3 color = texture(u_final, TexCoords).rgb;
-    color += texture(u_bloom, TexCoords).rgb;
-
-    // Anwenden der Belichtungskorrektur
-    color = vec3(1.0) - exp(-color * u_exposure);
-    // Anwenden der Gamma-Korrektur
-    color = pow(color, vec3(1.0 / u_gamma));
-
-    // Setzen der Fragmentfarbe
-    gl_FragColor = vec4(color, 1.0);
+    float dist;
+    FragColor = vec4(PostprocessPixel(ivec2(gl_FragCoord.xy), TexCoords, dist), 1.0);
 }
@@ -0,0 +1,91 @@
+/**
+ * Gemeinsame Nachbearbeitung pro Pixel.
+ *
+ * Fasst Nebel, Bloom, Belichtung, Gamma und Skybox zu einer Funktion
+ * zusammen, damit die Stufen nicht jeweils einen eigenen Fullscreen-Pass mit
+ * Lesen und Schreiben des ganzen Bildes brauchen. Wird per #include vom
+ * Postprocess-Shader und von beiden Shadern der Tiefenunschärfe eingebunden.
+ * Die Reihenfolge entspricht den früheren einzelnen Pässen.
+ *
+ * Varianten: FOG, BLOOM und SKYBOX schalten die jeweilige Stufe ein.
+ * Belichtung und Gamma werden immer angewendet.
+ *
+ * Autor: stud105751, stud104645
+ */
+
+uniform sampler2D u_depth; // Tiefe, aus der die Positionen rekonstruiert werden
+uniform sampler2D u_final; // Textur mit der beleuchteten Szene
+
+uniform vec3 u_cameraPos; // Position der Kamera
+uniform mat4 u_invViewProjection; // Inverse View-Projektions-Matrix der Kamera
+uniform vec2 u_renderSize; // Bereich des G-Buffers in Pixeln, in den gerendert wird
+
+#ifdef FOG
+uniform vec3 u_fogColor; // Farbe des Nebels
+uniform float u_fogDensity; // Dichte des Nebels
+#endif
+
+#ifdef BLOOM
+uniform sampler2D u_bloom; // größte Stufe der Bloom-Mip-Kette in halber Auflösung
+uniform float u_bloomStrength; // Faktor für die Summe der Bloom-Stufen
+uniform vec2 u_bloomSize; // genutzter Bereich der größten Bloom-Stufe in Texeln
+#endif
+
+uniform float u_exposure; // Belichtungswert
+uniform float u_gamma; // Gamma-Wert
+
+#ifdef SKYBOX
+uniform samplerCube u_skybox; // Cube-Map-Sampler für die Skybox
+#endif
+
+// Rekonstruiert die Weltposition aus Texturkoordinaten und Tiefe
+vec3 ReconstructPosition(vec2 uv, float depth)
+{
+    vec4 position = u_invViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    return position.xyz / position.w;
+}
+
+// Wendet alle Stufen der Nachbearbeitung auf einen Pixel an und liefert
+// zusätzlich die Entfernung zur Kamera
+vec3 PostprocessPixel(ivec2 pixel, vec2 uv, out float dist)
+{
+    float depth = texelFetch(u_depth, pixel, 0).r; // Tiefe des Fragments
+    vec3 color = texelFetch(u_final, pixel, 0).rgb; // Beleuchtete Farbe
+
+    vec3 position = ReconstructPosition(uv, depth); // Fragmentposition
+    dist = distance(u_cameraPos, position);
+
+#ifdef FOG
+    {
+        if (depth >= 1.0) {
+            color = u_fogColor; // Ohne Geometrie nur die Nebelfarbe
+        } else {
+            // https://www.mbsoftworks.sk/tutorials/opengl4/020-fog/
+            // Exp2 Nebel-Formel: e^-(density * coord)^2
+            color = mix(color, u_fogColor, clamp(1.0 - exp(-pow(u_fogDensity * dist, 2.0)), 0.0, 1.0));
+        }
+    }
+#endif
+
+#ifdef BLOOM
+    {
+        // Am Rand des genutzten Bereichs nicht in ungenutzte Texel filtern
+        vec2 bloomTexel = clamp(uv * u_bloomSize, vec2(0.5), u_bloomSize - 0.5);
+        color += texture(u_bloom, bloomTexel / vec2(textureSize(u_bloom, 0))).rgb * u_bloomStrength;
+    }
+#endif
+
+    // Anwenden der Belichtungskorrektur
+    color = vec3(1.0) - exp(-color * u_exposure);
+    // Anwenden der Gamma-Korrektur
+    color = pow(color, vec3(1.0 / u_gamma));
+
+    // Die Skybox wird wie bisher erst nach dem Tonemapping hinzugefügt
+#ifdef SKYBOX
+    if (depth >= 1.0) {
+        color += texture(u_skybox, position - u_cameraPos).rgb;
+    }
+#endif
+
+    return color;
+}
@@ -0,0 +1,102 @@
+#version 410 core
+
+/**
+ * Shader für die temporale Rekonstruktion.
+ *
+ * Setzt das Bild in voller Auflösung aus dem in verringerter Auflösung
+ * gerenderten Bild und dem Ergebnis des letzten Frames zusammen. Da die
+ * Projektion in jedem Frame um einen anderen Bruchteil eines Pixels
+ * verschoben wird, liegen die Samples über mehrere Frames an immer anderen
+ * Stellen jedes Ausgabepixels. Das letzte Ergebnis wird über die
+ * Bewegungsvektoren an die neue Stelle geholt und auf die Farben um das
+ * aktuelle Sample begrenzt, damit verdeckte oder veränderte Stellen nicht
+ * nachziehen.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+layout (location = 0) out vec4 FragColor; // Ausgabe in voller Auflösung, zugleich das nächste History-Bild
+
+in vec2 TexCoords; // Texturkoordinaten des Ausgabepixels
+
+uniform sampler2D u_image;    // aktuelles Bild, genutzt bis u_renderSize
+uniform sampler2D u_depth;    // Tiefe des G-Buffers
+uniform sampler2D u_velocity; // Bewegungsvektoren des G-Buffers
+uniform sampler2D u_history;  // Ergebnis des letzten Frames
+
+uniform vec2 u_renderSize;       // genutzter Bereich von u_image und dem G-Buffer in Texeln
+uniform vec2 u_jitter;           // Verschiebung der Projektion in Pixeln des aktuellen Bildes
+uniform mat4 u_reprojection;     // bildet NDC dieses Frames ohne Jitter auf die des letzten ab
+uniform float u_historyWeight;   // Anteil des letzten Ergebnisses bei einem Sample genau in der Pixelmitte
+uniform bool u_historyValid;     // false nach Größenänderung oder Wechsel des Modus
+
+// Gewicht eines Samples nach seinem Abstand zur Mitte des Ausgabepixels in
+// Pixeln des aktuellen Bildes, eine Näherung an den Blackman-Harris-Filter
+float SampleWeight(vec2 offset)
+{
+    return exp(-2.29 * dot(offset, offset));
+}
+
+// Liest das aktuelle Bild bilinear, ohne über seinen genutzten Bereich hinaus zu filtern
+vec3 FetchCurrent(vec2 uv)
+{
+    vec2 texel = clamp(uv * u_renderSize, vec2(0.5), u_renderSize - 0.5);
+    return texture(u_image, texel / vec2(textureSize(u_image, 0))).rgb;
+}
+
+void main()
+{
+    ivec2 renderSize = ivec2(u_renderSize);
+
+    // Der Texel i enthält die Szene an der Stelle i + 0.5 - u_jitter, der
+    // nächste Texel zum Ausgabepixel ist also der an position.
+    vec2 position = TexCoords * u_renderSize + u_jitter;
+    ivec2 center = clamp(ivec2(floor(position)), ivec2(0), renderSize - 1);
+
+    // Farbbereich der 3x3-Nachbarschaft für die Begrenzung und der Texel mit
+    // der kleinsten Tiefe, dessen Bewegung Kanten mit dem vorderen Objekt
+    // wandern lässt
+    vec3 current = texelFetch(u_image, center, 0).rgb;
+    vec3 minColor = current;
+    vec3 maxColor = current;
+    ivec2 closest = center;
+    float closestDepth = texelFetch(u_depth, center, 0).r;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            ivec2 neighbor = clamp(center + ivec2(x, y), ivec2(0), renderSize - 1);
+            vec3 color = texelFetch(u_image, neighbor, 0).rgb;
+            minColor = min(minColor, color);
+            maxColor = max(maxColor, color);
+
+            float depth = texelFetch(u_depth, neighbor, 0).r;
+            if (depth < closestDepth) {
+                closestDepth = depth;
+                closest = neighbor;
+            }
+        }
+    }
+
+    // Der Hintergrund hat keine Geometrie und damit keine Bewegungsvektoren,
+    // er bewegt sich nur mit der Kamera.
+    vec2 velocity;
+    if (closestDepth >= 1.0) {
+        vec4 previous = u_reprojection * vec4(TexCoords * 2.0 - 1.0, 1.0, 1.0);
+        velocity = TexCoords - (previous.xy / previous.w * 0.5 + 0.5);
+    } else {
+        velocity = texelFetch(u_velocity, closest, 0).xy;
+    }
+
+    vec2 previousCoords = TexCoords - velocity;
+    if (!u_historyValid || any(lessThan(previousCoords, vec2(0.0))) || any(greaterThan(previousCoords, vec2(1.0)))) {
+        FragColor = vec4(FetchCurrent(TexCoords), 1.0);
+        return;
+    }
+
+    vec3 history = clamp(texture(u_history, previousCoords).rgb, minColor, maxColor);
+
+    // Liegt das Sample weit von der Pixelmitte, zählt es weniger, das Bild
+    // entsteht so über mehrere Frames aus den nächstgelegenen Samples.
+    float currentWeight = (1.0 - u_historyWeight) * SampleWeight(vec2(center) + 0.5 - position);
+    FragColor = vec4(mix(history, current, currentWeight), 1.0);
+}
@@ -0,0 +1,186 @@
+#version 410 core
+
+/**
+ * Tiled Light Shader.
+ *
+ * Wertet in einem einzigen Pass alle Punktlichter aus, die die Zelle des
+ * Fragments berühren. Eine Zelle ist entweder eine Bildschirmkachel oder,
+ * wenn u_sliceCount größer als 1 ist, ein Cluster aus Kachel und
+ * logarithmischer Tiefenschicht. Die Lichter und Zellenlisten werden auf der
+ * CPU erstellt und als Texture Buffer übergeben (siehe lightgrid.c).
+ *
+ * Varianten: ohne POINT_LIGHTS wird nur die Emission geschrieben. SHADOWS
+ * wertet für Lichter mit einem Slot den Schatten-Atlas aus
+ * (shadowatlas.glsl), PCF filtert die Schatten dabei weich.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: stud105751, stud104645
+ */
+
+layout (location = 0) out vec3 gFinal; // Ausgabe der finalen Farbe
+
+// Struktur für die Eigenschaften eines Punktlichts
+struct PointLight
+{
+    vec3 position; // Position des Punktlichts
+    float radius; // Radius des Lichtvolumens
+
+    vec3 ambient; // Umgebungslichtanteil
+    vec3 diffuse; // Diffuses Licht
+    vec3 specular; // Spekulares Licht
+
+    float constant; // Konstante Abschwächung
+    float linear; // Lineare Abschwächung
+    float quadratic; // Quadratische Abschwächung
+
+    int shadowSlot; // Slot im Schatten-Atlas, -1 ohne Schatten
+};
+
+uniform sampler2D u_depth; // Tiefe, aus der die Positionen rekonstruiert werden
+uniform sampler2D u_normal; // Textur mit den oktaedrisch kodierten Normalen
+uniform sampler2D u_albedoSpec; // Textur mit Albedo- und Spekularinformationen
+uniform sampler2D u_material; // Textur mit Ambient-Faktor und Shininess
+uniform sampler2D u_emission; // Emissionstextur
+
+uniform samplerBuffer u_lights; // Lichtdaten, 5 Texel pro Licht
+uniform usamplerBuffer u_cells; // Offset und Anzahl der Lichter pro Zelle
+uniform usamplerBuffer u_cellLights; // Lichtindizes aller Zellen
+
+uniform int u_tileSize; // Kantenlänge einer Kachel in Pixeln
+uniform int u_tileCountX; // Anzahl der Kacheln pro Zeile
+uniform int u_tileCountY; // Anzahl der Kacheln pro Spalte
+uniform int u_sliceCount; // Anzahl der Tiefenschichten (1 = nur Kacheln)
+uniform float u_sliceScale; // Skalierung von log(Tiefe) auf die Schicht
+uniform float u_sliceBias; // Verschiebung von log(Tiefe) auf die Schicht
+
+uniform mat4 u_view; // View-Matrix der Kamera
+
+uniform vec3 u_cameraPos; // Position der Kamera
+
+uniform mat4 u_invViewProjection; // Inverse View-Projektions-Matrix der Kamera
+uniform vec2 u_renderSize; // Bereich des G-Buffers in Pixeln, in den gerendert wird
+
+#include "../pointlight/shadowatlas.glsl"
+
+// Rekonstruiert die Weltposition aus Texturkoordinaten und Tiefe
+vec3 ReconstructPosition(vec2 uv, float depth)
+{
+    vec4 position = u_invViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    return position.xyz / position.w;
+}
+
+// Dekodiert eine oktaedrisch kodierte Normale
+vec3 DecodeNormal(vec2 encoded)
+{
+    vec2 f = encoded * 2.0 - 1.0;
+    vec3 n = vec3(f, 1.0 - abs(f.x) - abs(f.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+// Dekodiert Ambient-Faktor und Shininess (siehe model.frag)
+vec2 DecodeMaterial(vec2 encoded)
+{
+    return vec2(encoded.x * 2.0, exp2(encoded.y * 11.0) - 1.0);
+}
+
+// Liest ein Licht aus dem Licht-Buffer
+PointLight FetchPointLight(int index)
+{
+    vec4 t0 = texelFetch(u_lights, index * 5 + 0);
+    vec4 t1 = texelFetch(u_lights, index * 5 + 1);
+    vec4 t2 = texelFetch(u_lights, index * 5 + 2);
+    vec4 t3 = texelFetch(u_lights, index * 5 + 3);
+    vec4 t4 = texelFetch(u_lights, index * 5 + 4);
+
+    PointLight light;
+    light.position = t0.xyz;
+    light.radius = t0.w;
+    light.ambient = t1.rgb;
+    light.constant = t1.a;
+    light.diffuse = t2.rgb;
+    light.linear = t2.a;
+    light.specular = t3.rgb;
+    light.quadratic = t3.a;
+    light.shadowSlot = int(t4.x);
+    return light;
+}
+
+// Berechnet die Beleuchtung durch ein Punktlicht
+vec3 CalcPointLight(PointLight light, vec3 fragPos, vec3 normal, vec3 viewDir, vec3 ambientMap, vec3 diffuseMap, vec3 specularMap, float shininess, float shadow)
+{
+    vec3 lightDir = normalize(light.position - fragPos);// Richtung zum Licht
+
+    float diff = max(dot(normal, lightDir), 0.0);// Diffuse Beleuchtung
+
+    vec3 reflectDir = reflect(-lightDir, normal);// Reflektierte Richtung
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);// Spekulare Beleuchtung
+
+    float distance = length(light.position - fragPos);// Entfernung zum Licht
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));// Abschwächung
+
+    vec3 ambient  = light.ambient         * ambientMap;// Umgebungslicht
+    vec3 diffuse  = light.diffuse  * diff * diffuseMap;// Diffuses Licht
+    vec3 specular = light.specular * spec * specularMap;// Spekulares Licht
+
+    return (ambient + (1.0 - shadow) * (diffuse + specular)) * attenuation; // Gesamte Beleuchtung
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+    // Pixel ohne Geometrie erhalten kein Licht, nur ihre Emission.
+    float depth = texelFetch(u_depth, pixel, 0).r;
+    if (depth >= 1.0) {
+        gFinal = texelFetch(u_emission, pixel, 0).rgb;
+        return;
+    }
+
+    vec2 uv         = gl_FragCoord.xy / u_renderSize;
+    vec3 fragPos    = ReconstructPosition(uv, depth); // Fragmentposition
+    vec3 normal     = DecodeNormal(texelFetch(u_normal, pixel, 0).rg); // Normalenvektor
+    vec4 albedoSpec = texelFetch(u_albedoSpec, pixel, 0); // Albedo und Spekularanteil
+    vec2 material   = DecodeMaterial(texelFetch(u_material, pixel, 0).rg); // Ambient-Faktor und Shininess
+    vec3 emission   = texelFetch(u_emission, pixel, 0).rgb; // Emission
+
+    vec3 viewDir = normalize(u_cameraPos - fragPos); // Blickrichtung
+
+    // Die Liste der Zelle dieses Fragments bestimmen.
+    ivec2 tile = pixel / u_tileSize;
+    int slice = 0;
+    if (u_sliceCount > 1) {
+        float viewDepth = max(-(u_view * vec4(fragPos, 1.0)).z, 1e-4);
+        slice = clamp(int(floor(log(viewDepth) * u_sliceScale + u_sliceBias)), 0, u_sliceCount - 1);
+    }
+    int cell = (slice * u_tileCountY + tile.y) * u_tileCountX + tile.x;
+    uvec2 range = texelFetch(u_cells, cell).xy;
+
+    vec3 light = vec3(0.0);
+#ifdef POINT_LIGHTS
+    {
+        for (uint i = 0u; i < range.y; ++i) {
+            int index = int(texelFetch(u_cellLights, int(range.x + i)).r);
+            PointLight pointLight = FetchPointLight(index);
+
+            // Lichter, deren Kugel das Fragment nicht erreicht, überspringen.
+            // Das ersetzt den Tiefentest pro Kachel.
+            if (distance(pointLight.position, fragPos) > pointLight.radius) {
+                continue;
+            }
+
+#ifdef SHADOWS
+            float shadow = pointLight.shadowSlot >= 0
+                         ? CalcShadows(fragPos, pointLight.position, u_cameraPos, pointLight.shadowSlot)
+                         : 0.0;
+#else
+            float shadow = 0.0;
+#endif
+            light += CalcPointLight(pointLight, fragPos, normal, viewDir, albedoSpec.rgb * material.x, albedoSpec.rgb, albedoSpec.aaa, material.y, shadow);
+        }
+    }
+#endif
+
+    gFinal = emission != vec3(0.0) ? emission : light;
+}
@@ -0,0 +1,14 @@
+#version 410 core
+
+/**
+ * Tiled Light Shader.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: stud105751, stud104645
+ */
+
+layout (location = 0) in vec2 aPos; // Vertex-Positionsattribut
+
+void main() {
+    gl_Position = vec4(aPos, 0.0, 1.0); // Setzen der Position des Vertex
+}
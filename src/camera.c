@@ -107,6 +107,26 @@ void camera_getPosition(Camera* camera, vec3 position)
     glm_vec3_copy(camera->position, position);
 }
 
+void camera_setPose(Camera* camera, vec3 position, float yaw, float pitch)
+{
+    glm_vec3_copy(position, camera->position);
+    camera->yaw = yaw;
+    camera->pitch = pitch;
+
+    // Die Rotation wie bei der Mauseingabe beschränken.
+    if (camera->pitch > 89.0f)
+    {
+        camera->pitch = 89.0f;
+    }
+
+    if (camera->pitch < -89.0f)
+    {
+        camera->pitch = -89.0f;
+    }
+
+    camera_updateVectors(camera);
+}
+
 void camera_processKeyboardInput(Camera* camera, CameraMovement movement, 
                                  bool fast, float deltaTime)
 {
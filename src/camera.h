@@ -62,6 +62,16 @@ float camera_getZoom(Camera* camera);
  */
 void camera_getPosition(Camera* camera, vec3 position);
 
+/**
+ * Setzt Position und Ausrichtung einer Kamera direkt.
+ * 
+ * @param camera die Kamera, die gesetzt werden soll.
+ * @param position die neue Position.
+ * @param yaw die Drehung um die Y-Achse in Grad.
+ * @param pitch die Neigung in Grad, wird auf +-89 Grad beschränkt.
+ */
+void camera_setPose(Camera* camera, vec3 position, float yaw, float pitch);
+
 /**
  * Verarbeitet Bewegungseingaben für eine Kamera.
  * 
@@ -11,6 +11,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "profiler.h"
 #include "utils.h"
 
 //////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
@@ -98,6 +99,9 @@ void common_labelObjectByFilename(GLenum type, GLuint name, const char* filepath
 
 void common_pushRenderScopeSource(const char* scope, GLenum source)
 {
+    // Die GPU-Zeit wird auch ohne KHR_debug gemessen.
+    profiler_pushScope(scope);
+
     // Erst prüfen, ob Funktion existiert.
     if (!GLAD_GL_KHR_debug)
     {
@@ -109,6 +113,8 @@ void common_pushRenderScopeSource(const char* scope, GLenum source)
 
 void common_popRenderScope()
 {
+    profiler_popScope();
+
     // Erst prüfen, ob Funktion existiert.
     if (!GLAD_GL_KHR_debug)
     {
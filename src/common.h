@@ -105,9 +105,10 @@ void common_labelObjectByFilename(GLenum type, GLuint name, const char* filepath
 
 /**
  * Diese Funktion markiert einen Render-Bereich mit einem Namen,
- * damit dieser in RenderDoc hervorgehoben wird. Nach einem Push
- * muss irgendwann innerhalb eines Frames zwingend ein Pop
- * aufgerufen werden!
+ * damit dieser in RenderDoc hervorgehoben wird. Zusätzlich wird
+ * die GPU-Zeit des Bereichs gemessen (siehe profiler.h). Nach
+ * einem Push muss irgendwann innerhalb eines Frames zwingend ein
+ * Pop aufgerufen werden!
  * 
  * @param scope der Name des Scopes
  * @param source die Quelle für diesen Scope (Anwendung oder 3rd Party)
@@ -0,0 +1,245 @@
+/**
+ * Modul zum Überwachen von Dateien auf Änderungen.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#include "filewatch.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sesp/stb_ds.h>
+
+#ifdef __linux__
+    #include <unistd.h>
+    #include <sys/inotify.h>
+#endif
+
+#include "utils.h"
+
+////////////////////////////////// KONSTANTEN //////////////////////////////////
+
+// Größe des Puffers für die Ereignisse von inotify in Bytes
+#define FILEWATCH_EVENT_BUFFER_SIZE 4096
+
+////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
+
+// Eine überwachte Datei
+typedef struct
+{
+    char* path;       // Pfad wie bei filewatch_addFile übergeben
+    const char* name; // Dateiname innerhalb von path
+    int wd;           // inotify Watch des Verzeichnisses, -1 ohne inotify
+    time_t mtime;     // letzter bekannter Änderungszeitpunkt
+    bool changed;     // geändert seit dem letzten Aufruf von pollChanges
+} WatchedFile;
+
+struct FileWatch
+{
+    int fd;               // inotify Instanz, -1 wenn nicht verfügbar
+    double lastPoll;      // Zeitpunkt des letzten Vergleichs der Zeitpunkte
+    WatchedFile* files;   // stb_ds Array aller Dateien
+    const char** changes; // stb_ds Array der zuletzt gemeldeten Pfade
+};
+
+////////////////////////////// LOKALE FUNKTIONEN ///////////////////////////////
+
+/**
+ * Liefert den Zeitpunkt der letzten Änderung einer Datei.
+ *
+ * @param path der Pfad der Datei
+ * @return der Zeitpunkt oder 0, wenn die Datei gerade nicht existiert
+ */
+static time_t filewatch_getModificationTime(const char* path)
+{
+    struct stat info;
+    return stat(path, &info) == 0 ? info.st_mtime : 0;
+}
+
+/**
+ * Liest alle anstehenden Ereignisse von inotify, ohne zu warten, und markiert
+ * die betroffenen Dateien.
+ *
+ * @param watch die Überwachung
+ */
+static void filewatch_readEvents(FileWatch* watch)
+{
+#ifdef __linux__
+    if (watch->fd < 0)
+    {
+        return;
+    }
+
+    char buffer[FILEWATCH_EVENT_BUFFER_SIZE]
+        __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+    ssize_t length;
+    while ((length = read(watch->fd, buffer, sizeof(buffer))) > 0)
+    {
+        char* ptr = buffer;
+        while (ptr < buffer + length)
+        {
+            const struct inotify_event* event = (const struct inotify_event*) ptr;
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            // Sind Ereignisse verloren gegangen, könnte jede Datei betroffen
+            // sein.
+            bool overflow = event->mask & IN_Q_OVERFLOW;
+            for (size_t i = 0; i < stbds_arrlenu(watch->files); i++)
+            {
+                WatchedFile* file = &watch->files[i];
+                if (file->wd >= 0
+                    && (overflow || (file->wd == event->wd && event->len > 0
+                                     && strcmp(file->name, event->name) == 0)))
+                {
+                    file->changed = true;
+                }
+            }
+        }
+    }
+#else
+    (void) watch;
+#endif
+}
+
+/**
+ * Vergleicht die Änderungszeitpunkte aller Dateien, die nicht von inotify
+ * überwacht werden. Geschieht höchstens alle FILEWATCH_POLL_INTERVAL
+ * Sekunden.
+ *
+ * @param watch die Überwachung
+ */
+static void filewatch_pollModificationTimes(FileWatch* watch)
+{
+    double now = utils_getTime();
+    if (now - watch->lastPoll < FILEWATCH_POLL_INTERVAL)
+    {
+        return;
+    }
+    watch->lastPoll = now;
+
+    for (size_t i = 0; i < stbds_arrlenu(watch->files); i++)
+    {
+        WatchedFile* file = &watch->files[i];
+        if (file->wd < 0)
+        {
+            // Fehlt die Datei gerade, z.B. weil ein Editor sie beim
+            // Speichern ersetzt, wird gewartet, bis sie wieder existiert.
+            time_t mtime = filewatch_getModificationTime(file->path);
+            if (mtime != 0 && mtime != file->mtime)
+            {
+                file->mtime = mtime;
+                file->changed = true;
+            }
+        }
+    }
+}
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+FileWatch* filewatch_createFileWatch(void)
+{
+    FileWatch* watch = malloc(sizeof(FileWatch));
+    memset(watch, 0, sizeof(FileWatch));
+
+#ifdef __linux__
+    watch->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#else
+    watch->fd = -1;
+#endif
+    watch->lastPoll = utils_getTime();
+
+    return watch;
+}
+
+void filewatch_addFile(FileWatch* watch, const char* path)
+{
+    for (size_t i = 0; i < stbds_arrlenu(watch->files); i++)
+    {
+        if (strcmp(watch->files[i].path, path) == 0)
+        {
+            return;
+        }
+    }
+
+    WatchedFile file;
+    file.path = strdup(path);
+    file.mtime = filewatch_getModificationTime(path);
+    file.changed = false;
+    file.wd = -1;
+
+    const char* slash = strrchr(file.path, '/');
+    file.name = slash ? slash + 1 : file.path;
+
+#ifdef __linux__
+    if (watch->fd >= 0)
+    {
+        // Überwacht wird das Verzeichnis, da viele Editoren beim Speichern die
+        // Datei ersetzen und ein Watch auf die Datei selbst dann verloren
+        // geht. Mehrfach überwachte Verzeichnisse liefern denselben Watch.
+        size_t dirLength = (size_t) (file.name - file.path);
+        char* dir = malloc(dirLength + 2);
+        if (dirLength > 0)
+        {
+            memcpy(dir, file.path, dirLength);
+            dir[dirLength] = '\0';
+        }
+        else
+        {
+            strcpy(dir, ".");
+        }
+
+        // Schlägt das fehl, wird der Änderungszeitpunkt verglichen.
+        file.wd = inotify_add_watch(watch->fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+        free(dir);
+    }
+#endif
+
+    stbds_arrput(watch->files, file);
+}
+
+const char* const* filewatch_pollChanges(FileWatch* watch, int* count)
+{
+    filewatch_readEvents(watch);
+    filewatch_pollModificationTimes(watch);
+
+    stbds_arrsetlen(watch->changes, 0);
+    for (size_t i = 0; i < stbds_arrlenu(watch->files); i++)
+    {
+        if (watch->files[i].changed)
+        {
+            watch->files[i].changed = false;
+            stbds_arrput(watch->changes, watch->files[i].path);
+        }
+    }
+
+    *count = (int) stbds_arrlen(watch->changes);
+    return watch->changes;
+}
+
+void filewatch_deleteFileWatch(FileWatch* watch)
+{
+    if (watch == NULL)
+    {
+        return;
+    }
+
+#ifdef __linux__
+    // Mit der Instanz werden auch alle Watches entfernt.
+    if (watch->fd >= 0)
+    {
+        close(watch->fd);
+    }
+#endif
+
+    for (size_t i = 0; i < stbds_arrlenu(watch->files); i++)
+    {
+        free(watch->files[i].path);
+    }
+    stbds_arrfree(watch->files);
+    stbds_arrfree(watch->changes);
+    free(watch);
+}
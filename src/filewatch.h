@@ -0,0 +1,65 @@
+/**
+ * Modul zum Überwachen von Dateien auf Änderungen, z.B. um Shader beim
+ * Speichern automatisch neu zu übersetzen.
+ *
+ * Unter Linux werden die Verzeichnisse der Dateien mit inotify überwacht, so
+ * werden auch Editoren erkannt, die beim Speichern eine neue Datei an die
+ * Stelle der alten verschieben. Auf anderen Systemen oder wenn inotify nicht
+ * verfügbar ist, wird in festen Abständen der Änderungszeitpunkt verglichen.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#ifndef FILEWATCH_H
+#define FILEWATCH_H
+
+#include <stdbool.h>
+
+// Abstand in Sekunden, in dem ohne inotify die Änderungszeitpunkte
+// verglichen werden
+#define FILEWATCH_POLL_INTERVAL 0.5
+
+//////////////////////////// ÖFFENTLICHE DATENTYPEN ////////////////////////////
+
+// Opaker Datentyp für die Überwachung
+struct FileWatch;
+typedef struct FileWatch FileWatch;
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+/**
+ * Erzeugt eine neue Überwachung ohne Dateien.
+ *
+ * @return die neue Überwachung
+ */
+FileWatch* filewatch_createFileWatch(void);
+
+/**
+ * Nimmt eine Datei in die Überwachung auf. Bereits überwachte Dateien werden
+ * ignoriert.
+ *
+ * @param watch die Überwachung
+ * @param path der Pfad der Datei
+ */
+void filewatch_addFile(FileWatch* watch, const char* path);
+
+/**
+ * Liefert alle Dateien, die sich seit dem letzten Aufruf geändert haben. Die
+ * Funktion wartet nicht und kann in jedem Frame aufgerufen werden.
+ *
+ * @param watch die Überwachung
+ * @param count Ausgabeparameter für die Anzahl der geänderten Dateien
+ * @return die Pfade der geänderten Dateien, wie sie bei filewatch_addFile
+ *         übergeben wurden. Gültig bis zum nächsten Aufruf.
+ */
+const char* const* filewatch_pollChanges(FileWatch* watch, int* count);
+
+/**
+ * Löscht die Überwachung und gibt alle Ressourcen frei.
+ *
+ * @param watch die zu löschende Überwachung
+ */
+void filewatch_deleteFileWatch(FileWatch* watch);
+
+#endif // FILEWATCH_H
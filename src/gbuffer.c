@@ -16,205 +16,225 @@
 
 #include <string.h>
 
+#include "utils.h"
+
 ////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
 
+/**
+ * @struct GBufferLayoutEntry
+ * @brief Beschreibung einer Textur des Standard-GBuffers.
+ */
+typedef struct GBufferLayoutEntry
+{
+    const char *name; /**< Name des Samplers in den Shadern. */
+    GLenum internalFormat; /**< Format der Textur. */
+    GLenum format; /**< Format der Pixeldaten beim Anlegen. */
+    GLenum type; /**< Datentyp der Pixeldaten beim Anlegen. */
+    int bytesPerPixel; /**< Gelesene bzw. geschriebene Bytes pro Texel. */
+    float scale; /**< Auflösung relativ zum Bildschirm. Alle Texturen eines Passes müssen gleich skaliert sein. */
+    GLfloat clearValue[4]; /**< Wert, mit dem die Textur im Geometry-Pass geleert wird. */
+    int location; /**< Ausgabe des Geometry-Shaders, -1 wenn er die Textur nicht schreibt. */
+    int passes; /**< Bitmaske der Pässe (GBufferPass), die die Textur lesen. */
+} GBufferLayoutEntry;
+
+/**
+ * Layout des Standard-GBuffers, ein Eintrag pro DEFAULT_GBUFFER_TEXTURE_TYPE.
+ * Die Locations müssen zu den Ausgaben in model.frag passen, die Namen zu den
+ * Samplern der lesenden Shader. Um andere Formate zu vergleichen, genügt es,
+ * diese Tabelle (und ggf. die Kodierung in den Shadern) anzupassen.
+ */
+static const GBufferLayoutEntry GBUFFER_LAYOUT[DEFAULT_GBUFFER_NUM_COLORATTACH] = {
+    // Kopie von Tiefe und Stencil nach dem Geometry-Pass, aus der Tiefe werden
+    // die Positionen rekonstruiert. Das Format muss zum Tiefenpuffer des
+    // Standard-FBOs passen, sonst lässt sich die Tiefe nicht kopieren.
+    [DEFAULT_GBUFFER_DEPTH] = {
+        "u_depth", GL_DEPTH32F_STENCIL8, GL_DEPTH_STENCIL, GL_FLOAT_32_UNSIGNED_INT_24_8_REV,
+        4, 1.0f, { 1.0f, 0.0f, 0.0f, 0.0f }, -1,
+        GBUFFER_PASS_LIGHT | GBUFFER_PASS_DOF | GBUFFER_PASS_POSTPROCESS | GBUFFER_PASS_TEMPORAL
+    },
+    // Normale, oktaedrisch kodiert
+    [DEFAULT_GBUFFER_COLORATTACH_NORMAL] = {
+        "u_normal", GL_RG16, GL_RG, GL_UNSIGNED_SHORT,
+        4, 1.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, 0,
+        GBUFFER_PASS_LIGHT
+    },
+    // Albedo (sRGB) und Specular (metalness)
+    [DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC] = {
+        "u_albedoSpec", GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE,
+        4, 1.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, 1,
+        GBUFFER_PASS_LIGHT
+    },
+    // Material (Ambient-Faktor relativ zur Albedo, Shininess)
+    [DEFAULT_GBUFFER_COLORATTACH_MATERIAL] = {
+        "u_material", GL_RG8, GL_RG, GL_UNSIGNED_BYTE,
+        2, 1.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, 2,
+        GBUFFER_PASS_LIGHT
+    },
+    // Emission
+    [DEFAULT_GBUFFER_COLORATTACH_EMISSION] = {
+        "u_emission", GL_RGB16F, GL_RGB, GL_FLOAT,
+        6, 1.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, 3,
+        GBUFFER_PASS_LIGHT | GBUFFER_PASS_BLOOM
+    },
+    // Bewegung jedes Pixels seit dem letzten Frame in Texturkoordinaten, ohne
+    // den Jitter der Projektion. Nur mit temporaler Rekonstruktion vorhanden.
+    [DEFAULT_GBUFFER_COLORATTACH_VELOCITY] = {
+        "u_velocity", GL_RG16F, GL_RG, GL_FLOAT,
+        4, 1.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, 4,
+        GBUFFER_PASS_TEMPORAL
+    },
+    // Finales Ausgabebild, wird nicht im Geometry-Pass, sondern vom
+    // Render-Graphen vor dem Licht-Pass mit der Clear Color geleert
+    [DEFAULT_GBUFFER_COLORATTACH_FINAL] = {
+        "u_final", GL_RGBA16F, GL_RGBA, GL_FLOAT,
+        8, 1.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, -1,
+        GBUFFER_PASS_BLOOM | GBUFFER_PASS_DOF | GBUFFER_PASS_POSTPROCESS
+    },
+};
+
 /**
  * @struct GBuffer
  * @brief Struktur zur Speicherung der GBuffer-Informationen für das Rendering.
  *
- * Die Struktur enthält Framebuffer-Objekte (FBOs) und Texturen für verschiedene Rendering-Pässe,
- * einschließlich Standard-Rendering, Blur-Effekt und Schattenberechnung für Punkt- und Richtungslichter.
+ * Die Struktur enthält Framebuffer-Objekte (FBOs) und Texturen für das Standard-Rendering und die
+ * Schattenberechnung für Richtungslichter. Die Schatten der Punktlichter liegen im Schatten-Atlas
+ * (siehe shadowatlas.h), die Ziele der Nachbearbeitung vergibt der Render-Graph (siehe rendergraph.h).
  */
 struct GBuffer
 {
     GLuint defaultFBO; /**< Das Standard-Framebuffer-Objekt für das Haupt-Rendering. */
-    GLuint blurFBO; /**< Das Framebuffer-Objekt für den Blur-Effekt. */
+    GLuint depthCopyFBO; /**< Das Framebuffer-Objekt, über das die Tiefe in die lesbare Textur kopiert wird. */
     GLuint dirLightShadowFBO; /**< Das Framebuffer-Objekt für Richtungslicht-Schatten. */
-    GLuint *pointLightFBOs; /**< Dynamisches Array von Framebuffer-Objekten für Punktlicht-Schatten. */
 
-    GLuint defaultTextures[DEFAULT_GBUFFER_NUM_COLORATTACH]; /**< Array der Standard-GBuffer-Texturen. */
-    GLuint blurTextures[BLUR_GBUFFER_NUM_COLORATTACH]; /**< Array der Blur-Texturen für den Blur-Pass. */
-    GLuint depthTexture; /**< Tiefen-Textur für das Standard-Framebuffer. */
+    GLuint depthStencilBuffer; /**< Tiefe und Stencil des Standard-FBOs, gegen die Geometry- und Licht-Pässe testen. */
 
-    GLuint *pointLightDepthMaps; /**< Dynamisches Array von Tiefentexturen für Punktlichter. */
-    GLuint dirLightDepthMap; /**< Tiefen-Textur für das Richtungslicht. */
+    GLuint defaultTextures[DEFAULT_GBUFFER_NUM_COLORATTACH]; /**< Array der Standard-GBuffer-Texturen, 0 wenn kein aktiver Pass sie liest. */
+    int activePasses; /**< Bitmaske der Pässe (GBufferPass), für die Texturen angelegt sind. */
+    GLenum drawBuffers[DEFAULT_GBUFFER_NUM_COLORATTACH]; /**< Draw Buffers des Geometry-Pass, nach Location sortiert. */
+    int drawBufferCount; /**< Anzahl der Ausgaben des Geometry-Pass. */
+
+    GLuint dirLightDepthMap; /**< Tiefen-Textur-Array für das Richtungslicht, eine Schicht pro Kaskade. */
 
-    int allocatedPointLightFBOs; /**< Anzahl der allokierten Punktlicht-FBOs. */
     int shadowSize; /**< Die Auflösung der Schatten-Texturen. */
+    int shadowLayers; /**< Die Anzahl der Schichten der Richtungslicht-Schatten. */
+    int width; /**< Die Breite der Standard-Texturen. */
+    int height; /**< Die Höhe der Standard-Texturen. */
 };
 
 /**
- * @brief Bereinigt die Ressourcen für Punktlicht-Framebuffer-Objekte und Tiefentexturen.
- *
- * Diese Funktion löscht die Framebuffer und Tiefentexturen, die für Punktlichter verwendet wurden,
- * und gibt den belegten Speicher frei.
+ * @brief Gibt das Attachment zurück, an dem eine Textur des Standard-GBuffers hängt.
  *
- * @param gbuffer Der GBuffer, dessen Punktlicht-FBOs bereinigt werden sollen.
+ * @param type Der Typ der Textur.
+ * @return Das Attachment im Standard-FBO.
  */
-static void cleanupPointLightFBOs(GBuffer *gbuffer) {
-    if (gbuffer->pointLightFBOs) {
-        for (int i = 0; i < gbuffer->allocatedPointLightFBOs; ++i) {
-            glDeleteFramebuffers(1, &gbuffer->pointLightFBOs[i]);
-        }
-        free(gbuffer->pointLightFBOs);
-    }
-
-    if (gbuffer->pointLightDepthMaps) {
-        for (int i = 0; i < gbuffer->allocatedPointLightFBOs; ++i) {
-            glDeleteTextures(1, &gbuffer->pointLightDepthMaps[i]);
-        }
-        free(gbuffer->pointLightDepthMaps);
-    }
-
-    gbuffer->pointLightFBOs = NULL;
-    gbuffer->pointLightDepthMaps = NULL;
+static GLenum gbuffer_getAttachment(const DEFAULT_GBUFFER_TEXTURE_TYPE type)
+{
+    return GBUFFER_LAYOUT[type].format == GL_DEPTH_STENCIL
+           ? GL_DEPTH_STENCIL_ATTACHMENT
+           : GL_COLOR_ATTACHMENT0 + type;
 }
 
 /**
- * @brief Reserviert Speicher für eine Punktlicht-Framebuffer-Array.
+ * @brief Gibt das FBO zurück, an dem eine Textur des Standard-GBuffers hängt. Die lesbare Tiefe hängt
+ * nicht am Standard-FBO, da die Licht-Pässe sie sonst zugleich lesen und als Attachment nutzen würden.
  *
  * @param gbuffer Der GBuffer.
- * @param count Die Anzahl der Punktlichter.
+ * @param type Der Typ der Textur.
+ * @return Das FBO der Textur.
  */
-static void gbuffer_mallocPointLightFBOArray(GBuffer* gbuffer, const int count)
+static GLuint gbuffer_getFramebuffer(const GBuffer *gbuffer, const DEFAULT_GBUFFER_TEXTURE_TYPE type)
 {
-    cleanupPointLightFBOs(gbuffer);
+    return gbuffer_getAttachment(type) == GL_DEPTH_STENCIL_ATTACHMENT
+           ? gbuffer->depthCopyFBO
+           : gbuffer->defaultFBO;
+}
 
-    gbuffer->allocatedPointLightFBOs = count;
-    gbuffer->pointLightFBOs      = malloc(sizeof(GLuint) * count);
-    gbuffer->pointLightDepthMaps = malloc(sizeof(GLuint) * count);
+/**
+ * @brief Legt eine Textur des Standard-GBuffers nach der Layout-Tabelle an und hängt sie an ihr FBO.
+ *
+ * @param gbuffer Der GBuffer.
+ * @param type Der Typ der Textur.
+ */
+static void gbuffer_createTexture(GBuffer *gbuffer, const DEFAULT_GBUFFER_TEXTURE_TYPE type)
+{
+    const GBufferLayoutEntry *entry = &GBUFFER_LAYOUT[type];
+    const int scaledWidth = utils_maxInt(1, (int) ((float) gbuffer->width * entry->scale));
+    const int scaledHeight = utils_maxInt(1, (int) ((float) gbuffer->height * entry->scale));
+
+    glGenTextures(1, &gbuffer->defaultTextures[type]);
+    glBindTexture(GL_TEXTURE_2D, gbuffer->defaultTextures[type]);
+    glTexImage2D(GL_TEXTURE_2D, 0, entry->internalFormat, scaledWidth, scaledHeight, 0, entry->format, entry->type, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, gbuffer_getFramebuffer(gbuffer, type));
+    glFramebufferTexture2D(GL_FRAMEBUFFER, gbuffer_getAttachment(type), GL_TEXTURE_2D, gbuffer->defaultTextures[type], 0);
 }
 
 /**
- * @brief Erstellt ein Framebuffer-Objekt für ein Punktlicht.
+ * @brief Sortiert die Ausgaben des Geometry-Pass nach ihrer Location ein. Ausgaben ohne Textur werden
+ * mit GL_NONE verworfen, am Ende stehende entfallen ganz.
  *
  * @param gbuffer Der GBuffer.
- * @param index Der Index des Punktlichts.
- * @param depthMapSize Die Größe der Depth Map.
  */
-static void gbuffer_createPointLightFBO(GBuffer* gbuffer, const int index, const int depthMapSize)
+static void gbuffer_updateDrawBuffers(GBuffer *gbuffer)
 {
-    glGenFramebuffers(1, &gbuffer->pointLightFBOs[index]);
-    glBindFramebuffer(GL_FRAMEBUFFER, gbuffer->pointLightFBOs[index]);
-    common_labelObjectByType(GL_FRAMEBUFFER, gbuffer->pointLightFBOs[index], "Point Light FBO " + index);
+    gbuffer->drawBufferCount = 0;
+    for (int i = 0; i < DEFAULT_GBUFFER_NUM_COLORATTACH; ++i) {
+        gbuffer->drawBuffers[i] = GL_NONE;
+    }
 
-    {
-        glGenTextures(1, &gbuffer->pointLightDepthMaps[index]);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, gbuffer->pointLightDepthMaps[index]);
-        for (int i = 0; i < 6; ++i) {
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_DEPTH_COMPONENT, depthMapSize, depthMapSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    for (int i = 0; i < DEFAULT_GBUFFER_NUM_COLORATTACH; ++i) {
+        const GBufferLayoutEntry *entry = &GBUFFER_LAYOUT[i];
+        if (entry->location >= 0 && gbuffer->defaultTextures[i] != 0) {
+            gbuffer->drawBuffers[entry->location] = GL_COLOR_ATTACHMENT0 + i;
+            gbuffer->drawBufferCount = utils_maxInt(gbuffer->drawBufferCount, entry->location + 1);
         }
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
     }
-
-    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, gbuffer->pointLightDepthMaps[index], 0);
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 //////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
 
-GBuffer *gbuffer_createGBuffer(const int width, const int height, const int shadowSize) {
+GBuffer *gbuffer_createGBuffer(const int width, const int height, const int shadowSize, const int shadowLayers) {
     // Wie immer muss zuerst der Speicher für den GBuffer angefordert werden.
     GBuffer *gbuffer = malloc(sizeof(GBuffer));
     memset(gbuffer, 0, sizeof(GBuffer));
 
     gbuffer->shadowSize = shadowSize;
+    gbuffer->shadowLayers = shadowLayers;
+    gbuffer->width = width;
+    gbuffer->height = height;
 
     // Dann erstellen wir unser FBO (Framebuffer Object) und binden es direkt.
     glGenFramebuffers(1, &gbuffer->defaultFBO);
-    glGenFramebuffers(1, &gbuffer->blurFBO);
+    glGenFramebuffers(1, &gbuffer->depthCopyFBO);
     glGenFramebuffers(1, &gbuffer->dirLightShadowFBO);
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, gbuffer->defaultFBO);
+        // Die lesbare Tiefe hat kein Color Attachment.
+        glBindFramebuffer(GL_FRAMEBUFFER, gbuffer->depthCopyFBO);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
 
-        // Position
-        glGenTextures(1, &gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_POSITION]);
-        glBindTexture(GL_TEXTURE_2D, gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_POSITION]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_POSITION, GL_TEXTURE_2D, gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_POSITION], 0);
-
-        // Normal
-        glGenTextures(1, &gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_NORMAL]);
-        glBindTexture(GL_TEXTURE_2D, gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_NORMAL]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_NORMAL, GL_TEXTURE_2D, gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_NORMAL], 0);
-
-        // Albedo Specular (metalness)
-        glGenTextures(1, &gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC]);
-        glBindTexture(GL_TEXTURE_2D, gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC, GL_TEXTURE_2D, gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC], 0);
-
-        // Ambient Shininess
-        glGenTextures(1, &gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_AMBIENTSHI]);
-        glBindTexture(GL_TEXTURE_2D, gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_AMBIENTSHI]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_AMBIENTSHI, GL_TEXTURE_2D, gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_AMBIENTSHI], 0);
-
-        // Emission
-        glGenTextures(1, &gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_EMISSION]);
-        glBindTexture(GL_TEXTURE_2D, gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_EMISSION]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_EMISSION, GL_TEXTURE_2D, gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_EMISSION], 0);
-
-        // Finales Ausgabebild
-        glGenTextures(1, &gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_FINAL]);
-        glBindTexture(GL_TEXTURE_2D, gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_FINAL]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_FINAL, GL_TEXTURE_2D, gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_FINAL], 0);
-    }
+        // Die Texturen der Standard-Pässe werden nach der Layout-Tabelle
+        // angelegt und die Ausgaben des Geometry-Pass nach ihrer Location
+        // einsortiert.
+        gbuffer->activePasses = GBUFFER_PASSES_DEFAULT;
+        for (int i = 0; i < DEFAULT_GBUFFER_NUM_COLORATTACH; ++i) {
+            if (GBUFFER_LAYOUT[i].passes & gbuffer->activePasses) {
+                gbuffer_createTexture(gbuffer, i);
+            }
+        }
+        gbuffer_updateDrawBuffers(gbuffer);
 
-    {
+        // Geometry- und Licht-Pässe testen gegen einen eigenen Tiefen- und
+        // Stencil-Puffer. Die Licht-Pässe lesen nur dessen Kopie, sonst
+        // würden sie eine Textur lesen, die zugleich am gebundenen FBO hängt.
         glBindFramebuffer(GL_FRAMEBUFFER, gbuffer->defaultFBO);
-
-        // Textur für Depth & Stencil Buffer
-        glGenRenderbuffers(1, &gbuffer->depthTexture);
-        glBindRenderbuffer(GL_RENDERBUFFER, gbuffer->depthTexture);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH32F_STENCIL8, width, height);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, gbuffer->depthTexture);
-    }
-
-    {
-        glBindFramebuffer(GL_FRAMEBUFFER, gbuffer->blurFBO);
-
-        // Blur Horizontal
-        glGenTextures(1, &gbuffer->blurTextures[BLUR_GBUFFER_COLORATTACH_BLUR_H]);
-        glBindTexture(GL_TEXTURE_2D, gbuffer->blurTextures[BLUR_GBUFFER_COLORATTACH_BLUR_H]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + BLUR_GBUFFER_COLORATTACH_BLUR_H, GL_TEXTURE_2D, gbuffer->blurTextures[BLUR_GBUFFER_COLORATTACH_BLUR_H], 0);
-
-        // Blur Vertical
-        glGenTextures(1, &gbuffer->blurTextures[BLUR_GBUFFER_COLORATTACH_BLUR_V]);
-        glBindTexture(GL_TEXTURE_2D, gbuffer->blurTextures[BLUR_GBUFFER_COLORATTACH_BLUR_V]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + BLUR_GBUFFER_COLORATTACH_BLUR_V, GL_TEXTURE_2D, gbuffer->blurTextures[BLUR_GBUFFER_COLORATTACH_BLUR_V], 0);
+        glGenRenderbuffers(1, &gbuffer->depthStencilBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, gbuffer->depthStencilBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GBUFFER_LAYOUT[DEFAULT_GBUFFER_DEPTH].internalFormat, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, gbuffer->depthStencilBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
     }
 
     {
@@ -223,15 +243,17 @@ GBuffer *gbuffer_createGBuffer(const int width, const int height, const int shad
         static const GLfloat borders[] = { 1.f, 1.f, 1.f, 1.f };
 
         glGenTextures(1, &gbuffer->dirLightDepthMap);
-        glBindTexture(GL_TEXTURE_2D, gbuffer->dirLightDepthMap);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, gbuffer->shadowSize, gbuffer->shadowSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borders);
-
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, gbuffer->dirLightDepthMap, 0);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, gbuffer->dirLightDepthMap);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT, gbuffer->shadowSize, gbuffer->shadowSize, gbuffer->shadowLayers, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borders);
+
+        // Die Schichten werden erst beim Rendern der einzelnen Kaskaden
+        // angehängt, zum Prüfen des FBOs reicht die erste.
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, gbuffer->dirLightDepthMap, 0, 0);
         glDrawBuffer(GL_NONE);
         glReadBuffer(GL_NONE);
     }
@@ -268,7 +290,7 @@ GBuffer *gbuffer_createGBuffer(const int width, const int height, const int shad
     }
 
     common_labelObjectByType(GL_FRAMEBUFFER, gbuffer->defaultFBO, "Default FBO");
-    common_labelObjectByType(GL_FRAMEBUFFER, gbuffer->blurFBO, "Blur FBO");
+    common_labelObjectByType(GL_FRAMEBUFFER, gbuffer->depthCopyFBO, "Depth Copy FBO");
     common_labelObjectByType(GL_FRAMEBUFFER, gbuffer->dirLightShadowFBO, "Directional Light FBO");
 
     // Zum Schluss wechseln wir zurück zum Standard FBO und
@@ -281,38 +303,59 @@ GLuint gbuffer_getDefaultTexture(GBuffer* gbuffer, DEFAULT_GBUFFER_TEXTURE_TYPE
     return gbuffer->defaultTextures[type];
 }
 
-GLuint gbuffer_getBlurTexture(GBuffer* gbuffer, BLUR_GBUFFER_TEXTURE_TYPE type) {
-    return gbuffer->blurTextures[type];
+void gbuffer_setActivePasses(GBuffer* gbuffer, const int passes) {
+    if (passes == gbuffer->activePasses) {
+        return;
+    }
+    gbuffer->activePasses = passes;
+
+    for (int i = 0; i < DEFAULT_GBUFFER_NUM_COLORATTACH; ++i) {
+        const bool needed = (GBUFFER_LAYOUT[i].passes & passes) != 0;
+        if (needed && gbuffer->defaultTextures[i] == 0) {
+            gbuffer_createTexture(gbuffer, i);
+        } else if (!needed && gbuffer->defaultTextures[i] != 0) {
+            glBindFramebuffer(GL_FRAMEBUFFER, gbuffer_getFramebuffer(gbuffer, i));
+            glFramebufferTexture2D(GL_FRAMEBUFFER, gbuffer_getAttachment(i), GL_TEXTURE_2D, 0, 0);
+            glDeleteTextures(1, &gbuffer->defaultTextures[i]);
+            gbuffer->defaultTextures[i] = 0;
+        }
+    }
+    gbuffer_updateDrawBuffers(gbuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-GLuint gbuffer_getDirLightShadowMap(GBuffer* gbuffer) {
-    return gbuffer->dirLightDepthMap;
-}
+void gbuffer_getBandwidth(const GBuffer* gbuffer, GBufferBandwidth* bandwidth) {
+    bandwidth->geometryBytes = 0.0f;
+    bandwidth->lightBytes = 0.0f;
+
+    for (int i = 0; i < DEFAULT_GBUFFER_NUM_COLORATTACH; ++i) {
+        const GBufferLayoutEntry *entry = &GBUFFER_LAYOUT[i];
+        const float bytes = (float) entry->bytesPerPixel * entry->scale * entry->scale;
 
-GLuint gbuffer_getPointLightShadowMap(GBuffer* gbuffer, const int index) {
-    if (index < 0 || index >= gbuffer->allocatedPointLightFBOs) {
-        fprintf(stderr, "Zugriff auf nicht vorhandene Punktlicht Schatten Textur");
+        if (entry->location >= 0 && gbuffer->defaultTextures[i] != 0) {
+            bandwidth->geometryBytes += bytes;
+        }
+        if (entry->passes & GBUFFER_PASS_LIGHT) {
+            bandwidth->lightBytes += bytes;
+        }
     }
 
-    return gbuffer->pointLightDepthMaps[index];
+    bandwidth->width = gbuffer->width;
+    bandwidth->height = gbuffer->height;
 }
 
-void gbuffer_clearDefaultTexture(GBuffer *gbuffer, DEFAULT_GBUFFER_TEXTURE_TYPE textureType)
-{
-    // GBuffer FBO binden und den entsprechenden Color-Buffer leeren
-    glBindFramebuffer(GL_FRAMEBUFFER, gbuffer->defaultFBO);
-    glDrawBuffer(GL_COLOR_ATTACHMENT0 + textureType);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glad_glBindFramebuffer(GL_FRAMEBUFFER, 0);
+GLuint gbuffer_getDirLightShadowMap(GBuffer* gbuffer) {
+    return gbuffer->dirLightDepthMap;
 }
 
-void gbuffer_clearBlurTexture(GBuffer *gbuffer, BLUR_GBUFFER_TEXTURE_TYPE textureType)
-{
-    // GBuffer FBO binden und den entsprechenden Color-Buffer leeren
-    glBindFramebuffer(GL_FRAMEBUFFER, gbuffer->blurFBO);
-    glDrawBuffer(GL_COLOR_ATTACHMENT0 + textureType);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glad_glBindFramebuffer(GL_FRAMEBUFFER, 0);
+void gbuffer_bindTexturesForPass(GBuffer* gbuffer, Shader* shader, const GBufferPass pass) {
+    for (int i = 0; i < DEFAULT_GBUFFER_NUM_COLORATTACH; ++i) {
+        if ((GBUFFER_LAYOUT[i].passes & pass) && gbuffer->defaultTextures[i] != 0) {
+            glActiveTexture(GL_TEXTURE0 + i);
+            glBindTexture(GL_TEXTURE_2D, gbuffer->defaultTextures[i]);
+            shader_setInt(shader, (char *) GBUFFER_LAYOUT[i].name, i);
+        }
+    }
 }
 
 void gbuffer_bindGBufferForGeomPass(GBuffer *gbuffer)
@@ -320,19 +363,34 @@ void gbuffer_bindGBufferForGeomPass(GBuffer *gbuffer)
     // GBuffer FBO binden
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gbuffer->defaultFBO);
 
-    // Die zu verwendenden Attribute konfigurieren.
-    GLenum drawBuffer[] = {
-            GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_POSITION, // location 0
-            GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_NORMAL,
-            GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC,
-            GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_AMBIENTSHI,
-            GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_EMISSION,
-    };
-
-    // Danach übergeben wir das Array mit den Color-Attachments.
+    // Danach übergeben wir das beim Anlegen aus der Layout-Tabelle erstellte
+    // Array mit den Color-Attachments.
     // ACHTUNG: Die Reihenfolge im Array gibt die Positionen im Shader an.
-    glDrawBuffers(sizeof(drawBuffer) / sizeof(drawBuffer[0]), drawBuffer);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glDrawBuffers(gbuffer->drawBufferCount, gbuffer->drawBuffers);
+
+    // Die Albedo liegt als sRGB vor, die Umrechnung übernimmt die Hardware
+    // beim Schreiben und beim Lesen.
+    glEnable(GL_FRAMEBUFFER_SRGB);
+
+    // Jede Ausgabe und die Tiefe mit ihrem eigenen Wert leeren.
+    for (int i = 0; i < DEFAULT_GBUFFER_NUM_COLORATTACH; ++i) {
+        const GBufferLayoutEntry *entry = &GBUFFER_LAYOUT[i];
+        if (entry->location >= 0 && gbuffer->defaultTextures[i] != 0) {
+            glClearBufferfv(GL_COLOR, entry->location, entry->clearValue);
+        } else if (gbuffer_getAttachment(i) == GL_DEPTH_STENCIL_ATTACHMENT) {
+            glClearBufferfi(GL_DEPTH_STENCIL, 0, entry->clearValue[0], (GLint) entry->clearValue[1]);
+        }
+    }
+}
+
+void gbuffer_copyDepth(GBuffer *gbuffer, const int width, const int height)
+{
+    // Beide Puffer haben dasselbe Format, nur dann darf die Tiefe kopiert
+    // werden. Der Stencil wird erst in den Licht-Pässen geschrieben.
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, gbuffer->defaultFBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gbuffer->depthCopyFBO);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, gbuffer->defaultFBO);
 }
 
 void gbuffer_bindGBufferForStencilPass(GBuffer *gbuffer)
@@ -347,45 +405,13 @@ void gbuffer_bindGBufferForLightPass(GBuffer *gbuffer)
     // GBuffer FBO binden und das finale Render-Ausgabebild als DrawBuffer setzen
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gbuffer->defaultFBO);
     glDrawBuffer(GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_FINAL);
+    glDisable(GL_FRAMEBUFFER_SRGB);
 }
 
-void gbuffer_bindGBufferForThreshold(GBuffer *gbuffer)
-{
-    // GBuffer FBO binden und den Threshold-Pass konfigurieren
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gbuffer->blurFBO);
-    glDrawBuffer(GL_COLOR_ATTACHMENT0 + BLUR_GBUFFER_COLORATTACH_BLUR_H);
-}
-
-void gbuffer_bindGBufferForBlur(GBuffer *gbuffer, bool isHorizontal)
-{
-    // GBuffer FBO binden und den Blur-Pass konfigurieren
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gbuffer->blurFBO);
-    glDrawBuffer(GL_COLOR_ATTACHMENT0 + (isHorizontal ? BLUR_GBUFFER_COLORATTACH_BLUR_H : BLUR_GBUFFER_COLORATTACH_BLUR_V));
-}
-
-void gbuffer_bindGBufferForFog(GBuffer *gbuffer)
-{
-    // GBuffer FBO binden und den Fog-Pass konfigurieren
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gbuffer->defaultFBO);
-    glDrawBuffer(GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_FINAL);
-}
-
-void gbuffer_bindGBufferForPostprocess(GBuffer *gbuffer)
-{
-    // GBuffer FBO binden und den Fog-Pass konfigurieren
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gbuffer->defaultFBO);
-    glDrawBuffer(GL_COLOR_ATTACHMENT0 + DEFAULT_GBUFFER_COLORATTACH_FINAL);
-}
-
-void gbuffer_bindGBufferForDirLightShadows(GBuffer *gbuffer)
+void gbuffer_bindGBufferForDirLightShadows(GBuffer *gbuffer, int layer)
 {
     glBindFramebuffer(GL_FRAMEBUFFER, gbuffer->dirLightShadowFBO);
-    glClear(GL_DEPTH_BUFFER_BIT);
-}
-
-void gbuffer_bindGBufferForPointLightShadow(GBuffer *gbuffer, const int index)
-{
-    glBindFramebuffer(GL_FRAMEBUFFER, gbuffer->pointLightFBOs[index]);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, gbuffer->dirLightDepthMap, 0, layer);
     glClear(GL_DEPTH_BUFFER_BIT);
 }
 
@@ -400,40 +426,18 @@ void gbuffer_bindForRead(GBuffer* gBuffer) {
     glBindFramebuffer(GL_READ_FRAMEBUFFER, gBuffer->defaultFBO);
 }
 
-void gbuffer_initializePointLightFBOs(GBuffer* gbuffer, const int count, const int depthMapSize)
-{
-    // Speicher reservieren
-    gbuffer_mallocPointLightFBOArray(gbuffer, count);
-
-    // Punktlicht-FBOs erstellen
-    for (int i = 0; i < count; ++i) {
-        gbuffer_createPointLightFBO(gbuffer, i, depthMapSize);
-    }
-}
-
 void gbuffer_deleteGBuffer(GBuffer *gbuffer)
 {
     // FBO löschen.
     glDeleteFramebuffers(1, &gbuffer->defaultFBO);
-    glDeleteFramebuffers(1, &gbuffer->blurFBO);
+    glDeleteFramebuffers(1, &gbuffer->depthCopyFBO);
     glDeleteFramebuffers(1, &gbuffer->dirLightShadowFBO);
+    glDeleteRenderbuffers(1, &gbuffer->depthStencilBuffer);
 
     // Die angehängten Texturen löschen.
-    glDeleteTextures(1, &gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_POSITION]);
-    glDeleteTextures(1, &gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_NORMAL]);
-    glDeleteTextures(1, &gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC]);
-    glDeleteTextures(1, &gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_AMBIENTSHI]);
-    glDeleteTextures(1, &gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_EMISSION]);
-    glDeleteTextures(1, &gbuffer->defaultTextures[DEFAULT_GBUFFER_COLORATTACH_FINAL]);
-
-    glDeleteTextures(1, &gbuffer->blurTextures[BLUR_GBUFFER_COLORATTACH_BLUR_H]);
-    glDeleteTextures(1, &gbuffer->blurTextures[BLUR_GBUFFER_COLORATTACH_BLUR_V]);
+    glDeleteTextures(DEFAULT_GBUFFER_NUM_COLORATTACH, gbuffer->defaultTextures);
 
     glDeleteTextures(1, &gbuffer->dirLightDepthMap);
 
-    glDeleteRenderbuffers(1, &gbuffer->depthTexture);
-
-    cleanupPointLightFBOs(gbuffer);
-
     free(gbuffer);
 }
@@ -9,27 +9,58 @@
 #define GBUFFER_H
 
 #include "common.h"
+#include "shader.h"
 
 //////////////////////////// ÖFFENTLICHE DATENTYPEN ////////////////////////////
 
-// Aufzählungstyp für die unterschiedlichen Color Attachments des GBuffers.
+// Aufzählungstyp für die unterschiedlichen Texturen des GBuffers. Der Index
+// verweist in die Layout-Tabelle in gbuffer.c, in der Format, Auflösung,
+// Clear-Wert und lesende Pässe jeder Textur festgelegt sind. Er ist zugleich
+// das Color Attachment und die Textur-Einheit beim Lesen. Die Tiefe ist kein
+// Color Attachment, belegt aber die erste Textur-Einheit, da die Positionen
+// aus ihr rekonstruiert werden. Sie ist eine Kopie des Tiefenpuffers, gegen
+// den Geometry- und Licht-Pässe testen (siehe gbuffer_copyDepth).
 typedef enum DEFAULT_GBUFFER_TEXTURE_TYPE {
-    DEFAULT_GBUFFER_COLORATTACH_POSITION,
+    DEFAULT_GBUFFER_DEPTH,
     DEFAULT_GBUFFER_COLORATTACH_NORMAL,
     DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC,
     DEFAULT_GBUFFER_COLORATTACH_EMISSION,
-    DEFAULT_GBUFFER_COLORATTACH_AMBIENTSHI,
+    DEFAULT_GBUFFER_COLORATTACH_MATERIAL,
+    DEFAULT_GBUFFER_COLORATTACH_VELOCITY,
     DEFAULT_GBUFFER_COLORATTACH_FINAL,
 
     DEFAULT_GBUFFER_NUM_COLORATTACH
 } DEFAULT_GBUFFER_TEXTURE_TYPE;
 
-typedef enum BLUR_GBUFFER_TEXTURE_TYPE {
-    BLUR_GBUFFER_COLORATTACH_BLUR_V,
-    BLUR_GBUFFER_COLORATTACH_BLUR_H,
-
-    BLUR_GBUFFER_NUM_COLORATTACH
-} BLUR_GBUFFER_TEXTURE_TYPE;
+// Pässe, die Texturen des GBuffers lesen. Die Layout-Tabelle gibt pro Textur
+// eine Bitmaske dieser Werte an.
+typedef enum GBufferPass {
+    GBUFFER_PASS_LIGHT       = 1 << 0, // alle Beleuchtungs-Pässe
+    GBUFFER_PASS_BLOOM       = 1 << 1, // erste Stufe des Bloom-Downsamplings
+    GBUFFER_PASS_DOF         = 1 << 2,
+    GBUFFER_PASS_POSTPROCESS = 1 << 3, // zusammengefasste Nachbearbeitung
+    GBUFFER_PASS_TEMPORAL    = 1 << 4  // temporale Rekonstruktion
+} GBufferPass;
+
+// Pässe, die in jedem Frame laufen können. Texturen, die nur andere Pässe
+// lesen, werden erst angelegt und geschrieben, wenn diese aktiv sind (siehe
+// gbuffer_setActivePasses).
+#define GBUFFER_PASSES_DEFAULT \
+    (GBUFFER_PASS_LIGHT | GBUFFER_PASS_BLOOM | GBUFFER_PASS_DOF | GBUFFER_PASS_POSTPROCESS)
+
+// Bytes pro Pixel des ursprünglichen Layouts mit Position, Normale, Albedo,
+// Ambient und Emission in Gleitkommaformaten, zum Vergleich der Bandbreite
+#define GBUFFER_LEGACY_GEOMETRY_BYTES 34
+#define GBUFFER_LEGACY_LIGHT_BYTES 34
+
+// Speicherbedarf des GBuffers pro Bildschirmpixel. Texturen mit verringerter
+// Auflösung gehen anteilig ein.
+typedef struct {
+    float geometryBytes; // im Geometry-Pass geschriebene Bytes (ohne Tiefe)
+    float lightBytes;    // von einem Beleuchtungs-Pass gelesene Bytes
+    int width;           // Breite des Bildschirms
+    int height;          // Höhe des Bildschirms
+} GBufferBandwidth;
 
 // GBuffer Datentyp.
 struct GBuffer;
@@ -43,31 +74,24 @@ typedef struct GBuffer GBuffer;
  * @param width die Breite des Buffers
  * @param height die Höhe des Buffers
  * @param shadowSize Schatten Textur Auflösung
+ * @param shadowLayers Anzahl der Schichten der Richtungslicht-Schatten
  * @return der neue GBuffer
  */
-GBuffer *gbuffer_createGBuffer(int width, int height, int shadowSize);
+GBuffer *gbuffer_createGBuffer(int width, int height, int shadowSize, int shadowLayers);
 
 /**
  * Gibt die Textur des angegebenen Typs zurück.
  *
  * @param gbuffer der GBuffer
  * @param type der Typ der Textur
- * @return die Textur-ID
+ * @return die Textur-ID oder 0, wenn kein aktiver Pass sie liest
  */
 GLuint gbuffer_getDefaultTexture(GBuffer* gbuffer, DEFAULT_GBUFFER_TEXTURE_TYPE type);
 
 
 /**
- * Gibt die Textur des angegebenen Typs zurück.
- *
- * @param gbuffer der GBuffer
- * @param type der Typ der Textur
- * @return die Textur-ID
- */
-GLuint gbuffer_getBlurTexture(GBuffer* gbuffer, BLUR_GBUFFER_TEXTURE_TYPE type);
-
-/**
- * @brief Gibt die Depth Map für das Richtungslicht zurück.
+ * @brief Gibt die Depth Map für das Richtungslicht zurück. Sie ist ein
+ * GL_TEXTURE_2D_ARRAY mit einer Schicht pro Kaskade.
  *
  * @param gbuffer Der GBuffer.
  * @return Die Textur-ID der Depth Map.
@@ -75,99 +99,84 @@ GLuint gbuffer_getBlurTexture(GBuffer* gbuffer, BLUR_GBUFFER_TEXTURE_TYPE type);
 GLuint gbuffer_getDirLightShadowMap(GBuffer* gbuffer);
 
 /**
- * @brief Gibt die Depth Map für das Punktlicht zurück.
+ * Legt fest, welche Pässe die Texturen des GBuffers lesen. Texturen, die
+ * keiner dieser Pässe liest, werden freigegeben und vom Geometry-Pass weder
+ * geleert noch geschrieben. Ändert sich nichts, kostet der Aufruf nichts.
  *
- * @param gbuffer Der GBuffer.
- * @param index Der Index des Punktlichts.
- * @return Die Textur-ID der Punktlicht-Depth Map.
+ * @param gbuffer der GBuffer
+ * @param passes Bitmaske aus GBufferPass, anfangs GBUFFER_PASSES_DEFAULT
  */
-GLuint gbuffer_getPointLightShadowMap(GBuffer* gbuffer, int index);
+void gbuffer_setActivePasses(GBuffer* gbuffer, int passes);
 
 /**
- * Bindet das GBuffer FBO, setzt die finale Render Ausgabe als DrawBuffer und
- * cleart den Color-Buffer dieses Attachments.
+ * Liefert die Bytes pro Pixel, die der Geometry-Pass schreibt und jeder
+ * Beleuchtungs-Pass liest. Die Werte werden aus der Layout-Tabelle berechnet.
  *
  * @param gbuffer der GBuffer
+ * @param bandwidth Ausgabeparameter für den Speicherbedarf
  */
-void gbuffer_clearDefaultTexture(GBuffer *gbuffer, DEFAULT_GBUFFER_TEXTURE_TYPE textureType);
+void gbuffer_getBandwidth(const GBuffer* gbuffer, GBufferBandwidth* bandwidth);
 
 /**
- * Bindet das GBuffer FBO, setzt die finale Render Ausgabe als DrawBuffer und
- * cleart den Color-Buffer dieses Attachments.
+ * Bindet alle Texturen, die laut Layout-Tabelle von dem Pass gelesen werden,
+ * an ihre Textur-Einheit und setzt die gleichnamigen Sampler des Shaders.
  *
  * @param gbuffer der GBuffer
+ * @param shader der Shader des Passes, muss bereits aktiv sein
+ * @param pass der Pass, für den gebunden wird
  */
-void gbuffer_clearBlurTexture(GBuffer *gbuffer, BLUR_GBUFFER_TEXTURE_TYPE textureType);
+void gbuffer_bindTexturesForPass(GBuffer* gbuffer, Shader* shader, GBufferPass pass);
 
 /**
  * Bindet das GBuffer FBO und setzt die entsprechenden Color_Attachments für
- * das den Geometry Pass Render Vorgang. Der Farb und Tiefenbuffer wird geleert.
+ * das den Geometry Pass Render Vorgang. Die Attachments und der Tiefenbuffer
+ * werden mit ihren Clear-Werten aus der Layout-Tabelle geleert. Die
+ * sRGB-Kodierung der Albedo wird bis zum Licht-Pass aktiviert.
  *
  * @param gbuffer der GBuffer
  */
 void gbuffer_bindGBufferForGeomPass(GBuffer *gbuffer);
 
 /**
- * Bindet das GBuffer FBO und deaktiviert das schreiben auf einen
- * Draw-Buffer
- *
- * @param gbuffer der GBuffer
- */
-void gbuffer_bindGBufferForStencilPass(GBuffer *gbuffer);
-
-/**
- * Bindet das GBuffer FBO, setzt die finale Render Ausgabe als DrawBuffer und
- * bindet die GBuffer Texturen als Texturen
- *
- * @param gbuffer der GBuffer
- */
-void gbuffer_bindGBufferForLightPass(GBuffer *gbuffer);
-
-/**
- * Bindet das GBuffer FBO für den Threshold-Pass.
+ * Kopiert die Tiefe des Geometry-Pass in die Tiefen-Textur, die die folgenden
+ * Pässe lesen. Die Licht-Pässe testen Tiefe und Stencil weiterhin gegen den
+ * Puffer des GBuffer FBOs und lesen nur die Kopie, so wird keine Textur
+ * zugleich gelesen und als Attachment genutzt. Danach ist das GBuffer FBO
+ * gebunden.
  *
  * @param gbuffer der GBuffer
+ * @param width die Breite des gerenderten Bereichs
+ * @param height die Höhe des gerenderten Bereichs
  */
-void gbuffer_bindGBufferForThreshold(GBuffer *gbuffer);
+void gbuffer_copyDepth(GBuffer *gbuffer, int width, int height);
 
 /**
- * Bindet das GBuffer FBO für den Blur-Pass.
+ * Bindet das GBuffer FBO und deaktiviert das schreiben auf einen
+ * Draw-Buffer
  *
  * @param gbuffer der GBuffer
- * @param isHorizontal gibt an, ob der Blur horizontal ist
  */
-void gbuffer_bindGBufferForBlur(GBuffer *gbuffer, bool isHorizontal);
+void gbuffer_bindGBufferForStencilPass(GBuffer *gbuffer);
 
 /**
- * Bindet das GBuffer FBO für den Fog-Pass.
+ * Bindet das GBuffer FBO, setzt die finale Render Ausgabe als DrawBuffer und
+ * bindet die GBuffer Texturen als Texturen. Die sRGB-Kodierung des Geometry
+ * Pass wird dabei wieder deaktiviert.
  *
  * @param gbuffer der GBuffer
  */
-void gbuffer_bindGBufferForFog(GBuffer *gbuffer);
-
-/**
- * @brief Bindet das GBuffer FBO für die Post-Processing Phase.
- *
- * @param gbuffer Der GBuffer.
- */
-void gbuffer_bindGBufferForPostprocess(GBuffer *gbuffer);
+void gbuffer_bindGBufferForLightPass(GBuffer *gbuffer);
 
 /**
- * @brief Bindet das GBuffer FBO für das Rendering von Richtungslicht-Schatten.
+ * @brief Bindet das GBuffer FBO für das Rendering einer Schicht der
+ * Richtungslicht-Schatten und leert deren Tiefe.
  *
  * @param gbuffer Der GBuffer.
+ * @param layer Die Schicht, also die Kaskade, die gerendert wird.
  */
-void gbuffer_bindGBufferForDirLightShadows(GBuffer *gbuffer);
+void gbuffer_bindGBufferForDirLightShadows(GBuffer *gbuffer, int layer);
 
 
-/**
- * @brief Bindet das GBuffer FBO für das Rendering von Punktlicht-Schatten.
- *
- * @param gbuffer Der GBuffer.
- * @param index Der Index des Punktlichts.
- */
-void gbuffer_bindGBufferForPointLightShadow(GBuffer *gbuffer, int index);
-
 /**
  * Setzt die Textur zum Lesen aus dem Framebuffer
  *
@@ -182,17 +191,6 @@ void gbuffer_bindGBufferForTextureRead(DEFAULT_GBUFFER_TEXTURE_TYPE textureType)
  */
 void gbuffer_bindForRead(GBuffer* gBuffer);
 
-/**
- * @brief Initialisiert die Framebuffer und Tiefentexturen für Punktlichter.
- *
- * Diese Funktion bereinigt bestehende Punktlicht-FBOs, reserviert Speicher
- * für neue FBOs und erstellt die Punktlicht-Framebuffer-Objekte und zugehörigen Tiefentexturen.
- *
- * @param gbuffer Zeiger auf den GBuffer, der die Punktlicht-FBOs verwaltet.
- * @param count Die Anzahl der Punktlichter.
- * @param depthMapSize Die Größe der Tiefentextur für jedes Punktlicht.
- */
-void gbuffer_initializePointLightFBOs(GBuffer* gbuffer, int count, int depthMapSize);
 /**
  * Löscht den übergebenen GBuffer wieder.
  *
@@ -13,6 +13,8 @@
 #include "window.h"
 #include "input.h"
 #include "rendering.h"
+#include "recorder.h"
+#include "profiler.h"
 
 ////////////////////////////////// KONSTANTEN //////////////////////////////////
 
@@ -21,6 +23,8 @@
 
 #define STATS_WIDTH (80)
 #define STATS_HEIGHT (30)
+#define STATS_WIDE_WIDTH (240)
+#define STATS_LINE_HEIGHT (25)
 
 #define MIN_VAL (-1000.0f)
 #define MAX_VAL (1000.0f)
@@ -35,6 +39,23 @@ static const char *renderModeNames[RENDER_MODE_COUNT] = {
     "Debug"
 };
 
+static const char *lightingModeNames[LIGHTING_MODE_COUNT] = {
+    "Pro Licht",
+    "Gekachelt",
+    "Geclustert",
+    "Ein Pass"
+};
+
+static const char *upscalingModeNames[UPSCALING_MODE_COUNT] = {
+    "Bilinear",
+    "Temporal"
+};
+
+static const char *recorderFormatNames[RECORDER_FORMAT_COUNT] = {
+    "PNG",
+    "Raw (PPM)"
+};
+
 ////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
 
 // Datentyp für die GUI Daten
@@ -226,6 +247,7 @@ static void gui_renderHelp(ProgContext *ctx, struct nk_context *nk) {
             HELP_LINE("Menü umschalten", "F4");
             HELP_LINE("Statistiken umschalten", "F5");
             HELP_LINE("Screenshot anfertigen", "F6");
+            HELP_LINE("Aufnahme starten/stoppen", "F7");
             HELP_LINE("Kamera vorwärst", "W");
             HELP_LINE("Kamera links", "A");
             HELP_LINE("Kamera zurück", "S");
@@ -295,9 +317,7 @@ static void gui_renderMenu(ProgContext *ctx, struct nk_context *nk) {
                 nk_layout_row_dynamic(nk, 30, 2);
                 // Shader Neukompilierung
                 if (nk_button_label(nk, "Shader aktual.")) {
-                    if (!rendering_recompileShader(ctx)) {
-                        fprintf(stderr, "Shader recompilation failed!\n");
-                    }
+                    rendering_recompileShader(ctx);
                 }
 
                 // Beenden
@@ -308,6 +328,51 @@ static void gui_renderMenu(ProgContext *ctx, struct nk_context *nk) {
                 nk_tree_pop(nk);
             }
 
+            // Einstellungen für die Aufnahme von Bildsequenzen.
+            if (nk_tree_push(nk, NK_TREE_TAB, "Aufnahme", NK_MINIMIZED)) {
+                bool recording = recorder_isRecording();
+
+                // Die Optionen können nur ohne laufende Aufnahme verändert werden.
+                if (!recording) {
+                    nk_layout_row_dynamic(nk, 25, 2);
+                    nk_label(nk, "Format", NK_TEXT_LEFT);
+                    if (nk_combo_begin_label(nk, recorderFormatNames[input->recording.format],
+                                             nk_vec2(nk_widget_width(nk), 200))) {
+                        nk_layout_row_dynamic(nk, 25, 1);
+                        for (int i = 0; i < RECORDER_FORMAT_COUNT; ++i) {
+                            if (nk_combo_item_label(nk, recorderFormatNames[i], NK_TEXT_LEFT)) {
+                                input->recording.format = i;
+                            }
+                        }
+                        nk_combo_end(nk);
+                    }
+
+                    nk_layout_row_dynamic(nk, 25, 1);
+                    nk_bool waitWhenFull = input->recording.waitWhenFull;
+                    if (nk_checkbox_label(nk, "Warten statt verwerfen", &waitWhenFull)) {
+                        input->recording.waitWhenFull = waitWhenFull;
+                    }
+
+                    // Ergebnis der letzten Aufnahme, während einer Aufnahme
+                    // stehen die Zahlen im Statistik-Fenster.
+                    RecorderStats recStats;
+                    recorder_getStats(&recStats);
+                    if (recStats.captured > 0) {
+                        char line[64];
+                        snprintf(line, sizeof(line), "Letzte: %d geschrieben, %d verworfen",
+                                 recStats.encoded, recStats.dropped);
+                        nk_label(nk, line, NK_TEXT_LEFT);
+                    }
+                }
+
+                nk_layout_row_dynamic(nk, 30, 1);
+                if (nk_button_label(nk, recording ? "Aufnahme stoppen" : "Aufnahme starten")) {
+                    input_toggleRecording(ctx);
+                }
+
+                nk_tree_pop(nk);
+            }
+
             // Einstellungen bezüglich der Darstellung.
             if (nk_tree_push(nk, NK_TREE_TAB, "Darstellung", NK_MINIMIZED)) {
                 // Anzeigemodus
@@ -379,6 +444,45 @@ static void gui_renderMenu(ProgContext *ctx, struct nk_context *nk) {
                     }
                     gui_display_float(nk, clipping, 2);
 
+                    // Dynamische Auflösung und ihr Budget an GPU-Zeit
+                    nk_layout_row_dynamic(nk, 25, 1);
+                    nk_bool dynamicResolution = rendering_getUseDynamicResolution(ctx);
+                    if (nk_checkbox_label(nk, "Dynamische Auflösung", &dynamicResolution)) {
+                        rendering_setUseDynamicResolution(ctx, dynamicResolution);
+                    }
+
+                    if (dynamicResolution) {
+                        nk_layout_row_dynamic(nk, 25, 3);
+                        nk_label(nk, "Budget (ms)", NK_TEXT_LEFT);
+                        float budget = rendering_getFrameBudget(ctx);
+                        if (nk_slider_float(nk, 2.0f, &budget, 33.3f, 0.1f)) {
+                            rendering_setFrameBudget(ctx, budget);
+                        }
+                        gui_display_float(nk, budget, 1);
+                    } else {
+                        nk_layout_row_dynamic(nk, 25, 3);
+                        nk_label(nk, "Auflösung", NK_TEXT_LEFT);
+                        float renderScale = rendering_getRenderScale(ctx);
+                        if (nk_slider_float(nk, DYNAMIC_RESOLUTION_MIN_SCALE, &renderScale,
+                                            DYNAMIC_RESOLUTION_MAX_SCALE, 0.01f)) {
+                            rendering_setRenderScale(ctx, renderScale);
+                        }
+                        gui_display_float(nk, renderScale, 2);
+                    }
+
+                    // Verfahren, mit dem auf die Größe des Fensters hochskaliert wird
+                    nk_layout_row_dynamic(nk, 25, 1);
+                    int upscalingMode = rendering_getUpscalingMode(ctx);
+                    if (nk_combo_begin_label(nk, upscalingModeNames[upscalingMode], nk_vec2(nk_widget_width(nk), 200))) {
+                        nk_layout_row_dynamic(nk, 25, 1);
+                        for (int i = 0; i < UPSCALING_MODE_COUNT; ++i) {
+                            if (nk_combo_item_label(nk, upscalingModeNames[i], NK_TEXT_LEFT)) {
+                                rendering_setUpscalingMode(ctx, i);
+                            }
+                        }
+                        nk_combo_end(nk);
+                    }
+
                     gui_widgetColor(nk, "Clear Color", ctx->input->rendering.clearColor);
                     nk_layout_row_static(nk, 10, 150, 1);
 
@@ -481,6 +585,19 @@ static void gui_renderMenu(ProgContext *ctx, struct nk_context *nk) {
                         rendering_setUsePCF(ctx, usePCF);
                     }
 
+                    // Verfahren für die Punktlichter
+                    nk_layout_row_dynamic(nk, 25, 1);
+                    int lightingMode = rendering_getLightingMode(ctx);
+                    if (nk_combo_begin_label(nk, lightingModeNames[lightingMode], nk_vec2(nk_widget_width(nk), 200))) {
+                        nk_layout_row_dynamic(nk, 25, 1);
+                        for (int i = 0; i < LIGHTING_MODE_COUNT; ++i) {
+                            if (nk_combo_item_label(nk, lightingModeNames[i], NK_TEXT_LEFT)) {
+                                rendering_setLightingMode(ctx, i);
+                            }
+                        }
+                        nk_combo_end(nk);
+                    }
+
                     if (nk_tree_push(nk, NK_TREE_TAB, "Richtungslicht", NK_MAXIMIZED)) {
                         nk_layout_row_dynamic(nk, 25, 1);
                         nk_bool isDirLightActive = rendering_getIsDirLightActive(ctx);
@@ -489,48 +606,29 @@ static void gui_renderMenu(ProgContext *ctx, struct nk_context *nk) {
                         }
 
                         if (isDirLightActive) {
-                            nk_layout_row_dynamic(nk, 25, 1);
-                            if (nk_button_label(nk, "Schatten aktual.")) {
-                                rendering_setShouldUpdateDirShadows(ctx);
-                            }
-
-                            nk_layout_row_dynamic(nk, 25, 1);
-                            nk_bool alwaysUpdateShadows = rendering_getAlwaysUpdateDirShadows(ctx);
-                            if (nk_checkbox_label(nk, "Schatten immer aktual.", &alwaysUpdateShadows)) {
-                                rendering_setAlwaysUpdateDirShadows(ctx, alwaysUpdateShadows);
-                            }
-
-                            nk_layout_row_dynamic(nk, 25, 3);
-                            nk_label(nk, "Distanz Faktor", NK_TEXT_LEFT);
-                            float dist = rendering_getDirLightDistanceMult(ctx);
-                            if (nk_slider_float(nk, 0.0f, &dist, 40.0f, 0.5f)) {
-                                rendering_setDirLightDistanceMult(ctx, dist);
-                            }
-                            gui_display_float(nk, dist, 2);
-
                             nk_layout_row_dynamic(nk, 25, 3);
-                            nk_label(nk, "zNear", NK_TEXT_LEFT);
-                            float znear = rendering_getZNear(ctx);
-                            if (nk_slider_float(nk, 0.0f, &znear, 15.0f, 0.05f)) {
-                                rendering_setZNear(ctx, znear);
+                            nk_label(nk, "Kaskaden", NK_TEXT_LEFT);
+                            int cascades = rendering_getCascadeCount(ctx);
+                            if (nk_slider_int(nk, DIR_SHADOW_MIN_CASCADES, &cascades, DIR_SHADOW_MAX_CASCADES, 1)) {
+                                rendering_setCascadeCount(ctx, cascades);
                             }
-                            gui_display_float(nk, znear, 2);
+                            gui_display_float(nk, (float) cascades, 0);
 
                             nk_layout_row_dynamic(nk, 25, 3);
-                            nk_label(nk, "zFar", NK_TEXT_LEFT);
-                            float zfar = rendering_getZFar(ctx);
-                            if (nk_slider_float(nk, 1.0f, &zfar, 300.0f, 1.f)) {
-                                rendering_setZFar(ctx, zfar);
+                            nk_label(nk, "Log. Aufteilung", NK_TEXT_LEFT);
+                            float lambda = rendering_getCascadeSplitLambda(ctx);
+                            if (nk_slider_float(nk, 0.0f, &lambda, 1.0f, 0.05f)) {
+                                rendering_setCascadeSplitLambda(ctx, lambda);
                             }
-                            gui_display_float(nk, zfar, 2);
+                            gui_display_float(nk, lambda, 2);
 
                             nk_layout_row_dynamic(nk, 25, 3);
-                            nk_label(nk, "quadSize", NK_TEXT_LEFT);
-                            float quadSize = rendering_getQuadSize(ctx);
-                            if (nk_slider_float(nk, 0.0f, &quadSize, 100.0f, 0.5f)) {
-                                rendering_setQuadSize(ctx, quadSize);
+                            nk_label(nk, "Reichweite", NK_TEXT_LEFT);
+                            float distance = rendering_getShadowDistance(ctx);
+                            if (nk_slider_float(nk, 10.0f, &distance, 200.0f, 1.0f)) {
+                                rendering_setShadowDistance(ctx, distance);
                             }
-                            gui_display_float(nk, quadSize, 2);
+                            gui_display_float(nk, distance, 2);
 
                             vec3 dirLightDirection;
                             rendering_getDirLightDirection(ctx, dirLightDirection);
@@ -562,8 +660,9 @@ static void gui_renderMenu(ProgContext *ctx, struct nk_context *nk) {
 
                         if (isPointLightActive) {
                             nk_layout_row_dynamic(nk, 25, 1);
-                            if (nk_button_label(nk, "Schatten aktual.")) {
-                                rendering_setShouldUpdatePointShadows(ctx);
+                            nk_bool use16BitShadows = rendering_getUse16BitPointShadows(ctx);
+                            if (nk_checkbox_label(nk, "16-Bit-Schatten", &use16BitShadows)) {
+                                rendering_setUse16BitPointShadows(ctx, use16BitShadows);
                             }
 
                             nk_layout_row_dynamic(nk, 25, 1);
@@ -577,6 +676,34 @@ static void gui_renderMenu(ProgContext *ctx, struct nk_context *nk) {
                             if (gui_widgetColor(nk, "Farbe", pointLightColor) && !glm_vec4_eqv_eps(pointLightColor, temp)) {
                                 rendering_setPointLightColor(ctx, pointLightColor);
                             }
+
+                            nk_layout_row_dynamic(nk, 25, 1);
+                            nk_bool useLightVolumes = rendering_getUseLightVolumes(ctx);
+                            if (nk_checkbox_label(nk, "Lichtvolumen", &useLightVolumes)) {
+                                rendering_setUseLightVolumes(ctx, useLightVolumes);
+                            }
+
+                            nk_bool useLightScissor = rendering_getUseLightScissor(ctx);
+                            if (nk_checkbox_label(nk, "Scissor-Rechteck", &useLightScissor)) {
+                                rendering_setUseLightScissor(ctx, useLightScissor);
+                            }
+
+                            // Beleuchtete Pixel im Vergleich zu reinen Fullscreen-Pässen
+                            LightVolumeStats lightStats;
+                            rendering_getLightVolumeStats(ctx, &lightStats);
+
+                            char line[64];
+                            nk_layout_row_dynamic(nk, 20, 1);
+                            snprintf(line, sizeof(line), "Volumen: %d Vollbild: %d",
+                                     lightStats.volumeLights, lightStats.fullscreenLights);
+                            nk_label(nk, line, NK_TEXT_LEFT);
+                            snprintf(line, sizeof(line), "Pixel: %llu / %llu",
+                                     (unsigned long long) lightStats.litPixels,
+                                     (unsigned long long) lightStats.fullscreenPixels);
+                            nk_label(nk, line, NK_TEXT_LEFT);
+                            snprintf(line, sizeof(line), "Übersprungen: %d Scissor: %d",
+                                     lightStats.skippedLights, lightStats.scissoredLights);
+                            nk_label(nk, line, NK_TEXT_LEFT);
                         }
 
                         nk_tree_pop(nk);
@@ -635,12 +762,12 @@ static void gui_renderMenu(ProgContext *ctx, struct nk_context *nk) {
                     gui_display_float(nk, emissionWeight, 2);
 
                     nk_layout_row_dynamic(nk, 25, 3);
-                    nk_label(nk, "Blur Iterationen", NK_TEXT_LEFT);
-                    float blurIterations = (float)rendering_getBloomBlurIterations(ctx);
-                    if (nk_slider_float(nk, 0.0f, &blurIterations, 20.f, 1.0f)) {
-                        rendering_setBloomBlurIterations(ctx, (int)blurIterations);
+                    nk_label(nk, "Bloom-Stufen", NK_TEXT_LEFT);
+                    int bloomLevels = rendering_getBloomLevels(ctx);
+                    if (nk_slider_int(nk, 0, &bloomLevels, BLOOM_MAX_LEVELS, 1)) {
+                        rendering_setBloomLevels(ctx, bloomLevels);
                     }
-                    gui_display_float(nk, blurIterations, 2);
+                    gui_display_float(nk, (float) bloomLevels, 0);
 
                     if (nk_tree_push(nk, NK_TREE_TAB, "Schärfentiefe", NK_MAXIMIZED)) {
                         nk_layout_row_dynamic(nk, 25, 1);
@@ -665,6 +792,14 @@ static void gui_renderMenu(ProgContext *ctx, struct nk_context *nk) {
                                 rendering_setDepthOfField(ctx, depthOfField);
                             }
                             gui_display_float(nk, depthOfField, 2);
+
+                            nk_layout_row_dynamic(nk, 25, 3);
+                            nk_label(nk, "Verkleinerung", NK_TEXT_LEFT);
+                            int dofDivisor = rendering_getDepthOfFieldDivisor(ctx);
+                            if (nk_slider_int(nk, 2, &dofDivisor, 4, 2)) {
+                                rendering_setDepthOfFieldDivisor(ctx, dofDivisor);
+                            }
+                            gui_display_float(nk, (float) dofDivisor, 0);
                         }
 
                         nk_tree_pop(nk);
@@ -718,11 +853,28 @@ static void gui_renderStats(ProgContext *ctx, struct nk_context *nk) {
 
     // Prüfen, ob das Menü überhaupt angezeigt werden soll.
     if (input->showStats) {
-        float x = (float) win->realWidth - STATS_WIDTH;
+        // Die Kosten der Beleuchtung werden immer angezeigt, während einer
+        // Aufnahme und im gekachelten bzw. geclusterten Modus kommen weitere
+        // Zeilen hinzu. Am Ende folgt eine Zeile pro gemessenem Render-Scope.
+        bool recording = recorder_isRecording();
+        LightingMode lightingMode = rendering_getLightingMode(ctx);
+        bool lightGrid = lightingMode == LIGHTING_MODE_TILED || lightingMode == LIGHTING_MODE_CLUSTERED;
+        float width = STATS_WIDE_WIDTH;
+        float height = STATS_HEIGHT + 19 * STATS_LINE_HEIGHT;
+        if (recording) {
+            height += 3 * STATS_LINE_HEIGHT;
+        }
+        if (lightGrid) {
+            height += 2 * STATS_LINE_HEIGHT;
+        }
+        int scopeCount;
+        const ProfilerScope *scopes = profiler_getScopes(&scopeCount);
+        height += (1 + scopeCount) * STATS_LINE_HEIGHT;
+        float x = (float) win->realWidth - width;
 
         // Fenster öffnen.
         if (nk_begin(nk, GUI_WINDOW_STATS,
-                     nk_rect(x, 0, STATS_WIDTH, STATS_HEIGHT),
+                     nk_rect(x, 0, width, height),
                      NK_WINDOW_NO_SCROLLBAR | NK_WINDOW_BACKGROUND |
                      NK_WINDOW_NO_INPUT)) {
             // FPS Anzeigen
@@ -730,6 +882,183 @@ static void gui_renderStats(ProgContext *ctx, struct nk_context *nk) {
             char fpsString[15];
             snprintf(fpsString, 14, "FPS: %d", win->fps);
             nk_label(nk, fpsString, NK_TEXT_LEFT);
+
+            // Zustand der Aufnahme anzeigen
+            if (recording) {
+                RecorderStats recStats;
+                recorder_getStats(&recStats);
+
+                char line[64];
+                nk_layout_row_dynamic(nk, 20, 1);
+                snprintf(line, sizeof(line), "REC: %d Frames", recStats.captured);
+                nk_label(nk, line, NK_TEXT_LEFT);
+                snprintf(line, sizeof(line), "Geschrieben: %d Verworfen: %d",
+                         recStats.encoded, recStats.dropped);
+                nk_label(nk, line, NK_TEXT_LEFT);
+                snprintf(line, sizeof(line), "Warteschlange: %d GPU: %d",
+                         recStats.queued, recStats.inFlight);
+                nk_label(nk, line, NK_TEXT_LEFT);
+            }
+
+            // Kosten der Beleuchtung und der Lichtzuordnung anzeigen
+            LightingStats lightStats;
+            rendering_getLightingStats(ctx, &lightStats);
+
+            char lightLine[64];
+            nk_layout_row_dynamic(nk, 20, 1);
+            snprintf(lightLine, sizeof(lightLine), "Licht CPU: %.2f ms GPU: %.2f ms",
+                     lightStats.submissionTime, lightStats.shadingTime);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+            snprintf(lightLine, sizeof(lightLine), "Licht-Pässe: %d", lightStats.lightPasses);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+
+            // Speicherverkehr des G-Buffers im Vergleich zum alten Layout
+            GBufferStats gbufferStats;
+            rendering_getGBufferStats(ctx, &gbufferStats);
+            snprintf(lightLine, sizeof(lightLine), "G-Buffer: %g/%g B/Pixel",
+                     gbufferStats.geometryBytes, gbufferStats.lightBytes);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+            snprintf(lightLine, sizeof(lightLine), "%.1f MB/Frame (vorher %.1f MB)",
+                     gbufferStats.frameMegabytes, gbufferStats.legacyMegabytes);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+
+            // Belegung des Schatten-Atlas und neu gerenderte Schattenkarten
+            ShadowStats shadowStats;
+            rendering_getShadowStats(ctx, &shadowStats);
+            snprintf(lightLine, sizeof(lightLine), "Schatten-Atlas: %d/%d Lichter, %.0f%%",
+                     shadowStats.shadowedLights, shadowStats.requestedLights,
+                     shadowStats.occupancy * 100.0f);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+            snprintf(lightLine, sizeof(lightLine), "Seiten: %d-%d px, %.0f MB",
+                     shadowStats.minFaceSize, shadowStats.maxFaceSize, shadowStats.megabytes);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+            snprintf(lightLine, sizeof(lightLine), "Schatten neu: %d Kaskaden (%d Meshes), %d Punkt",
+                     shadowStats.dirShadowRenders, shadowStats.dirShadowMeshes, shadowStats.pointShadowRenders);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+            snprintf(lightLine, sizeof(lightLine), "Punktschatten: %d Meshes, %d/%d Seiten",
+                     shadowStats.pointShadowMeshes, shadowStats.pointShadowFaces, 6 * shadowStats.pointShadowMeshes);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+
+            // Kosten des Bloom-Effekts bei der aktuellen Auflösung
+            BloomStats bloomStats;
+            rendering_getBloomStats(ctx, &bloomStats);
+            snprintf(lightLine, sizeof(lightLine), "Bloom: %.2f ms, %d Stufen ab %dx%d",
+                     bloomStats.gpuTime, bloomStats.levels, bloomStats.width, bloomStats.height);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+            snprintf(lightLine, sizeof(lightLine), "%d Pässe, %.1f MB (vorher %.1f MB)",
+                     bloomStats.passes, bloomStats.megabytes, bloomStats.legacyMegabytes);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+
+            DepthOfFieldStats dofStats;
+            rendering_getDepthOfFieldStats(ctx, &dofStats);
+            if (dofStats.enabled) {
+                snprintf(lightLine, sizeof(lightLine), "Schärfentiefe: %.2f ms, %d Pässe bei %dx%d",
+                         dofStats.gpuTime, dofStats.passes, dofStats.width, dofStats.height);
+            } else {
+                snprintf(lightLine, sizeof(lightLine), "Schärfentiefe: aus");
+            }
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+
+            // Zusammengefasste Nachbearbeitung im Vergleich zu einzelnen Pässen
+            PostprocessStats postStats;
+            rendering_getPostprocessStats(ctx, &postStats);
+            char stages[40] = "";
+            const struct { PostprocessStage stage; const char *name; } stageNames[] = {
+                { POSTPROCESS_STAGE_FOG, "Nebel" }, { POSTPROCESS_STAGE_BLOOM, "Bloom" },
+                { POSTPROCESS_STAGE_TONEMAP, "Tonemap" }, { POSTPROCESS_STAGE_SKYBOX, "Skybox" },
+                { POSTPROCESS_STAGE_DOF, "DoF" }
+            };
+            for (size_t i = 0; i < sizeof(stageNames) / sizeof(stageNames[0]); i++) {
+                if (postStats.stages & stageNames[i].stage) {
+                    if (stages[0] != '\0') {
+                        strncat(stages, "+", sizeof(stages) - strlen(stages) - 1);
+                    }
+                    strncat(stages, stageNames[i].name, sizeof(stages) - strlen(stages) - 1);
+                }
+            }
+            snprintf(lightLine, sizeof(lightLine), "Post %.2f ms: %s", postStats.gpuTime, stages);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+            snprintf(lightLine, sizeof(lightLine), "%d Pässe, %.1f MB (getrennt %d, %.1f MB)",
+                     postStats.passes, postStats.megabytes, postStats.separatePasses, postStats.separateMegabytes);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+
+            // Vom Render-Graphen entfernte Pässe und Speicher der transienten Ziele
+            FrameGraphStats graphStats;
+            rendering_getFrameGraphStats(ctx, &graphStats);
+            snprintf(lightLine, sizeof(lightLine), "Graph: %d/%d Pässe, %d Ziele in %d Texturen",
+                     graphStats.passes - graphStats.culledPasses, graphStats.passes,
+                     graphStats.targets, graphStats.textures);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+            snprintf(lightLine, sizeof(lightLine), "Ziele: %.1f MB, Pool %.1f MB (einzeln %.1f MB)",
+                     graphStats.megabytes, graphStats.poolMegabytes, graphStats.dedicatedMegabytes);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+
+            // Auflösung, in die gerendert wird, und GPU-Zeit des ganzen Frames
+            DynamicResolutionStats resolutionStats;
+            rendering_getDynamicResolutionStats(ctx, &resolutionStats);
+            if (resolutionStats.enabled) {
+                snprintf(lightLine, sizeof(lightLine), "Auflösung: %.0f%% (%dx%d), %.2f/%.1f ms",
+                         resolutionStats.scale * 100.0f, resolutionStats.width, resolutionStats.height,
+                         resolutionStats.gpuTime, resolutionStats.budget);
+            } else {
+                snprintf(lightLine, sizeof(lightLine), "Auflösung: %.0f%% (%dx%d), %.2f ms",
+                         resolutionStats.scale * 100.0f, resolutionStats.width, resolutionStats.height,
+                         resolutionStats.gpuTime);
+            }
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+
+            // Vergleich mit dem letzten Frame in voller Auflösung ohne Rekonstruktion
+            if (resolutionStats.nativeGpuTime > 0.0) {
+                snprintf(lightLine, sizeof(lightLine), "%s: %.2f ms, nativ %.2f ms (%.0f%%)",
+                         upscalingModeNames[resolutionStats.mode], resolutionStats.resolveTime,
+                         resolutionStats.nativeGpuTime, resolutionStats.gpuTime / resolutionStats.nativeGpuTime * 100.0);
+            } else {
+                snprintf(lightLine, sizeof(lightLine), "%s: %.2f ms, nativ nicht gemessen",
+                         upscalingModeNames[resolutionStats.mode], resolutionStats.resolveTime);
+            }
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+
+            // Herkunft und Ladezeit aller bisher angelegten Shader-Programme
+            ShaderCacheStats cacheStats;
+            shader_getCacheStats(&cacheStats);
+            snprintf(lightLine, sizeof(lightLine), "Shader: %d Cache, %d übersetzt (%d abgelehnt), %.0f ms",
+                     cacheStats.cachedPrograms, cacheStats.compiledPrograms, cacheStats.rejectedPrograms,
+                     cacheStats.loadTime);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+            snprintf(lightLine, sizeof(lightLine), "Shader neu geladen: %d", cacheStats.reloadedPrograms);
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+
+            if (lightGrid) {
+                snprintf(lightLine, sizeof(lightLine), "Lichter: %d Zellen: %d",
+                         lightStats.visibleLights, lightStats.cellCount);
+                nk_label(nk, lightLine, NK_TEXT_LEFT);
+                snprintf(lightLine, sizeof(lightLine), "Zuordnung: %.2f ms Max: %d",
+                         lightStats.assignmentTime, lightStats.maxLightsPerCell);
+                nk_label(nk, lightLine, NK_TEXT_LEFT);
+            }
+
+            // GPU-Zeit der einzelnen Render-Scopes, eingerückt nach ihrer
+            // Verschachtelung
+            ProfilerStats profilerStats;
+            profiler_getStats(&profilerStats);
+            if (profilerStats.skippedScopes > 0) {
+                snprintf(lightLine, sizeof(lightLine), "GPU-Pässe: %.2f ms (%d übersprungen)",
+                         profilerStats.gpuTime, profilerStats.skippedScopes);
+            } else {
+                snprintf(lightLine, sizeof(lightLine), "GPU-Pässe: %.2f ms, %d Frames alt",
+                         profilerStats.gpuTime, profilerStats.latency);
+            }
+            nk_label(nk, lightLine, NK_TEXT_LEFT);
+            for (int i = 0; i < scopeCount; i++) {
+                if (scopes[i].calls > 1) {
+                    snprintf(lightLine, sizeof(lightLine), "%*s%s: %.2f ms (%dx)",
+                             2 * (scopes[i].depth + 1), "", scopes[i].name, scopes[i].gpuTime, scopes[i].calls);
+                } else {
+                    snprintf(lightLine, sizeof(lightLine), "%*s%s: %.2f ms",
+                             2 * (scopes[i].depth + 1), "", scopes[i].name, scopes[i].gpuTime);
+                }
+                nk_label(nk, lightLine, NK_TEXT_LEFT);
+            }
         }
         nk_end(nk);
     }
@@ -0,0 +1,625 @@
+/**
+ * Modul zum Rendern ohne sichtbares Fenster. Damit kann der Renderer z.B. auf
+ * einer Renderfarm oder in der CI (auch mit Mesa llvmpipe) für Benchmarks und
+ * Regressionstests genutzt werden.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#include "headless.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sesp/stb_image.h>
+
+#include "common.h"
+#include "rendering.h"
+#include "input.h"
+#include "camera.h"
+#include "scene.h"
+#include "utils.h"
+
+#ifdef HEADLESS_EGL
+    // Wir brauchen keine X11 Typen, nur die surfaceless Plattform.
+    #define EGL_NO_X11
+    #include <EGL/egl.h>
+    #include <EGL/eglext.h>
+#endif
+
+////////////////////////////////// KONSTANTEN //////////////////////////////////
+
+#define HEADLESS_OPENGL_MAJOR 4
+#define HEADLESS_OPENGL_MINOR 1
+
+#define HEADLESS_DEFAULT_WIDTH 1200
+#define HEADLESS_DEFAULT_HEIGHT 800
+
+// Maximale Länge der erzeugten Dateinamen
+#define HEADLESS_FILENAME_SIZE 256
+
+// Halbe Kantenlänge des Bereichs, in dem zusätzliche Lichter verteilt werden
+#define HEADLESS_LIGHT_AREA 20.0f
+
+////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
+
+// Einstellungen aus der Kommandozeile
+typedef struct {
+    const char* scene;
+    bool hasCamera;
+    vec3 cameraPosition;
+    float cameraYaw;
+    float cameraPitch;
+    int width;
+    int height;
+    int frames;
+    const char* output;
+    bool writeImages;
+    int lights;
+    LightingMode lightingMode;
+} HeadlessOptions;
+
+// Der OpenGL-Kontext ohne Fenster
+typedef struct {
+#ifdef HEADLESS_EGL
+    EGLDisplay display;
+    EGLContext context;
+#else
+    GLFWwindow* window;
+#endif
+} HeadlessContext;
+
+// Zeitmessung eines Frames in Millisekunden
+typedef struct {
+    double cpu;
+    double gpu;
+    double lightCpu; // Absetzen der Beleuchtungs-Pässe
+    double lightGpu; // GPU-Zeit der Beleuchtung, ein bis zwei Frames verzögert
+    int lightPasses; // Draw-Calls, die den G-Buffer lesen
+    double gbufferMb; // geschätzter G-Buffer-Verkehr in MB
+    double legacyGbufferMb; // derselbe Frame mit dem alten G-Buffer-Layout
+} HeadlessTiming;
+
+// Namen der Beleuchtungsverfahren auf der Kommandozeile
+static const char* headless_lightingModeNames[LIGHTING_MODE_COUNT] = {
+    "per-light",
+    "tiled",
+    "clustered",
+    "single-pass"
+};
+
+////////////////////////////// LOKALE FUNKTIONEN ///////////////////////////////
+
+/**
+ * Gibt die unterstützten Argumente aus.
+ */
+static void headless_printUsage(void)
+{
+    fprintf(stderr,
+        "Usage: " PROGRAM_NAME " --headless [options]\n"
+        "  --scene <file>            scene (.json) or model to load\n"
+        "  --camera x,y,z,yaw,pitch  camera position and orientation\n"
+        "  --size <w>x<h>            image resolution (default %dx%d)\n"
+        "  --frames <n>              number of frames to render (default 1)\n"
+        "  --output <prefix>         prefix for images and timings (default headless)\n"
+        "  --no-images               only measure, do not write images\n"
+        "  --lights <n>              add n small point lights to the scene\n"
+        "  --lighting <mode>         per-light (default), tiled, clustered or single-pass\n",
+        HEADLESS_DEFAULT_WIDTH, HEADLESS_DEFAULT_HEIGHT);
+}
+
+/**
+ * Liest die Kommandozeilenargumente ein.
+ *
+ * @param argc Anzahl der Argumente
+ * @param argv die Argumente
+ * @param options Ausgabeparameter für die Einstellungen
+ * @return true, wenn alle Argumente gültig waren
+ */
+static bool headless_parseArguments(int argc, char** argv, HeadlessOptions* options)
+{
+    memset(options, 0, sizeof(HeadlessOptions));
+    options->width = HEADLESS_DEFAULT_WIDTH;
+    options->height = HEADLESS_DEFAULT_HEIGHT;
+    options->frames = 1;
+    options->output = "headless";
+    options->writeImages = true;
+    options->lightingMode = LIGHTING_MODE_PER_LIGHT;
+
+    for (int i = 0; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--no-images") == 0)
+        {
+            options->writeImages = false;
+            continue;
+        }
+
+        // Alle anderen Argumente erwarten einen Wert.
+        if (!value)
+        {
+            fprintf(stderr, "Error: Missing value for %s\n", arg);
+            return false;
+        }
+        i++;
+
+        if (strcmp(arg, "--scene") == 0)
+        {
+            options->scene = value;
+        }
+        else if (strcmp(arg, "--camera") == 0)
+        {
+            options->hasCamera = sscanf(value, "%f,%f,%f,%f,%f",
+                &options->cameraPosition[0], &options->cameraPosition[1],
+                &options->cameraPosition[2], &options->cameraYaw,
+                &options->cameraPitch) == 5;
+            if (!options->hasCamera)
+            {
+                fprintf(stderr, "Error: Invalid camera pose '%s'\n", value);
+                return false;
+            }
+        }
+        else if (strcmp(arg, "--size") == 0)
+        {
+            if (sscanf(value, "%dx%d", &options->width, &options->height) != 2
+                || options->width <= 0 || options->height <= 0)
+            {
+                fprintf(stderr, "Error: Invalid size '%s'\n", value);
+                return false;
+            }
+        }
+        else if (strcmp(arg, "--frames") == 0)
+        {
+            options->frames = atoi(value);
+            if (options->frames <= 0)
+            {
+                fprintf(stderr, "Error: Invalid frame count '%s'\n", value);
+                return false;
+            }
+        }
+        else if (strcmp(arg, "--output") == 0)
+        {
+            options->output = value;
+        }
+        else if (strcmp(arg, "--lights") == 0)
+        {
+            options->lights = atoi(value);
+            if (options->lights < 0)
+            {
+                fprintf(stderr, "Error: Invalid light count '%s'\n", value);
+                return false;
+            }
+        }
+        else if (strcmp(arg, "--lighting") == 0)
+        {
+            int mode = 0;
+            while (mode < LIGHTING_MODE_COUNT && strcmp(value, headless_lightingModeNames[mode]) != 0)
+            {
+                mode++;
+            }
+            if (mode == LIGHTING_MODE_COUNT)
+            {
+                fprintf(stderr, "Error: Unknown lighting mode '%s'\n", value);
+                return false;
+            }
+            options->lightingMode = (LightingMode) mode;
+        }
+        else
+        {
+            fprintf(stderr, "Error: Unknown argument %s\n", arg);
+            return false;
+        }
+    }
+
+    if (options->lights > 0 && !options->scene)
+    {
+        fprintf(stderr, "Error: --lights requires a scene\n");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Fügt der Szene zusätzliche kleine Punktlichter hinzu, z.B. um die
+ * Beleuchtungsverfahren bei vielen Lichtern zu vergleichen. Die Verteilung
+ * nutzt einen eigenen Zufallsgenerator, damit sie auf allen Plattformen
+ * gleich ist.
+ *
+ * @param scene die Szene
+ * @param count die Anzahl der Lichter
+ */
+static void headless_addLights(Scene* scene, int count)
+{
+    unsigned int seed = 12345;
+
+    for (int i = 0; i < count; i++)
+    {
+        float values[6];
+        for (int j = 0; j < 6; j++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            values[j] = (float) (seed >> 8) / (float) (1u << 24);
+        }
+
+        vec3 pos = {
+            (values[0] * 2.0f - 1.0f) * HEADLESS_LIGHT_AREA,
+            0.5f + values[1] * 4.0f,
+            (values[2] * 2.0f - 1.0f) * HEADLESS_LIGHT_AREA
+        };
+        vec3 color = { 0.2f + values[3] * 0.8f, 0.2f + values[4] * 0.8f, 0.2f + values[5] * 0.8f };
+
+        // Reichweite von etwa 7 Einheiten, siehe Tabelle in light.h
+        scene_addPointLight(scene, light_createPointLightEx(pos, color, 1.0f, 0.7f, 1.8f));
+    }
+}
+
+/**
+ * Erzeugt einen OpenGL-Kontext ohne sichtbares Fenster und lädt die
+ * OpenGL-Funktionen.
+ *
+ * @param hc Ausgabeparameter für den Kontext
+ * @return true, wenn der Kontext erzeugt werden konnte
+ */
+static bool headless_createContext(HeadlessContext* hc)
+{
+#ifdef HEADLESS_EGL
+    // Bevorzugt wird die surfaceless Plattform von Mesa genutzt, sie braucht
+    // weder Display noch GPU. Ansonsten nehmen wir das Standard-Display.
+    hc->display = EGL_NO_DISPLAY;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay)
+    {
+        hc->display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+    if (hc->display == EGL_NO_DISPLAY)
+    {
+        hc->display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint major, minor;
+    if (hc->display == EGL_NO_DISPLAY || !eglInitialize(hc->display, &major, &minor))
+    {
+        fprintf(stderr, "Error: Could not initialize EGL!\n");
+        return false;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        fprintf(stderr, "Error: EGL does not support desktop OpenGL!\n");
+        eglTerminate(hc->display);
+        return false;
+    }
+
+    // Eine Konfiguration wird nur für die Kontexterzeugung gebraucht, gerendert
+    // wird ausschließlich in eigene Framebuffer.
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config = NULL;
+    EGLint configCount = 0;
+    eglChooseConfig(hc->display, configAttribs, &config, 1, &configCount);
+    if (configCount == 0)
+    {
+        config = NULL; // EGL_NO_CONFIG_KHR
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, HEADLESS_OPENGL_MAJOR,
+        EGL_CONTEXT_MINOR_VERSION, HEADLESS_OPENGL_MINOR,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    hc->context = eglCreateContext(hc->display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (hc->context == EGL_NO_CONTEXT
+        || !eglMakeCurrent(hc->display, EGL_NO_SURFACE, EGL_NO_SURFACE, hc->context))
+    {
+        fprintf(stderr, "Error: Could not create surfaceless OpenGL %d.%d context!\n",
+                HEADLESS_OPENGL_MAJOR, HEADLESS_OPENGL_MINOR);
+        eglTerminate(hc->display);
+        return false;
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc) eglGetProcAddress))
+    {
+        fprintf(stderr, "Error: Could not load OpenGL functions!\n");
+        return false;
+    }
+#else
+    // Ohne EGL nutzen wir ein unsichtbares GLFW-Fenster. Dafür wird allerdings
+    // ein Display benötigt.
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Error: GLFW initialization failed! Without EGL the headless mode "
+                        "needs a display.\n");
+        return false;
+    }
+
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, HEADLESS_OPENGL_MAJOR);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, HEADLESS_OPENGL_MINOR);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    #ifdef __APPLE__
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    #endif
+
+    hc->window = glfwCreateWindow(1, 1, PROGRAM_NAME, NULL, NULL);
+    if (!hc->window)
+    {
+        fprintf(stderr, "Error: Could not create hidden window!\n");
+        glfwTerminate();
+        return false;
+    }
+
+    glfwMakeContextCurrent(hc->window);
+    if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress))
+    {
+        fprintf(stderr, "Error: Could not load OpenGL functions!\n");
+        return false;
+    }
+#endif
+
+    printf("OpenGL-Version: %s\n", glGetString(GL_VERSION));
+    printf("OpenGL-Renderer: %s\n", glGetString(GL_RENDERER));
+
+    return true;
+}
+
+/**
+ * Gibt den OpenGL-Kontext wieder frei.
+ *
+ * @param hc der Kontext
+ */
+static void headless_deleteContext(HeadlessContext* hc)
+{
+#ifdef HEADLESS_EGL
+    eglMakeCurrent(hc->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(hc->display, hc->context);
+    eglTerminate(hc->display);
+#else
+    glfwDestroyWindow(hc->window);
+    glfwTerminate();
+#endif
+}
+
+/**
+ * Erzeugt den Offscreen-Framebuffer, in den das fertige Bild gerendert wird.
+ *
+ * @param width die Breite
+ * @param height die Höhe
+ * @param renderbuffers Ausgabeparameter für Farb- und Tiefenpuffer
+ * @return der Framebuffer oder 0 im Fehlerfall
+ */
+static GLuint headless_createFramebuffer(int width, int height, GLuint renderbuffers[2])
+{
+    GLuint fbo;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    glGenRenderbuffers(2, renderbuffers);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    common_labelObjectByType(GL_FRAMEBUFFER, fbo, "Headless Output");
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (!complete)
+    {
+        fprintf(stderr, "Error: Headless framebuffer is not complete!\n");
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(2, renderbuffers);
+        return 0;
+    }
+
+    return fbo;
+}
+
+/**
+ * Liest das fertige Bild aus dem Offscreen-Framebuffer und speichert es als
+ * PNG-Datei.
+ *
+ * @param fbo der Offscreen-Framebuffer
+ * @param options die Einstellungen
+ * @param frame die Nummer des Frames
+ */
+static void headless_writeImage(GLuint fbo, const HeadlessOptions* options, int frame)
+{
+    unsigned char* pixels = malloc((size_t) options->width * options->height * 3);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, options->width, options->height, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+
+    char filename[HEADLESS_FILENAME_SIZE];
+    snprintf(filename, sizeof(filename), "%s_%04d.png", options->output, frame);
+
+    stbi_flip_vertically_on_write(true);
+    if (!stbi_write_png(filename, options->width, options->height, 3, pixels, 0))
+    {
+        fprintf(stderr, "Error: Could not write %s!\n", filename);
+    }
+
+    free(pixels);
+}
+
+/**
+ * Schreibt die Zeitmessungen als CSV-Datei und gibt eine Zusammenfassung aus.
+ * Der erste Frame enthält das Hochladen der Szene und wird deshalb bei
+ * mehreren Frames nicht in die Zusammenfassung einbezogen.
+ *
+ * @param options die Einstellungen
+ * @param timings die Zeitmessungen aller Frames
+ */
+static void headless_writeTimings(const HeadlessOptions* options, const HeadlessTiming* timings)
+{
+    char filename[HEADLESS_FILENAME_SIZE];
+    snprintf(filename, sizeof(filename), "%s_timings.csv", options->output);
+
+    FILE* file = fopen(filename, "w");
+    if (file)
+    {
+        fprintf(file, "frame,cpu_ms,gpu_ms,light_cpu_ms,light_gpu_ms,light_passes,gbuffer_mb,legacy_gbuffer_mb\n");
+        for (int i = 0; i < options->frames; i++)
+        {
+            fprintf(file, "%d,%.4f,%.4f,%.4f,%.4f,%d,%.2f,%.2f\n", i, timings[i].cpu, timings[i].gpu,
+                    timings[i].lightCpu, timings[i].lightGpu, timings[i].lightPasses,
+                    timings[i].gbufferMb, timings[i].legacyGbufferMb);
+        }
+        fclose(file);
+    }
+    else
+    {
+        fprintf(stderr, "Error: Could not write %s!\n", filename);
+    }
+
+    int first = options->frames > 1 ? 1 : 0;
+    int count = options->frames - first;
+    double cpuSum = 0.0, gpuSum = 0.0, lightCpuSum = 0.0;
+    double cpuMin = timings[first].cpu, cpuMax = timings[first].cpu;
+    for (int i = first; i < options->frames; i++)
+    {
+        cpuSum += timings[i].cpu;
+        gpuSum += timings[i].gpu;
+        lightCpuSum += timings[i].lightCpu;
+        cpuMin = timings[i].cpu < cpuMin ? timings[i].cpu : cpuMin;
+        cpuMax = timings[i].cpu > cpuMax ? timings[i].cpu : cpuMax;
+    }
+
+    printf("%s, %dx%d, %d Frames: Frame %.3f ms (min %.3f, max %.3f), GPU %.3f ms, "
+           "Lighting CPU %.3f ms, %d light passes, G-buffer %.1f MB (legacy layout %.1f MB)\n",
+           headless_lightingModeNames[options->lightingMode],
+           options->width, options->height, count,
+           cpuSum / count, cpuMin, cpuMax, gpuSum / count,
+           lightCpuSum / count, timings[options->frames - 1].lightPasses,
+           timings[options->frames - 1].gbufferMb, timings[options->frames - 1].legacyGbufferMb);
+}
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+int headless_run(int argc, char** argv)
+{
+    HeadlessOptions options;
+    if (!headless_parseArguments(argc, argv, &options))
+    {
+        headless_printUsage();
+        return EXIT_FAILURE;
+    }
+
+    HeadlessContext hc;
+    if (!headless_createContext(&hc))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // Der Programmkontext wird ohne Fenster und ohne GUI aufgebaut.
+    ProgContext* ctx = common_createContext();
+    ctx->winData->width = options.width;
+    ctx->winData->height = options.height;
+    ctx->winData->realWidth = options.width;
+    ctx->winData->realHeight = options.height;
+    glViewport(0, 0, options.width, options.height);
+
+    input_init(ctx);
+    rendering_init(ctx);
+
+    GLuint renderbuffers[2];
+    GLuint fbo = headless_createFramebuffer(options.width, options.height, renderbuffers);
+    if (!fbo)
+    {
+        rendering_cleanup(ctx);
+        input_cleanup(ctx);
+        common_deleteContext(ctx);
+        headless_deleteContext(&hc);
+        return EXIT_FAILURE;
+    }
+    rendering_setOutputFramebuffer(ctx, fbo);
+
+    if (options.scene)
+    {
+        input_userSelectedFile(ctx, options.scene);
+        if (ctx->input->rendering.userScene && options.lights > 0)
+        {
+            headless_addLights(ctx->input->rendering.userScene, options.lights);
+        }
+    }
+    rendering_setLightingMode(ctx, options.lightingMode);
+    if (options.hasCamera)
+    {
+        camera_setPose(ctx->input->mainCamera, options.cameraPosition,
+                       options.cameraYaw, options.cameraPitch);
+    }
+
+    // Die GPU-Zeit wird über Zeitstempel gemessen, da der Renderer intern
+    // selbst GL_TIME_ELAPSED-Queries benutzt und diese nicht verschachtelt
+    // werden dürfen. Die Frame-Zeit wird auf der CPU inklusive glFinish
+    // gemessen, damit die GPU-Arbeit enthalten ist.
+    GLuint queries[2];
+    glGenQueries(2, queries);
+    HeadlessTiming* timings = malloc(sizeof(HeadlessTiming) * options.frames);
+
+    for (int i = 0; i < options.frames; i++)
+    {
+        double start = utils_getTime();
+
+        glQueryCounter(queries[0], GL_TIMESTAMP);
+        rendering_draw(ctx);
+        glQueryCounter(queries[1], GL_TIMESTAMP);
+        glFinish();
+
+        double end = utils_getTime();
+
+        GLuint64 gpuStart = 0, gpuEnd = 0;
+        glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT, &gpuStart);
+        glGetQueryObjectui64v(queries[1], GL_QUERY_RESULT, &gpuEnd);
+        GLuint64 gpuTime = gpuEnd - gpuStart;
+
+        timings[i].cpu = (end - start) * 1000.0;
+        timings[i].gpu = (double) gpuTime / 1000000.0;
+
+        LightingStats lightStats;
+        rendering_getLightingStats(ctx, &lightStats);
+        timings[i].lightCpu = lightStats.submissionTime;
+        timings[i].lightGpu = lightStats.shadingTime;
+        timings[i].lightPasses = lightStats.lightPasses;
+
+        GBufferStats gbufferStats;
+        rendering_getGBufferStats(ctx, &gbufferStats);
+        timings[i].gbufferMb = gbufferStats.frameMegabytes;
+        timings[i].legacyGbufferMb = gbufferStats.legacyMegabytes;
+        ctx->winData->deltaTime = end - start;
+
+        if (options.writeImages)
+        {
+            headless_writeImage(fbo, &options, i);
+        }
+    }
+
+    headless_writeTimings(&options, timings);
+
+    free(timings);
+    glDeleteQueries(2, queries);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(2, renderbuffers);
+
+    rendering_cleanup(ctx);
+    input_cleanup(ctx);
+    common_deleteContext(ctx);
+    headless_deleteContext(&hc);
+
+    return EXIT_SUCCESS;
+}
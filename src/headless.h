@@ -0,0 +1,38 @@
+/**
+ * Modul zum Rendern ohne sichtbares Fenster. Damit kann der Renderer z.B. auf
+ * einer Renderfarm oder in der CI (auch mit Mesa llvmpipe) für Benchmarks und
+ * Regressionstests genutzt werden.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+/**
+ * Führt das Programm im Headless-Modus aus. Es wird ein OpenGL-Kontext ohne
+ * Fenster erzeugt (EGL surfaceless, falls verfügbar, sonst ein unsichtbares
+ * GLFW-Fenster, das weiterhin ein Display braucht), die Szene über
+ * rendering_draw in einen Offscreen-Framebuffer gerendert und die Bilder
+ * sowie die Zeitmessungen in Dateien geschrieben.
+ *
+ * Unterstützte Argumente:
+ *   --scene <datei>           Szene (.json) oder Modell, das geladen wird
+ *   --camera x,y,z,yaw,pitch  Position und Ausrichtung der Kamera
+ *   --size <breite>x<höhe>    Auflösung des Bildes
+ *   --frames <anzahl>         Anzahl der zu rendernden Frames
+ *   --output <präfix>         Präfix für Bilder und Zeitmessungen
+ *   --no-images               nur messen, keine Bilder schreiben
+ *   --lights <anzahl>         kleine Punktlichter zur Szene hinzufügen
+ *   --lighting <verfahren>    per-light, tiled, clustered oder single-pass
+ *
+ * @param argc Anzahl der Argumente (ohne Programmname und --headless)
+ * @param argv die Argumente
+ * @return der Exit-Code des Programms
+ */
+int headless_run(int argc, char** argv);
+
+#endif // HEADLESS_H
@@ -30,9 +30,19 @@ void input_init(ProgContext* ctx)
     data->rendering.clearColor[3] = 1.0f;
     data->rendering.userScene = NULL;
 
+    // Aufnahme Werte initialisieren
+    data->recording.format = RECORDER_FORMAT_PNG;
+    data->recording.waitWhenFull = true;
+
     // Kamera initialisieren
     data->mainCamera = camera_createCamera();
-    glfwGetCursorPos(ctx->window, &data->mouseLastX, &data->mouseLastY);
+    data->mouseLastX = 0.0;
+    data->mouseLastY = 0.0;
+    // Im Headless-Modus gibt es kein Fenster und damit keine Maus.
+    if (ctx->window)
+    {
+        glfwGetCursorPos(ctx->window, &data->mouseLastX, &data->mouseLastY);
+    }
     data->mouseLooking = false;
 }
 
@@ -116,12 +126,29 @@ void input_event(ProgContext* ctx, int key, int action, int mods)
             texture_saveScreenshot(ctx);
             break;
 
+        /* Aufnahme einer Bildsequenz starten/stoppen */
+        case GLFW_KEY_F7:
+            input_toggleRecording(ctx);
+            break;
+
         default:
             break;
         }
     }
 }
 
+void input_toggleRecording(ProgContext* ctx)
+{
+    if (recorder_isRecording())
+    {
+        recorder_stop();
+    }
+    else
+    {
+        recorder_start(ctx->input->recording.format, ctx->input->recording.waitWhenFull);
+    }
+}
+
 void input_mouseMove(ProgContext* ctx, double x, double y)
 {
     InputData* data = ctx->input;
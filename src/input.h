@@ -13,6 +13,7 @@
 #include "model.h"
 #include "camera.h"
 #include "scene.h"
+#include "recorder.h"
 
 //////////////////////////// ÖFFENTLICHE DATENTYPEN ////////////////////////////
 
@@ -31,6 +32,11 @@ struct InputData {
         bool hasUpdatedScene;
     } rendering;
 
+    struct {
+        RecorderFormat format;
+        bool waitWhenFull;
+    } recording;
+
     Camera *mainCamera;
     double mouseLastX;
     double mouseLastY;
@@ -73,6 +79,14 @@ void input_process(ProgContext *ctx);
  */
 void input_event(ProgContext *ctx, int key, int action, int mods);
 
+/**
+ * Startet bzw. beendet die Aufnahme einer Bildsequenz mit den aktuell
+ * eingestellten Aufnahme-Optionen.
+ *
+ * @param ctx Programmkontext.
+ */
+void input_toggleRecording(ProgContext *ctx);
+
 /**
  * Diese Funktion verarbeitet Mausbewegungen.
  *
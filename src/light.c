@@ -97,3 +97,85 @@ void light_deletePointLight(PointLight* light)
     // Aktuell ist kein Cleanup nötig.
     free(light);
 }
+
+float light_calcPointLightRadius(const PointLight* light)
+{
+    const float maxIntensity = fmaxf(fmaxf(light->diffuse[0], light->diffuse[1]), light->diffuse[2]);
+    return (-light->linear + sqrtf(powf(light->linear, 2.0f) - 4 * light->quadratic * (light->constant - maxIntensity * (256.0f / 5.0f)))) / (2 * light->quadratic);
+}
+
+bool light_calcPointLightScreenRect(const PointLight* light, float radius,
+                                    mat4 view, mat4 projection,
+                                    int width, int height, int rect[4])
+{
+    // Zuerst wird die Kugel gegen die sechs Ebenen des Sichtkörpers getestet.
+    mat4 viewProjection;
+    glm_mat4_mul(projection, view, viewProjection);
+
+    vec4 planes[6];
+    glm_frustum_planes(viewProjection, planes);
+
+    for (int i = 0; i < 6; i++)
+    {
+        if (glm_vec3_dot(planes[i], (float*) light->position) + planes[i][3] < -radius)
+        {
+            return false;
+        }
+    }
+
+    // Die Near-Plane lässt sich direkt aus der Projektionsmatrix ablesen.
+    const float zNear = projection[3][2] / (projection[2][2] - 1.0f);
+
+    vec3 center;
+    glm_mat4_mulv3(view, (float*) light->position, 1.0f, center);
+
+    // Schneidet die Kugel die Near-Plane, lässt sich das Rechteck nicht über
+    // die Projektion bestimmen. Dann wird der ganze Bildschirm genommen.
+    if (center[2] + radius > -zNear)
+    {
+        rect[0] = 0;
+        rect[1] = 0;
+        rect[2] = width;
+        rect[3] = height;
+        return true;
+    }
+
+    // Ansonsten werden die Ecken der umschließenden Box projiziert.
+    float minX = 1.0f, minY = 1.0f, maxX = -1.0f, maxY = -1.0f;
+    for (int i = 0; i < 8; i++)
+    {
+        vec4 corner = {
+            center[0] + ((i & 1) ? radius : -radius),
+            center[1] + ((i & 2) ? radius : -radius),
+            center[2] + ((i & 4) ? radius : -radius),
+            1.0f
+        };
+
+        vec4 clip;
+        glm_mat4_mulv(projection, corner, clip);
+
+        const float x = clip[0] / clip[3];
+        const float y = clip[1] / clip[3];
+        minX = fminf(minX, x);
+        minY = fminf(minY, y);
+        maxX = fmaxf(maxX, x);
+        maxY = fmaxf(maxY, y);
+    }
+
+    // Von NDC in Pixel umrechnen und auf den Bildschirm begrenzen.
+    const int x0 = (int) floorf((glm_clamp(minX, -1.0f, 1.0f) * 0.5f + 0.5f) * (float) width);
+    const int y0 = (int) floorf((glm_clamp(minY, -1.0f, 1.0f) * 0.5f + 0.5f) * (float) height);
+    const int x1 = (int) ceilf((glm_clamp(maxX, -1.0f, 1.0f) * 0.5f + 0.5f) * (float) width);
+    const int y1 = (int) ceilf((glm_clamp(maxY, -1.0f, 1.0f) * 0.5f + 0.5f) * (float) height);
+
+    if (x1 <= x0 || y1 <= y0)
+    {
+        return false;
+    }
+
+    rect[0] = x0;
+    rect[1] = y0;
+    rect[2] = x1 - x0;
+    rect[3] = y1 - y0;
+    return true;
+}
@@ -140,4 +140,31 @@ void light_deleteDirLight(DirLight* light);
  */
 void light_deletePointLight(PointLight* light);
 
+/**
+ * Berechnet den Radius, ab dem ein Punktlicht keinen sichtbaren Beitrag mehr
+ * liefert (weniger als 5/256 der maximalen Intensität).
+ *
+ * @param light das Punktlicht
+ * @return der Radius des Lichtvolumens
+ */
+float light_calcPointLightRadius(const PointLight* light);
+
+/**
+ * Bestimmt das Rechteck in Pixeln, das die Kugel eines Punktlichts auf dem
+ * Bildschirm abdeckt. Die Abschätzung ist konservativ, das Rechteck kann
+ * also etwas größer sein als die tatsächliche Projektion.
+ *
+ * @param light das Punktlicht
+ * @param radius der Radius der Kugel
+ * @param view die View-Matrix der Kamera
+ * @param projection die perspektivische Projektionsmatrix der Kamera
+ * @param width die Breite des Bildschirms
+ * @param height die Höhe des Bildschirms
+ * @param rect Ausgabeparameter für x, y, Breite und Höhe des Rechtecks
+ * @return false, wenn die Kugel komplett außerhalb des Sichtbereichs liegt
+ */
+bool light_calcPointLightScreenRect(const PointLight* light, float radius,
+                                    mat4 view, mat4 projection,
+                                    int width, int height, int rect[4]);
+
 #endif // LIGHT_H
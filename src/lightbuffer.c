@@ -0,0 +1,121 @@
+/**
+ * Modul für einen Uniform Buffer, der alle Punkt- und Richtungslichter eines
+ * Frames enthält.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#include "lightbuffer.h"
+
+#include <string.h>
+
+#include "utils.h"
+
+////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
+
+// Inhalt des Uniform Blocks im Layout std140. Jedes Licht belegt vier vec4:
+// Punktlichter [Position, Radius], [Ambient, Konstant], [Diffus, Linear],
+// [Spekular, Quadratisch], Richtungslichter [Richtung], [Ambient], [Diffus],
+// [Spekular].
+typedef struct
+{
+    GLint counts[4];
+    vec4 pointLights[LIGHTBUFFER_MAX_POINT_LIGHTS * 4];
+    vec4 dirLights[LIGHTBUFFER_MAX_DIR_LIGHTS * 4];
+} LightBufferData;
+
+struct LightBuffer
+{
+    GLuint ubo;
+    LightBufferData data; // CPU-Kopie des Blocks
+};
+
+////////////////////////////// LOKALE FUNKTIONEN ///////////////////////////////
+
+/**
+ * Schreibt einen Vektor und einen Skalar in einen vec4 des Blocks.
+ *
+ * @param dst das Ziel
+ * @param v der Vektor für xyz
+ * @param w der Wert für w
+ */
+static void lightbuffer_storeVec4(vec4 dst, const vec3 v, float w)
+{
+    dst[0] = v[0];
+    dst[1] = v[1];
+    dst[2] = v[2];
+    dst[3] = w;
+}
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+LightBuffer* lightbuffer_createLightBuffer(void)
+{
+    LightBuffer* buffer = malloc(sizeof(LightBuffer));
+    memset(buffer, 0, sizeof(LightBuffer));
+
+    glGenBuffers(1, &buffer->ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer->ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(LightBufferData), NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    common_labelObjectByType(GL_BUFFER, buffer->ubo, "Light Buffer");
+
+    return buffer;
+}
+
+void lightbuffer_updateLightBuffer(LightBuffer* buffer,
+                                   PointLight** pointLights, int pointCount,
+                                   DirLight** dirLights, int dirCount)
+{
+    LightBufferData* data = &buffer->data;
+    pointCount = utils_minInt(pointCount, LIGHTBUFFER_MAX_POINT_LIGHTS);
+    dirCount = utils_minInt(dirCount, LIGHTBUFFER_MAX_DIR_LIGHTS);
+
+    for (int i = 0; i < pointCount; i++)
+    {
+        const PointLight* light = pointLights[i];
+        vec4* dst = data->pointLights + i * 4;
+        lightbuffer_storeVec4(dst[0], light->position, light_calcPointLightRadius(light));
+        lightbuffer_storeVec4(dst[1], light->ambient, light->constant);
+        lightbuffer_storeVec4(dst[2], light->diffuse, light->linear);
+        lightbuffer_storeVec4(dst[3], light->specular, light->quadratic);
+    }
+
+    for (int i = 0; i < dirCount; i++)
+    {
+        const DirLight* light = dirLights[i];
+        vec4* dst = data->dirLights + i * 4;
+        lightbuffer_storeVec4(dst[0], light->direction, 0.0f);
+        lightbuffer_storeVec4(dst[1], light->ambient, 0.0f);
+        lightbuffer_storeVec4(dst[2], light->diffuse, 0.0f);
+        lightbuffer_storeVec4(dst[3], light->specular, 0.0f);
+    }
+
+    data->counts[0] = pointCount;
+    data->counts[1] = dirCount;
+
+    // Der gebundene Bereich muss den ganzen Block abdecken, daher wird immer
+    // die volle Größe hochgeladen. Der alte Speicher wird dabei verworfen,
+    // damit mehrere Durchgänge pro Frame nicht aufeinander warten.
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer->ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(LightBufferData), data, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void lightbuffer_bindLightBuffer(LightBuffer* buffer, Shader* shader)
+{
+    glBindBufferBase(GL_UNIFORM_BUFFER, LIGHTBUFFER_BINDING, buffer->ubo);
+    shader_setUniformBlock(shader, "Lights", LIGHTBUFFER_BINDING);
+}
+
+void lightbuffer_deleteLightBuffer(LightBuffer* buffer)
+{
+    if (buffer == NULL)
+    {
+        return;
+    }
+
+    glDeleteBuffers(1, &buffer->ubo);
+    free(buffer);
+}
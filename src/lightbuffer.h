@@ -0,0 +1,74 @@
+/**
+ * Modul für einen Uniform Buffer, der alle Punkt- und Richtungslichter eines
+ * Frames enthält. Damit kann ein einziger Fullscreen-Pass alle Lichter
+ * auswerten, ohne pro Licht den Shader zu binden, das Blending einzurichten
+ * und die Uniforms einzeln zu setzen.
+ *
+ * Der Buffer hat das Layout std140 und eine feste Größe, damit er in die
+ * minimale Größe eines Uniform Blocks (16 KB) passt. Szenen mit mehr
+ * Punktlichtern werden in mehreren Durchgängen hochgeladen.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#ifndef LIGHTBUFFER_H
+#define LIGHTBUFFER_H
+
+#include "common.h"
+#include "light.h"
+#include "shader.h"
+
+// Maximale Anzahl der Lichter in einem Durchgang
+#define LIGHTBUFFER_MAX_POINT_LIGHTS 240
+#define LIGHTBUFFER_MAX_DIR_LIGHTS 8
+
+// Binding-Punkt des Uniform Buffers
+#define LIGHTBUFFER_BINDING 0
+
+//////////////////////////// ÖFFENTLICHE DATENTYPEN ////////////////////////////
+
+// Opaker Datentyp für den Licht-Buffer
+struct LightBuffer;
+typedef struct LightBuffer LightBuffer;
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+/**
+ * Erzeugt einen neuen, leeren Licht-Buffer.
+ *
+ * @return der neue Licht-Buffer
+ */
+LightBuffer* lightbuffer_createLightBuffer(void);
+
+/**
+ * Lädt die übergebenen Lichter in den Buffer hoch. Es werden höchstens
+ * LIGHTBUFFER_MAX_POINT_LIGHTS Punktlichter und LIGHTBUFFER_MAX_DIR_LIGHTS
+ * Richtungslichter übernommen.
+ *
+ * @param buffer der Licht-Buffer
+ * @param pointLights die Punktlichter
+ * @param pointCount die Anzahl der Punktlichter
+ * @param dirLights die Richtungslichter
+ * @param dirCount die Anzahl der Richtungslichter
+ */
+void lightbuffer_updateLightBuffer(LightBuffer* buffer,
+                                   PointLight** pointLights, int pointCount,
+                                   DirLight** dirLights, int dirCount);
+
+/**
+ * Bindet den Buffer an den Uniform Block "Lights" des Shaders.
+ *
+ * @param buffer der Licht-Buffer
+ * @param shader der Shader, der die Lichter auswertet
+ */
+void lightbuffer_bindLightBuffer(LightBuffer* buffer, Shader* shader);
+
+/**
+ * Löscht den Licht-Buffer.
+ *
+ * @param buffer der zu löschende Licht-Buffer
+ */
+void lightbuffer_deleteLightBuffer(LightBuffer* buffer);
+
+#endif // LIGHTBUFFER_H
@@ -0,0 +1,613 @@
+/**
+ * Modul zum Einsortieren von Punktlichtern in Bildschirmkacheln (Tiled
+ * Deferred Shading) bzw. in ein dreidimensionales Raster aus Clustern
+ * (Clustered Shading).
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#include "lightgrid.h"
+
+#include <float.h>
+#include <string.h>
+
+#include "utils.h"
+
+// Der Test Kugel gegen Bounding Box wird mit SSE für vier Cluster auf
+// einmal ausgeführt, wenn der Compiler es unterstützt.
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define LIGHTGRID_USE_SSE
+    #include <xmmintrin.h>
+#endif
+
+////////////////////////////////// KONSTANTEN //////////////////////////////////
+
+// Anzahl der RGBA-Texel, die ein Licht im Licht-Buffer belegt
+#define LIGHTGRID_TEXELS_PER_LIGHT 5
+
+// Anzahl der Cluster, die gemeinsam getestet werden
+#define LIGHTGRID_SIMD_WIDTH 4
+
+////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
+
+// Ein Buffer-Objekt, das im Shader als samplerBuffer gelesen wird.
+typedef struct
+{
+    GLuint buffer;
+    GLuint texture;
+} LightGridBuffer;
+
+struct LightGrid
+{
+    LightGridBuffer lights;      // Lichtdaten, 5 Texel pro Licht
+    LightGridBuffer cells;       // Offset und Anzahl der Lichter pro Zelle
+    LightGridBuffer cellLights;  // Lichtindizes aller Zellen hintereinander
+
+    float* lightData;            // CPU-Kopie der Lichtdaten
+    int lightDataCapacity;
+
+    GLuint* pairs;               // Paare aus Zelle und Licht vor dem Sortieren
+    int pairCapacity;
+    int pairCount;
+
+    GLuint* cellData;            // CPU-Kopie von Offset und Anzahl
+    int cellCapacity;
+
+    GLuint* indexData;           // CPU-Kopie der Lichtindizes
+    int indexCapacity;
+
+    // Bounding Boxen der Cluster im View-Space als Structure of Arrays,
+    // damit jeweils vier Cluster mit einem Befehl geladen werden können.
+    float* bounds;
+    int boundsCapacity;
+    float* boundsMin[3];
+    float* boundsMax[3];
+
+    // Alles, wovon die Form der Cluster abhängt. Die Verschiebung der
+    // Projektion durch den Jitter der temporalen Rekonstruktion gehört nicht
+    // dazu, sonst müssten die Bounding Boxen in jedem Frame neu entstehen.
+    vec2 boundsScale;
+    float boundsNear;
+    float boundsFar;
+    int boundsWidth;
+    int boundsHeight;
+    int boundsTileSize;
+    int boundsSliceCount;
+
+    // Aufteilung des aktuellen Rasters
+    int tileSize;
+    int tileCountX;
+    int tileCountY;
+    int sliceCount;
+    float sliceScale;
+    float sliceBias;
+
+    LightGridStats stats;
+};
+
+////////////////////////////// LOKALE FUNKTIONEN ///////////////////////////////
+
+/**
+ * Erzeugt einen leeren Buffer samt Buffer-Textur.
+ *
+ * @param buffer der zu initialisierende Buffer
+ * @param format das interne Format der Buffer-Textur
+ * @param label der Name für Debug-Ausgaben
+ */
+static void lightgrid_createBuffer(LightGridBuffer* buffer, GLenum format, const char* label)
+{
+    glGenBuffers(1, &buffer->buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer->buffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(GLfloat) * 4, NULL, GL_STREAM_DRAW);
+    common_labelObjectByType(GL_BUFFER, buffer->buffer, label);
+
+    glGenTextures(1, &buffer->texture);
+    glBindTexture(GL_TEXTURE_BUFFER, buffer->texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, buffer->buffer);
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+/**
+ * Lädt neue Daten in einen Buffer. Der alte Speicher wird dabei verworfen,
+ * damit der Treiber nicht auf Draw-Calls des letzten Frames warten muss.
+ *
+ * @param buffer der Buffer
+ * @param data die Daten
+ * @param size die Größe der Daten in Bytes
+ */
+static void lightgrid_uploadBuffer(LightGridBuffer* buffer, const void* data, GLsizeiptr size)
+{
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer->buffer);
+    if (size > 0)
+    {
+        glBufferData(GL_TEXTURE_BUFFER, size, data, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+/**
+ * Löscht einen Buffer samt Buffer-Textur.
+ *
+ * @param buffer der zu löschende Buffer
+ */
+static void lightgrid_deleteBuffer(LightGridBuffer* buffer)
+{
+    glDeleteTextures(1, &buffer->texture);
+    glDeleteBuffers(1, &buffer->buffer);
+}
+
+/**
+ * Vergrößert ein Array, falls es nicht mindestens count Elemente fasst.
+ *
+ * @param array das Array
+ * @param capacity die aktuelle Kapazität in Elementen
+ * @param count die benötigte Anzahl an Elementen
+ * @param elementSize die Größe eines Elements in Bytes
+ */
+static void lightgrid_reserve(void** array, int* capacity, int count, size_t elementSize)
+{
+    if (count <= *capacity)
+    {
+        return;
+    }
+
+    int newCapacity = *capacity > 0 ? *capacity : 64;
+    while (newCapacity < count)
+    {
+        newCapacity *= 2;
+    }
+
+    *array = realloc(*array, elementSize * newCapacity);
+    *capacity = newCapacity;
+}
+
+/**
+ * Schreibt ein Licht in die CPU-Kopie des Licht-Buffers.
+ *
+ * @param grid das Lichtraster
+ * @param index der Index des Lichts im Buffer
+ * @param light das Licht
+ * @param radius der Radius des Lichts
+ * @param shadowSlot der Slot des Lichts im Schatten-Atlas oder -1
+ */
+static void lightgrid_storeLight(LightGrid* grid, int index, const PointLight* light, float radius, int shadowSlot)
+{
+    float* data = grid->lightData + index * LIGHTGRID_TEXELS_PER_LIGHT * 4;
+    glm_vec3_copy((float*) light->position, data + 0);
+    data[3] = radius;
+    glm_vec3_copy((float*) light->ambient, data + 4);
+    data[7] = light->constant;
+    glm_vec3_copy((float*) light->diffuse, data + 8);
+    data[11] = light->linear;
+    glm_vec3_copy((float*) light->specular, data + 12);
+    data[15] = light->quadratic;
+    data[16] = (float) shadowSlot;
+    data[17] = 0.0f;
+    data[18] = 0.0f;
+    data[19] = 0.0f;
+}
+
+/**
+ * Merkt sich, dass ein Licht eine Zelle berührt.
+ *
+ * @param grid das Lichtraster
+ * @param cell der Index der Zelle
+ * @param light der Index des Lichts
+ */
+static void lightgrid_addPair(LightGrid* grid, int cell, int light)
+{
+    lightgrid_reserve((void**) &grid->pairs, &grid->pairCapacity, (grid->pairCount + 1) * 2, sizeof(GLuint));
+    grid->pairs[grid->pairCount * 2] = (GLuint) cell;
+    grid->pairs[grid->pairCount * 2 + 1] = (GLuint) light;
+    grid->pairCount++;
+}
+
+/**
+ * Erstellt aus den gesammelten Paaren die Listen pro Zelle (Counting Sort)
+ * und lädt alle Daten auf die GPU hoch.
+ *
+ * @param grid das Lichtraster
+ * @param cellCount die Anzahl der Zellen
+ * @param visibleLights die Anzahl der sichtbaren Lichter
+ */
+static void lightgrid_buildLists(LightGrid* grid, int cellCount, int visibleLights)
+{
+    lightgrid_reserve((void**) &grid->cellData, &grid->cellCapacity, cellCount * 2, sizeof(GLuint));
+    memset(grid->cellData, 0, sizeof(GLuint) * 2 * cellCount);
+
+    // Zuerst die Lichter pro Zelle zählen.
+    for (int i = 0; i < grid->pairCount; i++)
+    {
+        grid->cellData[grid->pairs[i * 2] * 2 + 1]++;
+    }
+
+    // Aus den Anzahlen ergeben sich die Offsets der Listen.
+    GLuint total = 0;
+    int maxLights = 0;
+    for (int i = 0; i < cellCount; i++)
+    {
+        const GLuint lightCount = grid->cellData[i * 2 + 1];
+        grid->cellData[i * 2] = total;
+        grid->cellData[i * 2 + 1] = 0;
+        total += lightCount;
+        maxLights = utils_maxInt(maxLights, (int) lightCount);
+    }
+
+    // Danach die Listen füllen. Die Reihenfolge der Lichter bleibt erhalten.
+    lightgrid_reserve((void**) &grid->indexData, &grid->indexCapacity, (int) total, sizeof(GLuint));
+    for (int i = 0; i < grid->pairCount; i++)
+    {
+        GLuint* cell = grid->cellData + grid->pairs[i * 2] * 2;
+        grid->indexData[cell[0] + cell[1]] = grid->pairs[i * 2 + 1];
+        cell[1]++;
+    }
+
+    grid->stats.visibleLights = visibleLights;
+    grid->stats.cellCount = cellCount;
+    grid->stats.maxLightsPerCell = maxLights;
+    grid->stats.indexCount = (int) total;
+
+    lightgrid_uploadBuffer(&grid->lights, grid->lightData,
+                           (GLsizeiptr) (sizeof(float) * 4 * LIGHTGRID_TEXELS_PER_LIGHT * visibleLights));
+    lightgrid_uploadBuffer(&grid->cells, grid->cellData, (GLsizeiptr) (sizeof(GLuint) * 2 * cellCount));
+    lightgrid_uploadBuffer(&grid->cellLights, grid->indexData, (GLsizeiptr) (sizeof(GLuint) * total));
+}
+
+/**
+ * Berechnet die Bounding Boxen aller Cluster im View-Space. Das passiert nur,
+ * wenn sich Öffnungswinkel, Seitenverhältnis, Near- und Far-Plane,
+ * Bildschirmgröße oder die Aufteilung des Rasters geändert haben.
+ *
+ * @param grid das Lichtraster
+ * @param projection die Projektionsmatrix der Kamera
+ * @param zNear die Near-Plane der Kamera
+ * @param zFar die Far-Plane der Kamera
+ * @param width die Breite des Bildschirms
+ * @param height die Höhe des Bildschirms
+ */
+static void lightgrid_updateClusterBounds(LightGrid* grid, mat4 projection, float zNear, float zFar,
+                                          int width, int height)
+{
+    if (grid->bounds != NULL && grid->boundsWidth == width && grid->boundsHeight == height
+        && grid->boundsScale[0] == projection[0][0] && grid->boundsScale[1] == projection[1][1]
+        && grid->boundsNear == zNear && grid->boundsFar == zFar
+        && grid->boundsTileSize == grid->tileSize && grid->boundsSliceCount == grid->sliceCount)
+    {
+        return;
+    }
+
+    const int clusterCount = grid->tileCountX * grid->tileCountY * grid->sliceCount;
+
+    // Am Ende wird Platz für einen vollen SIMD-Block gelassen, damit beim
+    // Laden der letzten Cluster nicht über das Array hinaus gelesen wird.
+    const int stride = clusterCount + LIGHTGRID_SIMD_WIDTH;
+    lightgrid_reserve((void**) &grid->bounds, &grid->boundsCapacity, stride * 6, sizeof(float));
+    memset(grid->bounds, 0, sizeof(float) * stride * 6);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        grid->boundsMin[axis] = grid->bounds + axis * stride;
+        grid->boundsMax[axis] = grid->bounds + (3 + axis) * stride;
+    }
+
+    for (int z = 0; z < grid->sliceCount; z++)
+    {
+        const float depths[2] = {
+            zNear * powf(zFar / zNear, (float) z / (float) grid->sliceCount),
+            zNear * powf(zFar / zNear, (float) (z + 1) / (float) grid->sliceCount)
+        };
+
+        for (int y = 0; y < grid->tileCountY; y++)
+        {
+            const float ndcY[2] = {
+                (float) (y * grid->tileSize) / (float) height * 2.0f - 1.0f,
+                (float) utils_minInt((y + 1) * grid->tileSize, height) / (float) height * 2.0f - 1.0f
+            };
+
+            for (int x = 0; x < grid->tileCountX; x++)
+            {
+                const float ndcX[2] = {
+                    (float) (x * grid->tileSize) / (float) width * 2.0f - 1.0f,
+                    (float) utils_minInt((x + 1) * grid->tileSize, width) / (float) width * 2.0f - 1.0f
+                };
+
+                // Die acht Ecken des Froxels ergeben sich aus den Strahlen
+                // durch die Kachelecken in beiden Tiefen.
+                vec3 boxMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+                vec3 boxMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+                for (int i = 0; i < 8; i++)
+                {
+                    const float depth = depths[(i >> 2) & 1];
+                    vec3 corner = {
+                        ndcX[i & 1] * depth / projection[0][0],
+                        ndcY[(i >> 1) & 1] * depth / projection[1][1],
+                        -depth
+                    };
+                    glm_vec3_minv(boxMin, corner, boxMin);
+                    glm_vec3_maxv(boxMax, corner, boxMax);
+                }
+
+                const int cluster = (z * grid->tileCountY + y) * grid->tileCountX + x;
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    grid->boundsMin[axis][cluster] = boxMin[axis];
+                    grid->boundsMax[axis][cluster] = boxMax[axis];
+                }
+            }
+        }
+    }
+
+    grid->boundsScale[0] = projection[0][0];
+    grid->boundsScale[1] = projection[1][1];
+    grid->boundsNear = zNear;
+    grid->boundsFar = zFar;
+    grid->boundsWidth = width;
+    grid->boundsHeight = height;
+    grid->boundsTileSize = grid->tileSize;
+    grid->boundsSliceCount = grid->sliceCount;
+}
+
+/**
+ * Testet eine Kugel gegen vier aufeinanderfolgende Cluster.
+ *
+ * @param grid das Lichtraster
+ * @param first der Index des ersten Clusters
+ * @param center der Mittelpunkt der Kugel im View-Space
+ * @param radius der Radius der Kugel
+ * @return eine Bitmaske der Cluster, die die Kugel berührt
+ */
+static int lightgrid_testClusters(const LightGrid* grid, int first, const float center[3], float radius)
+{
+#ifdef LIGHTGRID_USE_SSE
+    const __m128 zero = _mm_setzero_ps();
+    __m128 distance = zero;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const __m128 c = _mm_set1_ps(center[axis]);
+        const __m128 lo = _mm_loadu_ps(grid->boundsMin[axis] + first);
+        const __m128 hi = _mm_loadu_ps(grid->boundsMax[axis] + first);
+
+        // Abstand des Mittelpunkts zur Box entlang dieser Achse
+        const __m128 d = _mm_add_ps(_mm_max_ps(_mm_sub_ps(lo, c), zero),
+                                    _mm_max_ps(_mm_sub_ps(c, hi), zero));
+        distance = _mm_add_ps(distance, _mm_mul_ps(d, d));
+    }
+
+    return _mm_movemask_ps(_mm_cmple_ps(distance, _mm_set1_ps(radius * radius)));
+#else
+    int mask = 0;
+    for (int i = 0; i < LIGHTGRID_SIMD_WIDTH; i++)
+    {
+        float distance = 0.0f;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            const float lo = grid->boundsMin[axis][first + i];
+            const float hi = grid->boundsMax[axis][first + i];
+            const float d = fmaxf(lo - center[axis], 0.0f) + fmaxf(center[axis] - hi, 0.0f);
+            distance += d * d;
+        }
+
+        if (distance <= radius * radius)
+        {
+            mask |= 1 << i;
+        }
+    }
+
+    return mask;
+#endif
+}
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+LightGrid* lightgrid_createLightGrid(void)
+{
+    LightGrid* grid = malloc(sizeof(LightGrid));
+    memset(grid, 0, sizeof(LightGrid));
+
+    lightgrid_createBuffer(&grid->lights, GL_RGBA32F, "Light Grid Lights");
+    lightgrid_createBuffer(&grid->cells, GL_RG32UI, "Light Grid Cells");
+    lightgrid_createBuffer(&grid->cellLights, GL_R32UI, "Light Grid Cell Lights");
+
+    return grid;
+}
+
+void lightgrid_updateTiles(LightGrid* grid, PointLight** lights, int count,
+                           const ShadowAtlas* shadowAtlas,
+                           mat4 view, mat4 projection, int width, int height)
+{
+    const double start = utils_getTime();
+
+    grid->tileSize = LIGHTGRID_TILE_SIZE;
+    grid->tileCountX = (width + grid->tileSize - 1) / grid->tileSize;
+    grid->tileCountY = (height + grid->tileSize - 1) / grid->tileSize;
+    grid->sliceCount = 1;
+    grid->sliceScale = 0.0f;
+    grid->sliceBias = 0.0f;
+
+    // Bei minimiertem Fenster gibt es nichts zu tun.
+    const int tileCount = grid->tileCountX * grid->tileCountY;
+    if (tileCount <= 0)
+    {
+        return;
+    }
+
+    // Die Anzahl der Lichter ist die Obergrenze für die sichtbaren Lichter.
+    lightgrid_reserve((void**) &grid->lightData, &grid->lightDataCapacity,
+                      count * LIGHTGRID_TEXELS_PER_LIGHT * 4, sizeof(float));
+    grid->pairCount = 0;
+
+    int visible = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const PointLight* light = lights[i];
+        const float radius = light_calcPointLightRadius(light);
+
+        int rect[4];
+        if (!light_calcPointLightScreenRect(light, radius, view, projection, width, height, rect))
+        {
+            continue;
+        }
+
+        lightgrid_storeLight(grid, visible, light, radius,
+                             shadowAtlas ? shadowatlas_getLightSlot(shadowAtlas, i) : -1);
+
+        const int x0 = rect[0] / grid->tileSize;
+        const int y0 = rect[1] / grid->tileSize;
+        const int x1 = (rect[0] + rect[2] - 1) / grid->tileSize;
+        const int y1 = (rect[1] + rect[3] - 1) / grid->tileSize;
+        for (int y = y0; y <= y1; y++)
+        {
+            for (int x = x0; x <= x1; x++)
+            {
+                lightgrid_addPair(grid, y * grid->tileCountX + x, visible);
+            }
+        }
+
+        visible++;
+    }
+
+    lightgrid_buildLists(grid, tileCount, visible);
+    grid->stats.assignmentTime = (utils_getTime() - start) * 1000.0;
+}
+
+void lightgrid_updateClusters(LightGrid* grid, PointLight** lights, int count,
+                              const ShadowAtlas* shadowAtlas,
+                              mat4 view, mat4 projection, int width, int height)
+{
+    const double start = utils_getTime();
+
+    grid->tileSize = LIGHTGRID_CLUSTER_TILE_SIZE;
+    grid->tileCountX = (width + grid->tileSize - 1) / grid->tileSize;
+    grid->tileCountY = (height + grid->tileSize - 1) / grid->tileSize;
+    grid->sliceCount = LIGHTGRID_CLUSTER_SLICES;
+
+    const int clusterCount = grid->tileCountX * grid->tileCountY * grid->sliceCount;
+    if (clusterCount <= 0)
+    {
+        return;
+    }
+
+    // Near- und Far-Plane lassen sich direkt aus der Projektionsmatrix lesen.
+    const float zNear = projection[3][2] / (projection[2][2] - 1.0f);
+    const float zFar = projection[3][2] / (projection[2][2] + 1.0f);
+
+    // Die Tiefenschicht ergibt sich aus slice = log(z) * scale + bias.
+    grid->sliceScale = (float) grid->sliceCount / logf(zFar / zNear);
+    grid->sliceBias = -logf(zNear) * grid->sliceScale;
+
+    lightgrid_updateClusterBounds(grid, projection, zNear, zFar, width, height);
+
+    lightgrid_reserve((void**) &grid->lightData, &grid->lightDataCapacity,
+                      count * LIGHTGRID_TEXELS_PER_LIGHT * 4, sizeof(float));
+    grid->pairCount = 0;
+
+    int visible = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const PointLight* light = lights[i];
+        const float radius = light_calcPointLightRadius(light);
+
+        int rect[4];
+        if (!light_calcPointLightScreenRect(light, radius, view, projection, width, height, rect))
+        {
+            continue;
+        }
+
+        vec3 center;
+        glm_mat4_mulv3(view, (float*) light->position, 1.0f, center);
+
+        // Bereich der Tiefenschichten, die die Kugel berührt
+        const float depthMin = fmaxf(-center[2] - radius, zNear);
+        const float depthMax = fminf(-center[2] + radius, zFar);
+        if (depthMin > depthMax)
+        {
+            continue;
+        }
+        const int z0 = utils_maxInt((int) floorf(logf(depthMin) * grid->sliceScale + grid->sliceBias), 0);
+        const int z1 = utils_minInt((int) floorf(logf(depthMax) * grid->sliceScale + grid->sliceBias),
+                                    grid->sliceCount - 1);
+
+        lightgrid_storeLight(grid, visible, light, radius,
+                             shadowAtlas ? shadowatlas_getLightSlot(shadowAtlas, i) : -1);
+
+        const int x0 = rect[0] / grid->tileSize;
+        const int y0 = rect[1] / grid->tileSize;
+        const int x1 = (rect[0] + rect[2] - 1) / grid->tileSize;
+        const int y1 = (rect[1] + rect[3] - 1) / grid->tileSize;
+        for (int z = z0; z <= z1; z++)
+        {
+            for (int y = y0; y <= y1; y++)
+            {
+                const int row = (z * grid->tileCountY + y) * grid->tileCountX;
+
+                // Jeweils vier Cluster einer Zeile werden gemeinsam getestet.
+                for (int x = x0; x <= x1; x += LIGHTGRID_SIMD_WIDTH)
+                {
+                    int mask = lightgrid_testClusters(grid, row + x, center, radius);
+                    mask &= (1 << utils_minInt(x1 - x + 1, LIGHTGRID_SIMD_WIDTH)) - 1;
+
+                    for (int bit = 0; mask != 0; bit++, mask >>= 1)
+                    {
+                        if (mask & 1)
+                        {
+                            lightgrid_addPair(grid, row + x + bit, visible);
+                        }
+                    }
+                }
+            }
+        }
+
+        visible++;
+    }
+
+    lightgrid_buildLists(grid, clusterCount, visible);
+    grid->stats.assignmentTime = (utils_getTime() - start) * 1000.0;
+}
+
+void lightgrid_bindLightGrid(LightGrid* grid, Shader* shader, int firstUnit)
+{
+    glActiveTexture(GL_TEXTURE0 + firstUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, grid->lights.texture);
+    shader_setInt(shader, "u_lights", firstUnit);
+
+    glActiveTexture(GL_TEXTURE0 + firstUnit + 1);
+    glBindTexture(GL_TEXTURE_BUFFER, grid->cells.texture);
+    shader_setInt(shader, "u_cells", firstUnit + 1);
+
+    glActiveTexture(GL_TEXTURE0 + firstUnit + 2);
+    glBindTexture(GL_TEXTURE_BUFFER, grid->cellLights.texture);
+    shader_setInt(shader, "u_cellLights", firstUnit + 2);
+
+    shader_setInt(shader, "u_tileSize", grid->tileSize);
+    shader_setInt(shader, "u_tileCountX", grid->tileCountX);
+    shader_setInt(shader, "u_tileCountY", grid->tileCountY);
+    shader_setInt(shader, "u_sliceCount", grid->sliceCount);
+    shader_setFloat(shader, "u_sliceScale", grid->sliceScale);
+    shader_setFloat(shader, "u_sliceBias", grid->sliceBias);
+}
+
+void lightgrid_getStats(const LightGrid* grid, LightGridStats* stats)
+{
+    *stats = grid->stats;
+}
+
+void lightgrid_deleteLightGrid(LightGrid* grid)
+{
+    if (grid == NULL)
+    {
+        return;
+    }
+
+    lightgrid_deleteBuffer(&grid->lights);
+    lightgrid_deleteBuffer(&grid->cells);
+    lightgrid_deleteBuffer(&grid->cellLights);
+
+    free(grid->lightData);
+    free(grid->pairs);
+    free(grid->cellData);
+    free(grid->indexData);
+    free(grid->bounds);
+    free(grid);
+}
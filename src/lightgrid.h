@@ -0,0 +1,125 @@
+/**
+ * Modul zum Einsortieren von Punktlichtern in Bildschirmkacheln (Tiled
+ * Deferred Shading) bzw. in ein dreidimensionales Raster aus Clustern
+ * (Clustered Shading).
+ *
+ * Beim gekachelten Verfahren wird der Bildschirm in Kacheln von
+ * LIGHTGRID_TILE_SIZE x LIGHTGRID_TILE_SIZE Pixeln aufgeteilt. Beim
+ * geclusterten Verfahren werden größere Kacheln zusätzlich logarithmisch in
+ * der Tiefe unterteilt, sodass Frusta-Stücke (Froxel) im View-Space
+ * entstehen. Für jede Zelle wird auf der CPU eine Liste der Lichter erstellt,
+ * deren Kugel die Zelle berührt. Die Lichter und Listen werden einmal pro
+ * Frame als Texture Buffer hochgeladen, sodass ein einziger Fullscreen-Pass
+ * jedes Texel des G-Buffers nur einmal lesen muss.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#ifndef LIGHTGRID_H
+#define LIGHTGRID_H
+
+#include "common.h"
+#include "light.h"
+#include "shader.h"
+#include "shadowatlas.h"
+
+// Kantenlänge einer Kachel in Pixeln beim gekachelten Verfahren
+#define LIGHTGRID_TILE_SIZE 16
+
+// Kantenlänge einer Kachel in Pixeln und Anzahl der Tiefenschichten beim
+// geclusterten Verfahren
+#define LIGHTGRID_CLUSTER_TILE_SIZE 64
+#define LIGHTGRID_CLUSTER_SLICES 24
+
+//////////////////////////// ÖFFENTLICHE DATENTYPEN ////////////////////////////
+
+// Opaker Datentyp für das Lichtraster
+struct LightGrid;
+typedef struct LightGrid LightGrid;
+
+// Statistiken des letzten Updates
+typedef struct {
+    int visibleLights;     // Lichter im Sichtbereich
+    int cellCount;         // Anzahl der Kacheln bzw. Cluster
+    int maxLightsPerCell;  // längste Liste einer Zelle
+    int indexCount;        // Einträge in allen Listen zusammen
+    double assignmentTime; // Zeit für das Einsortieren auf der CPU in ms
+} LightGridStats;
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+/**
+ * Erzeugt ein neues, leeres Lichtraster.
+ *
+ * @return das neue Lichtraster
+ */
+LightGrid* lightgrid_createLightGrid(void);
+
+/**
+ * Sortiert die Punktlichter in Bildschirmkacheln ein und lädt Lichter und
+ * Kachellisten auf die GPU hoch. Lichter außerhalb des Sichtbereichs werden
+ * dabei verworfen. Zu jedem Licht wird sein Slot im Schatten-Atlas
+ * mitgegeben, damit der Shader dieselben Schatten wie die Pässe pro Licht
+ * auswerten kann.
+ *
+ * @param grid das Lichtraster
+ * @param lights die Punktlichter
+ * @param count die Anzahl der Punktlichter
+ * @param shadowAtlas der Atlas, dem die Lichter in derselben Reihenfolge
+ *        zugeteilt wurden, oder NULL für Lichter ohne Schatten
+ * @param view die View-Matrix der Kamera
+ * @param projection die Projektionsmatrix der Kamera
+ * @param width die Breite des Bildschirms
+ * @param height die Höhe des Bildschirms
+ */
+void lightgrid_updateTiles(LightGrid* grid, PointLight** lights, int count,
+                           const ShadowAtlas* shadowAtlas,
+                           mat4 view, mat4 projection, int width, int height);
+
+/**
+ * Sortiert die Punktlichter in die Cluster ein und lädt Lichter und
+ * Clusterlisten auf die GPU hoch. Jede Lichtkugel wird dabei gegen die
+ * Bounding Box jedes Clusters in ihrem Bildschirmbereich getestet.
+ *
+ * @param grid das Lichtraster
+ * @param lights die Punktlichter
+ * @param count die Anzahl der Punktlichter
+ * @param shadowAtlas der Atlas, dem die Lichter in derselben Reihenfolge
+ *        zugeteilt wurden, oder NULL für Lichter ohne Schatten
+ * @param view die View-Matrix der Kamera
+ * @param projection die perspektivische Projektionsmatrix der Kamera
+ * @param width die Breite des Bildschirms
+ * @param height die Höhe des Bildschirms
+ */
+void lightgrid_updateClusters(LightGrid* grid, PointLight** lights, int count,
+                              const ShadowAtlas* shadowAtlas,
+                              mat4 view, mat4 projection, int width, int height);
+
+/**
+ * Bindet die Buffer des Lichtrasters an den Shader und setzt die Uniforms,
+ * mit denen der Shader die Zelle eines Fragments bestimmt. Belegt werden die
+ * drei Textur-Einheiten ab firstUnit.
+ *
+ * @param grid das Lichtraster
+ * @param shader der Shader, der die Lichter auswertet
+ * @param firstUnit die erste freie Textur-Einheit
+ */
+void lightgrid_bindLightGrid(LightGrid* grid, Shader* shader, int firstUnit);
+
+/**
+ * Liefert die Statistiken des letzten Updates.
+ *
+ * @param grid das Lichtraster
+ * @param stats Ausgabeparameter für die Statistiken
+ */
+void lightgrid_getStats(const LightGrid* grid, LightGridStats* stats);
+
+/**
+ * Löscht das Lichtraster und gibt alle Buffer frei.
+ *
+ * @param grid das zu löschende Lichtraster
+ */
+void lightgrid_deleteLightGrid(LightGrid* grid);
+
+#endif // LIGHTGRID_H
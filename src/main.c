@@ -7,6 +7,10 @@
 
 #include "window.h"
 
+#include <string.h>
+
+#include "headless.h"
+
 ////////////////////////////////// KONSTANTEN //////////////////////////////////
 
 // Titel für das Fenster je nach Build-Type anpassen.
@@ -24,8 +28,14 @@
  * @return EXIT_SUCCESS, wenn das Programm erfolgreich beendet wurde,
  *         EXIT_FAILURE wenn ein Fehler aufgetreten ist (nur über exit())
  */
-int main(void)
+int main(int argc, char** argv)
 {
+    // Im Headless-Modus wird ohne Fenster direkt in Bilddateien gerendert.
+    if (argc > 1 && strcmp(argv[1], "--headless") == 0)
+    {
+        return headless_run(argc - 2, argv + 2);
+    }
+
     // Zuerst muss das gesamte Programm initialisiert werden.
     ProgContext* ctx = window_init(WINDOW_TITLE);
 
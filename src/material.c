@@ -205,9 +205,10 @@ void material_useMaterial(Shader *shader, Material *mat) {
     // Shininess & dispFactor werden als einzelne Floats übergeben.
     shader_setFloat(shader, "u_material.shininess", mat->shininess);
 
-    // Als nächstes setzen wir die Texturen über das folgende Makro.
+    // Als nächstes setzen wir die Texturen über das folgende Makro. Ob eine
+    // Textur verwendet wird, legt die Variante des Shaders fest (siehe
+    // material_getMaps).
 #define MATERIAL_SET_TEX(idx, use, map) {                                  \
-        shader_setBool(shader, "u_material." #use, mat->use);                    \
         if (mat->use)                                                          \
         {                                                                      \
             glActiveTexture(GL_TEXTURE ## idx);                                \
@@ -236,6 +237,15 @@ void material_useMaterial(Shader *shader, Material *mat) {
 #undef MATERIAL_SET_DISPLACEMENT_MAP
 }
 
+MaterialMap material_getMaps(const Material *mat) {
+    MaterialMap maps = 0;
+    if (mat->useDiffuseMap) maps |= MATERIAL_MAP_DIFFUSE;
+    if (mat->useSpecularMap) maps |= MATERIAL_MAP_SPECULAR;
+    if (mat->useNormalMap) maps |= MATERIAL_MAP_NORMAL;
+    if (mat->useEmissionMap) maps |= MATERIAL_MAP_EMISSION;
+    return maps;
+}
+
 void material_deleteMaterial(Material *mat) {
     // Material nur löschen, wenn es existiert.
     if (mat == NULL) {
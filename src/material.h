@@ -30,6 +30,14 @@
 struct Material;
 typedef struct Material Material;
 
+// Texturen, die ein Material verwendet, als Bitmaske
+typedef enum {
+    MATERIAL_MAP_DIFFUSE  = 1 << 0,
+    MATERIAL_MAP_SPECULAR = 1 << 1,
+    MATERIAL_MAP_NORMAL   = 1 << 2,
+    MATERIAL_MAP_EMISSION = 1 << 3,
+} MaterialMap;
+
 //////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
 
 /**
@@ -83,6 +91,15 @@ Material* material_createMaterialFromAI(struct aiMaterial* aiMat,
  */
 void material_useMaterial(Shader* shader, Material* mat);
 
+/**
+ * Liefert die Texturen, die ein Material verwendet. Der Shader muss für jede
+ * davon in der passenden Variante gebunden sein.
+ *
+ * @param mat das Material
+ * @return die verwendeten Texturen als Bitmaske
+ */
+MaterialMap material_getMaps(const Material* mat);
+
 /**
  * Löscht ein Material.
  *
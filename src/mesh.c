@@ -25,6 +25,9 @@ struct Mesh
     GLuint ebo; // Element Buffer Object
 
     Material* material;
+
+    vec3 boundsMin; // Kleinste Ecke der Bounding Box
+    vec3 boundsMax; // Größte Ecke der Bounding Box
 };
 
 //////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
@@ -46,6 +49,21 @@ Mesh* mesh_createMesh(Vertex* vertices, GLuint vertexCount,
     // Außerdem übernehmen wir das Material.
     mesh->material = material;
 
+    // Die Bounding Box wird einmalig bestimmt, damit das Mesh später ohne
+    // Zugriff auf die Vertices gegen ein Sichtvolumen getestet werden kann.
+    glm_vec3_zero(mesh->boundsMin);
+    glm_vec3_zero(mesh->boundsMax);
+    if (vertexCount > 0)
+    {
+        glm_vec3_copy(vertices[0].position, mesh->boundsMin);
+        glm_vec3_copy(vertices[0].position, mesh->boundsMax);
+    }
+    for (GLuint i = 1; i < vertexCount; i++)
+    {
+        glm_vec3_minv(mesh->boundsMin, vertices[i].position, mesh->boundsMin);
+        glm_vec3_maxv(mesh->boundsMax, vertices[i].position, mesh->boundsMax);
+    }
+
     // Dann legen wir die benötigten Buffer und Objekte an.
     glGenVertexArrays(1, &mesh->vao);
     glGenBuffers(1, &mesh->vbo);
@@ -141,6 +159,82 @@ void mesh_drawMesh(Mesh* mesh, Shader* shader)
     }
 }
 
+Material* mesh_getMaterial(const Mesh* mesh)
+{
+    return mesh->material;
+}
+
+void mesh_getBounds(const Mesh* mesh, vec3 min, vec3 max)
+{
+    glm_vec3_copy((float*) mesh->boundsMin, min);
+    glm_vec3_copy((float*) mesh->boundsMax, max);
+}
+
+bool mesh_isInFrustum(const Mesh* mesh, mat4 clipFromMesh)
+{
+    // Jede Ecke bekommt ein Bit pro Ebene, vor der sie liegt. Nur wenn alle
+    // acht Ecken vor derselben Ebene liegen, ist die Box sicher unsichtbar.
+    int outside = 0x3F;
+    for (int corner = 0; corner < 8 && outside != 0; corner++)
+    {
+        vec4 position = {
+            (corner & 1) ? mesh->boundsMax[0] : mesh->boundsMin[0],
+            (corner & 2) ? mesh->boundsMax[1] : mesh->boundsMin[1],
+            (corner & 4) ? mesh->boundsMax[2] : mesh->boundsMin[2],
+            1.0f
+        };
+
+        vec4 clip;
+        glm_mat4_mulv(clipFromMesh, position, clip);
+
+        int planes = 0;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            planes |= (clip[axis] < -clip[3]) << (axis * 2);
+            planes |= (clip[axis] > clip[3]) << (axis * 2 + 1);
+        }
+        outside &= planes;
+    }
+
+    return outside == 0;
+}
+
+bool mesh_isInSphere(const Mesh* mesh, mat4 worldFromMesh, vec3 center, float radius)
+{
+    // Die transformierte Box wird wieder achsenparallel umschlossen, danach
+    // entscheidet der Abstand ihres nächsten Punkts zum Mittelpunkt.
+    vec3 worldMin, worldMax;
+    for (int corner = 0; corner < 8; corner++)
+    {
+        vec3 position = {
+            (corner & 1) ? mesh->boundsMax[0] : mesh->boundsMin[0],
+            (corner & 2) ? mesh->boundsMax[1] : mesh->boundsMin[1],
+            (corner & 4) ? mesh->boundsMax[2] : mesh->boundsMin[2]
+        };
+        glm_mat4_mulv3(worldFromMesh, position, 1.0f, position);
+
+        if (corner == 0)
+        {
+            glm_vec3_copy(position, worldMin);
+            glm_vec3_copy(position, worldMax);
+        }
+        else
+        {
+            glm_vec3_minv(worldMin, position, worldMin);
+            glm_vec3_maxv(worldMax, position, worldMax);
+        }
+    }
+
+    float distance2 = 0.0f;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const float closest = glm_clamp(center[axis], worldMin[axis], worldMax[axis]);
+        distance2 += (center[axis] - closest) * (center[axis] - closest);
+    }
+
+    return distance2 <= radius * radius;
+}
+
 void mesh_deleteMesh(Mesh* mesh)
 {
     // Nur löschen, wenn auch ein Mesh existiert.
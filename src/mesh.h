@@ -57,6 +57,46 @@ Mesh* mesh_createMesh(Vertex* vertices, GLuint vertexCount,
  */
 void mesh_drawMesh(Mesh* mesh, Shader* shader);
 
+/**
+ * Liefert das Material eines Meshes.
+ *
+ * @param mesh das Mesh
+ * @return das Material des Meshes
+ */
+Material* mesh_getMaterial(const Mesh* mesh);
+
+/**
+ * Liefert die achsenparallele Bounding Box eines Meshes.
+ *
+ * @param mesh das Mesh
+ * @param min Ausgabeparameter für die kleinste Ecke
+ * @param max Ausgabeparameter für die größte Ecke
+ */
+void mesh_getBounds(const Mesh* mesh, vec3 min, vec3 max);
+
+/**
+ * Prüft, ob die Bounding Box eines Meshes ein Sichtvolumen berühren kann.
+ * Der Test ist konservativ: Meshes, die knapp außerhalb einer Ecke des
+ * Volumens liegen, gelten noch als sichtbar.
+ *
+ * @param mesh das Mesh
+ * @param clipFromMesh die Matrix vom Mesh in den Clip Space des Volumens
+ * @return false, wenn das Mesh sicher außerhalb liegt
+ */
+bool mesh_isInFrustum(const Mesh* mesh, mat4 clipFromMesh);
+
+/**
+ * Prüft, ob die Bounding Box eines Meshes eine Kugel berühren kann, z.B. den
+ * Wirkungsbereich eines Punktlichts.
+ *
+ * @param mesh das Mesh
+ * @param worldFromMesh die Matrix vom Mesh in den Raum der Kugel
+ * @param center der Mittelpunkt der Kugel
+ * @param radius der Radius der Kugel
+ * @return false, wenn das Mesh sicher außerhalb liegt
+ */
+bool mesh_isInSphere(const Mesh* mesh, mat4 worldFromMesh, vec3 center, float radius);
+
 /**
  * Löscht ein Mesh.
  *
@@ -291,6 +291,56 @@ void model_drawModel(Model* model, Shader* shader)
     }
 }
 
+int model_drawModelInFrustum(Model* model, Shader* shader, mat4 clipFromModel)
+{
+    // Meshes, deren Bounding Box außerhalb des Volumens liegt, werden
+    // übersprungen.
+    int drawn = 0;
+    for (unsigned int i = 0; i < model->meshCount; i++)
+    {
+        if (mesh_isInFrustum(model->meshes[i], clipFromModel))
+        {
+            mesh_drawMesh(model->meshes[i], shader);
+            drawn++;
+        }
+    }
+
+    return drawn;
+}
+
+unsigned int model_getMeshCount(const Model* model)
+{
+    return model->meshCount;
+}
+
+Mesh* model_getMesh(const Model* model, unsigned int index)
+{
+    return model->meshes[index];
+}
+
+void model_getBounds(const Model* model, vec3 min, vec3 max)
+{
+    glm_vec3_zero(min);
+    glm_vec3_zero(max);
+
+    for (unsigned int i = 0; i < model->meshCount; i++)
+    {
+        vec3 meshMin, meshMax;
+        mesh_getBounds(model->meshes[i], meshMin, meshMax);
+
+        if (i == 0)
+        {
+            glm_vec3_copy(meshMin, min);
+            glm_vec3_copy(meshMax, max);
+        }
+        else
+        {
+            glm_vec3_minv(min, meshMin, min);
+            glm_vec3_maxv(max, meshMax, max);
+        }
+    }
+}
+
 void model_deleteModel(Model* model)
 {
     // Zuerst werden alle Meshes gelöscht.
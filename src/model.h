@@ -11,6 +11,7 @@
 #include "common.h"
 
 #include "shader.h"
+#include "mesh.h"
 
 //////////////////////////// ÖFFENTLICHE DATENTYPEN ////////////////////////////
 
@@ -37,6 +38,42 @@ Model* model_loadModel(const char* filename);
  */
 void model_drawModel(Model* model, Shader* shader);
 
+/**
+ * Zeigt nur die Meshes eines 3D Modells an, die ein Sichtvolumen berühren.
+ *
+ * @param model das anzuzeigende 3D Modell
+ * @param shader der zu verwendende Shader
+ * @param clipFromModel die Matrix vom Modell in den Clip Space des Volumens
+ * @return die Anzahl der gezeichneten Meshes
+ */
+int model_drawModelInFrustum(Model* model, Shader* shader, mat4 clipFromModel);
+
+/**
+ * Liefert die Anzahl der Meshes eines 3D Modells.
+ *
+ * @param model das 3D Modell
+ * @return die Anzahl der Meshes
+ */
+unsigned int model_getMeshCount(const Model* model);
+
+/**
+ * Liefert ein Mesh eines 3D Modells, z.B. um es einzeln zu testen.
+ *
+ * @param model das 3D Modell
+ * @param index der Index des Meshes
+ * @return das Mesh
+ */
+Mesh* model_getMesh(const Model* model, unsigned int index);
+
+/**
+ * Liefert die achsenparallele Bounding Box aller Meshes eines 3D Modells.
+ *
+ * @param model das 3D Modell
+ * @param min Ausgabeparameter für die kleinste Ecke
+ * @param max Ausgabeparameter für die größte Ecke
+ */
+void model_getBounds(const Model* model, vec3 min, vec3 max);
+
 /**
  * Löscht ein zuvor geladenes 3D Modell wieder.
  *
@@ -0,0 +1,360 @@
+/**
+ * Modul zum Messen der GPU-Zeit der Render-Scopes.
+ *
+ * Jeder Frame schreibt seine Zeitstempel in einen eigenen Eintrag eines Rings
+ * aus Queries. Bevor ein Eintrag wiederverwendet wird, wird er ausgelesen.
+ * Hat die GPU ihn noch nicht beantwortet, wird in diesem Frame nicht
+ * gemessen, statt auf die GPU zu warten.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#include "profiler.h"
+
+#include <string.h>
+
+////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
+
+// Ein gemessener Scope. Die Queries liegen im Eintrag des Rings an den
+// Indizes 2 * i (Beginn) und 2 * i + 1 (Ende).
+typedef struct {
+    char name[PROFILER_NAME_SIZE];
+    int parent;
+    bool closed;
+} ProfilerRecord;
+
+// Ein Eintrag im Ring, also die Messungen eines Frames
+typedef struct {
+    GLuint queries[PROFILER_MAX_SCOPES * 2];
+    bool created;
+    ProfilerRecord records[PROFILER_MAX_SCOPES];
+    int count;
+    int skipped;
+    GLuint lastQuery;
+    int frame;
+    bool issued;
+} ProfilerSlot;
+
+// Knoten des Baums beim Zusammenfassen gleichnamiger Scopes
+typedef struct {
+    const char* name;
+    int parent;
+    int firstChild;
+    int lastChild;
+    int nextSibling;
+    int calls;
+    double gpuTime;
+} ProfilerNode;
+
+// Gesamter Zustand des Profilers
+typedef struct {
+    bool enabled;
+    int frame;
+
+    // Ring der Messungen
+    ProfilerSlot slots[PROFILER_FRAMES];
+    int nextSlot;
+    int activeSlot;
+
+    // Offene Scopes des aktiven Eintrags, -1 für übersprungene Scopes. Zu
+    // tief verschachtelte Scopes werden nur gezählt, damit jedes
+    // profiler_popScope zu seinem profiler_pushScope passt.
+    int stack[PROFILER_MAX_DEPTH];
+    int depth;
+
+    // Ergebnis des zuletzt ausgelesenen Frames
+    ProfilerNode nodes[PROFILER_MAX_SCOPES];
+    ProfilerScope scopes[PROFILER_MAX_SCOPES];
+    ProfilerStats stats;
+} Profiler;
+
+///////////////////////////////// LOKALE DATEN /////////////////////////////////
+
+static Profiler g_profiler = { .activeSlot = -1 };
+
+////////////////////////////// LOKALE FUNKTIONEN ///////////////////////////////
+
+/**
+ * Sucht unter einem Knoten den Kindknoten mit dem gegebenen Namen und legt
+ * ihn an, wenn es ihn noch nicht gibt.
+ *
+ * @param count die Anzahl der bisherigen Knoten, wird ggf. erhöht
+ * @param parent der übergeordnete Knoten oder -1 für die oberste Ebene
+ * @param name der Name des Scopes
+ * @return der Index des Knotens
+ */
+static int profiler_findNode(int* count, int parent, const char* name)
+{
+    ProfilerNode* nodes = g_profiler.nodes;
+
+    // Die oberste Ebene hat keinen Knoten, ihre Einträge werden über die
+    // Verkettung der Geschwister ab dem ersten Knoten gefunden.
+    int node = parent < 0 ? (*count > 0 ? 0 : -1) : nodes[parent].firstChild;
+    int last = -1;
+    while (node >= 0)
+    {
+        if (strcmp(nodes[node].name, name) == 0)
+        {
+            return node;
+        }
+        last = node;
+        node = nodes[node].nextSibling;
+    }
+
+    node = (*count)++;
+    nodes[node] = (ProfilerNode) {
+        .name = name,
+        .parent = parent,
+        .firstChild = -1,
+        .lastChild = -1,
+        .nextSibling = -1
+    };
+
+    if (last >= 0)
+    {
+        nodes[last].nextSibling = node;
+    }
+    if (parent >= 0)
+    {
+        if (nodes[parent].firstChild < 0)
+        {
+            nodes[parent].firstChild = node;
+        }
+        nodes[parent].lastChild = node;
+    }
+
+    return node;
+}
+
+/**
+ * Liest die Zeitstempel eines Eintrags aus und fasst gleichnamige Scopes
+ * unter demselben übergeordneten Scope zusammen. Das Ergebnis ersetzt das des
+ * zuvor ausgelesenen Frames.
+ *
+ * @param slot der Eintrag, dessen Queries alle beantwortet sind
+ */
+static void profiler_resolveSlot(ProfilerSlot* slot)
+{
+    ProfilerNode* nodes = g_profiler.nodes;
+    int recordNodes[PROFILER_MAX_SCOPES];
+    int nodeCount = 0;
+
+    // Da ein Scope immer nach seinem übergeordneten Scope beginnt, ist dessen
+    // Knoten bereits angelegt.
+    for (int i = 0; i < slot->count; i++)
+    {
+        ProfilerRecord* record = &slot->records[i];
+        int parent = record->parent >= 0 ? recordNodes[record->parent] : -1;
+        int node = profiler_findNode(&nodeCount, parent, record->name);
+        recordNodes[i] = node;
+
+        if (!record->closed)
+        {
+            continue;
+        }
+
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(slot->queries[i * 2], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(slot->queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+
+        nodes[node].calls++;
+        nodes[node].gpuTime += end > begin ? (double) (end - begin) / 1000000.0 : 0.0;
+    }
+
+    // Baum in Tiefensuche ablaufen, damit jeder Eintrag auf seinen
+    // übergeordneten Eintrag folgt
+    int scopeCount = 0;
+    int depth = 0;
+    double gpuTime = 0.0;
+    int node = nodeCount > 0 ? 0 : -1;
+    while (node >= 0)
+    {
+        ProfilerScope* scope = &g_profiler.scopes[scopeCount++];
+        strncpy(scope->name, nodes[node].name, PROFILER_NAME_SIZE);
+        scope->depth = depth;
+        scope->calls = nodes[node].calls;
+        scope->gpuTime = nodes[node].gpuTime;
+
+        if (depth == 0)
+        {
+            gpuTime += nodes[node].gpuTime;
+        }
+
+        if (nodes[node].firstChild >= 0)
+        {
+            node = nodes[node].firstChild;
+            depth++;
+            continue;
+        }
+
+        while (node >= 0 && nodes[node].nextSibling < 0)
+        {
+            node = nodes[node].parent;
+            depth--;
+        }
+        if (node >= 0)
+        {
+            node = nodes[node].nextSibling;
+        }
+    }
+
+    g_profiler.stats = (ProfilerStats) {
+        .scopes = scopeCount,
+        .measuredScopes = slot->count,
+        .skippedScopes = slot->skipped,
+        .latency = g_profiler.frame - slot->frame,
+        .gpuTime = gpuTime
+    };
+}
+
+/**
+ * Setzt einen Zeitstempel in die nächste Query des aktiven Eintrags.
+ *
+ * @param slot der aktive Eintrag
+ * @param index der Index der Query
+ */
+static void profiler_writeTimestamp(ProfilerSlot* slot, int index)
+{
+    slot->lastQuery = slot->queries[index];
+    glQueryCounter(slot->lastQuery, GL_TIMESTAMP);
+}
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+void profiler_beginFrame(void)
+{
+    if (g_profiler.activeSlot >= 0)
+    {
+        ProfilerSlot* active = &g_profiler.slots[g_profiler.activeSlot];
+        active->issued = active->count > 0;
+        g_profiler.activeSlot = -1;
+    }
+
+    g_profiler.frame++;
+    g_profiler.depth = 0;
+
+    // Der nächste Eintrag ist der älteste im Ring. Ist er noch nicht
+    // beantwortet, bleibt er für den nächsten Frame stehen.
+    ProfilerSlot* slot = &g_profiler.slots[g_profiler.nextSlot];
+    if (slot->issued)
+    {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(slot->lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            return;
+        }
+
+        profiler_resolveSlot(slot);
+        slot->issued = false;
+    }
+
+    if (!g_profiler.enabled)
+    {
+        return;
+    }
+
+    if (!slot->created)
+    {
+        glGenQueries(PROFILER_MAX_SCOPES * 2, slot->queries);
+        slot->created = true;
+    }
+
+    slot->count = 0;
+    slot->skipped = 0;
+    slot->frame = g_profiler.frame;
+    g_profiler.activeSlot = g_profiler.nextSlot;
+    g_profiler.nextSlot = (g_profiler.nextSlot + 1) % PROFILER_FRAMES;
+}
+
+void profiler_setEnabled(bool enabled)
+{
+    g_profiler.enabled = enabled;
+}
+
+void profiler_pushScope(const char* name)
+{
+    if (g_profiler.activeSlot < 0)
+    {
+        return;
+    }
+
+    ProfilerSlot* slot = &g_profiler.slots[g_profiler.activeSlot];
+    int index = -1;
+    if (g_profiler.depth < PROFILER_MAX_DEPTH && slot->count < PROFILER_MAX_SCOPES)
+    {
+        index = slot->count++;
+
+        ProfilerRecord* record = &slot->records[index];
+        strncpy(record->name, name, PROFILER_NAME_SIZE - 1);
+        record->name[PROFILER_NAME_SIZE - 1] = '\0';
+        record->closed = false;
+
+        // Liegt der übergeordnete Scope nicht im Ring, kommt der Scope auf
+        // die oberste Ebene.
+        record->parent = -1;
+        for (int i = g_profiler.depth - 1; i >= 0 && record->parent < 0; i--)
+        {
+            record->parent = g_profiler.stack[i];
+        }
+
+        profiler_writeTimestamp(slot, index * 2);
+    }
+    else
+    {
+        slot->skipped++;
+    }
+
+    if (g_profiler.depth < PROFILER_MAX_DEPTH)
+    {
+        g_profiler.stack[g_profiler.depth] = index;
+    }
+    g_profiler.depth++;
+}
+
+void profiler_popScope(void)
+{
+    if (g_profiler.activeSlot < 0 || g_profiler.depth == 0)
+    {
+        return;
+    }
+
+    ProfilerSlot* slot = &g_profiler.slots[g_profiler.activeSlot];
+    g_profiler.depth--;
+    int index = g_profiler.depth < PROFILER_MAX_DEPTH ? g_profiler.stack[g_profiler.depth] : -1;
+    if (index < 0)
+    {
+        return;
+    }
+
+    profiler_writeTimestamp(slot, index * 2 + 1);
+    slot->records[index].closed = true;
+}
+
+const ProfilerScope* profiler_getScopes(int* count)
+{
+    *count = g_profiler.stats.scopes;
+    return g_profiler.scopes;
+}
+
+void profiler_getStats(ProfilerStats* stats)
+{
+    *stats = g_profiler.stats;
+}
+
+void profiler_cleanup(void)
+{
+    for (int i = 0; i < PROFILER_FRAMES; i++)
+    {
+        ProfilerSlot* slot = &g_profiler.slots[i];
+        if (slot->created)
+        {
+            glDeleteQueries(PROFILER_MAX_SCOPES * 2, slot->queries);
+        }
+    }
+
+    memset(&g_profiler, 0, sizeof(g_profiler));
+    g_profiler.activeSlot = -1;
+}
@@ -0,0 +1,107 @@
+/**
+ * Modul zum Messen der GPU-Zeit der Render-Scopes (siehe
+ * common_pushRenderScope).
+ *
+ * Jeder Scope setzt zu Beginn und am Ende einen Zeitstempel. Da der Renderer
+ * an mehreren Stellen selbst GL_TIME_ELAPSED-Queries benutzt und diese nicht
+ * verschachtelt werden dürfen, wird nur über GL_TIMESTAMP gemessen. Die
+ * Queries eines Frames werden erst PROFILER_FRAMES Frames später und nur dann
+ * ausgelesen, wenn die GPU sie bereits beantwortet hat. Scopes gleichen Namens
+ * unter demselben übergeordneten Scope, z.B. die Pässe der einzelnen
+ * Punktlichter, werden zusammengefasst.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "common.h"
+
+// Anzahl der Frames im Ring der Queries. So viele Frames darf die GPU
+// hinterherhängen, ohne dass ein Ergebnis verloren geht.
+#define PROFILER_FRAMES 3
+
+// Höchstzahl der gemessenen Scopes pro Frame, weitere werden übersprungen
+#define PROFILER_MAX_SCOPES 512
+
+// Höchste Verschachtelungstiefe der Scopes
+#define PROFILER_MAX_DEPTH 16
+
+// Maximale Länge eines Scope-Namens samt Nullzeichen
+#define PROFILER_NAME_SIZE 48
+
+//////////////////////////// ÖFFENTLICHE DATENTYPEN ////////////////////////////
+
+// Zusammengefasste GPU-Zeit aller gleichnamigen Scopes unter demselben
+// übergeordneten Scope
+typedef struct {
+    char name[PROFILER_NAME_SIZE]; // Name des Scopes
+    int depth;                     // Verschachtelungstiefe, 0 auf oberster Ebene
+    int calls;                     // Anzahl der zusammengefassten Scopes
+    double gpuTime;                // Summe ihrer GPU-Zeit in ms
+} ProfilerScope;
+
+// Statistiken des zuletzt ausgelesenen Frames
+typedef struct {
+    int scopes;         // Einträge in der Aufschlüsselung
+    int measuredScopes; // gemessene Scopes vor dem Zusammenfassen
+    int skippedScopes;  // übersprungene Scopes, weil PROFILER_MAX_SCOPES erreicht war
+    int latency;        // Alter des Frames in Frames
+    double gpuTime;     // Summe der Scopes auf oberster Ebene in ms
+} ProfilerStats;
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+/**
+ * Beginnt einen neuen Frame. Zuvor wird der älteste Frame im Ring
+ * ausgelesen, sofern die GPU alle seine Zeitstempel geschrieben hat. Scopes
+ * außerhalb eines Frames werden nicht gemessen.
+ */
+void profiler_beginFrame(void);
+
+/**
+ * Legt fest, ob die Scopes gemessen werden. Die Änderung gilt ab dem nächsten
+ * Frame.
+ *
+ * @param enabled true, um die GPU-Zeiten zu messen
+ */
+void profiler_setEnabled(bool enabled);
+
+/**
+ * Setzt den Zeitstempel zu Beginn eines Scopes.
+ *
+ * @param name der Name des Scopes, wird auf PROFILER_NAME_SIZE gekürzt
+ */
+void profiler_pushScope(const char* name);
+
+/**
+ * Setzt den Zeitstempel am Ende des zuletzt begonnenen Scopes.
+ */
+void profiler_popScope(void);
+
+/**
+ * Liefert die GPU-Zeiten des zuletzt ausgelesenen Frames. Jeder Eintrag
+ * folgt auf seinen übergeordneten Scope, die Reihenfolge entspricht also
+ * einer Baumansicht.
+ *
+ * @param count Ausgabeparameter für die Anzahl der Einträge
+ * @return die Einträge, gültig bis zum nächsten profiler_beginFrame
+ */
+const ProfilerScope* profiler_getScopes(int* count);
+
+/**
+ * Liefert die Statistiken des zuletzt ausgelesenen Frames.
+ *
+ * @param stats Ausgabeparameter für die Statistiken
+ */
+void profiler_getStats(ProfilerStats* stats);
+
+/**
+ * Löscht alle Queries. Muss vor dem Löschen des OpenGL-Kontexts aufgerufen
+ * werden.
+ */
+void profiler_cleanup(void);
+
+#endif // PROFILER_H
@@ -0,0 +1,452 @@
+/**
+ * Modul zum Aufzeichnen von Bildsequenzen (z.B. Kamerafahrten).
+ *
+ * Die Frames werden über einen Ring aus Pixel-Buffern ausgelesen, damit das
+ * Auslesen den Render-Thread nicht blockiert. Die fertigen Bilddaten werden
+ * über eine begrenzte Warteschlange an mehrere Encoder-Threads verteilt.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#include "recorder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sesp/stb_image.h>
+
+#include "thread.h"
+
+////////////////////////////////// KONSTANTEN //////////////////////////////////
+
+// Anzahl der Pixel-Buffer im Ring. Solange die GPU nicht mehr als so viele
+// Frames hinterherhängt, muss nie auf das Auslesen gewartet werden.
+#define RECORDER_PBO_COUNT 4
+
+// Anzahl der Encoder-Threads
+#define RECORDER_THREAD_COUNT 4
+
+// Maximale Anzahl an Frames, die auf einen Encoder warten dürfen
+#define RECORDER_QUEUE_SIZE 16
+
+// Maximale Länge des Dateinamens eines Frames
+#define RECORDER_FILENAME_SIZE 64
+
+////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
+
+// Ein Eintrag im Ring der Pixel-Buffer
+typedef struct {
+    GLuint pbo;
+    GLsync fence;
+    int width;
+    int height;
+} RecorderSlot;
+
+// Ein ausgelesener Frame, der kodiert werden muss
+typedef struct {
+    unsigned char* data;
+    int width;
+    int height;
+    int frameIndex;
+} RecorderJob;
+
+// Gesamter Zustand des Recorders
+typedef struct {
+    bool recording;
+    RecorderFormat format;
+    bool waitWhenFull;
+    char prefix[RECORDER_FILENAME_SIZE];
+    int nextFrameIndex;
+
+    // Ring der Pixel-Buffer, nur auf dem Render-Thread genutzt
+    RecorderSlot slots[RECORDER_PBO_COUNT];
+    int oldestSlot;
+    int pendingSlots;
+
+    // Warteschlange für die Encoder, geschützt durch mutex
+    RecorderJob queue[RECORDER_QUEUE_SIZE];
+    int queueHead;
+    int queueCount;
+    bool stopWorkers;
+    RecorderStats stats;
+
+    Mutex* mutex;
+    Condition* jobAvailable;
+    Condition* spaceAvailable;
+    Thread* workers[RECORDER_THREAD_COUNT];
+    int workerCount; // tatsächlich gestartete Encoder-Threads
+} Recorder;
+
+static Recorder g_recorder;
+
+////////////////////////////// LOKALE FUNKTIONEN ///////////////////////////////
+
+/**
+ * Schreibt einen Frame als binäres PPM. Da OpenGL die Zeilen von unten nach
+ * oben liefert, werden sie in umgekehrter Reihenfolge geschrieben.
+ *
+ * @param filename der Dateiname
+ * @param job der zu schreibende Frame
+ * @return true, wenn die Datei geschrieben werden konnte
+ */
+static bool recorder_writeRaw(const char* filename, RecorderJob* job)
+{
+    FILE* file = fopen(filename, "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    fprintf(file, "P6\n%d %d\n255\n", job->width, job->height);
+
+    size_t rowSize = (size_t) job->width * 3;
+    bool success = true;
+    for (int y = job->height - 1; y >= 0 && success; y--)
+    {
+        success = fwrite(job->data + rowSize * y, 1, rowSize, file) == rowSize;
+    }
+
+    fclose(file);
+    return success;
+}
+
+/**
+ * Schreibt einen ausgelesenen Frame im gewählten Format auf die Festplatte.
+ *
+ * @param job der zu schreibende Frame
+ */
+static void recorder_writeFrame(RecorderJob* job)
+{
+    char filename[RECORDER_FILENAME_SIZE + 16];
+    bool success;
+
+    if (g_recorder.format == RECORDER_FORMAT_RAW)
+    {
+        snprintf(filename, sizeof(filename), "%s_%06d.ppm", g_recorder.prefix, job->frameIndex);
+        success = recorder_writeRaw(filename, job);
+    }
+    else
+    {
+        snprintf(filename, sizeof(filename), "%s_%06d.png", g_recorder.prefix, job->frameIndex);
+        success = stbi_write_png(filename, job->width, job->height, 3, job->data, 0);
+    }
+
+    if (!success)
+    {
+        fprintf(stderr, "Error on recording: Could not write %s!\n", filename);
+    }
+}
+
+/**
+ * Hauptschleife eines Encoder-Threads. Nimmt so lange Frames aus der
+ * Warteschlange, bis der Recorder gestoppt wird und die Warteschlange leer
+ * ist.
+ *
+ * @param arg wird nicht genutzt
+ */
+static void recorder_worker(void* arg)
+{
+    (void) arg;
+
+    thread_lockMutex(g_recorder.mutex);
+    while (true)
+    {
+        while (g_recorder.queueCount == 0 && !g_recorder.stopWorkers)
+        {
+            thread_waitCondition(g_recorder.jobAvailable, g_recorder.mutex);
+        }
+
+        if (g_recorder.queueCount == 0)
+        {
+            break;
+        }
+
+        RecorderJob job = g_recorder.queue[g_recorder.queueHead];
+        g_recorder.queueHead = (g_recorder.queueHead + 1) % RECORDER_QUEUE_SIZE;
+        g_recorder.queueCount--;
+        thread_signalCondition(g_recorder.spaceAvailable);
+
+        // Das Kodieren passiert ohne gesperrten Mutex, damit die anderen
+        // Encoder parallel arbeiten können.
+        thread_unlockMutex(g_recorder.mutex);
+        recorder_writeFrame(&job);
+        free(job.data);
+        thread_lockMutex(g_recorder.mutex);
+
+        g_recorder.stats.encoded++;
+    }
+    thread_unlockMutex(g_recorder.mutex);
+}
+
+/**
+ * Hängt einen Frame an die Warteschlange an. Ist sie voll, wird je nach
+ * Einstellung gewartet oder der Frame verworfen. Läuft kein Encoder-Thread,
+ * wird der Frame direkt auf dem Render-Thread kodiert, da sonst niemand die
+ * Warteschlange leeren würde.
+ *
+ * @param job der Frame, dessen Daten an die Warteschlange übergehen
+ * @param wait true, wenn bei voller Warteschlange gewartet werden soll
+ */
+static void recorder_enqueue(RecorderJob job, bool wait)
+{
+    if (g_recorder.workerCount == 0)
+    {
+        recorder_writeFrame(&job);
+        free(job.data);
+
+        thread_lockMutex(g_recorder.mutex);
+        g_recorder.stats.encoded++;
+        thread_unlockMutex(g_recorder.mutex);
+        return;
+    }
+
+    thread_lockMutex(g_recorder.mutex);
+
+    while (wait && g_recorder.queueCount == RECORDER_QUEUE_SIZE)
+    {
+        thread_waitCondition(g_recorder.spaceAvailable, g_recorder.mutex);
+    }
+
+    if (g_recorder.queueCount == RECORDER_QUEUE_SIZE)
+    {
+        g_recorder.stats.dropped++;
+        free(job.data);
+    }
+    else
+    {
+        int index = (g_recorder.queueHead + g_recorder.queueCount) % RECORDER_QUEUE_SIZE;
+        g_recorder.queue[index] = job;
+        g_recorder.queueCount++;
+        thread_signalCondition(g_recorder.jobAvailable);
+    }
+
+    thread_unlockMutex(g_recorder.mutex);
+}
+
+/**
+ * Holt die ältesten fertig ausgelesenen Pixel-Buffer ab und übergibt ihre
+ * Daten an die Encoder. Die Reihenfolge der Frames bleibt dabei erhalten.
+ *
+ * @param block true, wenn auf die GPU gewartet werden soll, bis alle Buffer
+ *        abgeholt sind
+ * @param maxSlots maximale Anzahl abzuholender Buffer
+ */
+static void recorder_collect(bool block, int maxSlots)
+{
+    while (g_recorder.pendingSlots > 0 && maxSlots-- > 0)
+    {
+        RecorderSlot* slot = &g_recorder.slots[g_recorder.oldestSlot];
+
+        GLuint64 timeout = block ? GL_TIMEOUT_IGNORED : 0;
+        GLenum result = glClientWaitSync(slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            break;
+        }
+
+        glDeleteSync(slot->fence);
+        slot->fence = NULL;
+
+        // Die Daten werden kopiert, damit der Buffer sofort wieder für den
+        // nächsten Frame frei ist und nicht auf den Encoder warten muss.
+        RecorderJob job = { NULL, slot->width, slot->height, 0 };
+        size_t size = (size_t) slot->width * slot->height * 3;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+        void* mapped = result != GL_WAIT_FAILED
+            ? glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT)
+            : NULL;
+        if (mapped)
+        {
+            job.data = malloc(size);
+            memcpy(job.data, mapped, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        g_recorder.oldestSlot = (g_recorder.oldestSlot + 1) % RECORDER_PBO_COUNT;
+        g_recorder.pendingSlots--;
+
+        if (!job.data)
+        {
+            fprintf(stderr, "Error on recording: Could not read back frame!\n");
+            thread_lockMutex(g_recorder.mutex);
+            g_recorder.stats.dropped++;
+            thread_unlockMutex(g_recorder.mutex);
+            continue;
+        }
+
+        job.frameIndex = g_recorder.nextFrameIndex++;
+        recorder_enqueue(job, block || g_recorder.waitWhenFull);
+    }
+}
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+bool recorder_start(RecorderFormat format, bool waitWhenFull)
+{
+    if (g_recorder.recording)
+    {
+        return false;
+    }
+
+    memset(&g_recorder, 0, sizeof(Recorder));
+    g_recorder.format = format;
+    g_recorder.waitWhenFull = waitWhenFull;
+
+    // Alle Frames einer Aufnahme teilen sich ein Präfix mit der Startzeit.
+    time_t now = time(NULL);
+    strftime(
+        g_recorder.prefix,
+        RECORDER_FILENAME_SIZE - 1,
+        "recording_%Y-%m-%d_%H-%M-%S",
+        localtime(&now)
+    );
+
+    for (int i = 0; i < RECORDER_PBO_COUNT; i++)
+    {
+        glGenBuffers(1, &g_recorder.slots[i].pbo);
+        common_labelObjectByType(GL_BUFFER, g_recorder.slots[i].pbo, "Recorder PBO");
+    }
+
+    // Wie beim Screenshot muss vertikal gespiegelt werden.
+    stbi_flip_vertically_on_write(true);
+
+    g_recorder.mutex = thread_createMutex();
+    g_recorder.jobAvailable = thread_createCondition();
+    g_recorder.spaceAvailable = thread_createCondition();
+
+    for (int i = 0; i < RECORDER_THREAD_COUNT; i++)
+    {
+        g_recorder.workers[i] = thread_createThread(recorder_worker, NULL);
+        if (g_recorder.workers[i])
+        {
+            g_recorder.workerCount++;
+        }
+    }
+    if (g_recorder.workerCount == 0)
+    {
+        fprintf(stderr, "Error on recording: Could not start encoder threads, "
+                        "frames are encoded on the render thread!\n");
+    }
+
+    g_recorder.recording = true;
+
+    return true;
+}
+
+void recorder_stop(void)
+{
+    if (!g_recorder.recording)
+    {
+        return;
+    }
+
+    // Alle noch laufenden Auslesevorgänge abholen, dabei nichts verwerfen.
+    recorder_collect(true, RECORDER_PBO_COUNT);
+
+    // Encoder beenden, sobald die Warteschlange leer ist. Ohne Encoder-Thread
+    // wurde bereits alles beim Abholen kodiert.
+    thread_lockMutex(g_recorder.mutex);
+    g_recorder.stopWorkers = true;
+    thread_broadcastCondition(g_recorder.jobAvailable);
+    thread_unlockMutex(g_recorder.mutex);
+
+    for (int i = 0; i < RECORDER_THREAD_COUNT; i++)
+    {
+        if (g_recorder.workers[i])
+        {
+            thread_joinThread(g_recorder.workers[i]);
+            g_recorder.workers[i] = NULL;
+        }
+    }
+    g_recorder.workerCount = 0;
+
+    thread_deleteCondition(g_recorder.spaceAvailable);
+    thread_deleteCondition(g_recorder.jobAvailable);
+    thread_deleteMutex(g_recorder.mutex);
+
+    for (int i = 0; i < RECORDER_PBO_COUNT; i++)
+    {
+        glDeleteBuffers(1, &g_recorder.slots[i].pbo);
+    }
+
+    g_recorder.recording = false;
+}
+
+bool recorder_isRecording(void)
+{
+    return g_recorder.recording;
+}
+
+void recorder_captureFrame(ProgContext* ctx)
+{
+    if (!g_recorder.recording)
+    {
+        return;
+    }
+
+    common_pushRenderScope("Recorder Readback");
+
+    // Zuerst alles abholen, was die GPU inzwischen fertig hat.
+    recorder_collect(false, RECORDER_PBO_COUNT);
+
+    // Ist der Ring immer noch voll, hängt die GPU mehrere Frames hinterher.
+    // Dann wird entweder auf den ältesten Buffer gewartet oder der Frame
+    // verworfen.
+    if (g_recorder.pendingSlots == RECORDER_PBO_COUNT)
+    {
+        if (g_recorder.waitWhenFull)
+        {
+            recorder_collect(true, 1);
+        }
+        else
+        {
+            thread_lockMutex(g_recorder.mutex);
+            g_recorder.stats.dropped++;
+            thread_unlockMutex(g_recorder.mutex);
+            common_popRenderScope();
+            return;
+        }
+    }
+
+    // Den nächsten freien Buffer im Ring füllen.
+    int index = (g_recorder.oldestSlot + g_recorder.pendingSlots) % RECORDER_PBO_COUNT;
+    RecorderSlot* slot = &g_recorder.slots[index];
+    slot->width = ctx->winData->width;
+    slot->height = ctx->winData->height;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, slot->width * slot->height * 3, NULL, GL_STREAM_READ);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, slot->width, slot->height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    g_recorder.pendingSlots++;
+
+    thread_lockMutex(g_recorder.mutex);
+    g_recorder.stats.captured++;
+    thread_unlockMutex(g_recorder.mutex);
+
+    common_popRenderScope();
+}
+
+void recorder_getStats(RecorderStats* stats)
+{
+    if (!g_recorder.recording)
+    {
+        *stats = g_recorder.stats;
+        return;
+    }
+
+    thread_lockMutex(g_recorder.mutex);
+    *stats = g_recorder.stats;
+    stats->queued = g_recorder.queueCount;
+    thread_unlockMutex(g_recorder.mutex);
+
+    stats->inFlight = g_recorder.pendingSlots;
+}
@@ -0,0 +1,78 @@
+/**
+ * Modul zum Aufzeichnen von Bildsequenzen (z.B. Kamerafahrten).
+ *
+ * Die Frames werden über einen Ring aus Pixel-Buffern ausgelesen, damit das
+ * Auslesen den Render-Thread nicht blockiert. Die fertigen Bilddaten werden
+ * über eine begrenzte Warteschlange an mehrere Encoder-Threads verteilt.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include "common.h"
+
+//////////////////////////// ÖFFENTLICHE DATENTYPEN ////////////////////////////
+
+// Dateiformat der aufgezeichneten Frames
+typedef enum {
+    RECORDER_FORMAT_PNG, // komprimiert, langsamer zu kodieren
+    RECORDER_FORMAT_RAW, // unkomprimiertes PPM, sehr schnell zu schreiben
+    RECORDER_FORMAT_COUNT
+} RecorderFormat;
+
+// Statistiken der aktuellen bzw. letzten Aufnahme
+typedef struct {
+    int captured; // ausgelesene Frames
+    int encoded;  // bereits geschriebene Frames
+    int dropped;  // verworfene Frames, weil Ring oder Warteschlange voll waren
+    int queued;   // Frames, die auf einen Encoder warten
+    int inFlight; // Frames, deren Auslesen auf der GPU noch läuft
+} RecorderStats;
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+/**
+ * Startet eine neue Aufnahme. Die Frames werden im Programmverzeichnis als
+ * recording_yyyy-MM-dd_hh-mm-ss_nnnnnn.png bzw. .ppm abgelegt.
+ *
+ * @param format das Dateiformat der Frames
+ * @param waitWhenFull true, wenn der Render-Thread bei voller Warteschlange
+ *        warten soll, false, wenn Frames stattdessen verworfen werden sollen
+ * @return true, wenn die Aufnahme gestartet werden konnte
+ */
+bool recorder_start(RecorderFormat format, bool waitWhenFull);
+
+/**
+ * Beendet die laufende Aufnahme. Blockiert, bis alle ausstehenden Frames
+ * geschrieben wurden. Muss vor dem Löschen des OpenGL-Kontexts aufgerufen
+ * werden.
+ */
+void recorder_stop(void);
+
+/**
+ * Gibt an, ob aktuell aufgenommen wird.
+ *
+ * @return true, wenn eine Aufnahme läuft
+ */
+bool recorder_isRecording(void);
+
+/**
+ * Nimmt den aktuellen Inhalt des Default-Framebuffers auf und treibt die
+ * ausstehenden Auslesevorgänge voran. Muss einmal pro Frame aufgerufen
+ * werden. Ohne laufende Aufnahme passiert nichts.
+ *
+ * @param ctx der aktuelle Programmkontext
+ */
+void recorder_captureFrame(ProgContext* ctx);
+
+/**
+ * Liefert die Statistiken der aktuellen bzw. letzten Aufnahme.
+ *
+ * @param stats Ausgabeparameter für die Statistiken
+ */
+void recorder_getStats(RecorderStats* stats);
+
+#endif // RECORDER_H
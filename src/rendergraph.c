@@ -0,0 +1,538 @@
+/**
+ * Modul für einen Render-Graphen, der die Pässe eines Frames und die von
+ * ihnen gelesenen und geschriebenen Texturen beschreibt.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#include "rendergraph.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sesp/stb_ds.h>
+
+#include "utils.h"
+
+////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
+
+// Eine Ressource des aktuellen Frames
+typedef struct
+{
+    const char* name;            // Name für Fehlermeldungen und Labels
+    bool transient;              // Textur aus dem Pool statt importiert
+    RenderGraphTextureDesc desc; // Beschreibung, nur bei transienten Texturen
+    GLuint texture;              // importierte Textur oder Textur aus dem Pool
+    bool exported;               // wird nach dem Graphen noch gebraucht
+    bool clear;                  // vor dem ersten Schreiben leeren
+    GLfloat clearValue[4];       // Wert für das Leeren
+    int firstPass;               // erster laufender Pass, der sie benutzt, sonst -1
+    int lastPass;                // letzter laufender Pass, der sie benutzt, sonst -1
+} GraphResource;
+
+// Ein Pass des aktuellen Frames
+typedef struct
+{
+    const char* name;                                      // Name des Render-Scopes
+    RenderGraphExecute execute;                            // setzt die Arbeit ab
+    void* userData;                                        // Daten für execute
+    RenderGraphResource reads[RENDERGRAPH_MAX_PASS_RESOURCES];  // gelesene Ressourcen
+    int readCount;                                         // Anzahl in reads
+    RenderGraphResource writes[RENDERGRAPH_MAX_PASS_RESOURCES]; // geschriebene Ressourcen
+    int writeCount;                                        // Anzahl in writes
+    bool executed;                                         // läuft im aktuellen Frame
+} GraphPass;
+
+// Eine Textur des Pools
+typedef struct
+{
+    GLuint texture;              // die Textur
+    RenderGraphTextureDesc desc; // Format und Größe
+    int lastFrame;               // Frame, in dem sie zuletzt vergeben wurde
+    int busyUntil;               // letzter Pass dieses Frames, der sie benutzt
+} PoolTexture;
+
+struct RenderGraph
+{
+    GLuint fbo;                // FBO für transiente Ziele und das Leeren
+    GraphPass* passes;         // stb_ds Array der Pässe des Frames
+    GraphResource* resources;  // stb_ds Array der Ressourcen des Frames
+    PoolTexture* pool;         // stb_ds Array der Texturen des Pools
+    int frame;                 // Nummer des aktuellen Frames
+    RenderGraphStats stats;    // Statistiken des letzten Frames
+};
+
+////////////////////////////// LOKALE FUNKTIONEN ///////////////////////////////
+
+/**
+ * Liefert den Speicherbedarf einer Textur in MB.
+ *
+ * @param desc die Beschreibung der Textur
+ * @return der Speicherbedarf
+ */
+static double rendergraph_getMegabytes(const RenderGraphTextureDesc* desc)
+{
+    return (double) desc->width * (double) desc->height * (double) desc->bytesPerPixel
+           / (1024.0 * 1024.0);
+}
+
+/**
+ * Prüft, ob eine Textur des Pools für eine Beschreibung benutzt werden kann.
+ *
+ * @param a die erste Beschreibung
+ * @param b die zweite Beschreibung
+ * @return true, wenn Format, Größe und Filter übereinstimmen
+ */
+static bool rendergraph_matchesDesc(const RenderGraphTextureDesc* a, const RenderGraphTextureDesc* b)
+{
+    return a->internalFormat == b->internalFormat
+           && a->width == b->width && a->height == b->height
+           && a->filter == b->filter;
+}
+
+/**
+ * Fügt eine Ressource an die Liste eines Passes an.
+ *
+ * @param pass der Pass für die Fehlermeldung
+ * @param list die Liste der gelesenen oder geschriebenen Ressourcen
+ * @param count die Anzahl der Einträge in der Liste
+ * @param resource die Ressource
+ */
+static void rendergraph_addToList(const GraphPass* pass, RenderGraphResource* list, int* count,
+                                  RenderGraphResource resource)
+{
+    if (resource == RENDERGRAPH_NO_RESOURCE)
+    {
+        return;
+    }
+
+    if (*count >= RENDERGRAPH_MAX_PASS_RESOURCES)
+    {
+        fprintf(stderr, "Error: Render pass %s uses too many resources.\n", pass->name);
+        return;
+    }
+
+    list[(*count)++] = resource;
+}
+
+/**
+ * Prüft, ob ein Pass eine Ressource liest.
+ *
+ * @param pass der Pass
+ * @param resource die Ressource
+ * @return true, wenn die Ressource in den gelesenen Ressourcen steht
+ */
+static bool rendergraph_passReads(const GraphPass* pass, RenderGraphResource resource)
+{
+    for (int i = 0; i < pass->readCount; i++)
+    {
+        if (pass->reads[i] == resource)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Bestimmt, welche Pässe laufen. Der Graph wird dabei vom Ende her
+ * durchlaufen und merkt sich, welche Ressourcen später noch gelesen werden.
+ * Ein Pass läuft, wenn er eine davon schreibt. Überschreibt er sie, ohne sie
+ * selbst zu lesen, braucht niemand ihren vorherigen Inhalt.
+ *
+ * @param graph der Render-Graph
+ */
+static void rendergraph_cullPasses(RenderGraph* graph)
+{
+    const size_t resourceCount = stbds_arrlenu(graph->resources);
+    bool* needed = calloc(resourceCount + 1, sizeof(bool));
+    for (size_t i = 0; i < resourceCount; i++)
+    {
+        needed[i] = graph->resources[i].exported;
+    }
+
+    for (size_t p = stbds_arrlenu(graph->passes); p-- > 0;)
+    {
+        GraphPass* pass = &graph->passes[p];
+
+        pass->executed = false;
+        for (int i = 0; i < pass->writeCount; i++)
+        {
+            pass->executed |= needed[pass->writes[i]];
+        }
+
+        if (!pass->executed)
+        {
+            continue;
+        }
+
+        for (int i = 0; i < pass->writeCount; i++)
+        {
+            if (!rendergraph_passReads(pass, pass->writes[i]))
+            {
+                needed[pass->writes[i]] = false;
+            }
+        }
+        for (int i = 0; i < pass->readCount; i++)
+        {
+            needed[pass->reads[i]] = true;
+        }
+    }
+
+    free(needed);
+}
+
+/**
+ * Merkt sich für jede Ressource den ersten und letzten laufenden Pass, der
+ * sie benutzt.
+ *
+ * @param graph der Render-Graph
+ */
+static void rendergraph_computeLifetimes(RenderGraph* graph)
+{
+    for (size_t p = 0; p < stbds_arrlenu(graph->passes); p++)
+    {
+        const GraphPass* pass = &graph->passes[p];
+        if (!pass->executed)
+        {
+            continue;
+        }
+
+        for (int i = 0; i < pass->readCount + pass->writeCount; i++)
+        {
+            RenderGraphResource id = i < pass->readCount ? pass->reads[i] : pass->writes[i - pass->readCount];
+            GraphResource* resource = &graph->resources[id];
+            if (resource->firstPass < 0)
+            {
+                resource->firstPass = (int) p;
+            }
+            resource->lastPass = (int) p;
+        }
+    }
+}
+
+/**
+ * Vergibt eine Textur des Pools für die Lebenszeit einer Ressource. Eine
+ * Textur mit derselben Beschreibung wird wiederverwendet, wenn sie in diesem
+ * Frame noch nicht vergeben wurde oder ihr letzter Pass vor dem ersten Pass
+ * der Ressource liegt. Sonst wird eine neue Textur angelegt.
+ *
+ * @param graph der Render-Graph
+ * @param resource die transiente Ressource
+ * @return die Textur
+ */
+static GLuint rendergraph_acquireTexture(RenderGraph* graph, const GraphResource* resource)
+{
+    for (size_t i = 0; i < stbds_arrlenu(graph->pool); i++)
+    {
+        PoolTexture* entry = &graph->pool[i];
+        if (rendergraph_matchesDesc(&entry->desc, &resource->desc)
+            && (entry->lastFrame != graph->frame || entry->busyUntil < resource->firstPass))
+        {
+            entry->lastFrame = graph->frame;
+            entry->busyUntil = resource->lastPass;
+            return entry->texture;
+        }
+    }
+
+    PoolTexture entry;
+    entry.desc = resource->desc;
+    entry.lastFrame = graph->frame;
+    entry.busyUntil = resource->lastPass;
+
+    glGenTextures(1, &entry.texture);
+    glBindTexture(GL_TEXTURE_2D, entry.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, entry.desc.internalFormat, entry.desc.width, entry.desc.height, 0,
+                 entry.desc.format, entry.desc.type, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, entry.desc.filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, entry.desc.filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Spätere Ressourcen können die Textur mitbenutzen, das Label nennt die
+    // erste.
+    common_labelObjectByType(GL_TEXTURE, entry.texture, resource->name);
+
+    stbds_arrput(graph->pool, entry);
+    return entry.texture;
+}
+
+/**
+ * Vergibt die Texturen aller transienten Ressourcen, die ein laufender Pass
+ * benutzt, in der Reihenfolge ihres ersten Passes.
+ *
+ * @param graph der Render-Graph
+ */
+static void rendergraph_allocateTextures(RenderGraph* graph)
+{
+    const size_t resourceCount = stbds_arrlenu(graph->resources);
+
+    for (size_t p = 0; p < stbds_arrlenu(graph->passes); p++)
+    {
+        for (size_t i = 0; i < resourceCount; i++)
+        {
+            GraphResource* resource = &graph->resources[i];
+            if (resource->transient && resource->firstPass == (int) p)
+            {
+                resource->texture = rendergraph_acquireTexture(graph, resource);
+            }
+        }
+    }
+}
+
+/**
+ * Löscht alle Texturen des Pools, die RENDERGRAPH_POOL_FRAMES Frames lang
+ * nicht vergeben wurden.
+ *
+ * @param graph der Render-Graph
+ */
+static void rendergraph_trimPool(RenderGraph* graph)
+{
+    for (size_t i = stbds_arrlenu(graph->pool); i-- > 0;)
+    {
+        if (graph->frame - graph->pool[i].lastFrame > RENDERGRAPH_POOL_FRAMES)
+        {
+            glDeleteTextures(1, &graph->pool[i].texture);
+            stbds_arrdelswap(graph->pool, i);
+        }
+    }
+}
+
+/**
+ * Leert eine Textur über das FBO des Graphen.
+ *
+ * @param graph der Render-Graph
+ * @param resource die zu leerende Ressource
+ */
+static void rendergraph_clearTexture(RenderGraph* graph, const GraphResource* resource)
+{
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, graph->fbo);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, resource->texture, 0);
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+
+    // Der Scissor-Test der Licht-Pässe darf das Leeren nicht beschränken.
+    glDisable(GL_SCISSOR_TEST);
+    glClearBufferfv(GL_COLOR, 0, resource->clearValue);
+}
+
+/**
+ * Sammelt die Statistiken des gerade ausgeführten Frames.
+ *
+ * @param graph der Render-Graph
+ */
+static void rendergraph_updateStats(RenderGraph* graph)
+{
+    RenderGraphStats* stats = &graph->stats;
+    memset(stats, 0, sizeof(RenderGraphStats));
+
+    stats->passes = (int) stbds_arrlen(graph->passes);
+    for (size_t i = 0; i < stbds_arrlenu(graph->passes); i++)
+    {
+        if (!graph->passes[i].executed)
+        {
+            stats->culledPasses++;
+        }
+    }
+
+    for (size_t i = 0; i < stbds_arrlenu(graph->resources); i++)
+    {
+        const GraphResource* resource = &graph->resources[i];
+        if (resource->transient)
+        {
+            stats->declaredMegabytes += rendergraph_getMegabytes(&resource->desc);
+            if (resource->firstPass >= 0)
+            {
+                stats->transientTextures++;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < stbds_arrlenu(graph->pool); i++)
+    {
+        const PoolTexture* entry = &graph->pool[i];
+        const double megabytes = rendergraph_getMegabytes(&entry->desc);
+        if (entry->lastFrame == graph->frame)
+        {
+            stats->pooledTextures++;
+            stats->transientMegabytes += megabytes;
+        }
+        stats->poolMegabytes += megabytes;
+    }
+}
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+RenderGraph* rendergraph_createRenderGraph(void)
+{
+    RenderGraph* graph = malloc(sizeof(RenderGraph));
+    memset(graph, 0, sizeof(RenderGraph));
+
+    glGenFramebuffers(1, &graph->fbo);
+    common_labelObjectByType(GL_FRAMEBUFFER, graph->fbo, "Render Graph FBO");
+
+    return graph;
+}
+
+void rendergraph_beginFrame(RenderGraph* graph)
+{
+    stbds_arrsetlen(graph->passes, 0);
+    stbds_arrsetlen(graph->resources, 0);
+    graph->frame++;
+}
+
+RenderGraphResource rendergraph_importResource(RenderGraph* graph, const char* name, GLuint texture)
+{
+    GraphResource resource;
+    memset(&resource, 0, sizeof(GraphResource));
+    resource.name = name;
+    resource.texture = texture;
+    resource.firstPass = -1;
+    resource.lastPass = -1;
+
+    stbds_arrput(graph->resources, resource);
+    return (RenderGraphResource) stbds_arrlen(graph->resources) - 1;
+}
+
+RenderGraphResource rendergraph_createTexture(RenderGraph* graph, const char* name,
+                                              const RenderGraphTextureDesc* desc)
+{
+    RenderGraphResource id = rendergraph_importResource(graph, name, 0);
+    graph->resources[id].transient = true;
+    graph->resources[id].desc = *desc;
+    graph->resources[id].desc.width = utils_maxInt(1, desc->width);
+    graph->resources[id].desc.height = utils_maxInt(1, desc->height);
+
+    return id;
+}
+
+void rendergraph_exportResource(RenderGraph* graph, RenderGraphResource resource)
+{
+    graph->resources[resource].exported = true;
+}
+
+void rendergraph_clearResource(RenderGraph* graph, RenderGraphResource resource, const GLfloat value[4])
+{
+    graph->resources[resource].clear = true;
+    memcpy(graph->resources[resource].clearValue, value, sizeof(GLfloat) * 4);
+}
+
+int rendergraph_addPass(RenderGraph* graph, const char* name, RenderGraphExecute execute, void* userData)
+{
+    GraphPass pass;
+    memset(&pass, 0, sizeof(GraphPass));
+    pass.name = name;
+    pass.execute = execute;
+    pass.userData = userData;
+
+    stbds_arrput(graph->passes, pass);
+    return (int) stbds_arrlen(graph->passes) - 1;
+}
+
+void rendergraph_readResource(RenderGraph* graph, int pass, RenderGraphResource resource)
+{
+    GraphPass* graphPass = &graph->passes[pass];
+    rendergraph_addToList(graphPass, graphPass->reads, &graphPass->readCount, resource);
+}
+
+void rendergraph_writeResource(RenderGraph* graph, int pass, RenderGraphResource resource)
+{
+    GraphPass* graphPass = &graph->passes[pass];
+    rendergraph_addToList(graphPass, graphPass->writes, &graphPass->writeCount, resource);
+}
+
+void rendergraph_execute(RenderGraph* graph)
+{
+    rendergraph_cullPasses(graph);
+    rendergraph_computeLifetimes(graph);
+    rendergraph_allocateTextures(graph);
+
+    for (size_t p = 0; p < stbds_arrlenu(graph->passes); p++)
+    {
+        const GraphPass* pass = &graph->passes[p];
+        if (!pass->executed)
+        {
+            continue;
+        }
+
+        // Geleert wird direkt vor dem ersten Pass, der in die Textur schreibt.
+        // Schreibt ihn keiner, kostet das Leeren auch nichts.
+        for (int i = 0; i < pass->writeCount; i++)
+        {
+            GraphResource* resource = &graph->resources[pass->writes[i]];
+            if (resource->clear && resource->texture != 0)
+            {
+                rendergraph_clearTexture(graph, resource);
+                resource->clear = false;
+            }
+        }
+
+        common_pushRenderScope(pass->name);
+        pass->execute(pass->userData);
+        common_popRenderScope();
+    }
+
+    // Die letzte Textur wieder vom FBO lösen, sonst würde ihr Speicher beim
+    // Löschen aus dem Pool nicht freigegeben.
+    glBindFramebuffer(GL_FRAMEBUFFER, graph->fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    rendergraph_trimPool(graph);
+    rendergraph_updateStats(graph);
+}
+
+GLuint rendergraph_getTexture(const RenderGraph* graph, RenderGraphResource resource)
+{
+    return graph->resources[resource].texture;
+}
+
+void rendergraph_bindTarget(RenderGraph* graph, RenderGraphResource resource)
+{
+    const GraphResource* target = &graph->resources[resource];
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, graph->fbo);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target->texture, 0);
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    glViewport(0, 0, target->desc.width, target->desc.height);
+}
+
+void rendergraph_bindSource(RenderGraph* graph, RenderGraphResource resource)
+{
+    const GraphResource* source = &graph->resources[resource];
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, graph->fbo);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, source->texture, 0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+}
+
+void rendergraph_getStats(const RenderGraph* graph, RenderGraphStats* stats)
+{
+    *stats = graph->stats;
+}
+
+void rendergraph_releaseTextures(RenderGraph* graph)
+{
+    for (size_t i = 0; i < stbds_arrlenu(graph->pool); i++)
+    {
+        glDeleteTextures(1, &graph->pool[i].texture);
+    }
+    stbds_arrsetlen(graph->pool, 0);
+}
+
+void rendergraph_deleteRenderGraph(RenderGraph* graph)
+{
+    if (graph == NULL)
+    {
+        return;
+    }
+
+    rendergraph_releaseTextures(graph);
+    glDeleteFramebuffers(1, &graph->fbo);
+
+    stbds_arrfree(graph->passes);
+    stbds_arrfree(graph->resources);
+    stbds_arrfree(graph->pool);
+    free(graph);
+}
@@ -0,0 +1,224 @@
+/**
+ * Modul für einen Render-Graphen, der die Pässe eines Frames und die von
+ * ihnen gelesenen und geschriebenen Texturen beschreibt.
+ *
+ * Die Pässe werden in jedem Frame neu und in der Reihenfolge angemeldet, in
+ * der sie laufen sollen. Ein Pass darf also nur lesen, was ein früherer Pass
+ * geschrieben hat oder was von außen importiert wurde. Beim Ausführen wird der
+ * Graph vom Ende her durchlaufen: Ein Pass läuft nur, wenn ein später
+ * laufender Pass oder eine exportierte Ressource etwas braucht, das er
+ * schreibt. Alle übrigen Pässe entfallen samt ihrer Texturen.
+ *
+ * Transiente Texturen existieren nur vom ersten bis zum letzten laufenden
+ * Pass, der sie benutzt. Sie werden aus einem Pool vergeben, in dem eine
+ * Textur gleichen Formats und gleicher Größe mehrfach pro Frame vergeben
+ * wird, solange sich die Lebenszeiten nicht überschneiden. Texturen, die
+ * RENDERGRAPH_POOL_FRAMES Frames lang nicht gebraucht wurden, werden
+ * freigegeben.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#ifndef RENDERGRAPH_H
+#define RENDERGRAPH_H
+
+#include "common.h"
+
+// Anzahl der Frames, nach denen eine unbenutzte Textur des Pools gelöscht wird
+#define RENDERGRAPH_POOL_FRAMES 30
+
+// Höchstzahl der Ressourcen, die ein Pass lesen bzw. schreiben kann
+#define RENDERGRAPH_MAX_PASS_RESOURCES 12
+
+//////////////////////////// ÖFFENTLICHE DATENTYPEN ////////////////////////////
+
+// Handle einer Ressource, nur bis zum nächsten rendergraph_beginFrame gültig
+typedef int RenderGraphResource;
+
+// Ressource, die es nicht gibt, z.B. für abgeschaltete Stufen
+#define RENDERGRAPH_NO_RESOURCE (-1)
+
+// Beschreibung einer transienten Textur. Texturen mit gleicher Beschreibung
+// können sich im Pool denselben Speicher teilen.
+typedef struct {
+    GLenum internalFormat; // Format der Textur
+    GLenum format;         // Format der Pixeldaten beim Anlegen
+    GLenum type;           // Datentyp der Pixeldaten beim Anlegen
+    int bytesPerPixel;     // Speicherbedarf eines Texels, für die Statistik
+    int width;             // Breite in Texeln
+    int height;            // Höhe in Texeln
+    GLenum filter;         // GL_NEAREST oder GL_LINEAR
+} RenderGraphTextureDesc;
+
+// Funktion, die die Arbeit eines Passes absetzt
+typedef void (*RenderGraphExecute)(void* userData);
+
+// Statistiken des zuletzt ausgeführten Frames
+typedef struct {
+    int passes;                // angemeldete Pässe
+    int culledPasses;          // entfallene Pässe, deren Ergebnis niemand liest
+    int transientTextures;     // von laufenden Pässen benutzte transiente Texturen
+    int pooledTextures;        // dafür benutzte Texturen des Pools
+    double transientMegabytes; // Speicher dieser Texturen des Pools in MB
+    double declaredMegabytes;  // alle angemeldeten transienten Texturen einzeln in MB
+    double poolMegabytes;      // gesamter Speicher des Pools in MB
+} RenderGraphStats;
+
+// Opaker Datentyp für den Render-Graphen
+struct RenderGraph;
+typedef struct RenderGraph RenderGraph;
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+/**
+ * Erzeugt einen neuen, leeren Render-Graphen.
+ *
+ * @return der neue Render-Graph
+ */
+RenderGraph* rendergraph_createRenderGraph(void);
+
+/**
+ * Beginnt einen neuen Frame. Alle Pässe und Ressourcen des vorherigen Frames
+ * werden verworfen, die Texturen des Pools bleiben erhalten.
+ *
+ * @param graph der Render-Graph
+ */
+void rendergraph_beginFrame(RenderGraph* graph);
+
+/**
+ * Meldet eine Ressource an, die außerhalb des Graphen lebt, z.B. eine Textur
+ * des G-Buffers oder den Framebuffer des Fensters.
+ *
+ * @param graph der Render-Graph
+ * @param name der Name für Fehlermeldungen
+ * @param texture die Textur oder 0, wenn die Ressource keine einzelne Textur ist
+ * @return das Handle der Ressource
+ */
+RenderGraphResource rendergraph_importResource(RenderGraph* graph, const char* name, GLuint texture);
+
+/**
+ * Meldet eine transiente Textur an. Sie bekommt erst beim Ausführen eine
+ * Textur aus dem Pool und nur dann, wenn ein laufender Pass sie benutzt.
+ *
+ * @param graph der Render-Graph
+ * @param name der Name für Fehlermeldungen
+ * @param desc Format und Größe der Textur
+ * @return das Handle der Ressource
+ */
+RenderGraphResource rendergraph_createTexture(RenderGraph* graph, const char* name,
+                                              const RenderGraphTextureDesc* desc);
+
+/**
+ * Markiert eine Ressource als Ergebnis des Frames, das nach dem Graphen noch
+ * gebraucht wird. Pässe, die nichts zu einem Ergebnis beitragen, entfallen.
+ *
+ * @param graph der Render-Graph
+ * @param resource die Ressource
+ */
+void rendergraph_exportResource(RenderGraph* graph, RenderGraphResource resource);
+
+/**
+ * Legt fest, dass eine Textur geleert wird, bevor der erste laufende Pass in
+ * sie schreibt. Läuft keiner, entfällt auch das Leeren.
+ *
+ * @param graph der Render-Graph
+ * @param resource die Ressource, muss eine Textur mit Farbformat sein
+ * @param value der Wert, mit dem geleert wird
+ */
+void rendergraph_clearResource(RenderGraph* graph, RenderGraphResource resource, const GLfloat value[4]);
+
+/**
+ * Meldet einen Pass an. Er läuft nach allen zuvor angemeldeten Pässen.
+ *
+ * @param graph der Render-Graph
+ * @param name der Name, unter dem der Pass in RenderDoc erscheint
+ * @param execute die Funktion, die den Pass absetzt
+ * @param userData wird an execute übergeben, muss bis zum Ausführen gültig sein
+ * @return der Index des Passes
+ */
+int rendergraph_addPass(RenderGraph* graph, const char* name, RenderGraphExecute execute, void* userData);
+
+/**
+ * Gibt an, dass ein Pass eine Ressource liest. RENDERGRAPH_NO_RESOURCE wird
+ * ignoriert.
+ *
+ * @param graph der Render-Graph
+ * @param pass der Index des Passes
+ * @param resource die gelesene Ressource
+ */
+void rendergraph_readResource(RenderGraph* graph, int pass, RenderGraphResource resource);
+
+/**
+ * Gibt an, dass ein Pass eine Ressource schreibt. Liest er sie nicht auch,
+ * gilt ihr vorheriger Inhalt als vollständig überschrieben.
+ * RENDERGRAPH_NO_RESOURCE wird ignoriert.
+ *
+ * @param graph der Render-Graph
+ * @param pass der Index des Passes
+ * @param resource die geschriebene Ressource
+ */
+void rendergraph_writeResource(RenderGraph* graph, int pass, RenderGraphResource resource);
+
+/**
+ * Entfernt alle Pässe, die nichts zu einer exportierten Ressource beitragen,
+ * vergibt die Texturen des Pools und führt die übrigen Pässe in ihrer
+ * Reihenfolge aus.
+ *
+ * @param graph der Render-Graph
+ */
+void rendergraph_execute(RenderGraph* graph);
+
+/**
+ * Liefert die Textur einer Ressource. Transiente Texturen sind nur während der
+ * Pässe gültig, die sie benutzen.
+ *
+ * @param graph der Render-Graph
+ * @param resource die Ressource
+ * @return die Textur-ID
+ */
+GLuint rendergraph_getTexture(const RenderGraph* graph, RenderGraphResource resource);
+
+/**
+ * Bindet eine transiente Textur als einziges Ziel an das FBO des Graphen und
+ * setzt den Viewport auf ihre Größe. Der Aufrufer muss den Viewport danach
+ * wieder zurücksetzen.
+ *
+ * @param graph der Render-Graph
+ * @param resource die Ressource, in die gerendert wird
+ */
+void rendergraph_bindTarget(RenderGraph* graph, RenderGraphResource resource);
+
+/**
+ * Bindet eine transiente Textur als Quelle für glBlitFramebuffer an das FBO
+ * des Graphen. Das Ziel des Kopierens muss danach gebunden werden.
+ *
+ * @param graph der Render-Graph
+ * @param resource die Ressource, aus der gelesen wird
+ */
+void rendergraph_bindSource(RenderGraph* graph, RenderGraphResource resource);
+
+/**
+ * Liefert die Statistiken des zuletzt ausgeführten Frames.
+ *
+ * @param graph der Render-Graph
+ * @param stats Ausgabeparameter für die Statistiken
+ */
+void rendergraph_getStats(const RenderGraph* graph, RenderGraphStats* stats);
+
+/**
+ * Löscht alle Texturen des Pools, z.B. weil sich die Größe des Fensters
+ * geändert hat und sie nicht mehr passen.
+ *
+ * @param graph der Render-Graph
+ */
+void rendergraph_releaseTextures(RenderGraph* graph);
+
+/**
+ * Löscht den Render-Graphen und alle Texturen des Pools.
+ *
+ * @param graph der zu löschende Render-Graph
+ */
+void rendergraph_deleteRenderGraph(RenderGraph* graph);
+
+#endif // RENDERGRAPH_H
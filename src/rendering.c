@@ -7,18 +7,155 @@
 
 #include "rendering.h"
 
+#include <float.h>
+#include <math.h>
 #include <string.h>
 
 #include "shader.h"
+#include "mesh.h"
 #include "model.h"
 #include "utils.h"
 #include "input.h"
 #include "camera.h"
 #include "texture.h"
 #include "gbuffer.h"
+#include "lightgrid.h"
+#include "lightbuffer.h"
+#include "shadowatlas.h"
+#include "rendergraph.h"
+
+////////////////////////////////// KONSTANTEN //////////////////////////////////
+
+// Anzahl der Frames, die die Occlusion Queries der Lichtvolumen vorgehalten
+// werden, bevor sie ausgewertet werden. So muss nie auf die GPU gewartet werden.
+#define LIGHT_VOLUME_FRAMES 2
+
+// Auflösung der Kugel, die als Lichtvolumen gerastert wird.
+#define LIGHT_VOLUME_SECTORS 32
+#define LIGHT_VOLUME_STACKS 16
+
+// Sicherheitsabstand, ab dem die Kamera als innerhalb eines Lichtvolumens
+// gilt. Muss größer sein als der Abstand der Near-Plane-Ecken zur Kamera.
+#define LIGHT_VOLUME_CAMERA_MARGIN 0.5f
+
+// Near- und Far-Plane der Kamera
+#define CAMERA_Z_NEAR 0.1f
+#define CAMERA_Z_FAR 200.0f
+
+// Radius des Tent-Filters beim Hochskalieren der Bloom-Stufen in Texeln der
+// kleineren Stufe
+#define BLOOM_FILTER_RADIUS 1.0f
+
+// Bytes pro Pixel, mit denen der Speicherverkehr des Bloom-Effekts geschätzt
+// wird: finales Bild und Emission beim ersten Verkleinern, eine Stufe der
+// Mip-Kette sowie das RGBA16F-Ziel des früheren Gaussian-Blurs, der mit zwei
+// Iterationen (vier Pässen) in voller Auflösung lief
+#define BLOOM_SOURCE_BYTES 14.0
+#define BLOOM_LEVEL_BYTES 4.0
+#define BLOOM_LEGACY_TARGET_BYTES 8.0
+#define BLOOM_LEGACY_BLUR_PASSES 4
+
+// Anzahl der Blur-Iterationen der Tiefenunschärfe in verringerter Auflösung
+#define DOF_BLUR_ITERATIONS 2
+
+// Formate der transienten Ziele. Die Bloom-Stufen kommen ohne Alpha aus, was
+// die Bandbreite gegenüber RGBA16F halbiert. Die Tiefenunschärfe braucht den
+// Alpha-Kanal für die Entfernung zur Kamera. Das Bild vor dem Hochskalieren
+// ist bereits fertig nachbearbeitet und braucht nur 8 Bit pro Kanal.
+#define BLOOM_TARGET_FORMAT GL_R11F_G11F_B10F
+#define BLOOM_TARGET_BYTES 4
+#define DOF_TARGET_FORMAT GL_RGBA16F
+#define DOF_TARGET_BYTES 8
+#define UPSCALE_TARGET_FORMAT GL_RGBA8
+#define UPSCALE_TARGET_BYTES 4
+
+// Regelung der dynamischen Auflösung: Abweichung vom Budget, die ohne
+// Änderung hingenommen wird, und Anteil des Fehlers, der pro Frame
+// ausgeglichen wird. Die Messung ist LIGHT_VOLUME_FRAMES Frames alt, stärker
+// nachgeregelt würde die Auflösung aufschwingen.
+#define DYNAMIC_RESOLUTION_TOLERANCE 0.05f
+#define DYNAMIC_RESOLUTION_GAIN 0.2f
+
+// Voreingestelltes Budget der dynamischen Auflösung in ms (60 Hz)
+#define DYNAMIC_RESOLUTION_BUDGET 16.6f
+
+// Temporale Rekonstruktion: Anzahl der Positionen der Halton-Folge, um die
+// die Projektion verschoben wird, und Anteil des letzten Ergebnisses für ein
+// Sample in der Mitte eines Ausgabepixels. Bei halber Auflösung teilen sich
+// vier Ausgabepixel einen Texel, jeder bekommt so alle paar Frames ein nahes
+// Sample.
+#define TEMPORAL_JITTER_SAMPLES 16
+#define TEMPORAL_HISTORY_WEIGHT 0.9f
+
+// Format des Ergebnisses der temporalen Rekonstruktion. Es wird über viele
+// Frames gemittelt, mit 8 Bit pro Kanal entstünden dabei Stufen.
+#define TEMPORAL_HISTORY_FORMAT GL_RGBA16F
+
+// Textur-Einheiten der Nachbearbeitung hinter den Texturen des G-Buffers
+#define POSTPROCESS_UNIT_BLOOM DEFAULT_GBUFFER_NUM_COLORATTACH
+#define POSTPROCESS_UNIT_DOF_COLOR (DEFAULT_GBUFFER_NUM_COLORATTACH + 1)
+#define POSTPROCESS_UNIT_DOF_BLUR (DEFAULT_GBUFFER_NUM_COLORATTACH + 2)
+#define TEMPORAL_UNIT_IMAGE DEFAULT_GBUFFER_NUM_COLORATTACH
+#define TEMPORAL_UNIT_HISTORY (DEFAULT_GBUFFER_NUM_COLORATTACH + 1)
+
+// Bytes pro Pixel, mit denen der Speicherverkehr der Nachbearbeitung geschätzt
+// wird: Tiefe, finales Bild (RGBA16F), Ausgabeziel und die auf volle
+// Auflösung vergrößerte Bloom-Stufe. Texturen der Tiefenunschärfe werden pro
+// Texel in verringerter Auflösung gezählt.
+#define POSTPROCESS_DEPTH_BYTES 4.0
+#define POSTPROCESS_FINAL_BYTES 8.0
+#define POSTPROCESS_OUTPUT_BYTES 4.0
+#define POSTPROCESS_BLOOM_BYTES 1.0
+#define POSTPROCESS_DOF_TEXEL_BYTES 8.0
+
+// Anzahl der Einträge einer Tabelle mit den Defines von Shader-Varianten
+#define VARIANT_DEFINE_COUNT(defines) ((int) (sizeof(defines) / sizeof((defines)[0])))
 
 ////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
 
+/**
+ * Bits für die Varianten des Modell-Shaders. Die unteren vier Bits entsprechen
+ * den Texturen des Materials (MaterialMap).
+ */
+typedef enum ModelVariant {
+    MODEL_VARIANT_DIFFUSE_MAP = MATERIAL_MAP_DIFFUSE,
+    MODEL_VARIANT_SPECULAR_MAP = MATERIAL_MAP_SPECULAR,
+    MODEL_VARIANT_NORMAL_MAP = MATERIAL_MAP_NORMAL,
+    MODEL_VARIANT_EMISSION_MAP = MATERIAL_MAP_EMISSION,
+    MODEL_VARIANT_TWO_CHANNEL_NORMAL_MAP = 1 << 4,
+    MODEL_VARIANT_TESSELLATION = 1 << 5,
+    MODEL_VARIANT_DISPLACEMENT = 1 << 6,
+    MODEL_VARIANT_VELOCITY = 1 << 7,
+} ModelVariant;
+
+// Defines der Modell-Varianten, ein Eintrag pro Bit von ModelVariant
+static const char *const MODEL_VARIANT_DEFINES[] = {
+    "DIFFUSE_MAP", "SPECULAR_MAP", "NORMAL_MAP", "EMISSION_MAP",
+    "TWO_CHANNEL_NORMAL_MAP", "TESSELLATION", "DISPLACEMENT", "VELOCITY"
+};
+
+/**
+ * Bits für die Varianten der Licht-Shader. Jeder Shader wertet nur die Bits
+ * aus, die er kennt.
+ */
+typedef enum LightVariant {
+    LIGHT_VARIANT_POINT_LIGHTS = 1 << 0,
+    LIGHT_VARIANT_DIR_LIGHTS = 1 << 1,
+    LIGHT_VARIANT_SHADOWS = 1 << 2,
+    LIGHT_VARIANT_PCF = 1 << 3,
+} LightVariant;
+
+// Defines der Licht-Varianten, ein Eintrag pro Bit von LightVariant
+static const char *const LIGHT_VARIANT_DEFINES[] = {
+    "POINT_LIGHTS", "DIR_LIGHTS", "SHADOWS", "PCF"
+};
+
+// Defines der Nachbearbeitung, ein Eintrag pro Bit von PostprocessStage.
+// Belichtung und Tiefenunschärfe verändern die eingebundene Funktion nicht.
+static const char *const POSTPROCESS_VARIANT_DEFINES[] = {
+    "FOG", "BLOOM", NULL, "SKYBOX", NULL
+};
+
 /**
  * Struktur zur Speicherung der Transformationsdaten.
  */
@@ -33,17 +170,13 @@ typedef struct Transform {
  */
 typedef struct Skybox {
     bool skyboxEnabled; /**< Gibt an, ob die Skybox aktiviert ist. */
-    Shader *shader; /**< Der Shader der Skybox. */
     GLuint cubemapTexture; /**< Die Textur der Skybox. */
-    GLuint skyboxVAO, skyboxVBO; /**< Vertex Array Object und Vertex Buffer Object der Skybox. */
-    GLsizei skyboxVertexCount; /**< Anzahl der Vertices der Skybox. */
 } Skybox;
 
 /**
  * Struktur zur Speicherung der Nebeldaten.
  */
 typedef struct Fog {
-    Shader *shader; /**< Der Shader für den Nebel. */
     bool fogEnabled; /**< Gibt an, ob der Nebel aktiviert ist. */
     float fogDensity; /**< Die Dichte des Nebels. */
     vec3 color; /**< Die Farbe des Nebels. */
@@ -81,6 +214,118 @@ typedef struct FullscreenQuad {
     GLuint quadVAO, quadVBO; /**< Vertex Array Object und Vertex Buffer Object des Fullscreen-Quads. */
 } FullscreenQuad;
 
+/**
+ * Struktur zur Speicherung der Occlusion Queries eines Frames, mit denen die
+ * Anzahl der beleuchteten Pixel der Punktlichter gezählt wird.
+ */
+typedef struct LightVolumeFrame {
+    GLuint *queries; /**< Die Queries, eine pro gezeichnetem Punktlicht. */
+    int queryCount; /**< Anzahl der in diesem Frame benutzten Queries. */
+    int queryCapacity; /**< Anzahl der bereits erzeugten Queries. */
+    int volumeLights; /**< Anzahl der über ihr Volumen gezeichneten Punktlichter. */
+    int fullscreenLights; /**< Anzahl der als Fullscreen-Quad gezeichneten Punktlichter. */
+    int skippedLights; /**< Anzahl der Punktlichter außerhalb des Sichtbereichs. */
+    int scissoredLights; /**< Anzahl der Punktlichter mit verkleinertem Scissor-Rechteck. */
+    GLuint64 screenPixels; /**< Anzahl der Pixel des Bildschirms in diesem Frame. */
+} LightVolumeFrame;
+
+/**
+ * Struktur zur Speicherung der Lichtvolumen der Punktlichter.
+ */
+typedef struct LightVolume {
+    bool enabled; /**< Gibt an, ob die Punktlichter über ihr Volumen gezeichnet werden. */
+    bool useScissor; /**< Gibt an, ob die Pässe auf den Bildschirmbereich des Lichts begrenzt werden. */
+    GLuint vao, vbo, ebo; /**< Die Buffer der Einheitskugel. */
+    GLsizei indexCount; /**< Anzahl der Indizes der Einheitskugel. */
+    float scaleCorrection; /**< Faktor, damit die Kugel aus Dreiecken die echte Kugel umschließt. */
+    LightVolumeFrame frames[LIGHT_VOLUME_FRAMES]; /**< Die Queries der letzten Frames. */
+    int frameIndex; /**< Index des aktuellen Frames in frames. */
+    LightVolumeStats stats; /**< Die zuletzt ausgewerteten Statistiken. */
+} LightVolume;
+
+/**
+ * Struktur zur Messung der Kosten eines Abschnitts aus mehreren Pässen, z.B.
+ * der Beleuchtung oder des Bloom-Effekts. Die Timer Queries der letzten
+ * Frames werden reihum benutzt und ohne Warten ausgelesen.
+ */
+typedef struct PassTimer {
+    GLuint queries[LIGHT_VOLUME_FRAMES]; /**< Die Timer Queries der letzten Frames. */
+    bool issued[LIGHT_VOLUME_FRAMES]; /**< Gibt an, ob die Query eines Slots ein Ergebnis liefern wird. */
+    int frameIndex; /**< Index des aktuellen Frames in queries. */
+    double shadingTime; /**< Die zuletzt gemessene GPU-Zeit in Millisekunden. */
+    double cpuStart; /**< Startzeit des Abschnitts auf der CPU in Sekunden. */
+    double submissionTime; /**< CPU-Zeit für das Absetzen des Abschnitts in Millisekunden. */
+    int passes; /**< Anzahl der Draw-Calls im aktuellen Frame. */
+    int lastPasses; /**< Anzahl der Draw-Calls im letzten Frame. */
+} PassTimer;
+
+/**
+ * Struktur für die dynamische Auflösung. Alle Ziele sind für die volle Größe
+ * des Fensters angelegt, gerendert wird aber nur in einen Teil davon, dessen
+ * Größe aus der gemessenen GPU-Zeit des ganzen Frames geregelt wird. Da
+ * einzelne Pässe bereits eigene Timer Queries für GL_TIME_ELAPSED benutzen,
+ * die sich nicht verschachteln lassen, wird der Frame über Zeitstempel
+ * gemessen.
+ */
+typedef struct DynamicResolution {
+    bool enabled; /**< Gibt an, ob die Skalierung geregelt wird, sonst gilt fixedScale. */
+    float fixedScale; /**< Die Skalierung ohne Regelung. */
+    float budget; /**< Die angestrebte GPU-Zeit eines Frames in Millisekunden. */
+    float scale; /**< Der Anteil der Kantenlängen des Fensters, in den gerendert wird. */
+    int width; /**< Die Breite, in die im aktuellen Frame gerendert wird. */
+    int height; /**< Die Höhe, in die im aktuellen Frame gerendert wird. */
+    GLuint queries[LIGHT_VOLUME_FRAMES][2]; /**< Die Zeitstempel zu Beginn und Ende der letzten Frames. */
+    bool issued[LIGHT_VOLUME_FRAMES]; /**< Gibt an, ob die Zeitstempel eines Slots ein Ergebnis liefern werden. */
+    float issuedScales[LIGHT_VOLUME_FRAMES]; /**< Die Skalierung, mit der der Frame eines Slots gerendert wurde. */
+    bool issuedNative[LIGHT_VOLUME_FRAMES]; /**< Gibt an, ob der Frame eines Slots in voller Auflösung ohne Rekonstruktion lief. */
+    int frameIndex; /**< Index des aktuellen Frames in queries. */
+    double gpuTime; /**< Die zuletzt gemessene GPU-Zeit eines Frames in Millisekunden. */
+    float measuredScale; /**< Die Skalierung, zu der gpuTime gehört. */
+    bool hasMeasurement; /**< Gibt an, ob gpuTime noch nicht für die Regelung benutzt wurde. */
+    double nativeGpuTime; /**< Die zuletzt gemessene GPU-Zeit eines Frames in voller Auflösung ohne Rekonstruktion. */
+} DynamicResolution;
+
+/**
+ * Struktur für die temporale Rekonstruktion. Die Projektion wird in jedem
+ * Frame um eine andere Position der Halton-Folge verschoben. Das Ergebnis in
+ * voller Auflösung liegt abwechselnd in einer von zwei Texturen, aus der
+ * anderen wird das Ergebnis des letzten Frames gelesen. Die Matrizen ohne
+ * Jitter werden nur in diesem Modus gebraucht, von der Variante VELOCITY des
+ * Geometry-Pass für die Bewegungsvektoren und beim Zurückprojizieren des
+ * letzten Ergebnisses. Nachgeführt werden sie in jedem Frame, damit beim
+ * Umschalten schon die Matrizen des letzten Frames vorliegen.
+ */
+typedef struct TemporalUpscaling {
+    UpscalingMode mode; /**< Das Verfahren, mit dem auf das Ausgabeziel hochskaliert wird. */
+    int jitterIndex; /**< Index der aktuellen Position in der Halton-Folge. */
+    vec2 jitter; /**< Die Verschiebung der Projektion in Pixeln des gerenderten Bildes. */
+    mat4 viewProjection; /**< Die View-Projektions-Matrix des aktuellen Frames ohne Jitter. */
+    mat4 prevViewProjection; /**< Die View-Projektions-Matrix des letzten Frames ohne Jitter. */
+    mat4 prevModel; /**< Die Modellmatrix des letzten Frames. */
+    bool hasPrevious; /**< Gibt an, ob die Matrizen des letzten Frames gesetzt sind. */
+    GLuint framebuffer; /**< Das FBO, über das die Rekonstruktion in history schreibt. */
+    GLuint history[2]; /**< Die Ergebnisse dieses und des letzten Frames in voller Auflösung. */
+    int historyIndex; /**< Index des Ergebnisses des letzten Frames in history. */
+    int historyWidth; /**< Die Breite der Texturen in history. */
+    int historyHeight; /**< Die Höhe der Texturen in history. */
+    bool historyValid; /**< Gibt an, ob das Ergebnis des letzten Frames zum aktuellen passt. */
+    bool resolved; /**< Gibt an, ob die Rekonstruktion im aktuellen Frame gelaufen ist. */
+    PassTimer timer; /**< Die Zeitmessung der Rekonstruktion. */
+} TemporalUpscaling;
+
+/**
+ * Struktur für den Plan der Nachbearbeitung. Er legt fest, welche Stufen pro
+ * Pixel aktiv sind und in welchen Pässen sie ausgewertet werden, und schätzt
+ * die Kosten im Vergleich zu einzelnen Pässen pro Stufe.
+ */
+typedef struct PostprocessPlan {
+    int stages; /**< Bitmaske der aktiven PostprocessStage. */
+    int passes; /**< Anzahl der Fullscreen-Pässe in voller Auflösung. */
+    double bytesPerPixel; /**< Geschätzter Speicherverkehr pro Pixel des Bildschirms. */
+    int separatePasses; /**< Anzahl der Pässe, wenn jede Stufe einzeln liefe. */
+    double separateBytesPerPixel; /**< Speicherverkehr pro Pixel der einzelnen Pässe. */
+} PostprocessPlan;
+
 /**
  * Struktur zur Speicherung der Bloom-Daten.
  */
@@ -88,7 +333,9 @@ typedef struct Bloom {
     float colorWeight; /**< Farbgewicht des Bloom-Effekts. */
     float emissionWeight; /**< Emissionsgewicht des Bloom-Effekts. */
     float threshold; /**< Schwellenwert des Bloom-Effekts. */
-    int blurIterations; /**< Anzahl der Iterationen für den Bloom-Blur. */
+    int levels; /**< Anzahl der genutzten Stufen der Mip-Kette, 0 schaltet Bloom ab. */
+    GLuint linearSampler; /**< Sampler, mit dem das finale Bild und die Emission beim ersten Verkleinern linear gefiltert werden. */
+    PassTimer timer; /**< Die Zeitmessung der Bloom-Pässe. */
 } Bloom;
 
 /**
@@ -102,57 +349,91 @@ typedef struct Postprocessing {
     bool useDoF; /**< Gibt an, ob Tiefenunschärfe verwendet werden soll. */
     float focusDistance; /**< Die Fokusdistanz für die Tiefenunschärfe. */
     float depthOfField; /**< Die Stärke der Tiefenunschärfe. */
+    int dofDivisor; /**< Verkleinerung der Tiefenunschärfe gegenüber dem Bildschirm, 2 oder 4. */
+    PassTimer dofTimer; /**< Die Zeitmessung der Pässe der Tiefenunschärfe. */
+
+    PostprocessPlan plan; /**< Der Plan der Nachbearbeitung im aktuellen Frame. */
+    PassTimer timer; /**< Die Zeitmessung des zusammengefassten Passes ohne Tiefenunschärfe. */
 } Postprocessing;
 
 /**
  * @brief Struktur zur Speicherung der Schattenkarten-Daten.
  */
 typedef struct ShadowMap {
-    bool needsUpdating; /**< Gibt an, ob die Schattenkarte aktualisiert werden muss. */
-    float quadSize; /**< Die Größe des Schattenerfassungsbereichs. */
-    float zNear; /**< Der nahe Z-Wert für die Schattenprojektion. */
-    float zFar; /**< Der ferne Z-Wert für die Schattenprojektion. */
+    int cascadeCount; /**< Die Anzahl der Kaskaden des Richtungslichts. */
+    float splitLambda; /**< Die Gewichtung der logarithmischen gegenüber der gleichmäßigen Aufteilung der Kaskaden. */
+    float zFar; /**< Die Entfernung zur Kamera, bis zu der die Kaskaden reichen. */
     mat4* cubemapMatrices; /**< Die Matrizen für die Schattenwürfelkarte. */
 
     bool usePCF; /**< Gibt an, ob Percentage Closer Filtering (PCF) verwendet wird. */
     bool showShadows; /**< Gibt an, ob Schatten angezeigt werden sollen. */
-    bool dirLightShadowsAlwaysUpdate; /**< Gibt an, ob Richtungslicht-Schatten immer aktualisiert werden. */
-    bool dirLightShadowsShouldUpdate; /**< Gibt an, ob Richtungslicht-Schatten aktualisiert werden sollen. */
-    bool pointLightShadowsShouldUpdate; /**< Gibt an, ob Punktlicht-Schatten aktualisiert werden sollen. */
+
+    mat4 cascadeView; /**< Die View-Matrix der Kamera, an die die Kaskaden angepasst wurden. */
+    mat4 cascadeLightSpaces[DIR_SHADOW_MAX_CASCADES]; /**< Die Licht-Raum-Matrizen der Kaskaden. */
+    vec4 cascadeParams[DIR_SHADOW_MAX_CASCADES]; /**< Pro Kaskade das Ende im View Space, der Tiefenbereich und die Texelgröße in Welteinheiten. */
+
+    bool validCascades[DIR_SHADOW_MAX_CASCADES]; /**< Gibt an, ob eine Kaskade zu renderedLightSpaces passt. */
+    mat4 renderedLightSpaces[DIR_SHADOW_MAX_CASCADES]; /**< Die Licht-Raum-Matrizen, mit denen die Kaskaden gerendert wurden. */
+    mat4 renderedModelMatrix; /**< Die Modellmatrix, mit der alle Schattenkarten gerendert wurden. */
+    int dirShadowRenders; /**< Im letzten Frame neu gerenderte Kaskaden des Richtungslichts. */
+    int dirShadowMeshes; /**< Im letzten Frame in die Kaskaden gezeichnete Meshes. */
+    int pointShadowRenders; /**< Im letzten Frame neu gerenderte Punktlicht-Schattenkarten. */
+    int pointShadowMeshes; /**< Im letzten Frame in Punktlicht-Schattenkarten gezeichnete Meshes. */
+    int pointShadowFaces; /**< Im letzten Frame von diesen Meshes belegte Würfelseiten. */
 } ShadowMap;
 
 /**
  * @brief Struktur zur Speicherung der Beleuchtungsdaten.
  */
 typedef struct Light {
-    Shader *pointlightShader; /**< Der Shader für Punktlichter. */
+    ShaderVariants *pointlightShaders; /**< Die Varianten des Shaders für Punktlichter. */
+    ShaderVariants *tiledLightShaders; /**< Die Varianten des Shaders für alle Punktlichter im gekachelten Modus. */
+    ShaderVariants *multiLightShaders; /**< Die Varianten des Shaders für alle Lichter in einem Pass. */
     PointLight *defaultPointLight; /**< Das Standard-Punktlicht. */
     bool isPointLightActive; /**< Gibt an, ob das Punktlicht aktiv ist. */
 
-    Shader *dirlightShader; /**< Der Shader für Richtungslichter. */
+    ShaderVariants *dirlightShaders; /**< Die Varianten des Shaders für Richtungslichter. */
     DirLight *defaultDirLight; /**< Das Standard-Richtungslicht. */
     bool isDirLightActive; /**< Gibt an, ob das Richtungslicht aktiv ist. */
-    float dirLightDistanceMult; /**< Der Multiplikator für die Lichtdistanz. */
 
     bool hasCreatedDefaultPointLights; /**< Gibt an, ob ein Standard-Punktlicht erstellt wurde. */
     bool hasCreatedDefaultDirLights; /**< Gibt an, ob ein Standard-Richtungslicht erstellt wurde. */
 } Light;
 
+/**
+ * @brief Handles der Ressourcen des Render-Graphen im aktuellen Frame. Nicht
+ * benutzte Stufen sind RENDERGRAPH_NO_RESOURCE.
+ */
+typedef struct FrameResources {
+    RenderGraphResource gbuffer[DEFAULT_GBUFFER_NUM_COLORATTACH]; /**< Die importierten Texturen des G-Buffers. */
+    RenderGraphResource shadowMaps; /**< Die Schattenkarten der Richtungslichter und der Schatten-Atlas. */
+    RenderGraphResource bloom[BLOOM_MAX_LEVELS]; /**< Die Stufen der Bloom-Mip-Kette. */
+    RenderGraphResource dofColor; /**< Das verkleinerte Bild der Tiefenunschärfe mit der Entfernung im Alpha-Kanal. */
+    RenderGraphResource dofBlur; /**< Das Ergebnis des letzten Blur-Passes der Tiefenunschärfe. */
+    RenderGraphResource scaledOutput; /**< Das fertige Bild in verringerter Auflösung vor dem Hochskalieren. */
+    RenderGraphResource history; /**< Das Ergebnis der temporalen Rekonstruktion im letzten Frame. */
+    RenderGraphResource output; /**< Das Ziel des fertigen Bildes. */
+} FrameResources;
+
 /**
  * @brief Struktur zur Speicherung aller für das Rendering erforderlichen Daten.
  */
 struct RenderingData {
-    Shader *modelShader; /**< Der Shader für das Modell-Rendering. */
+    ShaderVariants *modelShaders; /**< Die Varianten des Shaders für das Modell-Rendering ohne Tessellation. */
+    ShaderVariants *modelTessShaders; /**< Die Varianten des Shaders für das Modell-Rendering mit Tessellation. */
     Shader *nullShader; /**< Ein Null-Shader für Debugging-Zwecke. */
     Shader *blurShader; /**< Der Shader für den Blur-Effekt. */
-    Shader *thresholdShader; /**< Der Shader für die Schwellenwertberechnung. */
-    Shader *postprocessShader; /**< Der Shader für die Nachbearbeitungseffekte. */
+    Shader *bloomDownShader; /**< Der Shader zum Verkleinern der Bloom-Stufen, die erste Stufe wendet den Schwellenwert an. */
+    Shader *bloomUpShader; /**< Der Shader zum Vergrößern und Aufaddieren der Bloom-Stufen. */
+    ShaderVariants *postprocessShaders; /**< Die Varianten des Shaders für die Nachbearbeitungseffekte. */
     Shader *dirLightShadowShader; /**< Der Shader für Richtungslicht-Schatten. */
     Shader *pointLightShadowShader; /**< Der Shader für Punktlicht-Schatten. */
-    Shader *depthOfFieldShader; /**< Der Shader für Tiefenunschärfe-Effekte. */
+    ShaderVariants *dofDownsampleShaders; /**< Die Varianten des Shaders zum Verkleinern des Bildes für die Tiefenunschärfe. */
+    ShaderVariants *depthOfFieldShaders; /**< Die Varianten des Shaders für Tiefenunschärfe-Effekte. */
+    Shader *temporalShader; /**< Der Shader der temporalen Rekonstruktion. */
 
     RenderMode renderMode; /**< Der aktuelle Rendering-Modus. */
-    Model* lightVolume; /**< Das Modell für Lichtvolumina. */
+    LightVolume lightVolume; /**< Die Lichtvolumina der Punktlichter. */
     float clipping; /**< Der Clipping-Wert für die Kamerasicht. */
     Transform transform; /**< Die Transformationsdaten für die Szene. */
     Skybox skybox; /**< Die Skybox-Daten für die Umgebung. */
@@ -165,10 +446,50 @@ struct RenderingData {
     Light light; /**< Die Lichtdaten für die Szene. */
     ShadowMap shadowMap; /**< Die Schattenkartendaten für Lichtquellen. */
     GBuffer *gbuffer; /**< Der G-Buffer zur Speicherung von Szeneninformationen. */
+    LightingMode lightingMode; /**< Das Verfahren, mit dem die Punktlichter ausgewertet werden. */
+    LightGrid *lightGrid; /**< Die Zellenlisten der Punktlichter für den gekachelten und geclusterten Modus. */
+    LightBuffer *lightBuffer; /**< Der Uniform Buffer mit allen Lichtern für den Einzelpass-Modus. */
+    ShadowAtlas *shadowAtlas; /**< Der gemeinsame Schatten-Atlas aller Punktlichter. */
+    PassTimer lightTimer; /**< Die Zeitmessung der Beleuchtungs-Pässe. */
+    mat4 invViewProjection; /**< Inverse View-Projektions-Matrix des Frames, um Positionen aus der Tiefe zu rekonstruieren. */
+    GLuint outputFramebuffer; /**< Das Ziel des fertigen Bildes, 0 für das Fenster. */
+    RenderGraph *renderGraph; /**< Der Render-Graph, der die Pässe ordnet und ihre Ziele vergibt. */
+    FrameResources resources; /**< Die Ressourcen des Render-Graphen im aktuellen Frame. */
+    DynamicResolution resolution; /**< Die nach der GPU-Zeit geregelte Auflösung. */
+    TemporalUpscaling temporal; /**< Jitter, Bewegungsvektoren und Ergebnisse der temporalen Rekonstruktion. */
 };
 
 typedef struct RenderingData RenderingData;
 
+/**
+ * @brief Daten eines Frames, die die Pässe des Render-Graphen brauchen. Sie
+ * leben nur während rendering_draw.
+ */
+typedef struct FrameContext {
+    const ProgContext *ctx; /**< Der Programmkontext. */
+    RenderingData *data; /**< Zugriff auf das Rendering-Datenobjekt. */
+    mat4 projectionMatrix; /**< Die Projektionsmatrix der Kamera. */
+    mat4 viewMatrix; /**< Die View-Matrix der Kamera. */
+    mat4 modelMatrix; /**< Die Modellmatrix der Szene. */
+    vec3 cameraPosition; /**< Die Position der Kamera in Weltkoordinaten. */
+    int width; /**< Die Breite, in die gerendert wird (siehe DynamicResolution). */
+    int height; /**< Die Höhe, in die gerendert wird (siehe DynamicResolution). */
+    int outputWidth; /**< Die Breite des Ausgabeziels. */
+    int outputHeight; /**< Die Höhe des Ausgabeziels. */
+} FrameContext;
+
+/**
+ * @brief Ein Blur-Pass der Tiefenunschärfe. Jeder Pass schreibt ein eigenes
+ * Ziel, der Render-Graph legt Ziele, die nicht mehr gelesen werden, auf
+ * dieselbe Textur.
+ */
+typedef struct BlurStep {
+    FrameContext *frame; /**< Die Daten des Frames. */
+    RenderGraphResource source; /**< Das gelesene Bild. */
+    RenderGraphResource target; /**< Das geschriebene Bild. */
+    bool horizontal; /**< Gibt an, ob horizontal weichgezeichnet wird. */
+} BlurStep;
+
 ////////////////////////////// LOKALE FUNKTIONEN ///////////////////////////////
 
 /**
@@ -179,16 +500,20 @@ typedef struct RenderingData RenderingData;
 static void rendering_loadShaders(RenderingData *data) {
     if (data == NULL) { return; }
 
-    data->modelShader = shader_createVeTessFrShader("Model",
-                                                    UTILS_CONST_RES("shader/model/model.vert"),
-                                                    UTILS_CONST_RES("shader/model/model.tesc"),
-                                                    UTILS_CONST_RES("shader/model/model.tese"),
-                                                    UTILS_CONST_RES("shader/model/model.frag")
+    data->modelShaders = shader_createVariants("Model",
+                                               UTILS_CONST_RES("shader/model/model.vert"),
+                                               NULL, NULL, NULL,
+                                               UTILS_CONST_RES("shader/model/model.frag"),
+                                               MODEL_VARIANT_DEFINES, VARIANT_DEFINE_COUNT(MODEL_VARIANT_DEFINES)
     );
 
-    data->skybox.shader = shader_createVeFrShader("Skybox",
-                                                  UTILS_CONST_RES("shader/skybox/skybox.vert"),
-                                                  UTILS_CONST_RES("shader/skybox/skybox.frag")
+    data->modelTessShaders = shader_createVariants("Model Tessellation",
+                                                   UTILS_CONST_RES("shader/model/model.vert"),
+                                                   UTILS_CONST_RES("shader/model/model.tesc"),
+                                                   UTILS_CONST_RES("shader/model/model.tese"),
+                                                   NULL,
+                                                   UTILS_CONST_RES("shader/model/model.frag"),
+                                                   MODEL_VARIANT_DEFINES, VARIANT_DEFINE_COUNT(MODEL_VARIANT_DEFINES)
     );
 
     data->nullShader = shader_createVeFrShader("Null",
@@ -196,14 +521,32 @@ static void rendering_loadShaders(RenderingData *data) {
                                                UTILS_CONST_RES("shader/null/null.frag")
     );
 
-    data->light.pointlightShader = shader_createVeFrShader("Pointlight",
-                                                           UTILS_CONST_RES("shader/pointlight/pointlight.vert"),
-                                                           UTILS_CONST_RES("shader/pointlight/pointlight.frag")
+    data->light.pointlightShaders = shader_createVariants("Pointlight",
+                                                          UTILS_CONST_RES("shader/pointlight/pointlight.vert"),
+                                                          NULL, NULL, NULL,
+                                                          UTILS_CONST_RES("shader/pointlight/pointlight.frag"),
+                                                          LIGHT_VARIANT_DEFINES, VARIANT_DEFINE_COUNT(LIGHT_VARIANT_DEFINES)
+    );
+
+    data->light.tiledLightShaders = shader_createVariants("Tiled Light",
+                                                          UTILS_CONST_RES("shader/tiledlight/tiledlight.vert"),
+                                                          NULL, NULL, NULL,
+                                                          UTILS_CONST_RES("shader/tiledlight/tiledlight.frag"),
+                                                          LIGHT_VARIANT_DEFINES, VARIANT_DEFINE_COUNT(LIGHT_VARIANT_DEFINES)
+    );
+
+    data->light.multiLightShaders = shader_createVariants("Multi Light",
+                                                          UTILS_CONST_RES("shader/multilight/multilight.vert"),
+                                                          NULL, NULL, NULL,
+                                                          UTILS_CONST_RES("shader/multilight/multilight.frag"),
+                                                          LIGHT_VARIANT_DEFINES, VARIANT_DEFINE_COUNT(LIGHT_VARIANT_DEFINES)
     );
 
-    data->light.dirlightShader = shader_createVeFrShader("Dirlight",
-                                                         UTILS_CONST_RES("shader/dirlight/dirlight.vert"),
-                                                         UTILS_CONST_RES("shader/dirlight/dirlight.frag")
+    data->light.dirlightShaders = shader_createVariants("Dirlight",
+                                                        UTILS_CONST_RES("shader/dirlight/dirlight.vert"),
+                                                        NULL, NULL, NULL,
+                                                        UTILS_CONST_RES("shader/dirlight/dirlight.frag"),
+                                                        LIGHT_VARIANT_DEFINES, VARIANT_DEFINE_COUNT(LIGHT_VARIANT_DEFINES)
     );
 
     data->blurShader = shader_createVeFrShader("Blur",
@@ -211,19 +554,21 @@ static void rendering_loadShaders(RenderingData *data) {
                                                UTILS_CONST_RES("shader/blur/blur.frag")
     );
 
-    data->thresholdShader = shader_createVeFrShader("Threshold",
-                                                    UTILS_CONST_RES("shader/threshold/threshold.vert"),
-                                                    UTILS_CONST_RES("shader/threshold/threshold.frag")
+    data->bloomDownShader = shader_createVeFrShader("Bloom Downsample",
+                                                    UTILS_CONST_RES("shader/bloomdown/bloomdown.vert"),
+                                                    UTILS_CONST_RES("shader/bloomdown/bloomdown.frag")
     );
 
-    data->fog.shader = shader_createVeFrShader("Fog",
-                                               UTILS_CONST_RES("shader/fog/fog.vert"),
-                                               UTILS_CONST_RES("shader/fog/fog.frag")
+    data->bloomUpShader = shader_createVeFrShader("Bloom Upsample",
+                                                  UTILS_CONST_RES("shader/bloomup/bloomup.vert"),
+                                                  UTILS_CONST_RES("shader/bloomup/bloomup.frag")
     );
 
-    data->postprocessShader = shader_createVeFrShader("Postprocess",
-                                                      UTILS_CONST_RES("shader/postprocess/postprocess.vert"),
-                                                      UTILS_CONST_RES("shader/postprocess/postprocess.frag")
+    data->postprocessShaders = shader_createVariants("Postprocess",
+                                                     UTILS_CONST_RES("shader/postprocess/postprocess.vert"),
+                                                     NULL, NULL, NULL,
+                                                     UTILS_CONST_RES("shader/postprocess/postprocess.frag"),
+                                                     POSTPROCESS_VARIANT_DEFINES, VARIANT_DEFINE_COUNT(POSTPROCESS_VARIANT_DEFINES)
     );
 
     data->dirLightShadowShader = shader_createVeFrShader("DirLightShadow",
@@ -237,102 +582,131 @@ static void rendering_loadShaders(RenderingData *data) {
                                                                UTILS_CONST_RES("shader/pointlightshadow/pointlightshadow.frag")
     );
 
-    data->depthOfFieldShader = shader_createVeFrShader("DepthOfField",
-                                                       UTILS_CONST_RES("shader/dof/dof.vert"),
-                                                       UTILS_CONST_RES("shader/dof/dof.frag")
-);
+    data->dofDownsampleShaders = shader_createVariants("DepthOfField Downsample",
+                                                       UTILS_CONST_RES("shader/dofdown/dofdown.vert"),
+                                                       NULL, NULL, NULL,
+                                                       UTILS_CONST_RES("shader/dofdown/dofdown.frag"),
+                                                       POSTPROCESS_VARIANT_DEFINES, VARIANT_DEFINE_COUNT(POSTPROCESS_VARIANT_DEFINES)
+    );
+
+    data->depthOfFieldShaders = shader_createVariants("DepthOfField",
+                                                      UTILS_CONST_RES("shader/dof/dof.vert"),
+                                                      NULL, NULL, NULL,
+                                                      UTILS_CONST_RES("shader/dof/dof.frag"),
+                                                      POSTPROCESS_VARIANT_DEFINES, VARIANT_DEFINE_COUNT(POSTPROCESS_VARIANT_DEFINES)
+    );
+
+    data->temporalShader = shader_createVeFrShader("Temporal",
+                                                   UTILS_CONST_RES("shader/temporal/temporal.vert"),
+                                                   UTILS_CONST_RES("shader/temporal/temporal.frag")
+    );
 }
 
 /**
- * Zeichnet die Skybox, wenn das Skybox-Rendering aktiviert ist.
+ * Setzt die Uniforms einer Variante des Model-Shaders. Da jede Variante ein
+ * eigenes Programm ist, muss das für jede Variante einzeln geschehen.
  *
  * @param data Zugriff auf das Rendering Datenobjekt.
- * @param viewMatrix Die View-Matrix der Szene.
- * @param projectionMatrix Die Projection-Matrix der Szene.
+ * @param shader Die aktive Variante des Model-Shaders.
+ * @param modelMatrix Die Modellmatrix der Szene.
  */
-static void rendering_drawSkybox(const RenderingData *data, mat4 viewMatrix, mat4 projectionMatrix) {
-    shader_useShader(data->skybox.shader);
-
-    // Nur die Rotationskomponenten der View-Matrix verwenden
-    mat4 skyboxView;
-    glm_mat4_copy(viewMatrix, skyboxView);
-
-    // Translation entfernen
-    mat3 rotation;
-    glm_mat4_pick3(viewMatrix, rotation);
-    glm_mat4_identity(skyboxView);
-    glm_mat4_ins3(rotation, skyboxView);
-
-    shader_setMat4(data->skybox.shader, "u_view", &skyboxView);
-    shader_setMat4(data->skybox.shader, "u_projection", (mat4 *) projectionMatrix);
+static void rendering_updateUniforms(RenderingData *data, Shader *shader, mat4 *modelMatrix) {
+    shader_setMat4(shader, "u_model", modelMatrix);
 
-    glDepthFunc(GL_LEQUAL); // Sicherstellen, dass die Skybox im Hintergrund bleibt
-
-    // Skybox-Textur und VAO binden und zeichnen
-    glBindVertexArray(data->skybox.skyboxVAO);
+    // Render-Modus
+    shader_setInt(shader, "u_renderMode", data->renderMode);
 
-    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_NUM_COLORATTACH);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, data->skybox.cubemapTexture);
-    shader_setInt(data->skybox.shader, "u_skybox", DEFAULT_GBUFFER_NUM_COLORATTACH);
+    // Clipping-Daten
+    shader_setFloat(shader, "u_clipping", data->clipping);
 
-    glDrawArrays(GL_TRIANGLES, 0, data->skybox.skyboxVertexCount);
-    glBindVertexArray(0);
+    //Tessellation-Daten
+    if (data->tesselation.useTessellation) {
+        shader_setInt(shader, "u_minTessellation", data->tesselation.minTessellation);
+        shader_setInt(shader, "u_maxTessellation", data->tesselation.maxTessellation);
+    }
 
-    glDepthFunc(GL_LESS); // Tiefentest zurücksetzen
+    //Displacement-Daten
+    if (data->displacement.useDisplacement) {
+        shader_setFloat(shader, "u_displacementData.factor", data->displacement.displacementFactor);
+    }
 }
 
 /**
- * Aktualisiert die Uniforms des Model-Shaders.
+ * Bestimmt die Variante des Model-Shaders für ein Material. Texturen, die das
+ * Material nicht hat oder die abgeschaltet sind, werden in der Variante gar
+ * nicht erst gelesen.
  *
  * @param data Zugriff auf das Rendering Datenobjekt.
+ * @param material Das Material des Meshes.
+ * @return Der Schlüssel der Variante aus ModelVariant.
  */
-static void rendering_updateUniforms(RenderingData *data) {
-    shader_useShader(data->modelShader);
+static unsigned int getModelVariantKey(const RenderingData *data, const Material *material) {
+    unsigned int key = material_getMaps(material);
 
-    // ModelMatrix festlegen.
-    {
-        mat4 modelMatrix;
-        glm_mat4_identity(modelMatrix);
-        glm_translate(modelMatrix, data->transform.translation);
-        glm_rotate_x(modelMatrix, glm_rad(data->transform.rotation[0]), modelMatrix);
-        glm_rotate_y(modelMatrix, glm_rad(data->transform.rotation[1]), modelMatrix);
-        glm_rotate_z(modelMatrix, glm_rad(data->transform.rotation[2]), modelMatrix);
-        glm_scale(modelMatrix, data->transform.scale);
-        shader_setMat4(data->modelShader, "u_model", &modelMatrix);
+    if (!data->normalMap.enableNormalMapping) {
+        key &= ~(unsigned int) MODEL_VARIANT_NORMAL_MAP;
+    } else if ((key & MODEL_VARIANT_NORMAL_MAP) && data->normalMap.enableTwoChannelNormalMap) {
+        key |= MODEL_VARIANT_TWO_CHANNEL_NORMAL_MAP;
     }
 
-    // Render-Modus
-    shader_setInt(data->modelShader, "u_renderMode", data->renderMode);
-
-    // Clipping-Daten
-    shader_setFloat(data->modelShader, "u_clipping", data->clipping);
-
-    // Fog-Daten
-    {
-        shader_setBool(data->modelShader, "u_fogEnabled", data->fog.fogEnabled);
-        shader_setFloat(data->modelShader, "u_fogDensity", data->fog.fogDensity);
-        if (data->fog.fogEnabled) {
-            shader_setVec3(data->modelShader, "u_fogColor", &data->fog.color);
-        }
+    if (data->tesselation.useTessellation) {
+        key |= MODEL_VARIANT_TESSELLATION;
     }
-
-    // Normal Map-Daten
-    {
-        shader_setBool(data->modelShader, "u_useNormalMapping", data->normalMap.enableNormalMapping);
-        shader_setBool(data->modelShader, "u_useTwoChannelNormalMaps", data->normalMap.enableTwoChannelNormalMap);
+    if (data->displacement.useDisplacement) {
+        key |= MODEL_VARIANT_DISPLACEMENT;
     }
-
-    //Tessellation-Daten
-    {
-        shader_setBool(data->modelShader, "u_doTessellation", data->tesselation.useTessellation);
-        shader_setInt(data->modelShader, "u_minTessellation", data->tesselation.minTessellation);
-        shader_setInt(data->modelShader, "u_maxTessellation", data->tesselation.maxTessellation);
+    if (data->temporal.mode == UPSCALING_MODE_TEMPORAL) {
+        key |= MODEL_VARIANT_VELOCITY;
     }
 
-    //Displacement-Daten
-    {
-        shader_setBool(data->modelShader, "u_displacementData.use", data->displacement.useDisplacement);
-        shader_setFloat(data->modelShader, "u_displacementData.factor", data->displacement.displacementFactor);
+    return key;
+}
+
+/**
+ * Zeichnet alle Meshes eines Modells in den G-Buffer, jedes mit der Variante
+ * des Model-Shaders, die zu seinem Material passt. Ohne Tessellation und
+ * Displacement entfallen auch die Tessellation-Stufen. Die Uniforms werden
+ * nur beim Wechsel der Variante gesetzt.
+ *
+ * @param data Zugriff auf das Rendering Datenobjekt.
+ * @param model Das zu zeichnende Modell.
+ * @param modelMatrix Die Modellmatrix der Szene.
+ * @param projectionMatrix Die Projektionsmatrix der Kamera.
+ * @param viewMatrix Die View-Matrix der Kamera.
+ * @param cameraPosition Die Position der Kamera.
+ */
+static void drawModelVariants(RenderingData *data, Model *model, mat4 *modelMatrix,
+                              mat4 *projectionMatrix, mat4 *viewMatrix, vec3 *cameraPosition) {
+    Shader *shader = NULL;
+    unsigned int currentKey = ~0u;
+
+    for (unsigned int i = 0; i < model_getMeshCount(model); i++) {
+        Mesh *mesh = model_getMesh(model, i);
+        const unsigned int key = getModelVariantKey(data, mesh_getMaterial(mesh));
+
+        if (key != currentKey) {
+            currentKey = key;
+            shader = shader_getVariant((key & (MODEL_VARIANT_TESSELLATION | MODEL_VARIANT_DISPLACEMENT))
+                                           ? data->modelTessShaders : data->modelShaders, key);
+            if (shader == NULL) {
+                continue;
+            }
+
+            shader_useShader(shader);
+            shader_setVec3(shader, "u_cameraPos", cameraPosition);
+            shader_setMat4(shader, "u_projection", projectionMatrix);
+            shader_setMat4(shader, "u_view", viewMatrix);
+            if (key & MODEL_VARIANT_VELOCITY) {
+                shader_setMat4(shader, "u_viewProjection", &data->temporal.viewProjection);
+                shader_setMat4(shader, "u_prevViewProjection", &data->temporal.prevViewProjection);
+                shader_setMat4(shader, "u_prevModel", &data->temporal.prevModel);
+            }
+            rendering_updateUniforms(data, shader, modelMatrix);
+        }
+
+        if (shader != NULL) {
+            mesh_drawMesh(mesh, shader);
+        }
     }
 }
 
@@ -439,7 +813,16 @@ static void initPostprocessing(Postprocessing *postprocessing) {
     postprocessing->bloom.colorWeight = 1.0f;
     postprocessing->bloom.emissionWeight = 1.0f;
     postprocessing->bloom.threshold = 1.0f;
-    postprocessing->bloom.blurIterations = 2;
+    postprocessing->bloom.levels = 5;
+    postprocessing->dofDivisor = 2;
+
+    // Das finale Bild und die Emission werden sonst ungefiltert gelesen. Nur
+    // beim ersten Verkleinern wird zwischen ihren Texeln interpoliert.
+    glGenSamplers(1, &postprocessing->bloom.linearSampler);
+    glSamplerParameteri(postprocessing->bloom.linearSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(postprocessing->bloom.linearSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glSamplerParameteri(postprocessing->bloom.linearSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(postprocessing->bloom.linearSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 }
 
 /**
@@ -447,8 +830,10 @@ static void initPostprocessing(Postprocessing *postprocessing) {
  *
  * @param scene Die Szene, die die Lichtdaten enthält.
  * @param light Die Lichtdaten, die initialisiert werden sollen.
+ * @param shadowAtlas Der Schatten-Atlas, der auf die Punktlichter verteilt wird.
+ * @param shadowMap Die Schattendaten, deren Karten neu gerendert werden müssen.
  */
-static void initLight(Scene *scene, Light *light, GBuffer* gbuffer, ShadowMap* shadowMap) {
+static void initLight(Scene *scene, Light *light, ShadowAtlas* shadowAtlas, ShadowMap* shadowMap) {
     if (scene != NULL && scene->countDirLights > 0) {
         light->defaultDirLight = scene->dirLights[0];
         light->hasCreatedDefaultDirLights = false;
@@ -461,15 +846,15 @@ static void initLight(Scene *scene, Light *light, GBuffer* gbuffer, ShadowMap* s
         light->defaultPointLight = scene->pointLights[0];
         light->hasCreatedDefaultPointLights = false;
 
-        gbuffer_initializePointLightFBOs(gbuffer, scene->countPointLights, POINT_SHADOW_SIZE);
+        shadowatlas_assignSlots(shadowAtlas, scene->pointLights, scene->countPointLights);
     } else {
         light->defaultPointLight = light_createPointLight((vec3){0.0f, 1.0f, 0.0f}, (vec3){1.0f, 1.0f, 0.0f});
         light->hasCreatedDefaultPointLights = true;
 
-        gbuffer_initializePointLightFBOs(gbuffer, 1, POINT_SHADOW_SIZE);
+        shadowatlas_assignSlots(shadowAtlas, &light->defaultPointLight, 1);
     }
 
-    shadowMap->needsUpdating = true;
+    memset(shadowMap->validCascades, 0, sizeof(shadowMap->validCascades));
 
     light->isDirLightActive = true;
     light->isPointLightActive = true;
@@ -487,21 +872,414 @@ static void renderFullscreenQuad(FullscreenQuad fullscreenQuad) {
 }
 
 /**
- * Berechnet den Skalierungsfaktor für das Punktlicht-Volumen.
+ * Rendert das Lichtvolumen. Die Kugel wird direkt gezeichnet und nicht als
+ * Modell, da das Material sonst die Texturen des G-Buffers überschreiben würde.
  *
- * @param light Das Punktlicht, dessen Volumen skaliert werden soll.
- * @return Der Skalierungsfaktor für das Punktlicht-Volumen.
+ * @param volume Das Lichtvolumen, das gerendert werden soll.
  */
-static float calcPointLightVolumeScale(const PointLight light) {
-    const float maxIntensity = fmaxf(fmaxf(light.diffuse[0], light.diffuse[1]), light.diffuse[2]);
-    return (-light.linear + sqrtf(powf(light.linear, 2.0f) - 4 * light.quadratic * (light.constant - maxIntensity * (256.0f / 5.0f)))) / (2 * light.quadratic);
+static void renderLightVolume(const LightVolume *volume) {
+    glBindVertexArray(volume->vao);
+    glDrawElements(GL_TRIANGLES, volume->indexCount, GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
 }
 
 /**
- * Rendert das Lichtvolumen.
+ * Erzeugt die Einheitskugel für die Lichtvolumen. Da die Dreiecke innerhalb
+ * der echten Kugel liegen, wird zusätzlich ein Korrekturfaktor bestimmt. Die
+ * Abschätzung nimmt die längste mögliche Kante eines Dreiecks als Radius des
+ * Umkreises und ist damit etwas zu groß, aber sicher.
+ *
+ * @param volume Das Lichtvolumen, das initialisiert werden soll.
  */
-static void renderLightVolume(const RenderingData* data, Shader* shader) {
-    model_drawModel(data->lightVolume, shader);
+static void createLightVolume(LightVolume *volume) {
+    GLsizei vertexCount;
+    utils_createSphere(&volume->vao, &volume->vbo, &volume->ebo, &vertexCount, &volume->indexCount,
+                       LIGHT_VOLUME_SECTORS, LIGHT_VOLUME_STACKS);
+
+    common_labelObjectByType(GL_BUFFER, volume->vbo, "Light Volume VBO");
+    common_labelObjectByType(GL_BUFFER, volume->ebo, "Light Volume EBO");
+
+    const float maxEdge = (float)(2 * M_PI / LIGHT_VOLUME_SECTORS + M_PI / LIGHT_VOLUME_STACKS);
+    volume->scaleCorrection = 1.0f / cosf(maxEdge);
+}
+
+/**
+ * Gibt die Buffer und Queries der Lichtvolumen wieder frei.
+ *
+ * @param volume Das Lichtvolumen, das gelöscht werden soll.
+ */
+static void deleteLightVolume(const LightVolume *volume) {
+    if (volume->vao != 0) { glDeleteVertexArrays(1, &volume->vao); }
+    if (volume->vbo != 0) { glDeleteBuffers(1, &volume->vbo); }
+    if (volume->ebo != 0) { glDeleteBuffers(1, &volume->ebo); }
+
+    for (int i = 0; i < LIGHT_VOLUME_FRAMES; ++i) {
+        const LightVolumeFrame *frame = &volume->frames[i];
+        if (frame->queries != NULL) {
+            glDeleteQueries(frame->queryCapacity, frame->queries);
+            free(frame->queries);
+        }
+    }
+}
+
+/**
+ * Beginnt einen neuen Frame für die Lichtvolumen. Die Queries dieses Slots
+ * stammen aus einem der vorherigen Frames und werden zuerst ausgewertet,
+ * sofern die GPU bereits fertig ist. Sonst bleiben die alten Statistiken
+ * erhalten, damit der Render-Thread nicht blockiert.
+ *
+ * @param volume Das Lichtvolumen.
+ * @param screenPixels Anzahl der Pixel des Bildschirms.
+ */
+static void beginLightVolumeFrame(LightVolume *volume, GLuint64 screenPixels) {
+    LightVolumeFrame *frame = &volume->frames[volume->frameIndex];
+
+    GLint available = GL_TRUE;
+    if (frame->queryCount > 0) {
+        glGetQueryObjectiv(frame->queries[frame->queryCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    }
+
+    if (available) {
+        GLuint64 litPixels = 0;
+        for (int i = 0; i < frame->queryCount; ++i) {
+            GLuint64 samples = 0;
+            glGetQueryObjectui64v(frame->queries[i], GL_QUERY_RESULT, &samples);
+            litPixels += samples;
+        }
+
+        volume->stats.volumeLights = frame->volumeLights;
+        volume->stats.fullscreenLights = frame->fullscreenLights;
+        volume->stats.skippedLights = frame->skippedLights;
+        volume->stats.scissoredLights = frame->scissoredLights;
+        volume->stats.litPixels = litPixels;
+        volume->stats.fullscreenPixels = frame->screenPixels * (GLuint64)(frame->volumeLights + frame->fullscreenLights);
+    }
+
+    frame->queryCount = 0;
+    frame->volumeLights = 0;
+    frame->fullscreenLights = 0;
+    frame->skippedLights = 0;
+    frame->scissoredLights = 0;
+    frame->screenPixels = screenPixels;
+}
+
+/**
+ * Schließt den aktuellen Frame der Lichtvolumen ab.
+ *
+ * @param volume Das Lichtvolumen.
+ */
+static void endLightVolumeFrame(LightVolume *volume) {
+    volume->frameIndex = (volume->frameIndex + 1) % LIGHT_VOLUME_FRAMES;
+}
+
+/**
+ * Startet die Occlusion Query für das nächste Punktlicht. Reichen die
+ * vorhandenen Queries nicht aus, werden weitere erzeugt.
+ *
+ * @param volume Das Lichtvolumen.
+ * @param isVolume Gibt an, ob das Licht über sein Volumen gezeichnet wird.
+ */
+static void beginLightVolumeQuery(LightVolume *volume, bool isVolume) {
+    LightVolumeFrame *frame = &volume->frames[volume->frameIndex];
+
+    if (frame->queryCount >= frame->queryCapacity) {
+        const int capacity = frame->queryCapacity > 0 ? frame->queryCapacity * 2 : 16;
+        frame->queries = realloc(frame->queries, sizeof(GLuint) * capacity);
+        glGenQueries(capacity - frame->queryCapacity, frame->queries + frame->queryCapacity);
+        frame->queryCapacity = capacity;
+    }
+
+    if (isVolume) {
+        frame->volumeLights++;
+    } else {
+        frame->fullscreenLights++;
+    }
+
+    glBeginQuery(GL_SAMPLES_PASSED, frame->queries[frame->queryCount++]);
+}
+
+/**
+ * Startet die Zeitmessung eines Abschnitts. Zuvor wird das Ergebnis des
+ * ältesten Slots übernommen, sofern die GPU bereits fertig ist.
+ *
+ * @param timer Die Zeitmessung.
+ */
+static void beginPassTimer(PassTimer *timer) {
+    timer->cpuStart = utils_getTime();
+    timer->passes = 0;
+
+    if (timer->queries[0] == 0) {
+        glGenQueries(LIGHT_VOLUME_FRAMES, timer->queries);
+    }
+
+    const GLuint query = timer->queries[timer->frameIndex];
+    if (timer->issued[timer->frameIndex]) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+            timer->shadingTime = (double) elapsed / 1.0e6;
+        }
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    timer->issued[timer->frameIndex] = true;
+}
+
+/**
+ * Beendet die Zeitmessung eines Abschnitts.
+ *
+ * @param timer Die Zeitmessung.
+ */
+static void endPassTimer(PassTimer *timer) {
+    glEndQuery(GL_TIME_ELAPSED);
+    timer->frameIndex = (timer->frameIndex + 1) % LIGHT_VOLUME_FRAMES;
+
+    timer->submissionTime = (utils_getTime() - timer->cpuStart) * 1000.0;
+    timer->lastPasses = timer->passes;
+}
+
+/**
+ * Setzt den Zeitstempel zu Beginn eines Frames. Zuvor wird die GPU-Zeit des
+ * ältesten Slots übernommen, sofern die GPU bereits fertig ist. Lief dieser
+ * Frame in voller Auflösung ohne Rekonstruktion, wird seine Zeit zusätzlich
+ * als Vergleichswert festgehalten.
+ *
+ * @param resolution Die dynamische Auflösung, die den Frame misst.
+ * @param native true, wenn der Frame in voller Auflösung ohne Rekonstruktion gerendert wird.
+ */
+static void beginFrameTimer(DynamicResolution *resolution, bool native) {
+    if (resolution->queries[0][0] == 0) {
+        glGenQueries(LIGHT_VOLUME_FRAMES * 2, resolution->queries[0]);
+    }
+
+    GLuint *queries = resolution->queries[resolution->frameIndex];
+    if (resolution->issued[resolution->frameIndex]) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 start = 0, end = 0;
+            glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT, &start);
+            glGetQueryObjectui64v(queries[1], GL_QUERY_RESULT, &end);
+            resolution->gpuTime = (double) (end - start) / 1.0e6;
+            resolution->measuredScale = resolution->issuedScales[resolution->frameIndex];
+            resolution->hasMeasurement = true;
+            if (resolution->issuedNative[resolution->frameIndex]) {
+                resolution->nativeGpuTime = resolution->gpuTime;
+            }
+        }
+    }
+
+    glQueryCounter(queries[0], GL_TIMESTAMP);
+    resolution->issued[resolution->frameIndex] = true;
+    resolution->issuedScales[resolution->frameIndex] = resolution->scale;
+    resolution->issuedNative[resolution->frameIndex] = native;
+}
+
+/**
+ * Setzt den Zeitstempel am Ende eines Frames.
+ *
+ * @param resolution Die dynamische Auflösung, die den Frame misst.
+ */
+static void endFrameTimer(DynamicResolution *resolution) {
+    glQueryCounter(resolution->queries[resolution->frameIndex][1], GL_TIMESTAMP);
+    resolution->frameIndex = (resolution->frameIndex + 1) % LIGHT_VOLUME_FRAMES;
+}
+
+/**
+ * Regelt die Skalierung der dynamischen Auflösung und bestimmt daraus die
+ * Größe, in die gerendert wird.
+ *
+ * Die Kosten der Pässe in verringerter Auflösung wachsen mit der Anzahl der
+ * Pixel, also mit dem Quadrat der Skalierung. Aus der letzten Messung ergibt
+ * sich damit die Skalierung, die das Budget gerade ausschöpfen würde. Liegt
+ * die Messung außerhalb der Toleranz, wird ein Teil des Weges dorthin
+ * gegangen. Feste Kosten wie die Schattenkarten gleicht die Regelung über
+ * mehrere Frames aus.
+ *
+ * @param resolution Die dynamische Auflösung.
+ * @param width Die Breite des Ausgabeziels.
+ * @param height Die Höhe des Ausgabeziels.
+ */
+static void updateResolutionScale(DynamicResolution *resolution, int width, int height) {
+    if (!resolution->enabled) {
+        resolution->scale = resolution->fixedScale;
+    } else if (resolution->hasMeasurement && resolution->gpuTime > 0.0) {
+        const double error = resolution->gpuTime / resolution->budget - 1.0;
+        if (fabs(error) > DYNAMIC_RESOLUTION_TOLERANCE) {
+            const float ideal = resolution->measuredScale
+                                * (float) sqrt(resolution->budget / resolution->gpuTime);
+            resolution->scale += (ideal - resolution->scale) * DYNAMIC_RESOLUTION_GAIN;
+            resolution->scale = glm_clamp(resolution->scale, DYNAMIC_RESOLUTION_MIN_SCALE,
+                                          DYNAMIC_RESOLUTION_MAX_SCALE);
+        }
+    }
+    resolution->hasMeasurement = false;
+
+    resolution->width = utils_maxInt(1, (int) ((float) width * resolution->scale + 0.5f));
+    resolution->height = utils_maxInt(1, (int) ((float) height * resolution->scale + 0.5f));
+}
+
+/**
+ * Liefert ein Element der Halton-Folge zur angegebenen Basis. Die Folge
+ * verteilt auch wenige aufeinanderfolgende Werte gleichmäßig über [0, 1).
+ *
+ * @param index Der Index des Elements, ab 1.
+ * @param base Die Basis, eine Primzahl.
+ * @return Das Element der Folge.
+ */
+static float getHaltonValue(int index, int base) {
+    float result = 0.0f;
+    float fraction = 1.0f;
+    while (index > 0) {
+        fraction /= (float) base;
+        result += fraction * (float) (index % base);
+        index /= base;
+    }
+    return result;
+}
+
+/**
+ * Bereitet die temporale Rekonstruktion eines Frames vor. Die
+ * View-Projektion ohne Jitter wird für die Bewegungsvektoren festgehalten,
+ * die nur im temporalen Modus geschrieben werden. Danach wird die Projektion
+ * um die nächste Position der Halton-Folge verschoben. Ohne Rekonstruktion
+ * bleibt sie unverändert.
+ *
+ * @param temporal Die temporale Rekonstruktion.
+ * @param frame Die Daten des Frames, Projektion und Größen müssen gesetzt sein.
+ */
+static void beginTemporalFrame(TemporalUpscaling *temporal, FrameContext *frame) {
+    glm_mat4_mul(frame->projectionMatrix, frame->viewMatrix, temporal->viewProjection);
+    if (!temporal->hasPrevious) {
+        glm_mat4_copy(temporal->viewProjection, temporal->prevViewProjection);
+        glm_mat4_copy(frame->modelMatrix, temporal->prevModel);
+        temporal->hasPrevious = true;
+    }
+
+    // Das letzte Ergebnis passt nur, wenn die Rekonstruktion im letzten Frame
+    // lief und das Ausgabeziel seine Größe behalten hat.
+    temporal->historyValid = temporal->resolved
+                             && temporal->historyWidth == frame->outputWidth
+                             && temporal->historyHeight == frame->outputHeight;
+    temporal->resolved = false;
+
+    temporal->jitter[0] = 0.0f;
+    temporal->jitter[1] = 0.0f;
+    if (temporal->mode != UPSCALING_MODE_TEMPORAL) {
+        return;
+    }
+
+    temporal->jitterIndex = (temporal->jitterIndex + 1) % TEMPORAL_JITTER_SAMPLES;
+    temporal->jitter[0] = getHaltonValue(temporal->jitterIndex + 1, 2) - 0.5f;
+    temporal->jitter[1] = getHaltonValue(temporal->jitterIndex + 1, 3) - 0.5f;
+
+    // Die Verschiebung wird im Clip Space mit w multipliziert, nach der
+    // Division ist sie also für alle Tiefen derselbe Bruchteil eines Pixels.
+    mat4 jitterMatrix;
+    glm_mat4_identity(jitterMatrix);
+    jitterMatrix[3][0] = 2.0f * temporal->jitter[0] / (float) frame->width;
+    jitterMatrix[3][1] = 2.0f * temporal->jitter[1] / (float) frame->height;
+    glm_mat4_mul(jitterMatrix, frame->projectionMatrix, frame->projectionMatrix);
+}
+
+/**
+ * Legt die Texturen für die Ergebnisse der temporalen Rekonstruktion in der
+ * Größe des Ausgabeziels an, sofern sie noch nicht so groß sind.
+ *
+ * @param temporal Die temporale Rekonstruktion.
+ * @param width Die Breite des Ausgabeziels.
+ * @param height Die Höhe des Ausgabeziels.
+ */
+static void resizeTemporalHistory(TemporalUpscaling *temporal, int width, int height) {
+    if (temporal->framebuffer == 0) {
+        glGenFramebuffers(1, &temporal->framebuffer);
+        common_labelObjectByType(GL_FRAMEBUFFER, temporal->framebuffer, "Temporal FBO");
+    }
+    if (temporal->historyWidth == width && temporal->historyHeight == height) {
+        return;
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        if (temporal->history[i] == 0) {
+            glGenTextures(1, &temporal->history[i]);
+        }
+        glBindTexture(GL_TEXTURE_2D, temporal->history[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, TEMPORAL_HISTORY_FORMAT, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    temporal->historyWidth = width;
+    temporal->historyHeight = height;
+}
+
+/**
+ * Prüft, ob sich die Kamera innerhalb eines Lichtvolumens befindet. In diesem
+ * Fall würde die Vorderseite der Kugel von der Near-Plane abgeschnitten und
+ * das Licht muss als Fullscreen-Quad gezeichnet werden.
+ *
+ * @param cameraPosition Die Position der Kamera.
+ * @param lightPosition Die Position des Punktlichts.
+ * @param radius Der Radius des Lichtvolumens.
+ * @return true, wenn die Kamera im Lichtvolumen liegt.
+ */
+static bool isCameraInLightVolume(vec3 cameraPosition, vec3 lightPosition, float radius) {
+    return glm_vec3_distance(cameraPosition, lightPosition) < radius + LIGHT_VOLUME_CAMERA_MARGIN;
+}
+
+/**
+ * Liefert die Auflösung einer Stufe der Bloom-Mip-Kette. Die erste Stufe hat
+ * die halbe Auflösung des Bildes, jede weitere die Hälfte der vorherigen.
+ *
+ * @param width Breite des Bildes, aus dem die Kette entsteht.
+ * @param height Höhe des Bildes, aus dem die Kette entsteht.
+ * @param level Die Stufe, 0 ist die größte.
+ * @param levelWidth Ausgabeparameter für die Breite der Stufe.
+ * @param levelHeight Ausgabeparameter für die Höhe der Stufe.
+ */
+static void getBloomLevelSize(int width, int height, int level, int *levelWidth, int *levelHeight) {
+    *levelWidth = width;
+    *levelHeight = height;
+    for (int i = 0; i <= level; ++i) {
+        *levelWidth = utils_maxInt(1, *levelWidth / 2);
+        *levelHeight = utils_maxInt(1, *levelHeight / 2);
+    }
+}
+
+/**
+ * Liefert den genutzten Bereich der verkleinerten Bilder der
+ * Tiefenunschärfe. Angelegt sind sie für die volle Größe des Fensters.
+ *
+ * @param frame Die Daten des Frames.
+ * @param width Ausgabeparameter für die Breite.
+ * @param height Ausgabeparameter für die Höhe.
+ */
+static void getDepthOfFieldSize(const FrameContext *frame, int *width, int *height) {
+    const int divisor = frame->data->postprocessing.dofDivisor;
+    *width = utils_maxInt(1, frame->width / divisor);
+    *height = utils_maxInt(1, frame->height / divisor);
+}
+
+/**
+ * Bindet das Ziel des fertigen Bildes. Bei verringerter Auflösung ist das ein
+ * transientes Ziel, das am Ende des Frames auf das Ausgabeziel hochskaliert
+ * wird.
+ *
+ * @param frame Die Daten des Frames.
+ */
+static void bindFinalTarget(const FrameContext *frame) {
+    RenderingData *data = frame->data;
+
+    if (data->resources.scaledOutput != RENDERGRAPH_NO_RESOURCE) {
+        rendergraph_bindTarget(data->renderGraph, data->resources.scaledOutput);
+    } else {
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, data->outputFramebuffer);
+    }
+    glViewport(0, 0, frame->width, frame->height);
 }
 
 /**
@@ -511,48 +1289,53 @@ static void renderLightVolume(const RenderingData* data, Shader* shader) {
  * @param shader Der Shader, der die Attachments setzen soll.
  */
 static void parseColorAttachmentsForLight(RenderingData *data, Shader *shader) {
-    GLuint albedoTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC);
-    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC);
-    glBindTexture(GL_TEXTURE_2D, albedoTex);
-    shader_setInt(shader, "u_albedoSpec", DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC);
-
-    GLuint ambientShiTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_AMBIENTSHI);
-    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_AMBIENTSHI);
-    glBindTexture(GL_TEXTURE_2D, ambientShiTex);
-    shader_setInt(shader, "u_ambientShi", DEFAULT_GBUFFER_COLORATTACH_AMBIENTSHI);
-
-    GLuint positionTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_POSITION);
-    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_POSITION);
-    glBindTexture(GL_TEXTURE_2D, positionTex);
-    shader_setInt(shader, "u_position", DEFAULT_GBUFFER_COLORATTACH_POSITION);
-
-    GLuint normalTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_NORMAL);
-    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_NORMAL);
-    glBindTexture(GL_TEXTURE_2D, normalTex);
-    shader_setInt(shader, "u_normal", DEFAULT_GBUFFER_COLORATTACH_NORMAL);
+    // Die Tiefe bleibt dabei am FBO angehängt. Da in den Licht-Pässen nicht
+    // in sie geschrieben wird, entsteht keine Rückkopplung.
+    gbuffer_bindTexturesForPass(data->gbuffer, shader, GBUFFER_PASS_LIGHT);
+    shader_setMat4(shader, "u_invViewProjection", &data->invViewProjection);
 
-    GLuint emissionTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_EMISSION);
-    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_EMISSION);
-    glBindTexture(GL_TEXTURE_2D, emissionTex);
-    shader_setInt(shader, "u_emission", DEFAULT_GBUFFER_COLORATTACH_EMISSION);
+    vec2 renderSize = { (float) data->resolution.width, (float) data->resolution.height };
+    shader_setVec2(shader, "u_renderSize", &renderSize);
 }
 
 /**
- * Parst die Farb-Attachments für den Schwellenwert.
+ * Parst die Farb-Attachments für das erste Verkleinern der Bloom-Stufen. Das
+ * finale Bild und die Emission werden dabei linear gefiltert gelesen.
  *
  * @param data Zugriff auf das Rendering Datenobjekt.
  * @param shader Der Shader, der die Attachments setzen soll.
  */
-static void parseColorAttachmentsForThreshold(RenderingData *data, Shader *shader) {
-    GLuint finalTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_FINAL);
-    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_FINAL);
-    glBindTexture(GL_TEXTURE_2D, finalTex);
-    shader_setInt(shader, "u_final", DEFAULT_GBUFFER_COLORATTACH_FINAL);
+static void parseColorAttachmentsForBloom(RenderingData *data, Shader *shader) {
+    gbuffer_bindTexturesForPass(data->gbuffer, shader, GBUFFER_PASS_BLOOM);
+    glBindSampler(DEFAULT_GBUFFER_COLORATTACH_FINAL, data->postprocessing.bloom.linearSampler);
+    glBindSampler(DEFAULT_GBUFFER_COLORATTACH_EMISSION, data->postprocessing.bloom.linearSampler);
+}
+
+/**
+ * Bindet eine Stufe der Bloom-Mip-Kette als Eingabe u_image.
+ *
+ * @param data Zugriff auf das Rendering Datenobjekt.
+ * @param shader Der Shader, der die Stufe lesen soll.
+ * @param level Die Stufe, die gelesen wird.
+ */
+static void parseBloomLevel(RenderingData *data, Shader *shader, int level) {
+    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_NUM_COLORATTACH);
+    glBindTexture(GL_TEXTURE_2D, rendergraph_getTexture(data->renderGraph, data->resources.bloom[level]));
+    shader_setInt(shader, "u_image", DEFAULT_GBUFFER_NUM_COLORATTACH);
+}
 
-    GLuint emissionTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_EMISSION);
-    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_EMISSION);
-    glBindTexture(GL_TEXTURE_2D, emissionTex);
-    shader_setInt(shader, "u_emission", DEFAULT_GBUFFER_COLORATTACH_EMISSION);
+/**
+ * Setzt den genutzten Bereich der gelesenen Textur. Bei verringerter
+ * Auflösung füllt das Bild nur einen Teil der für das Fenster angelegten
+ * Textur, die Shader filtern nur darin.
+ *
+ * @param shader Der Shader, der die Textur liest.
+ * @param width Die genutzte Breite in Texeln.
+ * @param height Die genutzte Höhe in Texeln.
+ */
+static void setSourceSize(Shader *shader, int width, int height) {
+    vec2 sourceSize = { (float) width, (float) height };
+    shader_setVec2(shader, "u_sourceSize", &sourceSize);
 }
 
 /**
@@ -560,52 +1343,82 @@ static void parseColorAttachmentsForThreshold(RenderingData *data, Shader *shade
  *
  * @param data Zugriff auf das Rendering Datenobjekt.
  * @param shader Der Shader, der die Attachments setzen soll.
- * @param isHorizontal Gibt an, ob der Blur horizontal ist.
- * @param isEntry Gibt an, ob es der Einstiegspunkt ist.
- */
-static void parseColorAttachmentsForBlur(RenderingData *data, Shader *shader, bool isHorizontal, bool isEntry, bool isDepthOfField) {
-    if (isEntry) {
-        if (isDepthOfField) {
-            const GLuint finalTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_FINAL);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, finalTex);
-        } else {
-            const GLuint thresholdTex = gbuffer_getBlurTexture(data->gbuffer, BLUR_GBUFFER_COLORATTACH_BLUR_H);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, thresholdTex);
-        }
+ * @param source Das Bild, das weichgezeichnet wird.
+ */
+static void parseColorAttachmentsForBlur(RenderingData *data, Shader *shader, RenderGraphResource source) {
+    const GLuint blurTex = rendergraph_getTexture(data->renderGraph, source);
+    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_NUM_COLORATTACH);
+    glBindTexture(GL_TEXTURE_2D, blurTex);
+    shader_setInt(shader, "u_image", DEFAULT_GBUFFER_NUM_COLORATTACH);
+}
 
-        shader_setInt(shader, "u_image", 0);
-    } else {
-        BLUR_GBUFFER_TEXTURE_TYPE textureType = isHorizontal ? BLUR_GBUFFER_COLORATTACH_BLUR_V : BLUR_GBUFFER_COLORATTACH_BLUR_H;
-        GLuint blurTex = gbuffer_getBlurTexture(data->gbuffer, textureType);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, blurTex);
-        shader_setInt(shader, "u_image", 0);
+/**
+ * Setzt Texturen und Uniforms der zusammengefassten Nachbearbeitung
+ * (postprocess.glsl), die der Postprocess-Shader und beide Shader der
+ * Tiefenunschärfe einbinden. Nur die Stufen, die in der Variante enthalten
+ * sind, bekommen ihre Texturen.
+ *
+ * @param data Zugriff auf das Rendering Datenobjekt.
+ * @param shader Der Shader, der die Nachbearbeitung einbindet.
+ * @param cameraPos Die Position der Kamera in Weltkoordinaten.
+ */
+static void parsePostprocessUniforms(RenderingData *data, Shader *shader, vec3 *cameraPos) {
+    const Postprocessing *postprocessing = &data->postprocessing;
+    const int stages = postprocessing->plan.stages;
+
+    gbuffer_bindTexturesForPass(data->gbuffer, shader, GBUFFER_PASS_POSTPROCESS);
+    shader_setMat4(shader, "u_invViewProjection", &data->invViewProjection);
+    shader_setVec3(shader, "u_cameraPos", cameraPos);
+
+    vec2 renderSize = { (float) data->resolution.width, (float) data->resolution.height };
+    shader_setVec2(shader, "u_renderSize", &renderSize);
+
+    if (stages & POSTPROCESS_STAGE_FOG) {
+        shader_setVec3(shader, "u_fogColor", &data->fog.color);
+        shader_setFloat(shader, "u_fogDensity", data->fog.fogDensity);
+    }
+
+    if (stages & POSTPROCESS_STAGE_BLOOM) {
+        // Die größte Bloom-Stufe enthält die Summe aller Stufen und wird
+        // beim Lesen linear auf die volle Auflösung vergrößert.
+        glActiveTexture(GL_TEXTURE0 + POSTPROCESS_UNIT_BLOOM);
+        glBindTexture(GL_TEXTURE_2D, rendergraph_getTexture(data->renderGraph, data->resources.bloom[0]));
+        shader_setInt(shader, "u_bloom", POSTPROCESS_UNIT_BLOOM);
+        shader_setFloat(shader, "u_bloomStrength", 1.0f / (float) postprocessing->bloom.levels);
+
+        int bloomWidth, bloomHeight;
+        getBloomLevelSize(data->resolution.width, data->resolution.height, 0, &bloomWidth, &bloomHeight);
+        vec2 bloomSize = { (float) bloomWidth, (float) bloomHeight };
+        shader_setVec2(shader, "u_bloomSize", &bloomSize);
+    }
+
+    shader_setFloat(shader, "u_exposure", postprocessing->exposure);
+    shader_setFloat(shader, "u_gamma", postprocessing->gamma);
+
+    if (stages & POSTPROCESS_STAGE_SKYBOX) {
+        glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT_CUBEMAP);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, data->skybox.cubemapTexture);
+        shader_setInt(shader, "u_skybox", TEXTURE_UNIT_CUBEMAP);
     }
 }
 
 /**
- * Parst die Farb-Attachments für den Nebel.
+ * Aktiviert die Variante eines Shaders der Nachbearbeitung, die genau die
+ * Stufen des aktuellen Plans enthält, und setzt ihre Uniforms.
  *
  * @param data Zugriff auf das Rendering Datenobjekt.
- * @param shader Der Shader, der die Attachments setzen soll.
+ * @param variants Die Varianten des Shaders, der die Nachbearbeitung einbindet.
+ * @param cameraPos Die Position der Kamera in Weltkoordinaten.
+ * @return Die aktive Variante oder NULL, wenn sie nicht gebaut werden konnte.
  */
-static void parseColorAttachmentsForFog(RenderingData *data, Shader *shader) {
-    GLuint positionTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_POSITION);
-    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_POSITION);
-    glBindTexture(GL_TEXTURE_2D, positionTex);
-    shader_setInt(shader, "u_position", DEFAULT_GBUFFER_COLORATTACH_POSITION);
-
-    GLuint normalTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_NORMAL);
-    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_NORMAL);
-    glBindTexture(GL_TEXTURE_2D, normalTex);
-    shader_setInt(shader, "u_normal", DEFAULT_GBUFFER_COLORATTACH_NORMAL);
+static Shader *usePostprocessVariant(RenderingData *data, ShaderVariants *variants, vec3 *cameraPos) {
+    Shader *shader = shader_getVariant(variants, (unsigned int) data->postprocessing.plan.stages);
+    if (shader != NULL) {
+        shader_useShader(shader);
+        parsePostprocessUniforms(data, shader, cameraPos);
+    }
 
-    GLuint finalTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_FINAL);
-    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_FINAL);
-    glBindTexture(GL_TEXTURE_2D, finalTex);
-    shader_setInt(shader, "u_final", DEFAULT_GBUFFER_COLORATTACH_FINAL);
+    return shader;
 }
 
 /**
@@ -615,28 +1428,33 @@ static void parseColorAttachmentsForFog(RenderingData *data, Shader *shader) {
  * @param scene Zeiger auf das Model, das im Schatten-Pass gerendert werden soll.
  * @param modelMatrix Zeiger auf die Modellmatrix zur Transformation des Models.
  * @param pointLightPosition Zeiger auf die Position der Punktlichtquelle.
- * @param index Index der Punktlichtquelle in der Schattenpufferstruktur.
+ * @param radius Der Radius des Punktlichts, auf den die Tiefe normiert wird.
+ * @param slot Index des Slots im Schatten-Atlas.
  * @param width Breite des ursprünglichen Viewports zur Wiederherstellung nach dem Rendern.
  * @param height Höhe des ursprünglichen Viewports zur Wiederherstellung nach dem Rendern.
  *
  * Diese Funktion rendert Schatten für eine Punktlichtquelle, indem sie:
  * 1. Die Perspektivprojektion für die Schattenwürfelkarte erstellt.
  * 2. Sechs verschiedene Ansichten generiert, die die sechs Seiten des Würfels abdecken.
- * 3. Die Schattenpuffer für das aktuelle Licht bindet.
+ * 3. Die Kacheln des Slots im Schatten-Atlas als Viewports bindet.
  * 4. Shader-Uniforms setzt, darunter Modellmatrix, Schattenmatrizen und Lichtposition.
- * 5. Das Szenenmodell rendert.
+ * 5. Jedes Mesh im Radius des Lichts nur in die Würfelseiten rendert, deren
+ *    Frustum es berührt.
  * 6. Den ursprünglichen Framebuffer und Viewport wiederherstellt.
  */
-static void performPointLightShadowPass(RenderingData *data, Model* scene, mat4* modelMatrix, vec3 *pointLightPosition, int index, int width, int height)
+static void performPointLightShadowPass(RenderingData *data, Model* scene, mat4* modelMatrix, vec3 *pointLightPosition,
+                                        float radius, int slot, int width, int height)
 {
     common_pushRenderScope("Pointlight-Shadow-Pass");
     {
         shader_useShader(data->pointLightShadowShader);
         glEnable(GL_DEPTH_TEST);
 
+        // Die Würfelseiten sind quadratisch, ihre Auflösung steckt nur im
+        // Viewport der jeweiligen Kachel.
         mat4 projection;
-        const float znear = .1f, zfar = 200;
-        glm_perspective(((90.0f) * (float)M_PI / 180.0f), ((float)POINT_SHADOW_SIZE / (float)POINT_SHADOW_SIZE), znear, zfar, projection);
+        const float znear = SHADOWATLAS_Z_NEAR, zfar = shadowatlas_calcZFar(radius);
+        glm_perspective(((90.0f) * (float)M_PI / 180.0f), 1.0f, znear, zfar, projection);
 
         mat4 view;
         vec3 position;
@@ -665,15 +1483,38 @@ static void performPointLightShadowPass(RenderingData *data, Model* scene, mat4*
         glm_lookat(*pointLightPosition, position, (vec3){ 0, -1, 0 }, view);
         glm_mat4_mul(projection, view, data->shadowMap.cubemapMatrices[5]);
 
-        glViewport(0, 0, POINT_SHADOW_SIZE, POINT_SHADOW_SIZE);
-        gbuffer_bindGBufferForPointLightShadow(data->gbuffer, index);
+        shadowatlas_bindForRendering(data->shadowAtlas, slot);
 
         shader_setMat4(data->pointLightShadowShader, "u_model", modelMatrix);
         shader_setMat4Array(data->pointLightShadowShader, "u_shadowMatrices", data->shadowMap.cubemapMatrices, 6);
         shader_setVec3(data->pointLightShadowShader, "u_position", pointLightPosition);
         shader_setFloat(data->pointLightShadowShader, "u_zFar", zfar);
 
-        model_drawModel(scene, data->pointLightShadowShader);
+        // Meshes außerhalb des Radius werfen keinen sichtbaren Schatten. Alle
+        // anderen gibt der Geometry Shader nur an die Seiten aus, deren Bit in
+        // u_faceMask gesetzt ist.
+        for (unsigned int i = 0; i < model_getMeshCount(scene); ++i) {
+            Mesh *mesh = model_getMesh(scene, i);
+            if (!mesh_isInSphere(mesh, *modelMatrix, *pointLightPosition, radius)) {
+                continue;
+            }
+
+            int faceMask = 0;
+            for (int face = 0; face < 6; ++face) {
+                mat4 clipFromModel;
+                glm_mat4_mul(data->shadowMap.cubemapMatrices[face], *modelMatrix, clipFromModel);
+                if (mesh_isInFrustum(mesh, clipFromModel)) {
+                    faceMask |= 1 << face;
+                    data->shadowMap.pointShadowFaces++;
+                }
+            }
+
+            if (faceMask != 0) {
+                shader_setInt(data->pointLightShadowShader, "u_faceMask", faceMask);
+                mesh_drawMesh(mesh, data->pointLightShadowShader);
+                data->shadowMap.pointShadowMeshes++;
+            }
+        }
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glViewport(0, 0, width, height);
@@ -682,141 +1523,384 @@ static void performPointLightShadowPass(RenderingData *data, Model* scene, mat4*
 }
 
 /**
- * Führt den Punktlicht-Pass durch.
+ * Bestimmt die Bits der Licht-Varianten, die von den Schatten-Einstellungen
+ * abhängen. PCF wird nur zusammen mit Schatten gesetzt, damit keine
+ * gleichwertigen Varianten doppelt gebaut werden.
+ *
+ * @param shadowMap Die Schatten-Einstellungen.
+ * @return Die Bits aus LightVariant.
+ */
+static unsigned int getShadowVariantKey(const ShadowMap *shadowMap) {
+    if (!shadowMap->showShadows) {
+        return 0;
+    }
+
+    return LIGHT_VARIANT_SHADOWS | (shadowMap->usePCF ? LIGHT_VARIANT_PCF : 0);
+}
+
+/**
+ * Führt den Punktlicht-Pass durch. Ist das Lichtvolumen aktiv, wird zuerst in
+ * einem Stencil-Pass markiert, welche Pixel innerhalb der Lichtkugel liegen.
+ * Danach wird nur die Kugel selbst gerastert, sodass der Beleuchtungs-Shader
+ * nur für diese Pixel läuft. Liegt die Kamera im Volumen, wird stattdessen
+ * ein Fullscreen-Quad gezeichnet.
+ *
+ * Ist der Scissor-Test aktiv, werden beide Pässe auf das Bildschirmrechteck
+ * der Lichtkugel begrenzt und Lichter außerhalb des Sichtbereichs ganz
+ * übersprungen.
  *
  * @param data Zugriff auf das Rendering Datenobjekt.
  * @param projectionMatrix Die Projektionsmatrix der Szene.
  * @param viewMatrix Die View-Matrix der Szene.
- * @param modelMatrix Die Model-Matrix der Szene
  * @param cameraPosition Die Position der Kamera.
  * @param pointLight Das Punktlicht, das gerendert werden soll.
+ * @param index Index des Punktlichts für den Slot im Schatten-Atlas.
+ * @param width Die Breite des Bildschirms.
+ * @param height Die Höhe des Bildschirms.
  */
-static void performPointLightPass(RenderingData *data, mat4 *projectionMatrix, mat4 *viewMatrix, mat4 modelMatrix, vec3 *cameraPosition, PointLight *pointLight, int index) {
-    mat4 model;
-    glm_mat4_copy(modelMatrix, model);
+static void performPointLightPass(RenderingData *data, mat4 *projectionMatrix, mat4 *viewMatrix, vec3 *cameraPosition,
+                                  PointLight *pointLight, int index, int width, int height) {
+    LightVolumeFrame *frame = &data->lightVolume.frames[data->lightVolume.frameIndex];
+
+    // Bildschirmbereich der Lichtkugel bestimmen. Die Kugel wird dabei mit
+    // ihrem exakten Radius projiziert, da das Licht außerhalb keinen Beitrag
+    // mehr liefert.
+    int rect[4] = { 0, 0, width, height };
+    if (data->lightVolume.useScissor && data->light.isPointLightActive) {
+        if (!light_calcPointLightScreenRect(pointLight, light_calcPointLightRadius(pointLight),
+                                            *viewMatrix, *projectionMatrix, width, height, rect)) {
+            frame->skippedLights++;
+            return;
+        }
+    }
+    const bool useScissor = rect[0] > 0 || rect[1] > 0 || rect[2] < width || rect[3] < height;
+    if (useScissor) {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(rect[0], rect[1], rect[2], rect[3]);
+        frame->scissoredLights++;
+    }
 
+    // Die Lichtposition liegt bereits im Weltkoordinatensystem.
+    const float radius = light_calcPointLightRadius(pointLight) * data->lightVolume.scaleCorrection;
+    mat4 model;
+    glm_mat4_identity(model);
     glm_translate(model, pointLight->position);
-
-    const float radius = calcPointLightVolumeScale(*pointLight);
-    vec3 scale = { radius, radius, radius };
-    glm_scale(model, scale);
-
-    // common_pushRenderScope("Stencil-Pass");
-    // {
-    //     gbuffer_bindGBufferForStencilPass(data->gbuffer);
-    //     shader_useShader(data->nullShader);
-    //
-    //     shader_setMat4(data->nullShader, "u_projection", projectionMatrix);
-    //     shader_setMat4(data->nullShader, "u_view", viewMatrix);
-    //     shader_setMat4(data->nullShader, "u_model", &model);
-    //
-    //     glEnable(GL_DEPTH_TEST);
-    //     glClear(GL_STENCIL_BUFFER_BIT);
-    //     glEnable(GL_STENCIL_TEST);
-    //     glStencilFunc(GL_ALWAYS, 0, 0);
-    //     glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR, GL_KEEP);
-    //     glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR, GL_KEEP);
-    //     glDisable(GL_CULL_FACE);
-    //
-    //     if (data->light.isPointLightActive) {
-    //         renderLightVolume(data, data->nullShader);
-    //     }
-    // }
-    // common_popRenderScope();
+    glm_scale_uni(model, radius);
+
+    const bool useVolume = data->lightVolume.enabled
+                           && !isCameraInLightVolume(*cameraPosition, pointLight->position, radius);
+
+    if (useVolume && data->light.isPointLightActive) {
+        common_pushRenderScope("Stencil-Pass");
+        {
+            gbuffer_bindGBufferForStencilPass(data->gbuffer);
+            shader_useShader(data->nullShader);
+
+            shader_setMat4(data->nullShader, "u_projection", projectionMatrix);
+            shader_setMat4(data->nullShader, "u_view", viewMatrix);
+            shader_setMat4(data->nullShader, "u_model", &model);
+
+            // Nur Pixel, deren Geometrie zwischen Vorder- und Rückseite der
+            // Kugel liegt, behalten einen Stencil-Wert ungleich 0.
+            glEnable(GL_DEPTH_TEST);
+            glDepthMask(GL_FALSE);
+            glEnable(GL_DEPTH_CLAMP);
+            glDisable(GL_CULL_FACE);
+            glEnable(GL_STENCIL_TEST);
+            glStencilFunc(GL_ALWAYS, 0, 0);
+            glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+            glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+
+            renderLightVolume(&data->lightVolume);
+        }
+        common_popRenderScope();
+    }
 
     common_pushRenderScope("Pointlight-Pass");
     {
-        glStencilFunc(GL_NOTEQUAL, 0, 0xFF); // Pass only where stencil != 0
+        gbuffer_bindGBufferForLightPass(data->gbuffer);
+
         glDisable(GL_DEPTH_TEST);
         glEnable(GL_BLEND);
         glBlendEquation(GL_FUNC_ADD);
         glBlendFunc(GL_ONE, GL_ONE); // Additive blending
 
-        // glEnable(GL_CULL_FACE);
-        // glCullFace(GL_FRONT);
+        if (useVolume) {
+            // Nur Pixel mit Stencil != 0 beleuchten und den Stencil dabei
+            // gleich für das nächste Licht zurücksetzen.
+            glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+            glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
 
-        gbuffer_bindGBufferForLightPass(data->gbuffer);
-        shader_useShader(data->light.pointlightShader);
+            // Die Rückseiten zeichnen, damit die Kugel auch dann sichtbar
+            // bleibt, wenn ihre Vorderseite vor der Near-Plane liegt.
+            glEnable(GL_CULL_FACE);
+            glCullFace(GL_FRONT);
+        } else {
+            glDisable(GL_STENCIL_TEST);
+        }
+
+        // Nur Lichter mit einem Slot im Schatten-Atlas werfen Schatten und
+        // nutzen die Variante mit Schatten. Der Atlas selbst ist für alle
+        // Lichter des Frames bereits gebunden.
+        const int shadowSlot = shadowatlas_getLightSlot(data->shadowAtlas, index);
+        Shader *shader = shader_getVariant(data->light.pointlightShaders,
+                                           shadowSlot >= 0 ? getShadowVariantKey(&data->shadowMap) : 0);
 
-        shader_setMat4(data->light.pointlightShader, "u_projection", projectionMatrix);
-        shader_setMat4(data->light.pointlightShader, "u_view", viewMatrix);
-        shader_setMat4(data->light.pointlightShader, "u_model", &model);
+        if (shader != NULL) {
+            shader_useShader(shader);
 
-        parseColorAttachmentsForLight(data, data->light.pointlightShader);
+            shader_setMat4(shader, "u_projection", projectionMatrix);
+            shader_setMat4(shader, "u_view", viewMatrix);
+            shader_setMat4(shader, "u_model", &model);
+            shader_setBool(shader, "u_useLightVolume", useVolume);
 
-        setPointLightUniforms(data->light.pointlightShader, *pointLight);
-        shader_setBool(data->light.pointlightShader, "u_isActive", data->light.isPointLightActive);
-        shader_setVec3(data->light.pointlightShader, "u_cameraPos", cameraPosition);
-        shader_setBool(data->light.pointlightShader, "u_showShadows", data->shadowMap.showShadows);
-        shader_setBool(data->light.pointlightShader, "u_usePCF", data->shadowMap.usePCF);
+            parseColorAttachmentsForLight(data, shader);
 
-        const float zfar = 200;
-        shader_setFloat(data->light.pointlightShader, "u_zFar", zfar);
+            setPointLightUniforms(shader, *pointLight);
+            shader_setVec3(shader, "u_cameraPos", cameraPosition);
+            shader_setInt(shader, "u_shadowSlot", utils_maxInt(shadowSlot, 0));
+        }
 
-        GLuint shadowMap = gbuffer_getPointLightShadowMap(data->gbuffer, index);
-        glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_NUM_COLORATTACH);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, shadowMap);
-        shader_setInt(data->light.pointlightShader, "u_shadowMap", DEFAULT_GBUFFER_NUM_COLORATTACH);
+        if (shader != NULL && data->light.isPointLightActive) {
+            data->lightTimer.passes++;
+            beginLightVolumeQuery(&data->lightVolume, useVolume);
 
-        if (data->light.isPointLightActive) {
-            renderFullscreenQuad(data->fullscreenQuad);
+            if (useVolume) {
+                renderLightVolume(&data->lightVolume);
+            } else {
+                renderFullscreenQuad(data->fullscreenQuad);
+            }
+
+            glEndQuery(GL_SAMPLES_PASSED);
         }
 
         glCullFace(GL_BACK);
         glDisable(GL_BLEND);
+        glDisable(GL_DEPTH_CLAMP);
+        glDisable(GL_STENCIL_TEST);
+        glDisable(GL_SCISSOR_TEST);
+        glDepthMask(GL_TRUE);
     }
     common_popRenderScope();
 }
 
 /**
- * @brief Berechnet die Licht-Raum-Matrix für die gerichtete Beleuchtung.
+ * Führt den gekachelten bzw. geclusterten Punktlicht-Pass durch. Die Lichter
+ * werden auf der CPU in Bildschirmkacheln oder Cluster einsortiert, danach
+ * wertet ein einziger Fullscreen-Pass für jedes Fragment nur die Lichter
+ * seiner Zelle aus. Lichter mit einem Slot im Schatten-Atlas werfen dabei
+ * dieselben Schatten wie im Modus pro Licht.
  *
- * @param data Zeiger auf die RenderingData-Struktur, die Licht- und Schatteninformationen enthält.
- * @param lightSpace Zeiger auf die Matrix, in die die berechnete Licht-Raum-Transformation gespeichert wird.
+ * @param data Zugriff auf das Rendering Datenobjekt.
+ * @param projectionMatrix Die Projektionsmatrix der Szene.
+ * @param viewMatrix Die View-Matrix der Szene.
+ * @param cameraPosition Die Position der Kamera.
+ * @param pointLights Die Punktlichter, die gerendert werden sollen.
+ * @param count Die Anzahl der Punktlichter.
+ * @param width Die Breite des Bildschirms.
+ * @param height Die Höhe des Bildschirms.
+ */
+static void performTiledLightPass(RenderingData *data, mat4 *projectionMatrix, mat4 *viewMatrix, vec3 *cameraPosition,
+                                  PointLight **pointLights, int count, int width, int height) {
+    common_pushRenderScope(data->lightingMode == LIGHTING_MODE_CLUSTERED ? "Clustered-Light-Pass" : "Tiled-Light-Pass");
+    {
+        // Die Slots im Atlas werden nur für die Variante mit Schatten gebraucht.
+        const unsigned int shadowKey = data->light.isPointLightActive ? getShadowVariantKey(&data->shadowMap) : 0;
+        const ShadowAtlas *shadowAtlas = shadowKey ? data->shadowAtlas : NULL;
+        if (data->lightingMode == LIGHTING_MODE_CLUSTERED) {
+            lightgrid_updateClusters(data->lightGrid, pointLights, count, shadowAtlas,
+                                     *viewMatrix, *projectionMatrix, width, height);
+        } else {
+            lightgrid_updateTiles(data->lightGrid, pointLights, count, shadowAtlas,
+                                  *viewMatrix, *projectionMatrix, width, height);
+        }
+
+        gbuffer_bindGBufferForLightPass(data->gbuffer);
+
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_STENCIL_TEST);
+        glEnable(GL_BLEND);
+        glBlendEquation(GL_FUNC_ADD);
+        glBlendFunc(GL_ONE, GL_ONE); // Additive blending
+
+        Shader *shader = shader_getVariant(data->light.tiledLightShaders,
+                                           data->light.isPointLightActive ? LIGHT_VARIANT_POINT_LIGHTS | shadowKey : 0);
+        if (shader != NULL) {
+            shader_useShader(shader);
+
+            parseColorAttachmentsForLight(data, shader);
+            lightgrid_bindLightGrid(data->lightGrid, shader, DEFAULT_GBUFFER_NUM_COLORATTACH);
+            if (shadowKey) {
+                // Der Atlas folgt auf die drei Buffer des Lichtrasters.
+                shadowatlas_bindShadowAtlas(data->shadowAtlas, shader, DEFAULT_GBUFFER_NUM_COLORATTACH + 3);
+            }
+
+            shader_setVec3(shader, "u_cameraPos", cameraPosition);
+            shader_setMat4(shader, "u_view", viewMatrix);
+
+            data->lightTimer.passes++;
+            renderFullscreenQuad(data->fullscreenQuad);
+        }
+
+        glDisable(GL_BLEND);
+    }
+    common_popRenderScope();
+}
+
+/**
+ * Teilt den Sichtbereich der Kamera bis zur Schattenreichweite in Kaskaden
+ * und passt für jede Kaskade eine orthografische Projektion aus Sicht des
+ * Richtungslichts an.
  *
- * Diese Funktion berechnet die Licht-Raum-Matrix für die gerichtete Beleuchtung, indem sie:
- * 1. Die Blickrichtung des Lichts normalisiert und skaliert.
- * 2. Eine orthografische Projektionsmatrix basierend auf den Schattenkarteneinstellungen erstellt.
- * 3. Eine View-Matrix erstellt, die das Licht auf den Ursprung ausrichtet.
- * 4. Die Projektions- und View-Matrix multipliziert, um die endgültige Licht-Raum-Matrix zu erzeugen.
+ * Die Grenzen der Kaskaden mischen eine logarithmische und eine gleichmäßige
+ * Aufteilung. Jede Kaskade umschließt ihr Teil-Frustum mit einer Kugel, deren
+ * Größe sich beim Drehen der Kamera nicht ändert. Ihr Mittelpunkt wird im
+ * Lichtraum auf ganze Texel gerundet, damit die Schattenkanten beim Bewegen
+ * der Kamera nicht flimmern und unveränderte Kaskaden nicht neu gerendert
+ * werden müssen. Zum Licht hin wird jede Kaskade bis zum Rand der Szene
+ * verlängert, damit auch Schattenwerfer außerhalb des Sichtbereichs erfasst
+ * werden.
+ *
+ * @param data Zugriff auf das Rendering Datenobjekt.
+ * @param scene Die Szene, deren Schattenwerfer erfasst werden, oder NULL.
+ * @param modelMatrix Die Modellmatrix der Szene.
+ * @param viewMatrix Die View-Matrix der Kamera.
+ * @param fovy Der vertikale Öffnungswinkel der Kamera im Bogenmaß.
+ * @param aspect Das Seitenverhältnis der Kamera.
  */
-static void CalcDirLightSpace(RenderingData* data, mat4* lightSpace)
+static void CalcDirLightCascades(RenderingData *data, Model *scene, mat4 *modelMatrix, mat4 *viewMatrix,
+                                 float fovy, float aspect)
 {
-    vec3 eye;
-    glm_vec3_copy(data->light.defaultDirLight->direction, eye);
-    glm_normalize(eye);
-    glm_vec3_scale(eye, data->light.dirLightDistanceMult, eye);
+    ShadowMap *shadowMap = &data->shadowMap;
+    glm_mat4_copy(*viewMatrix, shadowMap->cascadeView);
+
+    // Alle Kaskaden teilen sich eine View-Matrix, die aus Richtung des Lichts
+    // auf den Ursprung blickt. Nur so bleibt das Texelraster beim Bewegen der
+    // Kamera in der Welt fest.
+    vec3 lightDir;
+    glm_vec3_copy(data->light.defaultDirLight->direction, lightDir);
+    glm_normalize(lightDir);
+
+    vec3 up = {0.0f, 1.0f, 0.0f};
+    if (fabsf(lightDir[1]) > 0.99f) {
+        up[1] = 0.0f;
+        up[2] = 1.0f;
+    }
+
+    mat4 lightView;
+    glm_lookat(lightDir, GLM_VEC3_ZERO, up, lightView);
+
+    // Der Lichtraum blickt entlang -z, die dem Licht nächste Ecke der Szene
+    // hat also das größte z.
+    float sceneMaxZ = -FLT_MAX;
+    if (scene != NULL) {
+        vec3 boundsMin, boundsMax;
+        model_getBounds(scene, boundsMin, boundsMax);
+
+        mat4 lightFromModel;
+        glm_mat4_mul(lightView, *modelMatrix, lightFromModel);
+
+        for (int corner = 0; corner < 8; ++corner) {
+            vec3 position = {
+                (corner & 1) ? boundsMax[0] : boundsMin[0],
+                (corner & 2) ? boundsMax[1] : boundsMin[1],
+                (corner & 4) ? boundsMax[2] : boundsMin[2]
+            };
+            glm_mat4_mulv3(lightFromModel, position, 1.0f, position);
+            sceneMaxZ = glm_max(sceneMaxZ, position[2]);
+        }
+    }
 
-    mat4 projection, view;
-    glm_ortho(-data->shadowMap.quadSize, data->shadowMap.quadSize, -data->shadowMap.quadSize, data->shadowMap.quadSize, data->shadowMap.zNear, data->shadowMap.zFar, projection);
-    glm_lookat(eye, GLM_VEC3_ZERO, GLM_YUP, view);
-    glm_mat4_mul(projection, view, *lightSpace);
+    const int count = shadowMap->cascadeCount;
+    const float nearDist = CAMERA_Z_NEAR;
+    const float farDist = glm_clamp(shadowMap->zFar, nearDist + 1.0f, CAMERA_Z_FAR);
+
+    float splitNear = nearDist;
+    for (int i = 0; i < count; ++i) {
+        const float t = (float) (i + 1) / (float) count;
+        const float logSplit = nearDist * powf(farDist / nearDist, t);
+        const float uniformSplit = nearDist + (farDist - nearDist) * t;
+        const float splitFar = shadowMap->splitLambda * logSplit + (1.0f - shadowMap->splitLambda) * uniformSplit;
+
+        // Die Ecken des Teil-Frustums in Weltkoordinaten bestimmen.
+        mat4 projection, invViewProjection;
+        glm_perspective(fovy, aspect, splitNear, splitFar, projection);
+        glm_mat4_mul(projection, *viewMatrix, invViewProjection);
+        glm_mat4_inv(invViewProjection, invViewProjection);
+
+        vec3 corners[8];
+        vec3 center = {0.0f, 0.0f, 0.0f};
+        for (int corner = 0; corner < 8; ++corner) {
+            vec4 position = {
+                (corner & 1) ? 1.0f : -1.0f,
+                (corner & 2) ? 1.0f : -1.0f,
+                (corner & 4) ? 1.0f : -1.0f,
+                1.0f
+            };
+            glm_mat4_mulv(invViewProjection, position, position);
+            glm_vec3_scale(position, 1.0f / position[3], corners[corner]);
+            glm_vec3_add(center, corners[corner], center);
+        }
+        glm_vec3_scale(center, 1.0f / 8.0f, center);
+
+        // Der Radius wird leicht aufgerundet, damit Rundungsfehler die Größe
+        // der Kaskade nicht von Frame zu Frame ändern.
+        float radius = 0.0f;
+        for (int corner = 0; corner < 8; ++corner) {
+            radius = glm_max(radius, glm_vec3_distance(corners[corner], center));
+        }
+        radius = ceilf(radius * 16.0f) / 16.0f;
+
+        const float texelSize = 2.0f * radius / (float) DIR_SHADOW_SIZE;
+
+        vec3 lightCenter;
+        glm_mat4_mulv3(lightView, center, 1.0f, lightCenter);
+        lightCenter[0] = floorf(lightCenter[0] / texelSize) * texelSize;
+        lightCenter[1] = floorf(lightCenter[1] / texelSize) * texelSize;
+
+        const float maxZ = ceilf(glm_max(lightCenter[2] + radius, sceneMaxZ) / texelSize) * texelSize;
+        const float minZ = floorf((lightCenter[2] - radius) / texelSize) * texelSize;
+
+        glm_ortho(lightCenter[0] - radius, lightCenter[0] + radius,
+                  lightCenter[1] - radius, lightCenter[1] + radius,
+                  -maxZ, -minZ, projection);
+        glm_mat4_mul(projection, lightView, shadowMap->cascadeLightSpaces[i]);
+
+        shadowMap->cascadeParams[i][0] = splitFar;
+        shadowMap->cascadeParams[i][1] = maxZ - minZ;
+        shadowMap->cascadeParams[i][2] = texelSize;
+        shadowMap->cascadeParams[i][3] = 0.0f;
+
+        splitNear = splitFar;
+    }
 }
 
 /**
- * @brief Performs the directional light shadow pass for the scene.
+ * @brief Performs the directional light shadow pass for one cascade.
  *
  * @param data Pointer to the RenderingData structure containing rendering-related information.
- * @param cameraPosition The position of the camera (currently unused).
  * @param modelMatrix Pointer to the model matrix used for rendering the scene.
- * @param lightSpace Pointer to the light space transformation matrix.
+ * @param cascade The cascade, i.e. the layer of the shadow map, to render.
  * @param scene Pointer to the Model structure representing the scene to be rendered.
  * @param width The width of the viewport for restoring after rendering.
  * @param height The height of the viewport for restoring after rendering.
+ * @return The number of meshes inside the cascade's light volume.
  *
- * This function renders the scene to the directional light shadow map by:
+ * This function renders the scene to one layer of the directional light shadow map by:
  * 1. Setting up the shader and enabling depth testing.
- * 2. Binding the shadow map framebuffer.
+ * 2. Binding the shadow map framebuffer with the cascade's layer attached.
  * 3. Configuring viewport for shadow map resolution.
- * 4. Rendering the scene with front-face culling to prevent shadow artifacts.
+ * 4. Rendering the meshes inside the cascade with front-face culling to prevent shadow artifacts.
  * 5. Restoring the original framebuffer and viewport settings.
  */
-static void PerformDirLightShadowPass(RenderingData* data, vec3 cameraPosition, mat4* modelMatrix, mat4* lightSpace, Model* scene, int width, int height)
+static int PerformDirLightShadowPass(RenderingData* data, mat4* modelMatrix, int cascade, Model* scene, int width, int height)
 {
-    (void)cameraPosition;
+    int drawn;
 
     common_pushRenderScope("DirLight-Shadow-Pass");
     {
+        mat4 *lightSpace = &data->shadowMap.cascadeLightSpaces[cascade];
+
         shader_useShader(data->dirLightShadowShader);
         glEnable(GL_DEPTH_TEST);
 
@@ -824,16 +1908,103 @@ static void PerformDirLightShadowPass(RenderingData* data, vec3 cameraPosition,
         shader_setMat4(data->dirLightShadowShader, "u_lightSpace", lightSpace);
 
         glViewport(0, 0, DIR_SHADOW_SIZE, DIR_SHADOW_SIZE);
-        gbuffer_bindGBufferForDirLightShadows(data->gbuffer);
+        gbuffer_bindGBufferForDirLightShadows(data->gbuffer, cascade);
+
+        mat4 clipFromModel;
+        glm_mat4_mul(*lightSpace, *modelMatrix, clipFromModel);
 
         glCullFace(GL_FRONT);
-        model_drawModel(scene, data->dirLightShadowShader);
+        drawn = model_drawModelInFrustum(scene, data->dirLightShadowShader, clipFromModel);
         glCullFace(GL_BACK);
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glViewport(0, 0, width, height);
     }
     common_popRenderScope();
+
+    return drawn;
+}
+
+/**
+ * Rendert die Schattenkarten neu, deren Eingaben sich seit dem letzten
+ * Rendern geändert haben. Jede Kaskade des Richtungslichts hängt von ihrer
+ * Licht-Raum-Matrix ab, die Richtung, Kameraausschnitt und Aufteilung
+ * enthält, jeder Slot des Schatten-Atlas von der Position seines Lichts. Eine
+ * geänderte Modellmatrix verschiebt die Geometrie und verwirft daher alle
+ * Schattenkarten.
+ *
+ * @param data Zugriff auf das Rendering Datenobjekt.
+ * @param scene Die Szene, deren Schatten gerendert werden.
+ * @param modelMatrix Die Modellmatrix der Szene.
+ * @param width Die Breite des Bildschirms.
+ * @param height Die Höhe des Bildschirms.
+ */
+static void updateShadowMaps(RenderingData *data, Scene *scene, mat4 *modelMatrix, int width, int height)
+{
+    ShadowMap *shadowMap = &data->shadowMap;
+    shadowMap->dirShadowRenders = 0;
+    shadowMap->dirShadowMeshes = 0;
+    shadowMap->pointShadowRenders = 0;
+    shadowMap->pointShadowMeshes = 0;
+    shadowMap->pointShadowFaces = 0;
+
+    if (memcmp(*modelMatrix, shadowMap->renderedModelMatrix, sizeof(mat4)) != 0) {
+        glm_mat4_copy(*modelMatrix, shadowMap->renderedModelMatrix);
+        memset(shadowMap->validCascades, 0, sizeof(shadowMap->validCascades));
+        shadowatlas_invalidateSlots(data->shadowAtlas);
+    }
+
+    for (int cascade = 0; cascade < shadowMap->cascadeCount; ++cascade) {
+        if (shadowMap->validCascades[cascade]
+            && memcmp(shadowMap->cascadeLightSpaces[cascade], shadowMap->renderedLightSpaces[cascade], sizeof(mat4)) == 0) {
+            continue;
+        }
+
+        shadowMap->dirShadowMeshes += PerformDirLightShadowPass(data, modelMatrix, cascade, scene->model, width, height);
+
+        glm_mat4_copy(shadowMap->cascadeLightSpaces[cascade], shadowMap->renderedLightSpaces[cascade]);
+        shadowMap->validCascades[cascade] = true;
+        shadowMap->dirShadowRenders++;
+    }
+
+    PointLight **pointLights = scene->countPointLights > 0 ? scene->pointLights : &data->light.defaultPointLight;
+
+    const int slotCount = shadowatlas_getSlotCount(data->shadowAtlas);
+    for (int slot = 0; slot < slotCount; ++slot) {
+        const PointLight *pointLight = pointLights[shadowatlas_getSlot(data->shadowAtlas, slot)->lightIndex];
+        const float radius = light_calcPointLightRadius(pointLight);
+
+        vec3 pointLightPosition;
+        glm_vec3_copy((float *) pointLight->position, pointLightPosition);
+
+        if (shadowatlas_isSlotValid(data->shadowAtlas, slot, pointLightPosition, radius)) {
+            continue;
+        }
+
+        performPointLightShadowPass(data, scene->model, modelMatrix, &pointLightPosition, radius, slot, width, height);
+        shadowatlas_validateSlot(data->shadowAtlas, slot, pointLightPosition, radius);
+        shadowMap->pointShadowRenders++;
+    }
+}
+
+/**
+ * Übergibt die Kaskaden des Richtungslichts an einen Beleuchtungs-Shader und
+ * bindet die Schattenkarte an die erste freie Textur-Einheit.
+ *
+ * @param data Zugriff auf das Rendering Datenobjekt.
+ * @param shader Der Shader, der die Schatten auswertet.
+ */
+static void setDirLightShadowUniforms(RenderingData *data, Shader *shader) {
+    ShadowMap *shadowMap = &data->shadowMap;
+
+    shader_setMat4(shader, "u_view", &shadowMap->cascadeView);
+    shader_setMat4Array(shader, "u_lightSpaces", shadowMap->cascadeLightSpaces, DIR_SHADOW_MAX_CASCADES);
+    shader_setVec4Array(shader, "u_cascades", shadowMap->cascadeParams, DIR_SHADOW_MAX_CASCADES);
+    shader_setInt(shader, "u_cascadeCount", shadowMap->cascadeCount);
+
+    glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_NUM_COLORATTACH);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, gbuffer_getDirLightShadowMap(data->gbuffer));
+    shader_setInt(shader, "u_shadowMap", DEFAULT_GBUFFER_NUM_COLORATTACH);
 }
 
 /**
@@ -843,10 +2014,10 @@ static void PerformDirLightShadowPass(RenderingData* data, vec3 cameraPosition,
  * @param cameraPosition Die Position der Kamera.
  * @param dirLight Das Richtungslicht, das gerendert werden soll.
  */
-static void performDirLightPass(RenderingData *data, vec3 *cameraPosition, DirLight *dirLight, mat4 *lightSpace) {
+static void performDirLightPass(RenderingData *data, vec3 *cameraPosition, DirLight *dirLight) {
     common_pushRenderScope("DirLight-Pass");
     {
-        shader_useShader(data->light.dirlightShader);
+        Shader *shader = shader_getVariant(data->light.dirlightShaders, getShadowVariantKey(&data->shadowMap));
 
         glEnable(GL_BLEND);
         glBlendEquation(GL_FUNC_ADD);
@@ -854,26 +2025,23 @@ static void performDirLightPass(RenderingData *data, vec3 *cameraPosition, DirLi
 
         gbuffer_bindGBufferForLightPass(data->gbuffer);
 
-        parseColorAttachmentsForLight(data, data->light.dirlightShader);
+        if (shader != NULL) {
+            shader_useShader(shader);
 
-        setDirLightUniforms(data->light.dirlightShader, *dirLight);
-        shader_setBool(data->light.dirlightShader, "u_isActive", data->light.isDirLightActive);
-        shader_setVec3(data->light.dirlightShader, "u_cameraPos", cameraPosition);
-        shader_setMat4(data->light.dirlightShader, "u_lightSpace", lightSpace);
-        shader_setBool(data->light.dirlightShader, "u_showShadows", data->shadowMap.showShadows);
-        shader_setBool(data->light.dirlightShader, "u_usePCF", data->shadowMap.usePCF);
+            parseColorAttachmentsForLight(data, shader);
 
-        GLuint shadowMap = gbuffer_getDirLightShadowMap(data->gbuffer);
-        glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_NUM_COLORATTACH);
-        glBindTexture(GL_TEXTURE_2D, shadowMap);
-        shader_setInt(data->light.dirlightShader, "u_shadowMap", DEFAULT_GBUFFER_NUM_COLORATTACH);
+            setDirLightUniforms(shader, *dirLight);
+            shader_setVec3(shader, "u_cameraPos", cameraPosition);
+            setDirLightShadowUniforms(data, shader);
+        }
 
         glEnable(GL_STENCIL_TEST);
         glStencilFunc(GL_ALWAYS, 0, 0xFF);
         glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
         glDisable(GL_STENCIL_TEST);
 
-        if (data->light.isDirLightActive) {
+        if (shader != NULL && data->light.isDirLightActive) {
+            data->lightTimer.passes++;
             renderFullscreenQuad(data->fullscreenQuad);
         }
 
@@ -883,215 +2051,797 @@ static void performDirLightPass(RenderingData *data, vec3 *cameraPosition, DirLi
 }
 
 /**
- * Führt den Threshold-Pass durch.
+ * Führt den Einzelpass für alle Punkt- und Richtungslichter durch. Die
+ * Lichter werden in einen Uniform Buffer geladen und von einem einzigen
+ * Fullscreen-Pass ausgewertet, der das Ergebnis ohne Blending schreibt. Passen
+ * nicht alle Punktlichter in den Buffer, werden die übrigen in weiteren
+ * Durchgängen additiv ergänzt. Punktlichtschatten werden in diesem Modus nicht
+ * berücksichtigt.
  *
- * Dieser Pass extrahiert helle Bildanteile (Lichter, Glühen) aus der Final-Buffer-Phase,
- * um sie für nachfolgende Bloom-Effekte zu nutzen. Er wird üblicherweise zwischen
- * der Beleuchtungs- und der Bloom-Blur-Phase ausgeführt.
- *
- * @param data Zugriff auf das Rendering-Datenobjekt.
+ * @param data Zugriff auf das Rendering Datenobjekt.
+ * @param cameraPosition Die Position der Kamera.
+ * @param pointLights Die Punktlichter, die gerendert werden sollen.
+ * @param pointCount Die Anzahl der Punktlichter.
+ * @param dirLights Die Richtungslichter, die gerendert werden sollen.
+ * @param dirCount Die Anzahl der Richtungslichter.
  */
-static void performThresholdPass(RenderingData *data) {
-    common_pushRenderScope("Threshold-Pass");
+static void performMultiLightPass(RenderingData *data, vec3 *cameraPosition,
+                                  PointLight **pointLights, int pointCount,
+                                  DirLight **dirLights, int dirCount) {
+    common_pushRenderScope("Multi-Light-Pass");
     {
-        shader_useShader(data->thresholdShader);
+        gbuffer_bindGBufferForLightPass(data->gbuffer);
+
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_STENCIL_TEST);
+        glDisable(GL_BLEND);
 
-        gbuffer_bindGBufferForThreshold(data->gbuffer);
-        parseColorAttachmentsForThreshold(data, data->thresholdShader);
+        // Die Richtungslichter samt Schatten werden nur im ersten Durchgang
+        // ausgewertet, alle weiteren nutzen die Variante nur mit Punktlichtern.
+        const unsigned int pointKey = data->light.isPointLightActive ? LIGHT_VARIANT_POINT_LIGHTS : 0;
+        const unsigned int firstKey = pointKey
+                | (data->light.isDirLightActive ? LIGHT_VARIANT_DIR_LIGHTS | getShadowVariantKey(&data->shadowMap) : 0);
+        Shader *shader = NULL;
+
+        int first = 0;
+        do {
+            const int count = utils_minInt(pointCount - first, LIGHTBUFFER_MAX_POINT_LIGHTS);
+
+            // Die Richtungslichter und die Emission werden nur im ersten
+            // Durchgang ausgewertet, alle weiteren werden darauf addiert.
+            const bool isFirst = first == 0;
+            Shader *passShader = shader_getVariant(data->light.multiLightShaders, isFirst ? firstKey : pointKey);
+            if (passShader == NULL) {
+                break;
+            }
+            if (passShader != shader) {
+                shader = passShader;
+                shader_useShader(shader);
 
-        shader_setFloat(data->thresholdShader, "u_colorWeight", data->postprocessing.bloom.colorWeight);
-        shader_setFloat(data->thresholdShader, "u_emissionWeight", data->postprocessing.bloom.emissionWeight);
-        shader_setFloat(data->thresholdShader, "u_threshold", data->postprocessing.bloom.threshold);
+                parseColorAttachmentsForLight(data, shader);
 
-        renderFullscreenQuad(data->fullscreenQuad);
+                shader_setVec3(shader, "u_cameraPos", cameraPosition);
+                setDirLightShadowUniforms(data, shader);
+            }
+
+            lightbuffer_updateLightBuffer(data->lightBuffer, pointLights + first, count,
+                                          dirLights, isFirst ? dirCount : 0);
+            lightbuffer_bindLightBuffer(data->lightBuffer, shader);
+            shader_setBool(shader, "u_writeEmission", isFirst);
+
+            if (!isFirst) {
+                glEnable(GL_BLEND);
+                glBlendEquation(GL_FUNC_ADD);
+                glBlendFunc(GL_ONE, GL_ONE); // Additive blending
+            }
+
+            data->lightTimer.passes++;
+            renderFullscreenQuad(data->fullscreenQuad);
+
+            first += count;
+        } while (first < pointCount);
+
+        glDisable(GL_BLEND);
     }
     common_popRenderScope();
 }
 
 /**
- * Führt den Blur-Pass für den Bloom-Effekt durch.
+ * Führt den Geometry-Pass durch und schreibt alle Texturen des G-Buffers außer
+ * dem finalen Bild.
  *
- * Dieser Pass führt mehrfache horizontale und vertikale Weichzeichnungsdurchläufe (Blur-Iterationen) durch,
- * um aus den zuvor extrahierten hellen Bildanteilen einen weichen Bloom-Effekt zu erzeugen.
+ * @param userData Die Daten des Frames (FrameContext).
+ */
+static void performGeometryPass(void *userData) {
+    FrameContext *frame = userData;
+    RenderingData *data = frame->data;
+    InputData *input = frame->ctx->input;
+
+    gbuffer_bindGBufferForGeomPass(data->gbuffer);
+
+    // Bei verringerter Auflösung wird nur in einen Teil des G-Buffers
+    // gerendert, alle folgenden Pässe behalten diesen Viewport.
+    glViewport(0, 0, frame->width, frame->height);
+
+    glEnable(GL_DEPTH_TEST);
+
+    // Überprüfen, ob der Wireframe-Modus verwendet werden soll.
+    if (input->showWireframe) {
+        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        glDisable(GL_CULL_FACE); // Deaktivierung des Face Cullings
+    } else {
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        glEnable(GL_CULL_FACE); // Aktivierung des Face Cullings
+    }
+
+    if (input->rendering.userScene) {
+        drawModelVariants(data, input->rendering.userScene->model, &frame->modelMatrix,
+                          &frame->projectionMatrix, &frame->viewMatrix, &frame->cameraPosition);
+    }
+
+    // Die Licht-Pässe lesen die Tiefe aus einer Kopie, da sie gegen den
+    // Tiefenpuffer selbst noch testen und in seinen Stencil schreiben.
+    gbuffer_copyDepth(data->gbuffer, frame->width, frame->height);
+}
+
+/**
+ * Rendert die Schattenkarten neu, deren Licht, Kaskade oder Szene sich
+ * geändert hat. Die übrigen behalten ihren Inhalt aus früheren Frames.
+ *
+ * @param userData Die Daten des Frames (FrameContext).
+ */
+static void performShadowPass(void *userData) {
+    FrameContext *frame = userData;
+    InputData *input = frame->ctx->input;
+
+    if (input->rendering.userScene) {
+        updateShadowMaps(frame->data, input->rendering.userScene, &frame->modelMatrix,
+                         frame->width, frame->height);
+    }
+}
+
+/**
+ * Führt die Beleuchtung im gewählten Verfahren durch und schreibt sie in das
+ * finale Bild.
+ *
+ * @param userData Die Daten des Frames (FrameContext).
+ */
+static void performLightPass(void *userData) {
+    FrameContext *frame = userData;
+    RenderingData *data = frame->data;
+    InputData *input = frame->ctx->input;
+    const int width = frame->width;
+    const int height = frame->height;
+
+    gbuffer_bindGBufferForLightPass(data->gbuffer);
+
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glEnable(GL_CULL_FACE);
+
+    if (input->rendering.userScene) {
+         beginLightVolumeFrame(&data->lightVolume, (GLuint64) width * (GLuint64) height);
+         beginPassTimer(&data->lightTimer);
+
+         if (data->lightingMode == LIGHTING_MODE_SINGLE_PASS) {
+             Scene *scene = input->rendering.userScene;
+             performMultiLightPass(data, &frame->cameraPosition,
+                                   scene->countPointLights > 0 ? scene->pointLights : &data->light.defaultPointLight,
+                                   scene->countPointLights > 0 ? scene->countPointLights : 1,
+                                   scene->countDirLights > 0 ? scene->dirLights : &data->light.defaultDirLight,
+                                   scene->countDirLights > 0 ? scene->countDirLights : 1);
+         } else if (data->lightingMode == LIGHTING_MODE_TILED || data->lightingMode == LIGHTING_MODE_CLUSTERED) {
+             if (input->rendering.userScene->countPointLights > 0) {
+                 performTiledLightPass(data, &frame->projectionMatrix, &frame->viewMatrix, &frame->cameraPosition,
+                                       input->rendering.userScene->pointLights, input->rendering.userScene->countPointLights,
+                                       width, height);
+             } else {
+                 performTiledLightPass(data, &frame->projectionMatrix, &frame->viewMatrix, &frame->cameraPosition,
+                                       &data->light.defaultPointLight, 1,
+                                       width, height);
+             }
+         } else {
+             // Der Schatten-Atlas wird einmal für alle Lichter gebunden,
+             // jedes Licht wählt darin nur noch seinen Slot.
+             // Nur die Variante mit Schatten liest den Atlas.
+             const unsigned int shadowKey = getShadowVariantKey(&data->shadowMap);
+             Shader *shadowShader = shadowKey ? shader_getVariant(data->light.pointlightShaders, shadowKey) : NULL;
+             if (shadowShader != NULL) {
+                 shader_useShader(shadowShader);
+                 shadowatlas_bindShadowAtlas(data->shadowAtlas, shadowShader, DEFAULT_GBUFFER_NUM_COLORATTACH);
+             }
+
+             for (int i = 0; i < input->rendering.userScene->countPointLights; ++i) {
+                 PointLight *pointLight = input->rendering.userScene->pointLights[i];
+                 performPointLightPass(data, &frame->projectionMatrix, &frame->viewMatrix, &frame->cameraPosition,
+                                       pointLight, i, width, height);
+             }
+
+             if (input->rendering.userScene->countPointLights <= 0) {
+                 performPointLightPass(data, &frame->projectionMatrix, &frame->viewMatrix, &frame->cameraPosition,
+                                       data->light.defaultPointLight, 0, width, height);
+             }
+         }
+
+         endLightVolumeFrame(&data->lightVolume);
+
+        glClear(GL_STENCIL_BUFFER_BIT);
+        glDisable(GL_STENCIL_TEST);
+
+        // Im Einzelpass-Modus sind die Richtungslichter bereits enthalten.
+        if (data->lightingMode != LIGHTING_MODE_SINGLE_PASS) {
+            for (int i = 0; i < input->rendering.userScene->countDirLights; ++i) {
+                DirLight *dirLight = input->rendering.userScene->dirLights[i];
+                performDirLightPass(data, &frame->cameraPosition, dirLight);
+            }
+
+            if (input->rendering.userScene->countDirLights <= 0) {
+                performDirLightPass(data, &frame->cameraPosition, data->light.defaultDirLight);
+            }
+        }
+
+        endPassTimer(&data->lightTimer);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+/**
+ * Führt die Bloom-Pässe durch.
+ *
+ * Das finale Bild wird über eine Mip-Kette ab halber Auflösung schrittweise
+ * verkleinert und danach wieder vergrößert, wobei jede Stufe auf die nächst
+ * größere addiert wird. Der Schwellenwert wird beim ersten Verkleinern
+ * angewandt, ein eigener Pass in voller Auflösung entfällt. Da jede Stufe nur
+ * ein Viertel der Pixel der vorherigen hat, kostet die ganze Kette etwa so
+ * viel wie ein Pass in halber Auflösung, reicht aber über die Breite der
+ * kleinsten Stufe.
+ *
+ * @param userData Die Daten des Frames (FrameContext).
+ */
+static void performBloomPass(void *userData) {
+    FrameContext *frame = userData;
+    RenderingData *data = frame->data;
+    Bloom *bloom = &data->postprocessing.bloom;
+
+    beginPassTimer(&bloom->timer);
+
+    glDisable(GL_BLEND);
+
+    shader_useShader(data->bloomDownShader);
+    shader_setFloat(data->bloomDownShader, "u_colorWeight", bloom->colorWeight);
+    shader_setFloat(data->bloomDownShader, "u_emissionWeight", bloom->emissionWeight);
+    shader_setFloat(data->bloomDownShader, "u_threshold", bloom->threshold);
+
+    // Genutzter Bereich jeder Stufe, bei verringerter Auflösung nur ein Teil
+    // der für das Fenster angelegten Textur
+    int levelWidths[BLOOM_MAX_LEVELS], levelHeights[BLOOM_MAX_LEVELS];
+    for (int level = 0; level < bloom->levels; ++level) {
+        getBloomLevelSize(frame->width, frame->height, level, &levelWidths[level], &levelHeights[level]);
+    }
+
+    // Verkleinern, die erste Stufe liest das finale Bild und die Emission
+    parseColorAttachmentsForBloom(data, data->bloomDownShader);
+    for (int level = 0; level < bloom->levels; ++level) {
+        rendergraph_bindTarget(data->renderGraph, data->resources.bloom[level]);
+        glViewport(0, 0, levelWidths[level], levelHeights[level]);
+
+        shader_setBool(data->bloomDownShader, "u_prefilter", level == 0);
+        parseBloomLevel(data, data->bloomDownShader, utils_maxInt(level - 1, 0));
+        if (level == 0) {
+            setSourceSize(data->bloomDownShader, frame->width, frame->height);
+        } else {
+            setSourceSize(data->bloomDownShader, levelWidths[level - 1], levelHeights[level - 1]);
+        }
+
+        renderFullscreenQuad(data->fullscreenQuad);
+        bloom->timer.passes++;
+    }
+    glBindSampler(DEFAULT_GBUFFER_COLORATTACH_FINAL, 0);
+    glBindSampler(DEFAULT_GBUFFER_COLORATTACH_EMISSION, 0);
+
+    // Vergrößern, jede Stufe wird auf die nächst größere addiert
+    shader_useShader(data->bloomUpShader);
+    shader_setFloat(data->bloomUpShader, "u_filterRadius", BLOOM_FILTER_RADIUS);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    for (int level = bloom->levels - 2; level >= 0; --level) {
+        rendergraph_bindTarget(data->renderGraph, data->resources.bloom[level]);
+        glViewport(0, 0, levelWidths[level], levelHeights[level]);
+        parseBloomLevel(data, data->bloomUpShader, level + 1);
+        setSourceSize(data->bloomUpShader, levelWidths[level + 1], levelHeights[level + 1]);
+
+        renderFullscreenQuad(data->fullscreenQuad);
+        bloom->timer.passes++;
+    }
+    glDisable(GL_BLEND);
+
+    glViewport(0, 0, frame->width, frame->height);
+
+    endPassTimer(&bloom->timer);
+}
+
+/**
+ * Führt einen Blur-Pass der Tiefenunschärfe über das verkleinerte Bild durch.
+ * Horizontale und vertikale Pässe wechseln sich ab, jeder liest das Ergebnis
+ * des vorherigen.
+ *
+ * @param userData Der Blur-Pass (BlurStep).
+ */
+static void performBlurPass(void *userData) {
+    const BlurStep *step = userData;
+    RenderingData *data = step->frame->data;
+    int width, height;
+    getDepthOfFieldSize(step->frame, &width, &height);
+
+    shader_useShader(data->blurShader);
+
+    rendergraph_bindTarget(data->renderGraph, step->target);
+    glViewport(0, 0, width, height);
+
+    parseColorAttachmentsForBlur(data, data->blurShader, step->source);
+    setSourceSize(data->blurShader, width, height);
+
+    shader_setInt(data->blurShader, "u_horizontal", step->horizontal);
+
+    renderFullscreenQuad(data->fullscreenQuad);
+    data->postprocessing.dofTimer.passes++;
+}
+
+/**
+ * Legt fest, welche Stufen der Nachbearbeitung im aktuellen Frame aktiv sind
+ * und wie viele Pässe sie benötigen. Alle Stufen pro Pixel (Nebel, Bloom,
+ * Belichtung und Gamma, Skybox) laufen zusammen in einem Fullscreen-Pass, der
+ * direkt in das Ausgabeziel schreibt. Nur die Tiefenunschärfe braucht das
+ * fertige Bild verkleinert und weichgezeichnet. Die Stufen werden dann beim
+ * Verkleinern und beim Zusammensetzen ausgewertet, statt das Bild vorher in
+ * voller Auflösung zu schreiben und wieder zu lesen.
+ *
+ * Zum Vergleich wird geschätzt, was dieselben Stufen als einzelne Pässe
+ * gekostet hätten: Nebel und Skybox lesen und schreiben dabei jeweils das
+ * finale Bild, und ohne Tiefenunschärfe muss es mit Skybox noch in das
+ * Ausgabeziel kopiert werden.
  *
  * @param data Zugriff auf das Rendering-Datenobjekt.
- * @param isDepthOfField
+ * @param plan Ausgabeparameter für den Plan.
  */
-static void performBlurPass(RenderingData *data, bool isDepthOfField) {
-    common_pushRenderScope("Blur-Pass");
-    {
-        bool isHorizontal = true;
-        bool isEntry = true;
-        for (int i = 0; i < data->postprocessing.bloom.blurIterations * 2; ++i) {
-            shader_useShader(data->blurShader);
+static void compilePostprocessPlan(const RenderingData *data, PostprocessPlan *plan) {
+    const Postprocessing *postprocessing = &data->postprocessing;
+
+    plan->stages = POSTPROCESS_STAGE_TONEMAP;
+    if (data->fog.fogEnabled) { plan->stages |= POSTPROCESS_STAGE_FOG; }
+    if (postprocessing->bloom.levels > 0) { plan->stages |= POSTPROCESS_STAGE_BLOOM; }
+    if (data->skybox.skyboxEnabled) { plan->stages |= POSTPROCESS_STAGE_SKYBOX; }
+    if (postprocessing->useDoF) { plan->stages |= POSTPROCESS_STAGE_DOF; }
+
+    // Lesen der Tiefe, des finalen Bildes und der Bloom-Stufe pro Auswertung
+    const double bloomBytes = (plan->stages & POSTPROCESS_STAGE_BLOOM) ? POSTPROCESS_BLOOM_BYTES : 0.0;
+    const double fusedRead = POSTPROCESS_DEPTH_BYTES + POSTPROCESS_FINAL_BYTES + bloomBytes;
+
+    if (plan->stages & POSTPROCESS_STAGE_DOF) {
+        // Verkleinern schreibt, jeder Blur-Pass liest und schreibt, das
+        // Zusammensetzen liest Farbe und Blur in verringerter Auflösung.
+        const double lowRes = 1.0 / (double) (postprocessing->dofDivisor * postprocessing->dofDivisor);
+        const double dofBytes = lowRes * POSTPROCESS_DOF_TEXEL_BYTES * (1.0 + DOF_BLUR_ITERATIONS * 2 * 2.0 + 2.0);
+
+        plan->passes = 2;
+        plan->bytesPerPixel = 2.0 * fusedRead + POSTPROCESS_OUTPUT_BYTES + dofBytes;
+
+        // Getrennt: Nachbearbeitung in das finale Bild, danach liest die
+        // Tiefenunschärfe Tiefe und finales Bild zweimal.
+        plan->separatePasses = 3;
+        plan->separateBytesPerPixel = POSTPROCESS_FINAL_BYTES + bloomBytes + POSTPROCESS_FINAL_BYTES
+                                      + 2.0 * (POSTPROCESS_DEPTH_BYTES + POSTPROCESS_FINAL_BYTES)
+                                      + POSTPROCESS_OUTPUT_BYTES + dofBytes;
+    } else {
+        plan->passes = 1;
+        plan->bytesPerPixel = fusedRead + POSTPROCESS_OUTPUT_BYTES;
+
+        // Getrennt: Nachbearbeitung, mit Skybox in das finale Bild und
+        // anschließend in das Ausgabeziel kopiert
+        plan->separatePasses = 1;
+        plan->separateBytesPerPixel = POSTPROCESS_FINAL_BYTES + bloomBytes;
+        if (plan->stages & POSTPROCESS_STAGE_SKYBOX) {
+            plan->separatePasses++;
+            plan->separateBytesPerPixel += 2.0 * POSTPROCESS_FINAL_BYTES + POSTPROCESS_OUTPUT_BYTES;
+        } else {
+            plan->separateBytesPerPixel += POSTPROCESS_OUTPUT_BYTES;
+        }
+    }
 
-            gbuffer_bindGBufferForBlur(data->gbuffer, isHorizontal);
+    // Nebel und Skybox als eigene Pässe lesen Tiefe und finales Bild und
+    // schreiben das finale Bild
+    const double stageBytes = POSTPROCESS_DEPTH_BYTES + 2.0 * POSTPROCESS_FINAL_BYTES;
+    if (plan->stages & POSTPROCESS_STAGE_FOG) {
+        plan->separatePasses++;
+        plan->separateBytesPerPixel += stageBytes;
+    }
+    if (plan->stages & POSTPROCESS_STAGE_SKYBOX) {
+        plan->separatePasses++;
+        plan->separateBytesPerPixel += stageBytes;
+    }
+}
 
-            parseColorAttachmentsForBlur(data, data->blurShader, isHorizontal, isEntry, isDepthOfField);
+/**
+ * Führt die zusammengefasste Nachbearbeitung ohne Tiefenunschärfe in einem
+ * einzigen Fullscreen-Pass direkt in das Ausgabeziel durch.
+ *
+ * @param userData Die Daten des Frames (FrameContext).
+ */
+static void performPostprocessPass(void *userData) {
+    FrameContext *frame = userData;
+    RenderingData *data = frame->data;
 
-            shader_setInt(data->blurShader, "u_horizontal", isHorizontal);
+    beginPassTimer(&data->postprocessing.timer);
+    {
+        bindFinalTarget(frame);
 
+        if (usePostprocessVariant(data, data->postprocessShaders, &frame->cameraPosition) != NULL) {
             renderFullscreenQuad(data->fullscreenQuad);
+            data->postprocessing.timer.passes++;
+        }
+    }
+    endPassTimer(&data->postprocessing.timer);
+}
+
+/**
+ * Verkleinert das nachbearbeitete Bild für die Tiefenunschärfe auf die halbe
+ * oder viertel Auflösung, wobei jeder Texel die Entfernung zur Kamera im
+ * Alpha-Kanal mitbekommt. Die Stufen der Nachbearbeitung werden dabei und
+ * beim Zusammensetzen pro Pixel ausgewertet (siehe compilePostprocessPlan).
+ * Die Zeitmessung der Tiefenunschärfe beginnt hier und endet beim
+ * Zusammensetzen, der Render-Graph lässt immer alle ihre Pässe laufen oder
+ * keinen.
+ *
+ * @param userData Die Daten des Frames (FrameContext).
+ */
+static void performDepthOfFieldDownsamplePass(void *userData) {
+    FrameContext *frame = userData;
+    RenderingData *data = frame->data;
+    Postprocessing *postprocessing = &data->postprocessing;
+
+    beginPassTimer(&postprocessing->dofTimer);
+
+    // Verkleinern, dabei die Entfernung zur Kamera mitschreiben
+    int width, height;
+    getDepthOfFieldSize(frame, &width, &height);
+    rendergraph_bindTarget(data->renderGraph, data->resources.dofColor);
+    glViewport(0, 0, width, height);
+    Shader *downShader = usePostprocessVariant(data, data->dofDownsampleShaders, &frame->cameraPosition);
+    if (downShader != NULL) {
+        shader_setInt(downShader, "u_divisor", postprocessing->dofDivisor);
 
-            isHorizontal = !isHorizontal;
-            if (isEntry) {
-                isEntry = false;
-            }
-        }
+        renderFullscreenQuad(data->fullscreenQuad);
+        postprocessing->dofTimer.passes++;
     }
-    common_popRenderScope();
 }
 
 /**
- * Führt den Nebel-Pass durch.
+ * Setzt die Tiefenunschärfe zusammen mit der übrigen Nachbearbeitung in
+ * voller Auflösung in das Ausgabeziel.
  *
- * Dieser Pass mischt auf Basis der Kameraposition und zuvor gerenderter Tiefeninformationen
- * Nebel über das aktuelle Bild. Dabei wird die in den Shader-Uniforms
- * gesetzte Nebeldichte und -farbe genutzt, um Objekte in der Ferne in Nebel eintauchen zu lassen.
+ * Das weichgezeichnete Bild wird dabei bilateral vergrößert: Texel, deren
+ * Entfernung stark von der des Pixels abweicht, zählen kaum, damit Unschärfe
+ * nicht über Tiefenkanten blutet. Der Zerstreuungskreis bestimmt danach, wie
+ * viel vom scharfen und vom unscharfen Bild genommen wird.
  *
- * @param data Zugriff auf das Rendering-Datenobjekt.
- * @param cameraPosition Die Position der Kamera in Weltkoordinaten.
+ * @param userData Die Daten des Frames (FrameContext).
  */
-static void performFogPass(RenderingData *data, vec3 *cameraPosition) {
-    common_pushRenderScope("Fog-Pass");
-    {
-        shader_useShader(data->fog.shader);
-        gbuffer_bindGBufferForFog(data->gbuffer);
-        parseColorAttachmentsForFog(data, data->fog.shader);
+static void performDepthOfFieldCompositePass(void *userData) {
+    FrameContext *frame = userData;
+    RenderingData *data = frame->data;
+    Postprocessing *postprocessing = &data->postprocessing;
+
+    bindFinalTarget(frame);
+
+    Shader *dofShader = usePostprocessVariant(data, data->depthOfFieldShaders, &frame->cameraPosition);
+    if (dofShader != NULL) {
+        int width, height;
+        getDepthOfFieldSize(frame, &width, &height);
+        vec2 dofSize = { (float) width, (float) height };
+        shader_setVec2(dofShader, "u_dofSize", &dofSize);
+
+        const GLuint colorTex = rendergraph_getTexture(data->renderGraph, data->resources.dofColor);
+        glActiveTexture(GL_TEXTURE0 + POSTPROCESS_UNIT_DOF_COLOR);
+        glBindTexture(GL_TEXTURE_2D, colorTex);
+        shader_setInt(dofShader, "u_dofColor", POSTPROCESS_UNIT_DOF_COLOR);
+
+        const GLuint blurTex = rendergraph_getTexture(data->renderGraph, data->resources.dofBlur);
+        glActiveTexture(GL_TEXTURE0 + POSTPROCESS_UNIT_DOF_BLUR);
+        glBindTexture(GL_TEXTURE_2D, blurTex);
+        shader_setInt(dofShader, "u_dofBlur", POSTPROCESS_UNIT_DOF_BLUR);
 
-        shader_setVec3(data->fog.shader, "u_cameraPos", cameraPosition);
-        shader_setVec3(data->fog.shader, "u_fogColor", &data->fog.color);
-        shader_setFloat(data->fog.shader, "u_fogDensity", data->fog.fogDensity);
+        shader_setFloat(dofShader, "u_focusDistance", postprocessing->focusDistance);
+        shader_setFloat(dofShader, "u_depthOfField", postprocessing->depthOfField);
 
         renderFullscreenQuad(data->fullscreenQuad);
+        postprocessing->dofTimer.passes++;
     }
-    common_popRenderScope();
+
+    endPassTimer(&postprocessing->dofTimer);
 }
 
 /**
- * Führt den Skybox-Pass durch.
+ * Skaliert das in verringerter Auflösung fertig gerenderte Bild bilinear auf
+ * die volle Größe des Ausgabeziels.
  *
- * Dieser Pass rendert eine Skybox um die Szene herum. Die Skybox wird
- * anhand der Normal- und Final-Buffers im Hintergrund eingeblendet.
+ * @param userData Die Daten des Frames (FrameContext).
+ */
+static void performUpscalePass(void *userData) {
+    FrameContext *frame = userData;
+    RenderingData *data = frame->data;
+
+    rendergraph_bindSource(data->renderGraph, data->resources.scaledOutput);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, data->outputFramebuffer);
+
+    glBlitFramebuffer(0, 0, frame->width, frame->height, 0, 0, frame->outputWidth, frame->outputHeight,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+}
+
+/**
+ * Setzt das Bild in voller Auflösung aus dem aktuellen Bild in verringerter
+ * Auflösung und dem Ergebnis des letzten Frames zusammen (siehe
+ * temporal.frag). Das Ergebnis wird für den nächsten Frame aufgehoben und in
+ * das Ausgabeziel kopiert.
  *
- * @param data Zugriff auf das Rendering-Datenobjekt.
- * @param viewMatrix Die aktuelle View-Matrix der Kamera.
- * @param projectionMatrix Die aktuelle Projektions-Matrix.
- * @param width Breite des aktuellen Framebuffers / Fensters.
- * @param height Höhe des aktuellen Framebuffers / Fensters.
+ * @param userData Die Daten des Frames (FrameContext).
  */
-static void performSkyboxPass(RenderingData *data, mat4 viewMatrix, mat4 projectionMatrix, int width, int height) {
-    common_pushRenderScope("Skybox-Pass");
-    {
-        shader_useShader(data->skybox.shader);
+static void performTemporalPass(void *userData) {
+    FrameContext *frame = userData;
+    RenderingData *data = frame->data;
+    TemporalUpscaling *temporal = &data->temporal;
+    Shader *shader = data->temporalShader;
 
-        gbuffer_bindGBufferForPostprocess(data->gbuffer);
+    beginPassTimer(&temporal->timer);
 
-        GLuint normalTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_NORMAL);
-        glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_NORMAL);
-        glBindTexture(GL_TEXTURE_2D, normalTex);
-        shader_setInt(data->skybox.shader, "u_normal", DEFAULT_GBUFFER_COLORATTACH_NORMAL);
+    resizeTemporalHistory(temporal, frame->outputWidth, frame->outputHeight);
+    const int target = 1 - temporal->historyIndex;
 
-        GLuint finalTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_FINAL);
-        glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_FINAL);
-        glBindTexture(GL_TEXTURE_2D, finalTex);
-        shader_setInt(data->skybox.shader, "u_final", DEFAULT_GBUFFER_COLORATTACH_FINAL);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, temporal->framebuffer);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, temporal->history[target], 0);
+    glViewport(0, 0, frame->outputWidth, frame->outputHeight);
+    glDisable(GL_BLEND);
 
-        vec2 screenSize = {(float) width, (float) height};
-        shader_setVec2(data->skybox.shader, "u_screenSize", &screenSize);
+    shader_useShader(shader);
+    gbuffer_bindTexturesForPass(data->gbuffer, shader, GBUFFER_PASS_TEMPORAL);
 
-        rendering_drawSkybox(data, viewMatrix, projectionMatrix);
-    }
-    common_popRenderScope();
-}
+    glActiveTexture(GL_TEXTURE0 + TEMPORAL_UNIT_IMAGE);
+    glBindTexture(GL_TEXTURE_2D, rendergraph_getTexture(data->renderGraph, data->resources.scaledOutput));
+    shader_setInt(shader, "u_image", TEMPORAL_UNIT_IMAGE);
 
+    glActiveTexture(GL_TEXTURE0 + TEMPORAL_UNIT_HISTORY);
+    glBindTexture(GL_TEXTURE_2D, temporal->history[temporal->historyIndex]);
+    shader_setInt(shader, "u_history", TEMPORAL_UNIT_HISTORY);
 
-/**
- * @brief Performs the depth of field post-processing pass.
- *
- * @param data Pointer to the RenderingData structure containing rendering-related information.
- * @param cameraPos Pointer to the vec3 structure representing the camera position.
- *
- * This function applies depth of field effects by performing a blur pass, binding necessary textures,
- * and rendering the final processed image using the depth of field shader.
- */
-static void performDepthOfFieldPass(RenderingData *data, vec3 *cameraPos)
-{
-    common_pushRenderScope("DepthOfField-Pass");
-    {
-        performBlurPass(data, true);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    vec2 renderSize = { (float) frame->width, (float) frame->height };
+    shader_setVec2(shader, "u_renderSize", &renderSize);
+    shader_setVec2(shader, "u_jitter", &temporal->jitter);
 
-        shader_useShader(data->depthOfFieldShader);
+    // Bildet die Pixel des Hintergrunds, der keine Bewegungsvektoren hat, auf
+    // ihre Stelle im letzten Frame ab.
+    mat4 reprojection;
+    glm_mat4_inv(temporal->viewProjection, reprojection);
+    glm_mat4_mul(temporal->prevViewProjection, reprojection, reprojection);
+    shader_setMat4(shader, "u_reprojection", &reprojection);
 
-        GLuint positionTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_POSITION);
-        glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_POSITION);
-        glBindTexture(GL_TEXTURE_2D, positionTex);
-        shader_setInt(data->depthOfFieldShader, "u_position", DEFAULT_GBUFFER_COLORATTACH_POSITION);
+    shader_setFloat(shader, "u_historyWeight", TEMPORAL_HISTORY_WEIGHT);
+    shader_setBool(shader, "u_historyValid", temporal->historyValid);
 
-        const GLuint finalTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_FINAL);
-        glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_FINAL);
-        glBindTexture(GL_TEXTURE_2D, finalTex);
-        shader_setInt(data->depthOfFieldShader, "u_final", DEFAULT_GBUFFER_COLORATTACH_FINAL);
+    renderFullscreenQuad(data->fullscreenQuad);
+    temporal->timer.passes++;
 
-        const GLuint blurTex = gbuffer_getBlurTexture(data->gbuffer, BLUR_GBUFFER_COLORATTACH_BLUR_V);
-        glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_NUM_COLORATTACH + BLUR_GBUFFER_COLORATTACH_BLUR_V);
-        glBindTexture(GL_TEXTURE_2D, blurTex);
-        shader_setInt(data->depthOfFieldShader, "u_finalBlur", DEFAULT_GBUFFER_NUM_COLORATTACH + BLUR_GBUFFER_COLORATTACH_BLUR_V);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, temporal->framebuffer);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, data->outputFramebuffer);
+    glBlitFramebuffer(0, 0, frame->outputWidth, frame->outputHeight, 0, 0, frame->outputWidth, frame->outputHeight,
+                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
 
-        shader_setVec3(data->depthOfFieldShader, "u_cameraPos", cameraPos);
-        shader_setFloat(data->depthOfFieldShader, "u_focusDistance", data->postprocessing.focusDistance);
-        shader_setFloat(data->depthOfFieldShader, "u_depthOfField", data->postprocessing.depthOfField);
-        shader_setBool(data->depthOfFieldShader, "u_useDoF", data->postprocessing.useDoF);
+    temporal->historyIndex = target;
+    temporal->resolved = true;
 
-        renderFullscreenQuad(data->fullscreenQuad);
-    }
-    common_popRenderScope();
+    endPassTimer(&temporal->timer);
 }
 
 /**
- * Handhabt den RENDER_MODE_PHONG.
+ * Führt den Pass für RENDER_MODE_DEBUG durch.
  *
- * Hierbei wird der aktuell gerenderte Framebuffer einfach auf den Hauptframebuffer geblittet,
- * um einen Phong-shading-basierten Render-Output anzuzeigen.
+ * Hierbei wird das G-Buffer-Inhaltsdebugging ausgeführt, indem verschiedene G-Buffer-Texturen
+ * (Albedo/Spec, Normal, Material, Emission) in ein 2x2-Raster auf den Hauptframebuffer
+ * geschrieben werden. Dies hilft beim Debuggen und Verständnis der gerenderten Szene. Da das
+ * Raster das Ausgabeziel vollständig überschreibt, entfallen Beleuchtung und Nachbearbeitung.
  *
- * @param width Breite des Framebuffers.
- * @param height Höhe des Framebuffers.
+ * @param userData Die Daten des Frames (FrameContext).
  */
-static void handleRenderModePhong(int width, int height) {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+static void performDebugPass(void *userData) {
+    FrameContext *frame = userData;
+    RenderingData *data = frame->data;
+    const int width = frame->width;
+    const int height = frame->height;
+    const int outputWidth = frame->outputWidth;
+    const int outputHeight = frame->outputHeight;
+    int halfWidth = outputWidth / 2;
+    int halfHeight = outputHeight / 2;
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, data->outputFramebuffer);
+    gbuffer_bindForRead(data->gbuffer);
+
+    gbuffer_bindGBufferForTextureRead(DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC);
+    glBlitFramebuffer(0, 0, width, height, 0, halfHeight, halfWidth, outputHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    gbuffer_bindGBufferForTextureRead(DEFAULT_GBUFFER_COLORATTACH_NORMAL);
+    glBlitFramebuffer(0, 0, width, height, halfWidth, halfHeight, outputWidth, outputHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    gbuffer_bindGBufferForTextureRead(DEFAULT_GBUFFER_COLORATTACH_MATERIAL);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, halfWidth, halfHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    gbuffer_bindGBufferForTextureRead(DEFAULT_GBUFFER_COLORATTACH_EMISSION);
+    glBlitFramebuffer(0, 0, width, height, halfWidth, 0, outputWidth, halfHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
 }
 
 /**
- * Handhabt den RENDER_MODE_DEBUG.
+ * Meldet alle Pässe des Frames mit den Ressourcen, die sie lesen und
+ * schreiben, beim Render-Graphen an.
  *
- * Hierbei wird das G-Buffer-Inhaltsdebugging ausgeführt, indem verschiedene G-Buffer-Texturen
- * (Albedo/Spec, Normal, Position, Emission) in ein 2x2-Raster auf den Hauptframebuffer
- * geschrieben werden. Dies hilft beim Debuggen und Verständnis der gerenderten Szene.
+ * G-Buffer, Schattenkarten und Ausgabeziel leben außerhalb des Graphen. Die
+ * Bloom-Stufen und die Ziele der Tiefenunschärfe sind transient und bekommen
+ * nur dann eine Textur, wenn ihr Pass läuft. Beleuchtung und
+ * Nachbearbeitung werden unabhängig vom Render-Modus angemeldet, ob sie zum
+ * Bild beitragen, entscheidet der Graph.
+ *
+ * Alle Ziele werden für die volle Größe des Ausgabeziels angelegt, damit der
+ * Pool beim Ändern der dynamischen Auflösung keine neuen Texturen braucht.
+ * Ist sie verringert, schreibt die Nachbearbeitung in ein transientes Ziel,
+ * das ein letzter Pass auf das Ausgabeziel hochskaliert. Mit temporaler
+ * Rekonstruktion übernimmt das der Temporal-Pass, auch in voller Auflösung.
  *
- * @param data Zugriff auf das Rendering-Datenobjekt, insbesondere den G-Buffer.
- * @param width Breite des Fensters.
- * @param height Höhe des Fensters.
+ * @param data Zugriff auf das Rendering-Datenobjekt.
+ * @param frame Die Daten des Frames, die an die Pässe übergeben werden.
+ * @param blurSteps Platz für DOF_BLUR_ITERATIONS * 2 Blur-Pässe.
+ * @param clearColor Die Farbe, mit der das finale Bild geleert wird.
  */
-static void handleRenderModeDebug(RenderingData *data, int width, int height) {
-    int halfWidth = width / 2;
-    int halfHeight = height / 2;
+static void buildFrameGraph(RenderingData *data, FrameContext *frame, BlurStep *blurSteps, const float *clearColor) {
+    static const char *const gbufferNames[DEFAULT_GBUFFER_NUM_COLORATTACH] = {
+        "Depth", "Normal", "AlbedoSpec", "Emission", "Material", "Velocity", "Final"
+    };
+
+    RenderGraph *graph = data->renderGraph;
+    FrameResources *resources = &data->resources;
+    const Postprocessing *postprocessing = &data->postprocessing;
+    const int stages = postprocessing->plan.stages;
+
+    const bool temporal = data->temporal.mode == UPSCALING_MODE_TEMPORAL;
+
+    rendergraph_beginFrame(graph);
+
+    // Die Bewegungsvektoren werden nur für die temporale Rekonstruktion
+    // angelegt und geschrieben.
+    gbuffer_setActivePasses(data->gbuffer, GBUFFER_PASSES_DEFAULT | (temporal ? GBUFFER_PASS_TEMPORAL : 0));
+    for (int i = 0; i < DEFAULT_GBUFFER_NUM_COLORATTACH; ++i) {
+        const GLuint texture = gbuffer_getDefaultTexture(data->gbuffer, i);
+        resources->gbuffer[i] = texture != 0 ? rendergraph_importResource(graph, gbufferNames[i], texture)
+                                             : RENDERGRAPH_NO_RESOURCE;
+    }
+    resources->shadowMaps = rendergraph_importResource(graph, "Shadow Maps", gbuffer_getDirLightShadowMap(data->gbuffer));
+    resources->output = rendergraph_importResource(graph, "Output", 0);
+    rendergraph_exportResource(graph, resources->output);
+
+    const RenderGraphResource depth = resources->gbuffer[DEFAULT_GBUFFER_DEPTH];
+    const RenderGraphResource final = resources->gbuffer[DEFAULT_GBUFFER_COLORATTACH_FINAL];
+    rendergraph_clearResource(graph, final, clearColor);
+
+    int pass = rendergraph_addPass(graph, "Geometry-Pass", performGeometryPass, frame);
+    for (int i = 0; i < DEFAULT_GBUFFER_NUM_COLORATTACH; ++i) {
+        if (i != DEFAULT_GBUFFER_COLORATTACH_FINAL) {
+            rendergraph_writeResource(graph, pass, resources->gbuffer[i]);
+        }
+    }
 
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-    gbuffer_bindForRead(data->gbuffer);
+    // Nur geänderte Schattenkarten werden neu gerendert, der Pass liest also
+    // auch ihren alten Inhalt.
+    pass = rendergraph_addPass(graph, "Shadow-Pass", performShadowPass, frame);
+    rendergraph_readResource(graph, pass, resources->shadowMaps);
+    rendergraph_writeResource(graph, pass, resources->shadowMaps);
 
-    gbuffer_bindGBufferForTextureRead(DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC);
-    glBlitFramebuffer(0, 0, width, height, 0, halfHeight, halfWidth, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    pass = rendergraph_addPass(graph, "Light-Pass", performLightPass, frame);
+    for (int i = 0; i < DEFAULT_GBUFFER_NUM_COLORATTACH; ++i) {
+        if (i != DEFAULT_GBUFFER_COLORATTACH_FINAL && i != DEFAULT_GBUFFER_COLORATTACH_VELOCITY) {
+            rendergraph_readResource(graph, pass, resources->gbuffer[i]);
+        }
+    }
+    rendergraph_readResource(graph, pass, resources->shadowMaps);
+    rendergraph_writeResource(graph, pass, final);
 
-    gbuffer_bindGBufferForTextureRead(DEFAULT_GBUFFER_COLORATTACH_NORMAL);
-    glBlitFramebuffer(0, 0, width, height, halfWidth, halfHeight, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    for (int level = 0; level < BLOOM_MAX_LEVELS; ++level) {
+        resources->bloom[level] = RENDERGRAPH_NO_RESOURCE;
+    }
+    if (stages & POSTPROCESS_STAGE_BLOOM) {
+        // Die Bloom-Stufen werden linear gefiltert, da beim Verkleinern und
+        // Vergrößern zwischen den Texeln gelesen wird.
+        pass = rendergraph_addPass(graph, "Bloom-Pass", performBloomPass, frame);
+        rendergraph_readResource(graph, pass, final);
+        rendergraph_readResource(graph, pass, resources->gbuffer[DEFAULT_GBUFFER_COLORATTACH_EMISSION]);
+        for (int level = 0; level < postprocessing->bloom.levels; ++level) {
+            RenderGraphTextureDesc desc = {
+                BLOOM_TARGET_FORMAT, GL_RGB, GL_FLOAT, BLOOM_TARGET_BYTES, 0, 0, GL_LINEAR
+            };
+            getBloomLevelSize(frame->outputWidth, frame->outputHeight, level, &desc.width, &desc.height);
+
+            resources->bloom[level] = rendergraph_createTexture(graph, "Bloom Level", &desc);
+            rendergraph_writeResource(graph, pass, resources->bloom[level]);
+        }
+    }
 
-    gbuffer_bindGBufferForTextureRead(DEFAULT_GBUFFER_COLORATTACH_POSITION);
-    glBlitFramebuffer(0, 0, width, height, 0, 0, halfWidth, halfHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    // Bei verringerter Auflösung oder temporaler Rekonstruktion schreibt die
+    // Nachbearbeitung in ein eigenes Ziel, sonst direkt in das Ausgabeziel.
+    resources->scaledOutput = RENDERGRAPH_NO_RESOURCE;
+    RenderGraphResource finalTarget = resources->output;
+    if (temporal || frame->width != frame->outputWidth || frame->height != frame->outputHeight) {
+        const RenderGraphTextureDesc desc = {
+            UPSCALE_TARGET_FORMAT, GL_RGBA, GL_UNSIGNED_BYTE, UPSCALE_TARGET_BYTES,
+            frame->outputWidth, frame->outputHeight, GL_LINEAR
+        };
+        resources->scaledOutput = rendergraph_createTexture(graph, "Scaled Output", &desc);
+        finalTarget = resources->scaledOutput;
+    }
 
-    gbuffer_bindGBufferForTextureRead(DEFAULT_GBUFFER_COLORATTACH_EMISSION);
-    glBlitFramebuffer(0, 0, width, height, halfWidth, 0, width, halfHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    if (stages & POSTPROCESS_STAGE_DOF) {
+        const RenderGraphTextureDesc desc = {
+            DOF_TARGET_FORMAT, GL_RGBA, GL_FLOAT, DOF_TARGET_BYTES,
+            frame->outputWidth / postprocessing->dofDivisor, frame->outputHeight / postprocessing->dofDivisor, GL_NEAREST
+        };
+
+        resources->dofColor = rendergraph_createTexture(graph, "DoF Color", &desc);
+        pass = rendergraph_addPass(graph, "DepthOfField-Downsample", performDepthOfFieldDownsamplePass, frame);
+        rendergraph_readResource(graph, pass, depth);
+        rendergraph_readResource(graph, pass, final);
+        rendergraph_readResource(graph, pass, resources->bloom[0]);
+        rendergraph_writeResource(graph, pass, resources->dofColor);
+
+        // Jeder Blur-Pass schreibt ein eigenes Ziel. Nur das Ergebnis des
+        // vorherigen Passes muss dabei noch leben, der Graph wechselt also
+        // zwischen zwei Texturen.
+        RenderGraphResource source = resources->dofColor;
+        for (int i = 0; i < DOF_BLUR_ITERATIONS * 2; ++i) {
+            BlurStep *step = &blurSteps[i];
+            step->frame = frame;
+            step->source = source;
+            step->target = rendergraph_createTexture(graph, "DoF Blur", &desc);
+            step->horizontal = i % 2 == 0;
+
+            pass = rendergraph_addPass(graph, "Blur-Pass", performBlurPass, step);
+            rendergraph_readResource(graph, pass, step->source);
+            rendergraph_writeResource(graph, pass, step->target);
+            source = step->target;
+        }
+        resources->dofBlur = source;
+
+        pass = rendergraph_addPass(graph, "DepthOfField-Pass", performDepthOfFieldCompositePass, frame);
+        rendergraph_readResource(graph, pass, depth);
+        rendergraph_readResource(graph, pass, final);
+        rendergraph_readResource(graph, pass, resources->bloom[0]);
+        rendergraph_readResource(graph, pass, resources->dofColor);
+        rendergraph_readResource(graph, pass, resources->dofBlur);
+        rendergraph_writeResource(graph, pass, finalTarget);
+    } else {
+        resources->dofColor = RENDERGRAPH_NO_RESOURCE;
+        resources->dofBlur = RENDERGRAPH_NO_RESOURCE;
+
+        pass = rendergraph_addPass(graph, "PostProcess-Pass", performPostprocessPass, frame);
+        rendergraph_readResource(graph, pass, depth);
+        rendergraph_readResource(graph, pass, final);
+        rendergraph_readResource(graph, pass, resources->bloom[0]);
+        rendergraph_writeResource(graph, pass, finalTarget);
+    }
+
+    // Das Ergebnis des letzten Frames lebt außerhalb des Graphen, da es über
+    // das Ende des Frames hinaus gebraucht wird.
+    resources->history = RENDERGRAPH_NO_RESOURCE;
+    if (temporal) {
+        resources->history = rendergraph_importResource(graph, "History",
+                                                        data->temporal.history[data->temporal.historyIndex]);
+
+        pass = rendergraph_addPass(graph, "Temporal-Pass", performTemporalPass, frame);
+        rendergraph_readResource(graph, pass, resources->scaledOutput);
+        rendergraph_readResource(graph, pass, depth);
+        rendergraph_readResource(graph, pass, resources->gbuffer[DEFAULT_GBUFFER_COLORATTACH_VELOCITY]);
+        rendergraph_readResource(graph, pass, resources->history);
+        rendergraph_writeResource(graph, pass, resources->output);
+    } else if (resources->scaledOutput != RENDERGRAPH_NO_RESOURCE) {
+        pass = rendergraph_addPass(graph, "Upscale-Pass", performUpscalePass, frame);
+        rendergraph_readResource(graph, pass, resources->scaledOutput);
+        rendergraph_writeResource(graph, pass, resources->output);
+    }
+
+    // Das Raster überschreibt das ganze Ausgabeziel, alle Pässe, die nur zum
+    // beleuchteten Bild beitragen, entfallen damit.
+    if (data->renderMode == RENDER_MODE_DEBUG) {
+        pass = rendergraph_addPass(graph, "Debug-Pass", performDebugPass, frame);
+        rendergraph_readResource(graph, pass, resources->gbuffer[DEFAULT_GBUFFER_COLORATTACH_ALBEDOSPEC]);
+        rendergraph_readResource(graph, pass, resources->gbuffer[DEFAULT_GBUFFER_COLORATTACH_NORMAL]);
+        rendergraph_readResource(graph, pass, resources->gbuffer[DEFAULT_GBUFFER_COLORATTACH_MATERIAL]);
+        rendergraph_readResource(graph, pass, resources->gbuffer[DEFAULT_GBUFFER_COLORATTACH_EMISSION]);
+        rendergraph_writeResource(graph, pass, resources->output);
+    }
 }
 
 //////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
@@ -1121,23 +2871,34 @@ void rendering_init(ProgContext *ctx) {
         data->clipping = .1f;
     }
 
-    data->shadowMap.needsUpdating = true;
-    data->shadowMap.quadSize = 10.0f;
-    data->shadowMap.zNear = 0.1f;
+    data->shadowMap.cascadeCount = 3;
+    data->shadowMap.splitLambda = 0.75f;
     data->shadowMap.zFar = 150.f;
     data->shadowMap.cubemapMatrices = malloc(sizeof(mat4) * 6);
     data->shadowMap.showShadows = true;
     data->shadowMap.usePCF = true;
 
-    data->light.dirLightDistanceMult = 20;
-
     data->postprocessing.useDoF = true;
     data->postprocessing.focusDistance = 10;
     data->postprocessing.depthOfField = 8;
 
-    data->lightVolume = model_loadModel(RESOURCE_PATH "/model/sphere.fbx");
+    data->resolution.enabled = false;
+    data->resolution.budget = DYNAMIC_RESOLUTION_BUDGET;
+    data->resolution.scale = DYNAMIC_RESOLUTION_MAX_SCALE;
+    data->resolution.fixedScale = DYNAMIC_RESOLUTION_MAX_SCALE;
+    data->temporal.mode = UPSCALING_MODE_SPATIAL;
+
+    data->lightVolume.enabled = true;
+    data->lightVolume.useScissor = true;
+    createLightVolume(&data->lightVolume);
+
+    data->lightingMode = LIGHTING_MODE_PER_LIGHT;
+    data->lightGrid = lightgrid_createLightGrid();
+    data->lightBuffer = lightbuffer_createLightBuffer();
+    data->shadowAtlas = shadowatlas_createShadowAtlas(false);
 
-    data->gbuffer = gbuffer_createGBuffer(ctx->winData->width, ctx->winData->height, DIR_SHADOW_SIZE);
+    data->gbuffer = gbuffer_createGBuffer(ctx->winData->width, ctx->winData->height, DIR_SHADOW_SIZE, DIR_SHADOW_MAX_CASCADES);
+    data->renderGraph = rendergraph_createRenderGraph();
 
     utils_createQuad(&data->fullscreenQuad.quadVAO, &data->fullscreenQuad.quadVBO);
 
@@ -1156,11 +2917,6 @@ void rendering_init(ProgContext *ctx) {
         glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT_CUBEMAP);
         glBindTexture(GL_TEXTURE_CUBE_MAP, data->skybox.cubemapTexture);
     }
-
-    // Erstelle die Geometrie für die Skybox
-    utils_createCube(&data->skybox.skyboxVAO, &data->skybox.skyboxVBO, &data->skybox.skyboxVertexCount);
-
-    rendering_updateUniforms(data);
 }
 
 void rendering_draw(const ProgContext *ctx) {
@@ -1172,7 +2928,13 @@ void rendering_draw(const ProgContext *ctx) {
         input->rendering.hasUpdatedScene = false;
     }
 
-    // Bildschirm leeren (jetzt wird das GBuffer gereinigt)
+    // Shader, deren Dateien gespeichert wurden, im Hintergrund neu übersetzen.
+    // Sie werden bei ihrer Benutzung ausgetauscht, sobald sie fertig sind.
+    shader_reloadChangedShaders();
+
+    // Ausgabeziel leeren. Es wird ausdrücklich gebunden, da es im
+    // Headless-Modus ohne Oberfläche keinen Standard-Framebuffer gibt.
+    glBindFramebuffer(GL_FRAMEBUFFER, data->outputFramebuffer);
     glClearColor(
         input->rendering.clearColor[0],
         input->rendering.clearColor[1],
@@ -1181,168 +2943,65 @@ void rendering_draw(const ProgContext *ctx) {
     );
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
-    mat4 projectionMatrix;
-    mat4 viewMatrix;
+    // Die Auflösung folgt der gemessenen GPU-Zeit der letzten Frames.
+    updateResolutionScale(&data->resolution, ctx->winData->width, ctx->winData->height);
 
-    mat4 modelMatrix;
-    glm_mat4_identity(modelMatrix);
-    glm_translate(modelMatrix, data->transform.translation);
-    glm_rotate_x(modelMatrix, glm_rad(data->transform.rotation[0]), modelMatrix);
-    glm_rotate_y(modelMatrix, glm_rad(data->transform.rotation[1]), modelMatrix);
-    glm_rotate_z(modelMatrix, glm_rad(data->transform.rotation[2]), modelMatrix);
-    glm_scale(modelMatrix, data->transform.scale);
+    FrameContext frame;
+    frame.ctx = ctx;
+    frame.data = data;
+    frame.width = data->resolution.width;
+    frame.height = data->resolution.height;
+    frame.outputWidth = ctx->winData->width;
+    frame.outputHeight = ctx->winData->height;
 
-    mat4 dirlightSpace;
-    CalcDirLightSpace(data, &dirlightSpace);
+    glm_mat4_identity(frame.modelMatrix);
+    glm_translate(frame.modelMatrix, data->transform.translation);
+    glm_rotate_x(frame.modelMatrix, glm_rad(data->transform.rotation[0]), frame.modelMatrix);
+    glm_rotate_y(frame.modelMatrix, glm_rad(data->transform.rotation[1]), frame.modelMatrix);
+    glm_rotate_z(frame.modelMatrix, glm_rad(data->transform.rotation[2]), frame.modelMatrix);
+    glm_scale(frame.modelMatrix, data->transform.scale);
 
     // Zuerst die Projection Matrix aufsetzen.
-    const float aspect = (float) ctx->winData->width / (float) ctx->winData->height;
+    const float aspect = (float) frame.outputWidth / (float) frame.outputHeight;
     const float zoom = camera_getZoom(input->mainCamera);
-    glm_perspective(glm_rad(zoom), aspect, 0.1f, 200.0f, projectionMatrix);
+    glm_perspective(glm_rad(zoom), aspect, CAMERA_Z_NEAR, CAMERA_Z_FAR, frame.projectionMatrix);
 
     // Dann die View-Matrix bestimmen.
-    camera_getViewMatrix(input->mainCamera, viewMatrix);
-
-    vec3 cameraPosition;
-    camera_getPosition(input->mainCamera, cameraPosition);
-
-    common_pushRenderScope("Geometry-Pass");
-    {
-        gbuffer_bindGBufferForGeomPass(data->gbuffer);
-        shader_useShader(data->modelShader);
-
-        glEnable(GL_DEPTH_TEST);
-
-        // Überprüfen, ob der Wireframe-Modus verwendet werden soll.
-        if (input->showWireframe) {
-            glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-            glDisable(GL_CULL_FACE); // Deaktivierung des Face Cullings
-        } else {
-            glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-            glEnable(GL_CULL_FACE); // Aktivierung des Face Cullings
-        }
-
-        shader_setVec3(data->modelShader, "u_cameraPos", &cameraPosition);
-        shader_setMat4(data->modelShader, "u_projection", &projectionMatrix);
-        shader_setMat4(data->modelShader, "u_view", &viewMatrix);
-
-        if (input->rendering.userScene) {
-            model_drawModel(input->rendering.userScene->model, data->modelShader);
-
-            if (data->shadowMap.needsUpdating || data->shadowMap.dirLightShadowsShouldUpdate || data->shadowMap.dirLightShadowsAlwaysUpdate) {
-                PerformDirLightShadowPass(data, cameraPosition, &modelMatrix, &dirlightSpace, input->rendering.userScene->model, ctx->winData->width, ctx->winData->height);
-                data->shadowMap.dirLightShadowsShouldUpdate = false;
-            }
-
-            if (data->shadowMap.needsUpdating || data->shadowMap.pointLightShadowsShouldUpdate) {
-
-                for (int i = 0; i < input->rendering.userScene->countPointLights; ++i) {
-                    vec3 pointLightPosition;
-                    glm_vec3_copy(input->rendering.userScene->pointLights[i]->position, pointLightPosition);
-
-                    performPointLightShadowPass(data, input->rendering.userScene->model, &modelMatrix, &pointLightPosition, i, ctx->winData->width, ctx->winData->height);
-                }
-
-                data->shadowMap.pointLightShadowsShouldUpdate = false;
-            }
-
-            data->shadowMap.needsUpdating = false;
-        }
-    }
-    common_popRenderScope();
-
-    common_pushRenderScope("Light-Pass");
-    {
-        gbuffer_bindGBufferForLightPass(data->gbuffer);
-
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glEnable(GL_CULL_FACE);
-
-        if (input->rendering.userScene) {
-             for (int i = 0; i < input->rendering.userScene->countPointLights; ++i) {
-                 PointLight *pointLight = input->rendering.userScene->pointLights[i];
-                 performPointLightPass(data, &projectionMatrix, &viewMatrix, modelMatrix, &cameraPosition, pointLight, i);
-             }
-
-             if (input->rendering.userScene->countPointLights <= 0) {
-                 performPointLightPass(data, &projectionMatrix, &viewMatrix, modelMatrix, &cameraPosition, data->light.defaultPointLight, 0);
-             }
-
-            glClear(GL_STENCIL_BUFFER_BIT);
-            glDisable(GL_STENCIL_TEST);
-
-            for (int i = 0; i < input->rendering.userScene->countDirLights; ++i) {
-                DirLight *dirLight = input->rendering.userScene->dirLights[i];
-                performDirLightPass(data, &cameraPosition, dirLight, &dirlightSpace);
-            }
-
-            if (input->rendering.userScene->countDirLights <= 0) {
-                performDirLightPass(data, &cameraPosition, data->light.defaultDirLight, &dirlightSpace);
-            }
-        }
-    }
-    common_popRenderScope();
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    performThresholdPass(data);
-    performBlurPass(data, false);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    if (data->fog.fogEnabled) {
-        performFogPass(data, &cameraPosition);
-    }
+    camera_getViewMatrix(input->mainCamera, frame.viewMatrix);
 
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    // Für die temporale Rekonstruktion wird die Projektion um einen
+    // Bruchteil eines Pixels verschoben. Alle Pässe sehen nur diese Projektion,
+    // die Bewegungsvektoren entstehen aus den Matrizen ohne Jitter.
+    beginTemporalFrame(&data->temporal, &frame);
 
-    common_pushRenderScope("PostProcess-Pass");
-    {
-        shader_useShader(data->postprocessShader);
-
-        if (data->skybox.skyboxEnabled) {
-            gbuffer_bindGBufferForPostprocess(data->gbuffer);
-        }
-
-        const GLuint finalTex = gbuffer_getDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_FINAL);
-        glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_COLORATTACH_FINAL);
-        glBindTexture(GL_TEXTURE_2D, finalTex);
-        shader_setInt(data->postprocessShader, "u_final", DEFAULT_GBUFFER_COLORATTACH_FINAL);
-
-        const GLuint bloomTex = gbuffer_getBlurTexture(data->gbuffer, BLUR_GBUFFER_COLORATTACH_BLUR_V);
-        glActiveTexture(GL_TEXTURE0 + DEFAULT_GBUFFER_NUM_COLORATTACH + BLUR_GBUFFER_COLORATTACH_BLUR_V);
-        glBindTexture(GL_TEXTURE_2D, bloomTex);
-        shader_setInt(data->postprocessShader, "u_bloom", DEFAULT_GBUFFER_NUM_COLORATTACH + BLUR_GBUFFER_COLORATTACH_BLUR_V);
-
-        shader_setFloat(data->postprocessShader, "u_exposure", data->postprocessing.exposure);
-        shader_setFloat(data->postprocessShader, "u_gamma", data->postprocessing.gamma);
-
-        renderFullscreenQuad(data->fullscreenQuad);
-    }
-    common_popRenderScope();
+    // Die Kaskaden der Richtungslicht-Schatten folgen dem Sichtbereich.
+    CalcDirLightCascades(data, input->rendering.userScene ? input->rendering.userScene->model : NULL,
+                         &frame.modelMatrix, &frame.viewMatrix, glm_rad(zoom), aspect);
 
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-
-    if (data->skybox.skyboxEnabled) {
-        performSkyboxPass(data, viewMatrix, projectionMatrix, ctx->winData->width, ctx->winData->height);
-    }
+    camera_getPosition(input->mainCamera, frame.cameraPosition);
 
-    performDepthOfFieldPass(data, &cameraPosition);
+    // Die Positionen werden in den späteren Pässen aus der Tiefe rekonstruiert.
+    glm_mat4_mul(frame.projectionMatrix, frame.viewMatrix, data->invViewProjection);
+    glm_mat4_inv(data->invViewProjection, data->invViewProjection);
 
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    // Alle Stufen pro Pixel laufen zusammengefasst, mit Tiefenunschärfe in
+    // deren Pässen, sonst in einem einzigen Pass.
+    compilePostprocessPlan(data, &data->postprocessing.plan);
 
-    int width = ctx->winData->width;
-    int height = ctx->winData->height;
-    if (data->renderMode == RENDER_MODE_PHONG) {
-        handleRenderModePhong(width, height);
-    } else if (data->renderMode == RENDER_MODE_DEBUG) {
-        handleRenderModeDebug(data, width, height);
-    }
+    // Der Render-Graph lässt nur die Pässe laufen, die zum Ausgabeziel
+    // beitragen, und vergibt ihre Ziele aus seinem Pool.
+    BlurStep blurSteps[DOF_BLUR_ITERATIONS * 2];
+    buildFrameGraph(data, &frame, blurSteps, input->rendering.clearColor);
+    beginFrameTimer(&data->resolution, data->temporal.mode != UPSCALING_MODE_TEMPORAL
+                                       && frame.width == frame.outputWidth && frame.height == frame.outputHeight);
+    rendergraph_execute(data->renderGraph);
+    endFrameTimer(&data->resolution);
 
-    gbuffer_clearBlurTexture(data->gbuffer, BLUR_GBUFFER_COLORATTACH_BLUR_H);
-    gbuffer_clearBlurTexture(data->gbuffer, BLUR_GBUFFER_COLORATTACH_BLUR_V);
-    gbuffer_clearDefaultTexture(data->gbuffer, DEFAULT_GBUFFER_COLORATTACH_FINAL);
+    // Im nächsten Frame sind das die Matrizen des letzten Frames.
+    glm_mat4_copy(data->temporal.viewProjection, data->temporal.prevViewProjection);
+    glm_mat4_copy(frame.modelMatrix, data->temporal.prevModel);
 
+    glViewport(0, 0, frame.outputWidth, frame.outputHeight);
     glDisable(GL_DEPTH_TEST);
 
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -1351,48 +3010,66 @@ void rendering_draw(const ProgContext *ctx) {
 void rendering_cleanup(const ProgContext *ctx) {
     const RenderingData *data = ctx->rendering;
 
-    shader_deleteShader(data->modelShader);
-    shader_deleteShader(data->skybox.shader);
-    shader_deleteShader(data->fog.shader);
-    shader_deleteShader(data->light.dirlightShader);
-    shader_deleteShader(data->light.pointlightShader);
-    shader_deleteShader(data->postprocessShader);
+    shader_deleteVariants(data->modelShaders);
+    shader_deleteVariants(data->modelTessShaders);
+    shader_deleteVariants(data->light.dirlightShaders);
+    shader_deleteVariants(data->light.pointlightShaders);
+    shader_deleteVariants(data->light.tiledLightShaders);
+    shader_deleteVariants(data->light.multiLightShaders);
+    shader_deleteVariants(data->postprocessShaders);
     shader_deleteShader(data->nullShader);
     shader_deleteShader(data->blurShader);
-    shader_deleteShader(data->thresholdShader);
+    shader_deleteShader(data->bloomDownShader);
+    shader_deleteShader(data->bloomUpShader);
     shader_deleteShader(data->dirLightShadowShader);
     shader_deleteShader(data->pointLightShadowShader);
-    shader_deleteShader(data->depthOfFieldShader);
+    shader_deleteVariants(data->dofDownsampleShaders);
+    shader_deleteVariants(data->depthOfFieldShaders);
+    shader_deleteShader(data->temporalShader);
 
     if (data->shadowMap.cubemapMatrices != NULL) { free(data->shadowMap.cubemapMatrices); }
-    if (data->lightVolume != NULL) { model_deleteModel(data->lightVolume); }
+    deleteLightVolume(&data->lightVolume);
+    lightgrid_deleteLightGrid(data->lightGrid);
+    lightbuffer_deleteLightBuffer(data->lightBuffer);
+    shadowatlas_deleteShadowAtlas(data->shadowAtlas);
+    if (data->lightTimer.queries[0] != 0) { glDeleteQueries(LIGHT_VOLUME_FRAMES, data->lightTimer.queries); }
+    if (data->postprocessing.bloom.timer.queries[0] != 0) { glDeleteQueries(LIGHT_VOLUME_FRAMES, data->postprocessing.bloom.timer.queries); }
+    if (data->postprocessing.dofTimer.queries[0] != 0) { glDeleteQueries(LIGHT_VOLUME_FRAMES, data->postprocessing.dofTimer.queries); }
+    if (data->postprocessing.timer.queries[0] != 0) { glDeleteQueries(LIGHT_VOLUME_FRAMES, data->postprocessing.timer.queries); }
+    if (data->resolution.queries[0][0] != 0) { glDeleteQueries(LIGHT_VOLUME_FRAMES * 2, data->resolution.queries[0]); }
+    if (data->temporal.timer.queries[0] != 0) { glDeleteQueries(LIGHT_VOLUME_FRAMES, data->temporal.timer.queries); }
+    if (data->temporal.framebuffer != 0) { glDeleteFramebuffers(1, &data->temporal.framebuffer); }
+    if (data->temporal.history[0] != 0) { glDeleteTextures(2, data->temporal.history); }
+    glDeleteSamplers(1, &data->postprocessing.bloom.linearSampler);
 
-    if (data->skybox.skyboxVAO != 0) { glDeleteVertexArrays(1, &data->skybox.skyboxVAO); }
-    if (data->skybox.skyboxVBO != 0) { glDeleteBuffers(1, &data->skybox.skyboxVBO); }
     if (data->skybox.cubemapTexture != 0) { glDeleteTextures(1, &data->skybox.cubemapTexture); }
 
     if (data->gbuffer != NULL) { gbuffer_deleteGBuffer(data->gbuffer); }
+    rendergraph_deleteRenderGraph(data->renderGraph);
 
     free(ctx->rendering);
 }
 
-bool rendering_recompileShader(const ProgContext *ctx) {
-    bool shaderOK = shader_recompileShader(&ctx->rendering->modelShader)
-            && shader_recompileShader(&ctx->rendering->skybox.shader)
-            && shader_recompileShader(&ctx->rendering->fog.shader)
-            && shader_recompileShader(&ctx->rendering->light.dirlightShader)
-            && shader_recompileShader(&ctx->rendering->light.pointlightShader)
-            && shader_recompileShader(&ctx->rendering->postprocessShader)
-            && shader_recompileShader(&ctx->rendering->nullShader)
-            && shader_recompileShader(&ctx->rendering->blurShader)
-            && shader_recompileShader(&ctx->rendering->thresholdShader)
-            && shader_recompileShader(&ctx->rendering->dirLightShadowShader)
-            && shader_recompileShader(&ctx->rendering->pointLightShadowShader)
-            && shader_recompileShader(&ctx->rendering->dirLightShadowShader)
-            && shader_recompileShader(&ctx->rendering->depthOfFieldShader);
-
-    rendering_updateUniforms(ctx->rendering);
-    return shaderOK;
+void rendering_recompileShader(const ProgContext *ctx) {
+    // Alle Shader werden nur übergeben, damit der Treiber sie parallel
+    // übersetzen kann. Ausgetauscht wird jeder bei seiner nächsten Benutzung,
+    // sobald er fertig ist.
+    shader_recompileVariants(ctx->rendering->modelShaders);
+    shader_recompileVariants(ctx->rendering->modelTessShaders);
+    shader_recompileVariants(ctx->rendering->light.dirlightShaders);
+    shader_recompileVariants(ctx->rendering->light.pointlightShaders);
+    shader_recompileVariants(ctx->rendering->light.tiledLightShaders);
+    shader_recompileVariants(ctx->rendering->light.multiLightShaders);
+    shader_recompileVariants(ctx->rendering->postprocessShaders);
+    shader_recompileShader(ctx->rendering->nullShader);
+    shader_recompileShader(ctx->rendering->blurShader);
+    shader_recompileShader(ctx->rendering->bloomDownShader);
+    shader_recompileShader(ctx->rendering->bloomUpShader);
+    shader_recompileShader(ctx->rendering->dirLightShadowShader);
+    shader_recompileShader(ctx->rendering->pointLightShadowShader);
+    shader_recompileVariants(ctx->rendering->dofDownsampleShaders);
+    shader_recompileVariants(ctx->rendering->depthOfFieldShaders);
+    shader_recompileShader(ctx->rendering->temporalShader);
 }
 
 void rendering_updateSceneData(const ProgContext *ctx) {
@@ -1406,12 +3083,15 @@ void rendering_updateSceneData(const ProgContext *ctx) {
         light_deleteDirLight(ctx->rendering->light.defaultDirLight);
     }
 
-    initLight(ctx->input->rendering.userScene, light, ctx->rendering->gbuffer, &ctx->rendering->shadowMap);
+    initLight(ctx->input->rendering.userScene, light, ctx->rendering->shadowAtlas, &ctx->rendering->shadowMap);
 }
 
 void rendering_updateFramebuffer(const ProgContext *ctx) {
     gbuffer_deleteGBuffer(ctx->rendering->gbuffer);
-    ctx->rendering->gbuffer = gbuffer_createGBuffer(ctx->winData->width, ctx->winData->height, DIR_SHADOW_SIZE);
+    ctx->rendering->gbuffer = gbuffer_createGBuffer(ctx->winData->width, ctx->winData->height, DIR_SHADOW_SIZE, DIR_SHADOW_MAX_CASCADES);
+    // Die transienten Ziele haben die alte Größe und würden sonst noch
+    // RENDERGRAPH_POOL_FRAMES Frames lang Speicher belegen.
+    rendergraph_releaseTextures(ctx->rendering->renderGraph);
     rendering_updateSceneData(ctx);
 }
 
@@ -1425,7 +3105,6 @@ void rendering_selectRenderMode(const ProgContext *ctx, const RenderMode mode) {
     if (ctx->rendering->renderMode == mode) { return; }
 
     ctx->rendering->renderMode = mode;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 bool rendering_getSkyboxEnabled(const ProgContext *ctx) {
@@ -1448,14 +3127,12 @@ void rendering_enableNormalMapping(const ProgContext *ctx) {
     if (ctx->rendering->normalMap.enableNormalMapping) { return; }
 
     ctx->rendering->normalMap.enableNormalMapping = true;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_disableNormalMapping(const ProgContext *ctx) {
     if (!ctx->rendering->normalMap.enableNormalMapping) { return; }
 
     ctx->rendering->normalMap.enableNormalMapping = false;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 bool rendering_getTwoChannelNormalMapEnabled(const ProgContext *ctx) {
@@ -1466,14 +3143,12 @@ void rendering_enableTwoChannelNormalMap(const ProgContext *ctx) {
     if (ctx->rendering->normalMap.enableTwoChannelNormalMap) { return; }
 
     ctx->rendering->normalMap.enableTwoChannelNormalMap = true;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_disableTwoChannelNormalMap(const ProgContext *ctx) {
     if (!ctx->rendering->normalMap.enableTwoChannelNormalMap) { return; }
 
     ctx->rendering->normalMap.enableTwoChannelNormalMap = false;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 bool rendering_getFogEnabled(const ProgContext *ctx) {
@@ -1484,14 +3159,12 @@ void rendering_enableFog(const ProgContext *ctx) {
     if (ctx->rendering->fog.fogEnabled) { return; }
 
     ctx->rendering->fog.fogEnabled = true;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_disableFog(const ProgContext *ctx) {
     if (!ctx->rendering->fog.fogEnabled) { return; }
 
     ctx->rendering->fog.fogEnabled = false;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 float rendering_getFogDensity(const ProgContext *ctx) {
@@ -1502,7 +3175,6 @@ void rendering_setFogDensity(const ProgContext *ctx, const float density) {
     if (ctx->rendering->fog.fogDensity == density) { return; }
 
     ctx->rendering->fog.fogDensity = density;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 float rendering_getAlphaClipping(const ProgContext *ctx) {
@@ -1513,7 +3185,6 @@ void rendering_setAlphaClipping(const ProgContext *ctx, const float clipping) {
     if (ctx->rendering->clipping == clipping) { return; }
 
     ctx->rendering->clipping = clipping;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_getTranslation(const ProgContext *ctx, vec3 outTranslation) {
@@ -1548,70 +3219,60 @@ void rendering_setTranslation(const ProgContext *ctx, vec3 translation) {
     if (glm_vec3_eqv_eps(ctx->rendering->transform.translation, translation)) { return; }
 
     glm_vec3_copy(translation, ctx->rendering->transform.translation);
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_setRotation(const ProgContext *ctx, vec3 rotation) {
     if (glm_vec3_eqv_eps(ctx->rendering->transform.rotation, rotation)) { return; }
 
     glm_vec3_copy(rotation, ctx->rendering->transform.rotation);
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_setScale(const ProgContext *ctx, vec3 scale) {
     if (glm_vec3_eqv_eps(ctx->rendering->transform.scale, scale)) { return; }
 
     glm_vec3_copy(scale, ctx->rendering->transform.scale);
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_enableTesselation(const ProgContext *ctx) {
     if (ctx->rendering->tesselation.useTessellation) { return; }
 
     ctx->rendering->tesselation.useTessellation = true;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_disableTesselation(const ProgContext *ctx) {
     if (!ctx->rendering->tesselation.useTessellation) { return; }
 
     ctx->rendering->tesselation.useTessellation = false;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_setTesselationMin(const ProgContext *ctx, int min) {
     if (ctx->rendering->tesselation.minTessellation == min) { return; }
 
     ctx->rendering->tesselation.minTessellation = min;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_setTesselationMax(const ProgContext *ctx, int max) {
     if (ctx->rendering->tesselation.maxTessellation == max) { return; }
 
     ctx->rendering->tesselation.maxTessellation = max;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_enableDisplacement(const ProgContext *ctx) {
     if (ctx->rendering->displacement.useDisplacement) { return; }
 
     ctx->rendering->displacement.useDisplacement = true;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_disableDisplacement(const ProgContext *ctx) {
     if (!ctx->rendering->displacement.useDisplacement) { return; }
 
     ctx->rendering->displacement.useDisplacement = false;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 void rendering_setDisplacementFactor(const ProgContext *ctx, float factor) {
     if (ctx->rendering->displacement.displacementFactor == factor) { return; }
 
     ctx->rendering->displacement.displacementFactor = factor;
-    rendering_updateUniforms(ctx->rendering);
 }
 
 float rendering_getDisplacementFactor(const ProgContext *ctx) {
@@ -1646,8 +3307,8 @@ float rendering_getThresholdColorWeight(const ProgContext *ctx) {
     return ctx->rendering->postprocessing.bloom.colorWeight;
 }
 
-int rendering_getBloomBlurIterations(const ProgContext *ctx) {
-    return ctx->rendering->postprocessing.bloom.blurIterations;
+int rendering_getBloomLevels(const ProgContext *ctx) {
+    return ctx->rendering->postprocessing.bloom.levels;
 }
 
 void rendering_setThreshold(const ProgContext *ctx, float threshold) {
@@ -1662,8 +3323,8 @@ void rendering_setThresholdColorWeight(const ProgContext *ctx, float colorWeight
     ctx->rendering->postprocessing.bloom.colorWeight = colorWeight;
 }
 
-void rendering_setBloomBlurIterations(const ProgContext *ctx, int blurIterations) {
-    ctx->rendering->postprocessing.bloom.blurIterations = blurIterations;
+void rendering_setBloomLevels(const ProgContext *ctx, int levels) {
+    ctx->rendering->postprocessing.bloom.levels = utils_maxInt(0, utils_minInt(levels, BLOOM_MAX_LEVELS));
 }
 
 void rendering_setFogColor(const ProgContext *ctx, vec4 fogColor) {
@@ -1762,102 +3423,323 @@ bool rendering_getUsePCF(const ProgContext *ctx)
     return ctx->rendering->shadowMap.usePCF;
 }
 
-bool rendering_getAlwaysUpdateDirShadows(const ProgContext *ctx)
+void rendering_setshowShadows(const ProgContext *ctx, bool value)
 {
-    return ctx->rendering->shadowMap.dirLightShadowsAlwaysUpdate;
+    ctx->rendering->shadowMap.showShadows = value;
 }
 
-void rendering_setAlwaysUpdateDirShadows(const ProgContext *ctx, bool value)
+void rendering_setUsePCF(const ProgContext *ctx, bool value)
 {
-    ctx->rendering->shadowMap.dirLightShadowsAlwaysUpdate = value;
+    ctx->rendering->shadowMap.usePCF = value;
 }
 
-void rendering_setShouldUpdateDirShadows(const ProgContext *ctx)
+void rendering_setUseDoF(const ProgContext *ctx, bool value)
 {
-    ctx->rendering->shadowMap.dirLightShadowsShouldUpdate = true;
+    ctx->rendering->postprocessing.useDoF = value;
 }
 
-void rendering_setShouldUpdatePointShadows(const ProgContext *ctx)
+void rendering_setDepthOfField(const ProgContext *ctx, float value)
 {
-    ctx->rendering->shadowMap.pointLightShadowsShouldUpdate = true;
+    ctx->rendering->postprocessing.depthOfField = value;
 }
 
-void rendering_setshowShadows(const ProgContext *ctx, bool value)
+void rendering_setFocusDistance(const ProgContext *ctx, float value)
 {
-    ctx->rendering->shadowMap.showShadows = value;
+    ctx->rendering->postprocessing.focusDistance = value;
 }
 
-void rendering_setUsePCF(const ProgContext *ctx, bool value)
+bool rendering_getUseDoF(const ProgContext *ctx)
 {
-    ctx->rendering->shadowMap.usePCF = value;
+    return ctx->rendering->postprocessing.useDoF;
+}
+
+float rendering_getDepthOfField(const ProgContext *ctx)
+{
+    return ctx->rendering->postprocessing.depthOfField;
 }
 
-float rendering_getDirLightDistanceMult(const ProgContext *ctx)
+float rendering_getFocusDistance(const ProgContext *ctx)
 {
-    return ctx->rendering->light.dirLightDistanceMult;
+    return ctx->rendering->postprocessing.focusDistance;
 }
 
-void rendering_setDirLightDistanceMult(const ProgContext *ctx, float value)
+int rendering_getDepthOfFieldDivisor(const ProgContext *ctx)
 {
-    ctx->rendering->light.dirLightDistanceMult = value;
+    return ctx->rendering->postprocessing.dofDivisor;
 }
 
-void rendering_setUseDoF(const ProgContext *ctx, bool value)
+void rendering_setDepthOfFieldDivisor(const ProgContext *ctx, int value)
 {
-    ctx->rendering->postprocessing.useDoF = value;
+    ctx->rendering->postprocessing.dofDivisor = value <= 2 ? 2 : 4;
 }
 
-void rendering_setDepthOfField(const ProgContext *ctx, float value)
+int rendering_getCascadeCount(const ProgContext *ctx)
 {
-    ctx->rendering->postprocessing.depthOfField = value;
+    return ctx->rendering->shadowMap.cascadeCount;
 }
 
-void rendering_setFocusDistance(const ProgContext *ctx, float value)
+void rendering_setCascadeCount(const ProgContext *ctx, int value)
 {
-    ctx->rendering->postprocessing.focusDistance = value;
+    ctx->rendering->shadowMap.cascadeCount = utils_maxInt(DIR_SHADOW_MIN_CASCADES, utils_minInt(value, DIR_SHADOW_MAX_CASCADES));
 }
 
-bool rendering_getUseDoF(const ProgContext *ctx)
+float rendering_getCascadeSplitLambda(const ProgContext *ctx)
 {
-    return ctx->rendering->postprocessing.useDoF;
+    return ctx->rendering->shadowMap.splitLambda;
 }
 
-float rendering_getDepthOfField(const ProgContext *ctx)
+void rendering_setCascadeSplitLambda(const ProgContext *ctx, float value)
 {
-    return ctx->rendering->postprocessing.depthOfField;
+    ctx->rendering->shadowMap.splitLambda = value;
 }
 
-float rendering_getFocusDistance(const ProgContext *ctx)
+float rendering_getShadowDistance(const ProgContext *ctx)
 {
-    return ctx->rendering->postprocessing.focusDistance;
+    return ctx->rendering->shadowMap.zFar;
 }
 
-float rendering_getZNear(const ProgContext *ctx)
+void rendering_setShadowDistance(const ProgContext *ctx, float value)
 {
-    return ctx->rendering->shadowMap.zNear;
+    ctx->rendering->shadowMap.zFar = value;
 }
 
-float rendering_getZFar(const ProgContext *ctx)
+GLuint rendering_getOutputFramebuffer(const ProgContext *ctx)
 {
-    return ctx->rendering->shadowMap.zFar;
+    return ctx->rendering->outputFramebuffer;
 }
 
-float rendering_getQuadSize(const ProgContext *ctx)
+void rendering_setOutputFramebuffer(const ProgContext *ctx, GLuint framebuffer)
 {
-    return ctx->rendering->shadowMap.quadSize;
+    ctx->rendering->outputFramebuffer = framebuffer;
 }
 
-void rendering_setZNear(const ProgContext *ctx, float value)
+bool rendering_getUseLightVolumes(const ProgContext *ctx)
 {
-    ctx->rendering->shadowMap.zNear = value;;
+    return ctx->rendering->lightVolume.enabled;
 }
 
-void rendering_setZFar(const ProgContext *ctx, float value)
+void rendering_setUseLightVolumes(const ProgContext *ctx, bool value)
 {
-    ctx->rendering->shadowMap.zFar = value;
+    ctx->rendering->lightVolume.enabled = value;
+}
+
+bool rendering_getUseLightScissor(const ProgContext *ctx)
+{
+    return ctx->rendering->lightVolume.useScissor;
+}
+
+void rendering_setUseLightScissor(const ProgContext *ctx, bool value)
+{
+    ctx->rendering->lightVolume.useScissor = value;
+}
+
+void rendering_getLightVolumeStats(const ProgContext *ctx, LightVolumeStats *stats)
+{
+    *stats = ctx->rendering->lightVolume.stats;
+}
+
+LightingMode rendering_getLightingMode(const ProgContext *ctx)
+{
+    return ctx->rendering->lightingMode;
+}
+
+void rendering_setLightingMode(const ProgContext *ctx, LightingMode mode)
+{
+    ctx->rendering->lightingMode = mode;
+}
+
+void rendering_getLightingStats(const ProgContext *ctx, LightingStats *stats)
+{
+    LightGridStats gridStats;
+    lightgrid_getStats(ctx->rendering->lightGrid, &gridStats);
+
+    stats->visibleLights = gridStats.visibleLights;
+    stats->cellCount = gridStats.cellCount;
+    stats->maxLightsPerCell = gridStats.maxLightsPerCell;
+    stats->assignmentTime = gridStats.assignmentTime;
+    stats->shadingTime = ctx->rendering->lightTimer.shadingTime;
+    stats->submissionTime = ctx->rendering->lightTimer.submissionTime;
+    stats->lightPasses = ctx->rendering->lightTimer.lastPasses;
+}
+
+void rendering_getGBufferStats(const ProgContext *ctx, GBufferStats *stats)
+{
+    GBufferBandwidth bandwidth;
+    gbuffer_getBandwidth(ctx->rendering->gbuffer, &bandwidth);
+
+    const double pixels = (double) bandwidth.width * (double) bandwidth.height;
+    const int passes = ctx->rendering->lightTimer.lastPasses;
+
+    stats->geometryBytes = bandwidth.geometryBytes;
+    stats->lightBytes = bandwidth.lightBytes;
+    stats->frameMegabytes = pixels * (bandwidth.geometryBytes + bandwidth.lightBytes * passes)
+                            / (1024.0 * 1024.0);
+    stats->legacyMegabytes = pixels * (GBUFFER_LEGACY_GEOMETRY_BYTES + GBUFFER_LEGACY_LIGHT_BYTES * passes)
+                             / (1024.0 * 1024.0);
+}
+
+bool rendering_getUse16BitPointShadows(const ProgContext *ctx)
+{
+    return shadowatlas_getUse16Bit(ctx->rendering->shadowAtlas);
+}
+
+void rendering_setUse16BitPointShadows(const ProgContext *ctx, bool value)
+{
+    shadowatlas_setUse16Bit(ctx->rendering->shadowAtlas, value);
+}
+
+void rendering_getShadowStats(const ProgContext *ctx, ShadowStats *stats)
+{
+    ShadowAtlasStats atlasStats;
+    shadowatlas_getStats(ctx->rendering->shadowAtlas, &atlasStats);
+
+    stats->shadowedLights = atlasStats.slotCount;
+    stats->requestedLights = atlasStats.requestedLights;
+    stats->minFaceSize = atlasStats.minFaceSize;
+    stats->maxFaceSize = atlasStats.maxFaceSize;
+    stats->occupancy = atlasStats.occupancy;
+    stats->megabytes = atlasStats.megabytes;
+    stats->dirShadowRenders = ctx->rendering->shadowMap.dirShadowRenders;
+    stats->dirShadowMeshes = ctx->rendering->shadowMap.dirShadowMeshes;
+    stats->pointShadowMeshes = ctx->rendering->shadowMap.pointShadowMeshes;
+    stats->pointShadowFaces = ctx->rendering->shadowMap.pointShadowFaces;
+    stats->pointShadowRenders = ctx->rendering->shadowMap.pointShadowRenders;
+}
+
+void rendering_getBloomStats(const ProgContext *ctx, BloomStats *stats)
+{
+    const Bloom *bloom = &ctx->rendering->postprocessing.bloom;
+
+    GBufferBandwidth bandwidth;
+    gbuffer_getBandwidth(ctx->rendering->gbuffer, &bandwidth);
+    const double screenPixels = (double) bandwidth.width * (double) bandwidth.height;
+
+    // Verkleinern liest die vorherige Stufe und schreibt die aktuelle,
+    // Vergrößern liest die kleinere Stufe und mischt in die größere.
+    double bytes = 0.0;
+    double previousPixels = screenPixels;
+    for (int level = 0; level < bloom->levels; ++level) {
+        int levelWidth, levelHeight;
+        getBloomLevelSize(bandwidth.width, bandwidth.height, level, &levelWidth, &levelHeight);
+        const double levelPixels = (double) levelWidth * (double) levelHeight;
+
+        if (level == 0) {
+            bytes += previousPixels * BLOOM_SOURCE_BYTES + levelPixels * BLOOM_LEVEL_BYTES;
+        } else {
+            bytes += (previousPixels + levelPixels) * BLOOM_LEVEL_BYTES;
+            bytes += (levelPixels + 2.0 * previousPixels) * BLOOM_LEVEL_BYTES;
+        }
+        previousPixels = levelPixels;
+    }
+
+    stats->gpuTime = bloom->timer.shadingTime;
+    stats->levels = bloom->levels;
+    stats->passes = bloom->timer.lastPasses;
+    getBloomLevelSize(bandwidth.width, bandwidth.height, 0, &stats->width, &stats->height);
+    stats->megabytes = bytes / (1024.0 * 1024.0);
+    stats->legacyMegabytes = screenPixels * (BLOOM_SOURCE_BYTES + BLOOM_LEGACY_TARGET_BYTES
+                                             + BLOOM_LEGACY_BLUR_PASSES * 2.0 * BLOOM_LEGACY_TARGET_BYTES)
+                             / (1024.0 * 1024.0);
+}
+
+void rendering_getDepthOfFieldStats(const ProgContext *ctx, DepthOfFieldStats *stats)
+{
+    const Postprocessing *postprocessing = &ctx->rendering->postprocessing;
+    const DynamicResolution *resolution = &ctx->rendering->resolution;
+
+    // Die Tiefenunschärfe arbeitet auf der aktuellen Render-Auflösung, nicht
+    // auf der des Fensters (siehe getDepthOfFieldSize).
+    stats->enabled = postprocessing->useDoF;
+    stats->gpuTime = postprocessing->useDoF ? postprocessing->dofTimer.shadingTime : 0.0;
+    stats->passes = postprocessing->useDoF ? postprocessing->dofTimer.lastPasses : 0;
+    stats->width = utils_maxInt(1, resolution->width / postprocessing->dofDivisor);
+    stats->height = utils_maxInt(1, resolution->height / postprocessing->dofDivisor);
+}
+
+void rendering_getPostprocessStats(const ProgContext *ctx, PostprocessStats *stats)
+{
+    const Postprocessing *postprocessing = &ctx->rendering->postprocessing;
+    const PostprocessPlan *plan = &postprocessing->plan;
+
+    GBufferBandwidth bandwidth;
+    gbuffer_getBandwidth(ctx->rendering->gbuffer, &bandwidth);
+    const double screenMegabytes = (double) bandwidth.width * (double) bandwidth.height / (1024.0 * 1024.0);
+
+    stats->stages = plan->stages;
+    stats->gpuTime = (plan->stages & POSTPROCESS_STAGE_DOF) ? postprocessing->dofTimer.shadingTime
+                                                             : postprocessing->timer.shadingTime;
+    stats->passes = plan->passes;
+    stats->megabytes = plan->bytesPerPixel * screenMegabytes;
+    stats->separatePasses = plan->separatePasses;
+    stats->separateMegabytes = plan->separateBytesPerPixel * screenMegabytes;
+}
+
+void rendering_getFrameGraphStats(const ProgContext *ctx, FrameGraphStats *stats)
+{
+    RenderGraphStats graphStats;
+    rendergraph_getStats(ctx->rendering->renderGraph, &graphStats);
+
+    stats->passes = graphStats.passes;
+    stats->culledPasses = graphStats.culledPasses;
+    stats->targets = graphStats.transientTextures;
+    stats->textures = graphStats.pooledTextures;
+    stats->megabytes = graphStats.transientMegabytes;
+    stats->poolMegabytes = graphStats.poolMegabytes;
+    stats->dedicatedMegabytes = graphStats.declaredMegabytes;
+}
+
+bool rendering_getUseDynamicResolution(const ProgContext *ctx)
+{
+    return ctx->rendering->resolution.enabled;
+}
+
+void rendering_setUseDynamicResolution(const ProgContext *ctx, bool value)
+{
+    ctx->rendering->resolution.enabled = value;
+}
+
+float rendering_getFrameBudget(const ProgContext *ctx)
+{
+    return ctx->rendering->resolution.budget;
+}
+
+void rendering_setFrameBudget(const ProgContext *ctx, float budget)
+{
+    ctx->rendering->resolution.budget = budget;
+}
+
+float rendering_getRenderScale(const ProgContext *ctx)
+{
+    return ctx->rendering->resolution.fixedScale;
+}
+
+void rendering_setRenderScale(const ProgContext *ctx, float scale)
+{
+    ctx->rendering->resolution.fixedScale = glm_clamp(scale, DYNAMIC_RESOLUTION_MIN_SCALE, DYNAMIC_RESOLUTION_MAX_SCALE);
+}
+
+UpscalingMode rendering_getUpscalingMode(const ProgContext *ctx)
+{
+    return ctx->rendering->temporal.mode;
+}
+
+void rendering_setUpscalingMode(const ProgContext *ctx, UpscalingMode mode)
+{
+    ctx->rendering->temporal.mode = mode;
 }
 
-void rendering_setQuadSize(const ProgContext *ctx, float value)
+void rendering_getDynamicResolutionStats(const ProgContext *ctx, DynamicResolutionStats *stats)
 {
-    ctx->rendering->shadowMap.quadSize = value;
+    const DynamicResolution *resolution = &ctx->rendering->resolution;
+    const TemporalUpscaling *temporal = &ctx->rendering->temporal;
+
+    stats->enabled = resolution->enabled;
+    stats->scale = resolution->scale;
+    stats->width = resolution->width;
+    stats->height = resolution->height;
+    stats->gpuTime = resolution->gpuTime;
+    stats->budget = resolution->budget;
+    stats->mode = temporal->mode;
+    stats->nativeGpuTime = resolution->nativeGpuTime;
+    stats->resolveTime = temporal->mode == UPSCALING_MODE_TEMPORAL ? temporal->timer.shadingTime : 0.0;
 }
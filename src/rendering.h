@@ -18,8 +18,154 @@ typedef enum {
  RENDER_MODE_COUNT // Anzahl der Modi, um die Dropdown-Länge zu bestimmen
 } RenderMode;
 
+// Verfahren, mit dem die Punktlichter ausgewertet werden
+typedef enum {
+ LIGHTING_MODE_PER_LIGHT, // ein Pass pro Licht (Lichtvolumen oder Fullscreen)
+ LIGHTING_MODE_TILED, // ein Pass für alle Lichter mit Kachellisten
+ LIGHTING_MODE_CLUSTERED, // ein Pass für alle Lichter mit Clusterlisten
+ LIGHTING_MODE_SINGLE_PASS, // ein Pass für alle Punkt- und Richtungslichter aus einem Uniform Buffer
+
+ LIGHTING_MODE_COUNT
+} LightingMode;
+
+// Verfahren, mit dem ein in verringerter Auflösung gerendertes Bild auf die
+// Größe des Ausgabeziels gebracht wird
+typedef enum {
+ UPSCALING_MODE_SPATIAL, // bilinear aus dem Bild des aktuellen Frames
+ UPSCALING_MODE_TEMPORAL, // aus den verschobenen Bildern mehrerer Frames (temporale Rekonstruktion)
+
+ UPSCALING_MODE_COUNT
+} UpscalingMode;
+
 #define DIR_SHADOW_SIZE 1024
-#define POINT_SHADOW_SIZE 512
+
+// Anzahl der Kaskaden der Richtungslicht-Schatten, muss zu den Shadern passen
+#define DIR_SHADOW_MIN_CASCADES 2
+#define DIR_SHADOW_MAX_CASCADES 4
+
+// Höchstzahl der Bloom-Stufen
+#define BLOOM_MAX_LEVELS 6
+
+// Statistiken der Punktlicht-Pässe eines Frames
+typedef struct {
+    int volumeLights;          // über ihr Lichtvolumen gezeichnete Punktlichter
+    int fullscreenLights;      // als Fullscreen-Quad gezeichnete Punktlichter
+    int skippedLights;         // außerhalb des Sichtbereichs übersprungene Punktlichter
+    int scissoredLights;       // auf ihr Bildschirmrechteck begrenzte Punktlichter
+    GLuint64 litPixels;        // Pixel, für die der Beleuchtungs-Shader lief
+    GLuint64 fullscreenPixels; // Pixel, die reine Fullscreen-Pässe beleuchtet hätten
+} LightVolumeStats;
+
+// Statistiken der Beleuchtungs-Pässe
+typedef struct {
+    int visibleLights;     // Lichter im Sichtbereich (gekachelt/geclustert)
+    int cellCount;         // Anzahl der Kacheln bzw. Cluster
+    int maxLightsPerCell;  // längste Lichtliste einer Zelle
+    double assignmentTime; // Zeit für das Einsortieren auf der CPU in ms
+    double shadingTime;    // GPU-Zeit der Beleuchtungs-Pässe in ms
+    double submissionTime; // CPU-Zeit für das Absetzen der Beleuchtung in ms
+    int lightPasses;       // Draw-Calls, die den G-Buffer lesen
+} LightingStats;
+
+// Geschätzter Speicherverkehr des G-Buffers im letzten Frame. Jeder
+// Beleuchtungs-Pass wird dabei als Fullscreen-Pass gezählt.
+typedef struct {
+    float geometryBytes;    // pro Pixel im Geometry-Pass geschriebene Bytes
+    float lightBytes;       // pro Pixel und Beleuchtungs-Pass gelesene Bytes
+    double frameMegabytes;  // G-Buffer-Verkehr des Frames in MB
+    double legacyMegabytes; // derselbe Frame mit dem alten Layout in MB
+} GBufferStats;
+
+// Belegung des Schatten-Atlas der Punktlichter und Anzahl der Schattenkarten,
+// die im letzten Frame neu gerendert wurden
+typedef struct {
+    int shadowedLights;  // Punktlichter mit einem Slot im Atlas
+    int requestedLights; // Punktlichter der Szene
+    int minFaceSize;     // kleinste vergebene Kantenlänge einer Würfelseite
+    int maxFaceSize;     // größte vergebene Kantenlänge einer Würfelseite
+    float occupancy;     // belegter Anteil des Atlas zwischen 0 und 1
+    double megabytes;    // fester Speicherbedarf des Atlas in MB
+    int dirShadowRenders;   // neu gerenderte Kaskaden des Richtungslichts
+    int dirShadowMeshes;    // in diese Kaskaden gezeichnete Meshes
+    int pointShadowRenders; // neu gerenderte Punktlicht-Schattenkarten
+    int pointShadowMeshes;  // in diese Schattenkarten gezeichnete Meshes
+    int pointShadowFaces;   // von diesen Meshes belegte Würfelseiten
+} ShadowStats;
+
+// Kosten des Bloom-Effekts im letzten Frame. Zum Vergleich wird der
+// Speicherverkehr geschätzt, den Threshold-Pass und Gaussian-Blur in voller
+// Auflösung bei derselben Bildschirmgröße verursacht hätten.
+typedef struct {
+    double gpuTime;         // GPU-Zeit aller Bloom-Pässe in ms
+    int levels;             // genutzte Stufen der Mip-Kette
+    int passes;             // Draw-Calls der Bloom-Pässe
+    int width;              // Breite der ersten Stufe
+    int height;             // Höhe der ersten Stufe
+    double megabytes;       // geschätzter Speicherverkehr in MB
+    double legacyMegabytes; // derselbe Frame mit dem alten Blur in MB
+} BloomStats;
+
+// Kosten der Tiefenunschärfe im letzten Frame. Ist sie abgeschaltet, läuft
+// keiner ihrer Pässe.
+typedef struct {
+    bool enabled;   // Tiefenunschärfe aktiv
+    double gpuTime; // GPU-Zeit aller Pässe der Tiefenunschärfe in ms
+    int passes;     // Draw-Calls der Tiefenunschärfe
+    int width;      // Breite des verkleinerten Bildes
+    int height;     // Höhe des verkleinerten Bildes
+} DepthOfFieldStats;
+
+// Stufen der Nachbearbeitung, die pro Pixel ausgewertet werden
+typedef enum PostprocessStage {
+    POSTPROCESS_STAGE_FOG     = 1 << 0, // Nebel
+    POSTPROCESS_STAGE_BLOOM   = 1 << 1, // Aufaddieren der Bloom-Stufen
+    POSTPROCESS_STAGE_TONEMAP = 1 << 2, // Belichtung und Gamma
+    POSTPROCESS_STAGE_SKYBOX  = 1 << 3, // Skybox im Hintergrund
+    POSTPROCESS_STAGE_DOF     = 1 << 4  // Zusammensetzen der Tiefenunschärfe
+} PostprocessStage;
+
+// Kosten der zusammengefassten Nachbearbeitung im letzten Frame. Zum
+// Vergleich wird geschätzt, was dieselben Stufen als einzelne Fullscreen-Pässe
+// verursacht hätten. Pässe der Tiefenunschärfe in verringerter Auflösung
+// zählen nicht zu den Pässen, aber zum Speicherverkehr.
+typedef struct {
+    int stages;               // Bitmaske der aktiven PostprocessStage
+    double gpuTime;           // GPU-Zeit der Nachbearbeitung in ms
+    int passes;               // Fullscreen-Pässe in voller Auflösung
+    double megabytes;         // geschätzter Speicherverkehr in MB
+    int separatePasses;       // Pässe, wenn jede Stufe einzeln liefe
+    double separateMegabytes; // Speicherverkehr der einzelnen Pässe in MB
+} PostprocessStats;
+
+// Pässe und transiente Ziele des Render-Graphen im letzten Frame. Zum
+// Vergleich wird der Speicher angegeben, den alle angemeldeten Ziele mit
+// eigenen, dauerhaft angelegten Texturen bräuchten.
+typedef struct {
+    int passes;                // angemeldete Pässe
+    int culledPasses;          // entfallene Pässe, deren Ergebnis niemand liest
+    int targets;               // von laufenden Pässen benutzte Ziele
+    int textures;              // dafür vergebene Texturen des Pools
+    double megabytes;          // Speicher dieser Texturen in MB
+    double poolMegabytes;      // Speicher des Pools samt unbenutzter Texturen in MB
+    double dedicatedMegabytes; // alle Ziele mit eigener Textur in MB
+} FrameGraphStats;
+
+// Grenzen der dynamischen Auflösung als Anteil der Kantenlängen des Fensters
+#define DYNAMIC_RESOLUTION_MIN_SCALE 0.5f
+#define DYNAMIC_RESOLUTION_MAX_SCALE 1.0f
+
+// Zustand der dynamischen Auflösung im letzten Frame
+typedef struct {
+    bool enabled;   // Skalierung wird nach dem Budget geregelt
+    float scale;    // Anteil der Kantenlängen des Fensters, in den gerendert wurde
+    int width;      // Breite, in die gerendert wurde
+    int height;     // Höhe, in die gerendert wurde
+    double gpuTime; // zuletzt gemessene GPU-Zeit eines Frames in ms
+    float budget;   // angestrebte GPU-Zeit eines Frames in ms
+    UpscalingMode mode;   // Verfahren des Hochskalierens
+    double nativeGpuTime; // zuletzt gemessene GPU-Zeit in voller Auflösung ohne Rekonstruktion in ms, 0 ohne Messung
+    double resolveTime;   // GPU-Zeit der temporalen Rekonstruktion in ms
+} DynamicResolutionStats;
 
 //////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
 
@@ -65,14 +211,16 @@ void rendering_selectRenderMode(const ProgContext* ctx, RenderMode mode);
 /**
  * Rekompiliert die Shader, die im Rendering-Modul verwendet werden.
  *
- * Diese Funktion lädt die Shader-Dateien neu, kompiliert sie erneut und verlinkt
- * die Shader-Programme. Sie ermöglicht es, Änderungen an den Shader-Quellcodes
- * zur Laufzeit zu übernehmen, ohne das Programm neu zu starten.
+ * Diese Funktion lädt die Shader-Dateien neu und übergibt alle gemeinsam an
+ * den Treiber. Jedes Programm wird erst ausgetauscht, wenn es fertig ist, der
+ * Frame wartet also nicht auf das Übersetzen. Fehler werden dann ausgegeben
+ * und das alte Programm bleibt aktiv. Sie ermöglicht es, Änderungen an den
+ * Shader-Quellcodes zur Laufzeit zu übernehmen, ohne das Programm neu zu
+ * starten.
  *
  * @param ctx Programmkontext.
- * @return true, wenn die Operation erfolgreich war, false wenn nicht.
  */
-bool rendering_recompileShader(const ProgContext* ctx);
+void rendering_recompileShader(const ProgContext* ctx);
 
 /**
  * Gibt den Status des Skybox-Renderings zurück.
@@ -396,12 +544,12 @@ float rendering_getThresholdEmissionWeight(const ProgContext *ctx);
 float rendering_getThresholdColorWeight(const ProgContext *ctx);
 
 /**
- * Gibt die Anzahl der Iterationen für den Bloom-Blur zurück.
+ * Gibt die Anzahl der Stufen der Bloom-Mip-Kette zurück.
  *
  * @param ctx Programmkontext.
- * @return Die Anzahl der Iterationen für den Bloom-Blur.
+ * @return Die Anzahl der Stufen, 0 wenn Bloom abgeschaltet ist.
  */
-int rendering_getBloomBlurIterations(const ProgContext *ctx);
+int rendering_getBloomLevels(const ProgContext *ctx);
 
 /**
  * Setzt den Schwellenwert.
@@ -428,12 +576,14 @@ void rendering_setThresholdEmissionWeight(const ProgContext *ctx, float emission
 void rendering_setThresholdColorWeight(const ProgContext *ctx, float colorWeight);
 
 /**
- * Setzt die Anzahl der Iterationen für den Bloom-Blur.
+ * Setzt die Anzahl der Stufen der Bloom-Mip-Kette. Mehr Stufen machen den
+ * Bloom breiter, kosten aber kaum mehr, da jede Stufe nur ein Viertel der
+ * Pixel der vorherigen hat. Der Wert wird auf 0 bis BLOOM_MAX_LEVELS begrenzt.
  *
  * @param ctx Programmkontext.
- * @param blurIterations Die neue Anzahl der Iterationen für den Bloom-Blur.
+ * @param levels Die neue Anzahl der Stufen, 0 schaltet Bloom ab.
  */
-void rendering_setBloomBlurIterations(const ProgContext *ctx, int blurIterations);
+void rendering_setBloomLevels(const ProgContext *ctx, int levels);
 
 /**
  * Setzt die Nebelfarbe.
@@ -536,40 +686,6 @@ bool rendering_getShowShadows(const ProgContext *ctx);
  */
 bool rendering_getUsePCF(const ProgContext *ctx);
 
-/**
- * @brief Gibt zurück, ob Richtungslicht-Schatten immer aktualisiert werden sollen.
- *
- * @param ctx Zeiger auf den Programmkontext.
- * @return True, wenn Richtungslicht-Schatten immer aktualisiert werden sollen, sonst False.
- */
-bool rendering_getAlwaysUpdateDirShadows(const ProgContext *ctx);
-
-/**
- * @brief Setzt, ob Richtungslicht-Schatten immer aktualisiert werden sollen.
- *
- * @param ctx Zeiger auf den Programmkontext.
- * @param value True, um die ständige Aktualisierung zu aktivieren, sonst False.
- */
-void rendering_setAlwaysUpdateDirShadows(const ProgContext *ctx, bool value);
-
-/**
- * @brief Setzt das Flag, dass Richtungslicht-Schatten aktualisiert werden sollen.
- *
- * Diese Funktion markiert die Richtungslicht-Schatten zur Aktualisierung in der nächsten Renderphase.
- *
- * @param ctx Zeiger auf den Programmkontext.
- */
-void rendering_setShouldUpdateDirShadows(const ProgContext *ctx);
-
-/**
- * @brief Setzt das Flag, dass Punktlicht-Schatten aktualisiert werden sollen.
- *
- * Diese Funktion markiert die Punktlicht-Schatten zur Aktualisierung in der nächsten Renderphase.
- *
- * @param ctx Zeiger auf den Programmkontext.
- */
-void rendering_setShouldUpdatePointShadows(const ProgContext *ctx);
-
 /**
  * @brief Setzt, ob Schatten angezeigt werden sollen.
  *
@@ -586,22 +702,6 @@ void rendering_setshowShadows(const ProgContext *ctx, bool value);
  */
 void rendering_setUsePCF(const ProgContext *ctx, bool value);
 
-/**
- * @brief Gibt den Distanz-Multiplikator für das Richtungslicht zurück.
- *
- * @param ctx Zeiger auf den Programmkontext.
- * @return Der aktuelle Distanz-Multiplikator für das Richtungslicht.
- */
-float rendering_getDirLightDistanceMult(const ProgContext *ctx);
-
-/**
- * @brief Setzt den Distanz-Multiplikator für das Richtungslicht.
- *
- * @param ctx Zeiger auf den Programmkontext.
- * @param value Der neue Distanz-Multiplikator für das Richtungslicht.
- */
-void rendering_setDirLightDistanceMult(const ProgContext *ctx, float value);
-
 /**
  * Gibt die aktuelle Richtung der Richtungslichtquelle zurück.
  *
@@ -659,51 +759,319 @@ float rendering_getDepthOfField(const ProgContext *ctx);
 float rendering_getFocusDistance(const ProgContext *ctx);
 
 /**
- * Gibt die aktuelle Near-Z-Koordinate der Kamera zurück.
+ * Gibt zurück, um welchen Faktor die Tiefenunschärfe verkleinert berechnet wird.
+ *
+ * @param ctx Programmkontext.
+ * @return 2 für halbe, 4 für viertel Auflösung.
+ */
+int rendering_getDepthOfFieldDivisor(const ProgContext *ctx);
+
+/**
+ * Setzt, um welchen Faktor die Tiefenunschärfe verkleinert berechnet wird.
+ * Werte bis 2 ergeben die halbe, größere die viertel Auflösung.
+ *
+ * @param ctx Programmkontext.
+ * @param value 2 für halbe, 4 für viertel Auflösung.
+ */
+void rendering_setDepthOfFieldDivisor(const ProgContext *ctx, int value);
+
+/**
+ * Gibt die Anzahl der Kaskaden der Richtungslicht-Schatten zurück.
+ *
+ * @param ctx Programmkontext.
+ * @return Die Anzahl der Kaskaden.
+ */
+int rendering_getCascadeCount(const ProgContext *ctx);
+
+/**
+ * Setzt die Anzahl der Kaskaden der Richtungslicht-Schatten. Der Wert wird
+ * auf DIR_SHADOW_MIN_CASCADES bis DIR_SHADOW_MAX_CASCADES begrenzt.
+ *
+ * @param ctx Programmkontext.
+ * @param value Die neue Anzahl der Kaskaden.
+ */
+void rendering_setCascadeCount(const ProgContext *ctx, int value);
+
+/**
+ * Gibt die Gewichtung der logarithmischen Aufteilung der Kaskaden zurück.
+ *
+ * @param ctx Programmkontext.
+ * @return 0 für gleich lange, 1 für rein logarithmisch verteilte Kaskaden.
+ */
+float rendering_getCascadeSplitLambda(const ProgContext *ctx);
+
+/**
+ * Setzt die Gewichtung der logarithmischen Aufteilung der Kaskaden.
+ *
+ * @param ctx Programmkontext.
+ * @param value 0 für gleich lange, 1 für rein logarithmisch verteilte Kaskaden.
+ */
+void rendering_setCascadeSplitLambda(const ProgContext *ctx, float value);
+
+/**
+ * Gibt die Entfernung zur Kamera zurück, bis zu der Richtungslichter
+ * Schatten werfen.
+ *
+ * @param ctx Programmkontext.
+ * @return Das Ende der letzten Kaskade.
+ */
+float rendering_getShadowDistance(const ProgContext *ctx);
+
+/**
+ * Setzt die Entfernung zur Kamera, bis zu der Richtungslichter Schatten
+ * werfen.
+ *
+ * @param ctx Programmkontext.
+ * @param value Das neue Ende der letzten Kaskade.
+ */
+void rendering_setShadowDistance(const ProgContext *ctx, float value);
+
+/**
+ * Gibt den Framebuffer zurück, in den das fertige Bild gerendert wird.
+ *
+ * @param ctx Programmkontext.
+ * @return Der Ziel-Framebuffer, 0 steht für das Fenster.
+ */
+GLuint rendering_getOutputFramebuffer(const ProgContext *ctx);
+
+/**
+ * Setzt den Framebuffer, in den das fertige Bild gerendert wird. Wird z.B.
+ * im Headless-Modus genutzt, in dem es keinen Default-Framebuffer gibt.
+ *
+ * @param ctx Programmkontext.
+ * @param framebuffer Der neue Ziel-Framebuffer, 0 steht für das Fenster.
+ */
+void rendering_setOutputFramebuffer(const ProgContext *ctx, GLuint framebuffer);
+
+/**
+ * Gibt an, ob die Punktlichter über ihr Lichtvolumen gezeichnet werden.
+ *
+ * @param ctx Programmkontext.
+ * @return true, wenn die Lichtvolumen aktiv sind.
+ */
+bool rendering_getUseLightVolumes(const ProgContext *ctx);
+
+/**
+ * Legt fest, ob die Punktlichter über ihr Lichtvolumen (mit Stencil-Test)
+ * oder als Fullscreen-Quad gezeichnet werden.
+ *
+ * @param ctx Programmkontext.
+ * @param value true, um die Lichtvolumen zu aktivieren.
+ */
+void rendering_setUseLightVolumes(const ProgContext *ctx, bool value);
+
+/**
+ * Gibt an, ob die Punktlicht-Pässe auf das Bildschirmrechteck des Lichts
+ * begrenzt werden.
+ *
+ * @param ctx Programmkontext.
+ * @return true, wenn der Scissor-Test aktiv ist.
+ */
+bool rendering_getUseLightScissor(const ProgContext *ctx);
+
+/**
+ * Legt fest, ob die Punktlicht-Pässe per Scissor-Test auf das
+ * Bildschirmrechteck des Lichts begrenzt und Lichter außerhalb des
+ * Sichtbereichs übersprungen werden.
+ *
+ * @param ctx Programmkontext.
+ * @param value true, um den Scissor-Test zu aktivieren.
+ */
+void rendering_setUseLightScissor(const ProgContext *ctx, bool value);
+
+/**
+ * Liefert die Statistiken der Punktlicht-Pässe. Die Werte stammen aus einem
+ * der letzten Frames, da die Queries ohne Warten ausgelesen werden.
+ *
+ * @param ctx Programmkontext.
+ * @param stats Ausgabeparameter für die Statistiken.
+ */
+void rendering_getLightVolumeStats(const ProgContext *ctx, LightVolumeStats *stats);
+
+/**
+ * Gibt das Verfahren zurück, mit dem die Punktlichter ausgewertet werden.
+ *
+ * @param ctx Programmkontext.
+ * @return Das aktuelle Beleuchtungsverfahren.
+ */
+LightingMode rendering_getLightingMode(const ProgContext *ctx);
+
+/**
+ * Legt das Verfahren fest, mit dem die Punktlichter ausgewertet werden.
+ *
+ * @param ctx Programmkontext.
+ * @param mode Das neue Beleuchtungsverfahren.
+ */
+void rendering_setLightingMode(const ProgContext *ctx, LightingMode mode);
+
+/**
+ * Liefert die Statistiken der Beleuchtung. Die Werte der Lichtzuordnung
+ * stammen aus dem gekachelten bzw. geclusterten Modus, die Zeiten und die
+ * Anzahl der Pässe werden in jedem Modus gemessen. Die GPU-Zeit stammt aus
+ * einem der letzten Frames.
+ *
+ * @param ctx Programmkontext.
+ * @param stats Ausgabeparameter für die Statistiken.
+ */
+void rendering_getLightingStats(const ProgContext *ctx, LightingStats *stats);
+
+/**
+ * Liefert den geschätzten Speicherverkehr des G-Buffers im letzten Frame, zum
+ * Vergleich auch für das alte Layout mit gespeicherten Positionen.
+ *
+ * @param ctx Programmkontext.
+ * @param stats Ausgabeparameter für die Statistiken.
+ */
+void rendering_getGBufferStats(const ProgContext *ctx, GBufferStats *stats);
+
+/**
+ * Gibt zurück, ob der Schatten-Atlas der Punktlichter die Tiefe mit 16 Bit
+ * speichert.
+ *
+ * @param ctx Programmkontext.
+ * @return True bei 16 Bit, False bei 32 Bit.
+ */
+bool rendering_getUse16BitPointShadows(const ProgContext *ctx);
+
+/**
+ * Legt fest, ob der Schatten-Atlas der Punktlichter die Tiefe mit 16 Bit
+ * speichert. Der Atlas wird dabei neu angelegt und alle Punktlicht-Schatten
+ * werden neu gerendert.
+ *
+ * @param ctx Programmkontext.
+ * @param value True für 16 Bit, False für 32 Bit.
+ */
+void rendering_setUse16BitPointShadows(const ProgContext *ctx, bool value);
+
+/**
+ * Liefert die Belegung des Schatten-Atlas der Punktlichter und wie viele
+ * Schattenkarten im letzten Frame neu gerendert wurden. Schattenkarten werden
+ * nur neu gerendert, wenn sich Licht, Szenentransformation oder
+ * Schattenparameter geändert haben.
+ *
+ * @param ctx Programmkontext.
+ * @param stats Ausgabeparameter für die Statistiken.
+ */
+void rendering_getShadowStats(const ProgContext *ctx, ShadowStats *stats);
+
+/**
+ * Liefert GPU-Zeit und geschätzten Speicherverkehr der Bloom-Pässe im
+ * letzten Frame sowie die Auflösung, ab der die Mip-Kette beginnt.
+ *
+ * @param ctx Programmkontext.
+ * @param stats Ausgabeparameter für die Statistiken.
+ */
+void rendering_getBloomStats(const ProgContext *ctx, BloomStats *stats);
+
+/**
+ * Liefert GPU-Zeit und Auflösung der Tiefenunschärfe im letzten Frame.
+ *
+ * @param ctx Programmkontext.
+ * @param stats Ausgabeparameter für die Statistiken.
+ */
+void rendering_getDepthOfFieldStats(const ProgContext *ctx, DepthOfFieldStats *stats);
+
+/**
+ * Liefert die aktiven Stufen der Nachbearbeitung, die Anzahl der Pässe, in
+ * die sie zusammengefasst wurden, und deren geschätzten Speicherverkehr im
+ * Vergleich zu einzelnen Pässen.
+ *
+ * @param ctx Programmkontext.
+ * @param stats Ausgabeparameter für die Statistiken.
+ */
+void rendering_getPostprocessStats(const ProgContext *ctx, PostprocessStats *stats);
+
+/**
+ * Liefert, wie viele Pässe der Render-Graph im letzten Frame angemeldet und
+ * wie viele er entfernt hat, sowie den Speicher der transienten Ziele.
+ *
+ * @param ctx Programmkontext.
+ * @param stats Ausgabeparameter für die Statistiken.
+ */
+void rendering_getFrameGraphStats(const ProgContext *ctx, FrameGraphStats *stats);
+
+/**
+ * Gibt an, ob die Auflösung nach dem GPU-Budget geregelt wird.
+ *
+ * @param ctx Programmkontext.
+ * @return true, wenn die dynamische Auflösung aktiv ist.
+ */
+bool rendering_getUseDynamicResolution(const ProgContext *ctx);
+
+/**
+ * Legt fest, ob Geometrie, Beleuchtung und Nachbearbeitung in einer nach der
+ * gemessenen GPU-Zeit geregelten Auflösung laufen und danach auf das Fenster
+ * hochskaliert werden. Ohne gilt die feste Skalierung (siehe
+ * rendering_setRenderScale).
+ *
+ * @param ctx Programmkontext.
+ * @param value true, um die dynamische Auflösung zu aktivieren.
+ */
+void rendering_setUseDynamicResolution(const ProgContext *ctx, bool value);
+
+/**
+ * Gibt die angestrebte GPU-Zeit eines Frames zurück.
+ *
+ * @param ctx Programmkontext.
+ * @return Das Budget in Millisekunden.
+ */
+float rendering_getFrameBudget(const ProgContext *ctx);
+
+/**
+ * Setzt die GPU-Zeit, auf die die dynamische Auflösung einen Frame regelt.
  *
  * @param ctx Programmkontext.
- * @return Der aktuelle Z-Near-Wert.
+ * @param budget Das Budget in Millisekunden.
  */
-float rendering_getZNear(const ProgContext *ctx);
+void rendering_setFrameBudget(const ProgContext *ctx, float budget);
 
 /**
- * Gibt die aktuelle Far-Z-Koordinate der Kamera zurück.
+ * Gibt den Anteil der Kantenlängen des Fensters zurück, in den ohne
+ * dynamische Auflösung gerendert wird.
  *
  * @param ctx Programmkontext.
- * @return Der aktuelle Z-Far-Wert.
+ * @return Die feste Skalierung.
  */
-float rendering_getZFar(const ProgContext *ctx);
+float rendering_getRenderScale(const ProgContext *ctx);
 
 /**
- * Gibt die aktuelle Quad-Größe zurück.
+ * Legt fest, in welchen Anteil der Kantenlängen des Fensters ohne dynamische
+ * Auflösung gerendert wird. Mit 1 wird in voller Auflösung gerendert.
  *
  * @param ctx Programmkontext.
- * @return Die aktuelle Quad-Größe.
+ * @param scale Die Skalierung zwischen DYNAMIC_RESOLUTION_MIN_SCALE und
+ *              DYNAMIC_RESOLUTION_MAX_SCALE.
  */
-float rendering_getQuadSize(const ProgContext *ctx);
+void rendering_setRenderScale(const ProgContext *ctx, float scale);
 
 /**
- * Setzt die Near-Z-Koordinate der Kamera.
+ * Gibt das Verfahren zurück, mit dem auf die Größe des Fensters hochskaliert
+ * wird.
  *
  * @param ctx Programmkontext.
- * @param value Der neue Z-Near-Wert.
+ * @return Das aktuelle Verfahren.
  */
-void rendering_setZNear(const ProgContext *ctx, float value);
+UpscalingMode rendering_getUpscalingMode(const ProgContext *ctx);
 
 /**
- * Setzt die Far-Z-Koordinate der Kamera.
+ * Legt das Verfahren fest, mit dem auf die Größe des Fensters hochskaliert
+ * wird. Bei der temporalen Rekonstruktion wird die Projektion in jedem Frame
+ * um einen Bruchteil eines Pixels verschoben und das Ergebnis auch in voller
+ * Auflösung über mehrere Frames gemittelt.
  *
  * @param ctx Programmkontext.
- * @param value Der neue Z-Far-Wert.
+ * @param mode Das neue Verfahren.
  */
-void rendering_setZFar(const ProgContext *ctx, float value);
+void rendering_setUpscalingMode(const ProgContext *ctx, UpscalingMode mode);
 
 /**
- * Setzt die Quad-Größe.
+ * Liefert die aktuelle Skalierung und Auflösung sowie die zuletzt gemessene
+ * GPU-Zeit eines Frames. Zum Vergleich wird die GPU-Zeit des letzten Frames
+ * angegeben, der in voller Auflösung ohne Rekonstruktion gerendert wurde.
  *
  * @param ctx Programmkontext.
- * @param value Die neue Quad-Größe.
+ * @param stats Ausgabeparameter für die Statistiken.
  */
-void rendering_setQuadSize(const ProgContext *ctx, float value);
+void rendering_getDynamicResolutionStats(const ProgContext *ctx, DynamicResolutionStats *stats);
 
 #endif // RENDERING_H
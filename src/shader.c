@@ -8,12 +8,51 @@
 #include "shader.h"
 
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
 #include <sesp/stb_ds.h>
 
+#include "filewatch.h"
 #include "utils.h"
 
+////////////////////////////////// KONSTANTEN //////////////////////////////////
+
+// Maximale Verschachtelungstiefe von #include, schützt vor Zyklen
+#define SHADER_MAX_INCLUDE_DEPTH 8
+
+// Verzeichnis für die gelinkten Programme, relativ zum Arbeitsverzeichnis
+#define SHADER_CACHE_DIR "shadercache"
+
+// Kennung und Version des Dateiformats im Cache
+#define SHADER_CACHE_MAGIC 0x43505345u
+#define SHADER_CACHE_VERSION 1u
+
+// Maximale Anzahl der Stufen eines Programms
+#define SHADER_MAX_STAGES 5
+
+// Aus GL_KHR_parallel_shader_compile, fehlt im eingebundenen glad
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// Startwert und Primzahl des 64 Bit FNV-1a Hashes
+#define SHADER_HASH_OFFSET 0xcbf29ce484222325ull
+#define SHADER_HASH_PRIME 0x100000001b3ull
+
 ////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
 
+// Ein an den Treiber übergebenes Programm, dessen Status noch nicht abgefragt
+// wurde. Bis dahin kann der Treiber es im Hintergrund übersetzen und linken.
+typedef struct
+{
+    GLuint program;                         // 0, wenn gerade nichts gebaut wird
+    GLuint stages[SHADER_MAX_STAGES];       // übersetzte Stufen
+    const char* files[SHADER_MAX_STAGES];   // Dateien der Stufen für Meldungen
+    int stageCount;                         // 0 bei Programmen aus dem Cache
+    uint64_t key;                           // Schlüssel im Cache, 0 ohne Cache
+    bool cached;                            // Programm stammt aus dem Cache
+} ShaderBuild;
+
 // Implementierung der Datenstruktur, die einen Shader repräsentiert.
 // Dadurch, dass das Struct erst hier vollständig definiert wird, sind die
 // Eigenschaften eines Shaders nur in dieser Datei sichtbar.
@@ -36,41 +75,439 @@ struct Shader
     char* teseShaderPath;
     char* tescShaderPath;
     char* geomShaderPath;
+    char* defines; // #define Zeilen der Variante oder NULL
+
+    // Neues Programm, das das aktuelle ersetzt, sobald es fertig ist
+    ShaderBuild build;
+
+    // Alle Dateien samt #include, aus denen das Programm zuletzt gebaut
+    // wurde, als stb_ds Array
+    char** dependencies;
+};
+
+// Alle bisher benötigten Varianten eines Shaders, nach Schlüssel sortiert.
+struct ShaderVariants
+{
+    char* label;
+    char* vertexShaderPath;
+    char* tescShaderPath;
+    char* teseShaderPath;
+    char* geomShaderPath;
+    char* fragmentShaderPath;
+
+    char** defineNames; // Name des Defines für jedes Bit des Schlüssels
+    int defineCount;
+    unsigned int keyMask; // Bits des Schlüssels, zu denen es ein Define gibt
+
+    struct VariantHashmap {
+        unsigned int key;
+        Shader* value; // ohne gelinktes Programm, wenn der Bau fehlschlug
+    } *variants;
 };
 
+// Kopf einer Datei im Cache, danach folgt das Binary des Programms
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;     // Schlüssel aus Quellcode und Treiber
+    uint32_t format;  // Format des Binaries laut glGetProgramBinary
+    uint32_t length;  // Länge des Binaries in Bytes
+} ShaderCacheHeader;
+
+//////////////////////////////// LOKALE DATEN /////////////////////////////////
+
+// Statistik aller bisher angelegten Programme
+static ShaderCacheStats g_cacheStats = { 0 };
+
+// Hash des Treibers, wird beim ersten Programm bestimmt
+static uint64_t g_driverHash = 0;
+static bool g_driverHashed = false;
+
+// Ob der Treiber GL_KHR_parallel_shader_compile unterstützt, -1 wenn das noch
+// nicht abgefragt wurde
+static int g_parallelCompile = -1;
+
+// Alle bestehenden Shader und die Überwachung ihrer Dateien
+static Shader** g_shaders = NULL;
+static FileWatch* g_fileWatch = NULL;
+
 ////////////////////////////// LOKALE FUNKTIONEN ///////////////////////////////
 
 /**
- * Hilfsfunktion zum Laden eines Shaders aus einer Datei.
- * Der Shader wird direkt kompiliert.
+ * Führt einen FNV-1a Hash über einen Speicherbereich fort.
+ *
+ * @param hash der bisherige Hash
+ * @param data die Daten
+ * @param length die Länge der Daten in Bytes
+ * @return der neue Hash
+ */
+static uint64_t shader_hash(uint64_t hash, const void* data, size_t length)
+{
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= SHADER_HASH_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * Liefert einen Hash über Hersteller, Renderer und Version des Treibers.
+ * Ein Binary ist nur für genau diesen Treiber gültig.
+ *
+ * @return der Hash des Treibers, 0 wenn der Treiber keine Binaries unterstützt
+ */
+static uint64_t shader_hashDriver(void)
+{
+    if (g_driverHashed)
+    {
+        return g_driverHash;
+    }
+    g_driverHashed = true;
+
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount <= 0)
+    {
+        return 0;
+    }
+
+    uint64_t hash = SHADER_HASH_OFFSET;
+    const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        const char* value = (const char*) glGetString(names[i]);
+        if (value)
+        {
+            // Das Nullbyte trennt die Einträge voneinander.
+            hash = shader_hash(hash, value, strlen(value) + 1);
+        }
+    }
+
+    g_driverHash = hash;
+    return g_driverHash;
+}
+
+/**
+ * Setzt den Pfad einer Datei im Cache zusammen.
+ *
+ * @param key der Schlüssel des Programms
+ * @param path Ausgabeparameter für den Pfad
+ * @param size die Größe von path
+ */
+static void shader_getCachePath(uint64_t key, char* path, size_t size)
+{
+    snprintf(path, size, SHADER_CACHE_DIR "/%016llx.bin", (unsigned long long) key);
+}
+
+/**
+ * Versucht, ein Programm aus dem Cache zu laden. Der Treiber darf ein
+ * Binary jederzeit ablehnen, z.B. nach einem Update.
+ *
+ * @param key der Schlüssel des Programms
+ * @return das gelinkte Programm oder 0, wenn es nicht geladen werden konnte
+ */
+static GLuint shader_loadCachedProgram(uint64_t key)
+{
+    char path[256];
+    shader_getCachePath(key, path, sizeof(path));
+
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return 0;
+    }
+
+    ShaderCacheHeader header;
+    void* binary = NULL;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1
+                 && header.magic == SHADER_CACHE_MAGIC
+                 && header.version == SHADER_CACHE_VERSION
+                 && header.key == key
+                 && header.length > 0;
+    if (valid)
+    {
+        binary = malloc(header.length);
+        valid = fread(binary, header.length, 1, file) == 1;
+    }
+    fclose(file);
+
+    GLuint program = 0;
+    if (valid)
+    {
+        program = glCreateProgram();
+        glProgramBinary(program, header.format, binary, (GLsizei) header.length);
+
+        GLint isLinked;
+        glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+        if (!isLinked)
+        {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    // Unbrauchbare Einträge werden beim Speichern des neu gebauten
+    // Programms überschrieben.
+    if (!program)
+    {
+        g_cacheStats.rejectedPrograms++;
+    }
+
+    free(binary);
+    return program;
+}
+
+/**
+ * Speichert ein gelinktes Programm im Cache. Fehler werden ignoriert, das
+ * Programm wird dann beim nächsten Start erneut übersetzt.
+ *
+ * @param key der Schlüssel des Programms
+ * @param program das gelinkte Programm
+ */
+static void shader_storeCachedProgram(uint64_t key, GLuint program)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return;
+    }
+
+    ShaderCacheHeader header = { SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, key, 0, 0 };
+    void* binary = malloc(length);
+    GLenum format;
+    glGetProgramBinary(program, length, &length, &format, binary);
+    header.format = format;
+    header.length = (uint32_t) length;
+
+    char path[256];
+    shader_getCachePath(key, path, sizeof(path));
+
+    utils_createDirectory(SHADER_CACHE_DIR);
+    FILE* file = fopen(path, "wb");
+    if (file)
+    {
+        fwrite(&header, sizeof(header), 1, file);
+        fwrite(binary, header.length, 1, file);
+        fclose(file);
+    }
+
+    free(binary);
+}
+
+/**
+ * Lädt den Quellcode eines Shaders und ersetzt dabei jede Zeile der Form
+ * #include "datei" durch den Inhalt dieser Datei. Der Pfad ist relativ zum
+ * Verzeichnis der einbindenden Datei. Eingebundene Dateien dürfen selbst
+ * wieder #include verwenden, aber keine #version Zeile enthalten.
  *
- * @param type die Art Shader, die erzeugt werden soll
  * @param file der Pfad zum Shader-Quellcode
- * @param success signalisiert, ob die erzeugung erfolgreich war
- * @return die ID des neu erzeugten Shaders
+ * @param depth die aktuelle Verschachtelungstiefe, 0 für die Hauptdatei
+ * @param dependencies stb_ds Array, an das alle gelesenen Dateien angehängt
+ *        werden, oder NULL
+ * @return der vollständige Quellcode, muss mit free freigegeben werden, oder
+ *         NULL, wenn die Datei oder eine eingebundene Datei fehlt
  */
-static GLuint shader_createGLSLShader(GLenum type, const char* file,
-                                      bool* success)
+static char* shader_loadSource(const char* file, int depth, char*** dependencies)
 {
-    // Grundsätzlich gehen wir von einem Erfolg aus.
-    *success = true;
+    // Auch fehlende Dateien werden überwacht, damit der Shader neu gebaut
+    // wird, sobald es sie wieder gibt.
+    if (dependencies)
+    {
+        stbds_arrput(*dependencies, strdup(file));
+    }
+    char* source = utils_tryReadFile(file);
+    if (!source)
+    {
+        return NULL;
+    }
+    if (depth >= SHADER_MAX_INCLUDE_DEPTH)
+    {
+        // Der Compiler meldet die verbleibende #include Zeile als Fehler.
+        fprintf(stderr, "Error: Includes in \"%s\" are nested too deeply.\n", file);
+        return source;
+    }
 
-    // Zuerst erstellen wir einen neuen, leeren Shader.
-    GLuint shader = glCreateShader(type);
+    // Länge des Verzeichnisses inklusive des letzten Schrägstrichs
+    const char* slash = strrchr(file, '/');
+    size_t dirLength = slash ? (size_t) (slash - file + 1) : 0;
+
+    char* result = NULL;
+    const char* line = source;
+    while (*line)
+    {
+        const char* end = strchr(line, '\n');
+        size_t lineLength = end ? (size_t) (end - line + 1) : strlen(line);
+
+        const char* directive = line;
+        while (*directive == ' ' || *directive == '\t')
+        {
+            directive++;
+        }
+
+        const char* nameStart = NULL;
+        const char* nameEnd = NULL;
+        if (strncmp(directive, "#include", 8) == 0)
+        {
+            nameStart = memchr(directive, '"', lineLength - (size_t) (directive - line));
+            if (nameStart)
+            {
+                nameStart++;
+                nameEnd = memchr(nameStart, '"', lineLength - (size_t) (nameStart - line));
+            }
+        }
+
+        if (nameStart && nameEnd)
+        {
+            // Pfad der eingebundenen Datei zusammensetzen und rekursiv laden
+            size_t nameLength = (size_t) (nameEnd - nameStart);
+            char* path = malloc(dirLength + nameLength + 1);
+            memcpy(path, file, dirLength);
+            memcpy(path + dirLength, nameStart, nameLength);
+            path[dirLength + nameLength] = '\0';
+
+            char* included = shader_loadSource(path, depth + 1, dependencies);
+            free(path);
+            if (!included)
+            {
+                stbds_arrfree(result);
+                free(source);
+                return NULL;
+            }
+
+            size_t includedLength = strlen(included);
+            memcpy(stbds_arraddnptr(result, includedLength), included, includedLength);
+            stbds_arrput(result, '\n');
+
+            free(included);
+        }
+        else
+        {
+            memcpy(stbds_arraddnptr(result, lineLength), line, lineLength);
+        }
+
+        line += lineLength;
+    }
+    stbds_arrput(result, '\0');
+    free(source);
+
+    // Das stb_ds Array in einen gewöhnlichen String umkopieren, damit der
+    // Aufrufer ihn wie das Ergebnis von utils_readFile freigeben kann.
+    char* combined = malloc(stbds_arrlenu(result));
+    memcpy(combined, result, stbds_arrlenu(result));
+    stbds_arrfree(result);
+
+    return combined;
+}
+
+/**
+ * Lädt den vollständigen Quellcode einer Shader-Stufe samt aller
+ * eingebundenen Dateien. Die Defines werden hinter der #version Zeile
+ * eingefügt, danach wird die Zeilennummer für Fehlermeldungen wieder auf die
+ * der Datei zurückgesetzt.
+ *
+ * @param file der Pfad zum Shader-Quellcode
+ * @param defines #define Zeilen, die eingefügt werden, oder NULL
+ * @param dependencies stb_ds Array, an das alle gelesenen Dateien angehängt
+ *        werden, oder NULL
+ * @return der Quellcode, muss mit free freigegeben werden, oder NULL, wenn
+ *         eine Datei fehlt
+ */
+static char* shader_loadStageSource(const char* file, const char* defines, char*** dependencies)
+{
+    char* source = shader_loadSource(file, 0, dependencies);
+    if (!source || !defines)
+    {
+        return source;
+    }
+
+    // Die #version Zeile muss vor allem anderen stehen.
+    const char* body = strchr(source, '\n');
+    body = body ? body + 1 : source + strlen(source);
+
+    const char* lineReset = "#line 2\n";
+    size_t versionLength = (size_t) (body - source);
+    size_t definesLength = strlen(defines);
+    size_t resetLength = strlen(lineReset);
+    size_t bodyLength = strlen(body);
+
+    char* combined = malloc(versionLength + definesLength + resetLength + bodyLength + 1);
+    memcpy(combined, source, versionLength);
+    memcpy(combined + versionLength, defines, definesLength);
+    memcpy(combined + versionLength + definesLength, lineReset, resetLength);
+    memcpy(combined + versionLength + definesLength + resetLength, body, bodyLength + 1);
+
+    free(source);
+    return combined;
+}
+
+/**
+ * Prüft einmalig, ob der Treiber den Fortschritt des Übersetzens über
+ * GL_COMPLETION_STATUS_KHR melden kann. Die Anzahl der Threads wird nicht
+ * gesetzt, ohne Aufruf von glMaxShaderCompilerThreadsKHR wählt der Treiber
+ * sie selbst.
+ *
+ * @return true, wenn GL_KHR_parallel_shader_compile oder die gleichwertige
+ *         ARB Erweiterung verfügbar ist
+ */
+static bool shader_hasParallelCompile(void)
+{
+    if (g_parallelCompile < 0)
+    {
+        g_parallelCompile = 0;
+
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i = 0; i < extensionCount && !g_parallelCompile; i++)
+        {
+            const char* name = (const char*) glGetStringi(GL_EXTENSIONS, (GLuint) i);
+            g_parallelCompile = name
+                                && (strcmp(name, "GL_KHR_parallel_shader_compile") == 0
+                                    || strcmp(name, "GL_ARB_parallel_shader_compile") == 0);
+        }
+    }
 
-    // Danach laden wir den Quellcode des Shaders aus der
-    // angegebenen Datei. Dieser wird dem neuen Shader zugewiesen.
-    const char* source = utils_readFile(file);
+    return g_parallelCompile > 0;
+}
+
+/**
+ * Übergibt eine Shader-Stufe zum Übersetzen an den Treiber. Der Status wird
+ * nicht abgefragt, damit der Aufruf nicht auf das Ergebnis warten muss.
+ *
+ * @param type die Art Shader, die erzeugt werden soll
+ * @param file der Pfad zum Shader-Quellcode für das Label
+ * @param source der vollständige Quellcode (siehe shader_loadStageSource)
+ * @return die ID des neu erzeugten Shaders
+ */
+static GLuint shader_submitStage(GLenum type, const char* file, const char* source)
+{
+    // Zuerst erstellen wir einen neuen, leeren Shader und weisen ihm den
+    // Quellcode zu.
+    GLuint shader = glCreateShader(type);
     glShaderSource(shader, 1, &source, NULL);
 
     // Als nächstes kann der Shader kompiliert werden.
     glCompileShader(shader);
 
-    // Außerdem kann der Speicher für den Quellcode wieder freigegeben werden.
-    free((void*) source);
+    // Label setzen, damit der Shader in RenderDoc leichter erkennbar ist.
+    common_labelObjectByFilename(GL_SHADER, shader, file);
 
-    // Zum Schluss muss festgestellt werden, ob Fehler beim Kompilieren
-    // aufgetreten sind.
+    return shader;
+}
+
+/**
+ * Stellt fest, ob beim Übersetzen einer Stufe Fehler aufgetreten sind, und
+ * gibt sie gegebenenfalls aus. Wartet, bis der Treiber fertig ist.
+ *
+ * @param shader die ID der Stufe
+ * @param file der Pfad zum Shader-Quellcode für die Meldung
+ * @return true, wenn die Stufe übersetzt werden konnte
+ */
+static bool shader_checkStage(GLuint shader, const char* file)
+{
     GLint successId;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &successId);
     if (!successId)
@@ -92,19 +529,39 @@ static GLuint shader_createGLSLShader(GLenum type, const char* file,
             file, buffer
         );
 
-        // Nach der Meldung geben wir die neu erstellten Ressourcen wieder frei.
         free(buffer);
-        glDeleteShader(shader);
-
-        // Den Misserfolg an die aufrufende Funktion melden.
-        *success = false;
     }
 
-    // Label setzen, damit der Shader in RenderDoc leichter erkennbar ist.
-    common_labelObjectByFilename(GL_SHADER, shader, file);
+    return successId;
+}
 
-    // Bei Erfolg geben wir die ID des neuen Shaders zurück.
-    return shader;
+/**
+ * Stellt fest, ob beim Linken eines Programms Fehler aufgetreten sind, und
+ * gibt sie gegebenenfalls aus. Wartet, bis der Treiber fertig ist.
+ *
+ * @param program das Programm
+ * @return true, wenn das Programm gelinkt werden konnte
+ */
+static bool shader_checkProgram(GLuint program)
+{
+    GLint isLinked;
+    glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+    if (!isLinked)
+    {
+        // Wenn es einen Fehler gab, geben wir eine Meldung auf der Konsole aus.
+        // Dazu muss erst die Länge der Meldung abgerufen werden, bevor diese
+        // in den neu erstellten Buffer geladen werden kann.
+        GLint logSize = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logSize);
+
+        GLchar* buffer = (GLchar*) malloc(logSize);
+        glGetProgramInfoLog(program, logSize, &logSize, buffer);
+        fprintf(stderr, "Error on shader linking:\n\t%s\n", buffer);
+
+        free(buffer);
+    }
+
+    return isLinked;
 }
 
 /**
@@ -133,6 +590,409 @@ static GLint shader_getUniformLocation(Shader* shader, const char* name)
     return location;
 }
 
+
+/**
+ * Übersetzt eine Shader-Stufe und hängt sie bei Erfolg an den Shader.
+ *
+ * @param shader der Shader, an den die Stufe gehängt wird
+ * @param type der Shadertyp der Stufe
+ * @param file der Pfad zur Datei, für Meldungen und das Label
+ * @param source der vollständige Quellcode der Stufe
+ * @return true, wenn die Operation erfolgreich war, false wenn nicht
+ */
+static bool shader_attachShaderSource(Shader* shader, GLenum type,
+                                      const char* file, const char* source)
+{
+    // Wenn der Shader bereits gelinkt wurde, darf keine neue Datei
+    // hinzugefügt werden.
+    if (shader->linked)
+    {
+        fprintf(stderr, "Cannot attach a file to an already linked shader!\n");
+        return false;
+    }
+
+    // Zuerst kompilieren wir den Quellcode und warten auf das Ergebnis.
+    GLuint glslShader = shader_submitStage(type, file, source);
+    bool success = shader_checkStage(glslShader, file);
+
+    // Danach wird geprüft, ob die Operation erfolgreich war.
+    if (success)
+    {
+        // Wenn ja fügen wir die neue Shader ID zum Array mit allen IDs hinzu.
+        shader->fileCount++;
+        shader->shaderFiles = realloc(
+            shader->shaderFiles,
+            sizeof(GLuint) * shader->fileCount
+        );
+        shader->shaderFiles[shader->fileCount - 1] = glslShader;
+    }
+    else
+    {
+        glDeleteShader(glslShader);
+    }
+
+    return success;
+}
+
+/**
+ * Gibt ein laufendes Programm samt seiner Stufen wieder frei, ohne auf das
+ * Ergebnis zu warten.
+ *
+ * @param build das laufende Programm
+ */
+static void shader_discardBuild(ShaderBuild* build)
+{
+    for (int i = 0; i < build->stageCount; i++)
+    {
+        glDeleteShader(build->stages[i]);
+    }
+    if (build->program)
+    {
+        glDeleteProgram(build->program);
+    }
+    memset(build, 0, sizeof(ShaderBuild));
+}
+
+/**
+ * Gibt die Liste der Dateien frei, von denen ein Shader abhängt.
+ *
+ * @param shader der Shader
+ */
+static void shader_freeDependencies(Shader* shader)
+{
+    for (size_t i = 0; i < stbds_arrlenu(shader->dependencies); i++)
+    {
+        free(shader->dependencies[i]);
+    }
+    stbds_arrfree(shader->dependencies);
+}
+
+/**
+ * Prüft, ob ein Shader von einer der übergebenen Dateien abhängt.
+ *
+ * @param shader der Shader
+ * @param files die Pfade der Dateien
+ * @param count die Anzahl der Dateien
+ * @return true, wenn der Shader mindestens eine der Dateien verwendet
+ */
+static bool shader_dependsOn(const Shader* shader, const char* const* files, int count)
+{
+    for (size_t i = 0; i < stbds_arrlenu(shader->dependencies); i++)
+    {
+        for (int j = 0; j < count; j++)
+        {
+            if (strcmp(shader->dependencies[i], files[j]) == 0)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Übergibt alle Stufen eines Shaders an den Treiber und beauftragt das
+ * Linken. Der Status wird erst in shader_finishBuild abgefragt, dazwischen
+ * können weitere Programme übergeben werden. Liegt ein passendes Programm im
+ * Cache, wird stattdessen dieses geladen.
+ *
+ * @param shader der Shader, dessen Dateien und Defines gebaut werden
+ */
+static void shader_submitBuild(Shader* shader)
+{
+    double start = utils_getTime();
+
+    ShaderBuild* build = &shader->build;
+    shader_discardBuild(build);
+
+    // Die Stufen in der Reihenfolge der Pipeline, nicht verwendete fehlen.
+    const GLenum allTypes[SHADER_MAX_STAGES] = {
+        GL_VERTEX_SHADER, GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER,
+        GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER
+    };
+    const char* allFiles[SHADER_MAX_STAGES] = {
+        shader->vertexShaderPath, shader->tescShaderPath, shader->teseShaderPath,
+        shader->geomShaderPath, shader->fragmentShaderPath
+    };
+
+    GLenum types[SHADER_MAX_STAGES];
+    char* sources[SHADER_MAX_STAGES];
+    int stageCount = 0;
+    for (int i = 0; i < SHADER_MAX_STAGES; i++)
+    {
+        if (allFiles[i])
+        {
+            types[stageCount] = allTypes[i];
+            build->files[stageCount++] = allFiles[i];
+        }
+    }
+
+    // Zuerst wird der Quellcode aller Stufen geladen. Der Schlüssel im Cache
+    // ergibt sich aus dem Treiber und dem Quellcode samt Defines und
+    // eingebundener Dateien, jede Änderung erzeugt also einen neuen Eintrag.
+    // Die gelesenen Dateien werden überwacht, da sich die eingebundenen
+    // Dateien seit dem letzten Bau geändert haben können.
+    shader_freeDependencies(shader);
+    uint64_t key = shader_hashDriver();
+    bool loaded = true;
+    for (int i = 0; i < stageCount; i++)
+    {
+        sources[i] = shader_loadStageSource(build->files[i], shader->defines, &shader->dependencies);
+        loaded &= sources[i] != NULL;
+        if (key && sources[i])
+        {
+            key = shader_hash(key, &types[i], sizeof(types[i]));
+            key = shader_hash(key, sources[i], strlen(sources[i]) + 1);
+        }
+    }
+
+    if (!g_fileWatch)
+    {
+        g_fileWatch = filewatch_createFileWatch();
+    }
+    for (size_t i = 0; i < stbds_arrlenu(shader->dependencies); i++)
+    {
+        filewatch_addFile(g_fileWatch, shader->dependencies[i]);
+    }
+
+    // Fehlt eine Datei, wird nichts gebaut. Ein bestehendes Programm bleibt
+    // aktiv, bis die Datei wieder da ist und eine Änderung gemeldet wird.
+    if (!loaded)
+    {
+        for (int i = 0; i < stageCount; i++)
+        {
+            free(sources[i]);
+        }
+        if (shader->linked)
+        {
+            fprintf(stderr, "Error on reloading shader \"%s\", keeping the previous program.\n",
+                    shader->label);
+        }
+        g_cacheStats.loadTime += (utils_getTime() - start) * 1000.0;
+        return;
+    }
+
+    build->key = key;
+    build->program = key ? shader_loadCachedProgram(key) : 0;
+    build->cached = build->program != 0;
+    if (!build->cached)
+    {
+        // Ohne passenden Eintrag werden alle Stufen übersetzt und gelinkt,
+        // egal ob eine davon Fehler verursacht. Der Hinweis erlaubt es, das
+        // Binary anschließend für den Cache abzufragen.
+        build->program = glCreateProgram();
+        for (int i = 0; i < stageCount; i++)
+        {
+            build->stages[i] = shader_submitStage(types[i], build->files[i], sources[i]);
+            glAttachShader(build->program, build->stages[i]);
+        }
+        build->stageCount = stageCount;
+
+        glProgramParameteri(build->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(build->program);
+    }
+
+    for (int i = 0; i < stageCount; i++)
+    {
+        free(sources[i]);
+    }
+    g_cacheStats.loadTime += (utils_getTime() - start) * 1000.0;
+}
+
+/**
+ * Prüft, ob ein laufendes Programm fertig ist, ohne darauf zu warten. Ohne
+ * GL_KHR_parallel_shader_compile lässt sich das nicht feststellen, das
+ * Programm gilt dann als fertig und shader_finishBuild wartet bei Bedarf.
+ *
+ * @param build das laufende Programm
+ * @return true, wenn shader_finishBuild nicht auf den Treiber warten muss
+ */
+static bool shader_isBuildReady(const ShaderBuild* build)
+{
+    if (build->cached || !shader_hasParallelCompile())
+    {
+        return true;
+    }
+
+    GLint completed = GL_FALSE;
+    glGetProgramiv(build->program, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed;
+}
+
+/**
+ * Schließt ein laufendes Programm ab. Dabei werden alle Fehler ausgegeben und
+ * erfolgreich übersetzte Programme im Cache gespeichert. Ist der Treiber noch
+ * nicht fertig, wird gewartet.
+ *
+ * @param build das laufende Programm, ist danach leer
+ * @return das gelinkte Programm oder 0 bei einem Fehler
+ */
+static GLuint shader_finishBuild(ShaderBuild* build)
+{
+    double start = utils_getTime();
+    GLuint program = build->program;
+
+    if (build->cached)
+    {
+        g_cacheStats.cachedPrograms++;
+    }
+    else
+    {
+        // Alle Stufen werden geprüft, damit jeder Fehler gemeldet wird. Das
+        // Linken schlägt dann ohnehin fehl und braucht keine eigene Meldung.
+        bool ok = true;
+        for (int i = 0; i < build->stageCount; i++)
+        {
+            ok &= shader_checkStage(build->stages[i], build->files[i]);
+        }
+        ok = ok && shader_checkProgram(program);
+
+        // Nach dem Linken werden die einzelnen Stufen nicht mehr benötigt.
+        // Gelöscht werden sie erst, wenn sie von allen Programmen getrennt
+        // wurden.
+        for (int i = 0; i < build->stageCount; i++)
+        {
+            glDetachShader(program, build->stages[i]);
+            glDeleteShader(build->stages[i]);
+        }
+
+        if (ok)
+        {
+            g_cacheStats.compiledPrograms++;
+            if (build->key)
+            {
+                shader_storeCachedProgram(build->key, program);
+            }
+        }
+        else
+        {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    memset(build, 0, sizeof(ShaderBuild));
+    g_cacheStats.loadTime += (utils_getTime() - start) * 1000.0;
+
+    return program;
+}
+
+/**
+ * Übernimmt das laufende Programm eines Shaders, sobald es fertig ist. Ein
+ * bestehendes Programm wird erst dann ersetzt, bei einem Fehler bleibt es
+ * erhalten.
+ *
+ * @param shader der Shader
+ * @param wait true, wenn auf den Treiber gewartet werden soll
+ * @return true, wenn der Shader danach ein gelinktes Programm hat
+ */
+static bool shader_updateBuild(Shader* shader, bool wait)
+{
+    if (!shader->build.program || (!wait && !shader_isBuildReady(&shader->build)))
+    {
+        return shader->linked;
+    }
+
+    GLuint program = shader_finishBuild(&shader->build);
+    if (program)
+    {
+        if (shader->linked)
+        {
+            // Die Locations gehören zum alten Programm.
+            glDeleteProgram(shader->id);
+            stbds_shfree(shader->uniforms);
+            stbds_sh_new_arena(shader->uniforms);
+            stbds_shdefault(shader->uniforms, -2);
+            g_cacheStats.reloadedPrograms++;
+        }
+
+        shader->id = program;
+        shader->linked = true;
+        common_labelObjectByType(GL_PROGRAM, program, shader->label);
+    }
+    else if (shader->linked)
+    {
+        fprintf(stderr, "Error on reloading shader \"%s\", keeping the previous program.\n",
+                shader->label);
+    }
+
+    return shader->linked;
+}
+
+/**
+ * Hilfsfunktion zum Anlegen eines Shaders aus bis zu fünf Stufen. Nicht
+ * benötigte Stufen werden als NULL übergeben. Das Programm wird nur an den
+ * Treiber übergeben und erst bei der ersten Benutzung abgeschlossen.
+ *
+ * @param label der Name des Shaders für Debugger und Meldungen
+ * @param vert der Vertex Shader
+ * @param tesc der Tessellation Control Shader oder NULL
+ * @param tese der Tessellation Evaluation Shader oder NULL
+ * @param geom der Geometry Shader oder NULL
+ * @param frag der Fragment Shader
+ * @param defines #define Zeilen für alle Stufen oder NULL
+ * @return der neue Shader
+ */
+static Shader* shader_createProgram(const char* label,
+                                    const char* vert, const char* tesc,
+                                    const char* tese, const char* geom,
+                                    const char* frag, const char* defines)
+{
+    Shader* newShader = shader_createShader(tesc != NULL, geom != NULL);
+    newShader->label = strdup(label);
+    newShader->vertexShaderPath = strdup(vert);
+    newShader->fragmentShaderPath = strdup(frag);
+    newShader->tescShaderPath = tesc ? strdup(tesc) : NULL;
+    newShader->teseShaderPath = tese ? strdup(tese) : NULL;
+    newShader->geomShaderPath = geom ? strdup(geom) : NULL;
+    newShader->defines = defines ? strdup(defines) : NULL;
+
+    shader_submitBuild(newShader);
+
+    return newShader;
+}
+
+/**
+ * Baut eine Variante aus den Dateien der Sammlung. Für jedes gesetzte Bit des
+ * Schlüssels wird das zugehörige Define eingefügt.
+ *
+ * @param variants die Sammlung der Varianten
+ * @param key der Schlüssel der Variante
+ * @return der neue Shader, dessen Programm noch gebaut wird
+ */
+static Shader* shader_createVariant(ShaderVariants* variants, unsigned int key)
+{
+    char* defines = NULL;
+    for (int i = 0; i < variants->defineCount; i++)
+    {
+        if (key & (1u << i))
+        {
+            size_t nameLength = strlen(variants->defineNames[i]);
+            memcpy(stbds_arraddnptr(defines, 8), "#define ", 8);
+            memcpy(stbds_arraddnptr(defines, nameLength), variants->defineNames[i], nameLength);
+            stbds_arrput(defines, '\n');
+        }
+    }
+    stbds_arrput(defines, '\0');
+
+    // Das Label enthält den Schlüssel, damit Varianten im Debugger und in
+    // Fehlermeldungen unterscheidbar sind.
+    char label[256];
+    snprintf(label, sizeof(label), "%s [0x%x]", variants->label, key);
+
+    Shader* shader = shader_createProgram(label,
+                                          variants->vertexShaderPath,
+                                          variants->tescShaderPath,
+                                          variants->teseShaderPath,
+                                          variants->geomShaderPath,
+                                          variants->fragmentShaderPath,
+                                          defines);
+    stbds_arrfree(defines);
+
+    return shader;
+}
+
 //////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
 
 Shader* shader_createShader(bool useTessellation, bool useGeometrie)
@@ -150,6 +1010,9 @@ Shader* shader_createShader(bool useTessellation, bool useGeometrie)
     shader->geomShaderPath = NULL;
     shader->teseShaderPath = NULL;
     shader->tescShaderPath = NULL;
+    shader->defines = NULL;
+    memset(&shader->build, 0, sizeof(ShaderBuild));
+    shader->dependencies = NULL;
 
     stbds_sh_new_arena(shader->uniforms);
     stbds_shdefault(shader->uniforms, -2);
@@ -157,34 +1020,22 @@ Shader* shader_createShader(bool useTessellation, bool useGeometrie)
     shader->useTesselation = useTessellation;
     shader->useGeometrie = useGeometrie;
 
+    stbds_arrput(g_shaders, shader);
+
     return shader;
 }
 
 bool shader_attachShaderFile(Shader* shader, GLenum type, const char* file)
 {
-    // Wenn der Shader bereits gelinkt wurde, darf keine neue Datei
-    // hinzugefügt werden.
-    if (shader->linked)
+    // Die Datei wird samt eingebundener Dateien geladen und übersetzt.
+    char* source = shader_loadStageSource(file, shader->defines, NULL);
+    if (!source)
     {
-        fprintf(stderr, "Cannot attach a file to an already linked shader!\n");
         return false;
     }
 
-    // Zuerst laden und kompilieren wir die angegebene Datei.
-    bool success;
-    GLuint glslShader = shader_createGLSLShader(type, file, &success);
-
-    // Danach wird geprüft, ob die Operation erfolgreich war.
-    if (success)
-    {
-        // Wenn ja fügen wir die neue Shader ID zum Array mit allen IDs hinzu.
-        shader->fileCount++;
-        shader->shaderFiles = realloc(
-            shader->shaderFiles,
-            sizeof(GLuint) * shader->fileCount
-        );
-        shader->shaderFiles[shader->fileCount - 1] = glslShader;
-    }
+    bool success = shader_attachShaderSource(shader, type, file, source);
+    free(source);
 
     return success;
 }
@@ -206,7 +1057,6 @@ bool shader_buildShader(Shader* shader)
     }
 
     // Benötigte Variablen und ein neues Shader-Programm anlegen.
-    bool success = true;
     int i;
     GLuint newProgram = glCreateProgram();
 
@@ -222,54 +1072,41 @@ bool shader_buildShader(Shader* shader)
 
     // Zum Schluss muss festgestellt werden, ob Fehler beim Linken
     // aufgetreten sind.
-    GLint isLinked;
-    glGetProgramiv(newProgram, GL_LINK_STATUS, &isLinked);
-    if (!isLinked)
+    if (!shader_checkProgram(newProgram))
     {
-        // Wenn es einen Fehler gab, geben wir eine Meldung auf der Konsole aus.
-        // Dazu muss erst die Länge der Meldung abgerufen werden, bevor diese
-        // in den neu erstellten Buffer geladen werden kann.
-        GLint logSize = 0;
-        glGetProgramiv(newProgram, GL_INFO_LOG_LENGTH, &logSize);
-
-        GLchar* buffer = (GLchar*) malloc(logSize);
-        glGetProgramInfoLog(newProgram, logSize, &logSize, buffer);
-        fprintf(stderr, "Error on shader linking:\n\t%s\n", buffer);
-
         // Nach der Meldung geben wir die neu erstellten Ressourcen wieder frei.
-        free(buffer);
         glDeleteProgram(newProgram);
-
-        // Der Fehlschlag wird dem Aufrufer mitgeteilt.
-        success = false;
+        return false;
     }
-    else
-    {
-        // Nach dem Linken sollten immer alle Shader
-        // vom Programm getrennt werden.
-        // Außerdem werden bach dem Linken die einzelnen Bestandteile nicht mehr
-        // benötigt und müssen freigegeben werden. Das Löschen wird jedoch
-        // solange aufgeschoben, bis die Shader von allen Programmen getrennt
-        // wurden. Deswegen haben wir sie bereits im letzten Schritt getrennt.
-        for (i = 0; i < shader->fileCount; i++)
-        {
-            glDetachShader(newProgram, shader->shaderFiles[i]);
-            glDeleteShader(shader->shaderFiles[i]);
-        }
 
-        // Jetzt kann das Shaderobjekt vollständig gefüllt werden.
-        shader->linked = true;
-        shader->id = newProgram;
-        free(shader->shaderFiles);
-        shader->shaderFiles = NULL;
-        shader->fileCount = 0;
+    // Nach dem Linken sollten immer alle Shader
+    // vom Programm getrennt werden.
+    // Außerdem werden bach dem Linken die einzelnen Bestandteile nicht mehr
+    // benötigt und müssen freigegeben werden. Das Löschen wird jedoch
+    // solange aufgeschoben, bis die Shader von allen Programmen getrennt
+    // wurden. Deswegen haben wir sie bereits im letzten Schritt getrennt.
+    for (i = 0; i < shader->fileCount; i++)
+    {
+        glDetachShader(newProgram, shader->shaderFiles[i]);
+        glDeleteShader(shader->shaderFiles[i]);
     }
 
-    return success;
+    // Jetzt kann das Shaderobjekt vollständig gefüllt werden.
+    shader->linked = true;
+    shader->id = newProgram;
+    free(shader->shaderFiles);
+    shader->shaderFiles = NULL;
+    shader->fileCount = 0;
+
+    return true;
 }
 
 void shader_useShader(Shader* shader)
 {
+    // Ein neu gebautes Programm wird übernommen, sobald der Treiber damit
+    // fertig ist. Nur wenn es noch gar kein Programm gibt, wird gewartet.
+    shader_updateBuild(shader, !shader->linked);
+
     // Der Shader muss gelinkt sein, bevor er verwendet werden kann.
     if (!shader->linked)
     {
@@ -281,29 +1118,35 @@ void shader_useShader(Shader* shader)
     glUseProgram(shader->id);
 }
 
-bool shader_recompileShader(Shader** shader_ptr)
+void shader_recompileShader(Shader* shader)
 {
-    Shader* tempShader;
-    if ((*shader_ptr)->useTesselation) {
-        tempShader = shader_createVeTessFrShader((*shader_ptr)->label, (*shader_ptr)->vertexShaderPath, (*shader_ptr)->tescShaderPath,
-                                                 (*shader_ptr)->teseShaderPath, (*shader_ptr)->fragmentShaderPath);
-    } else if ((*shader_ptr)->useGeometrie) {
-        tempShader = shader_createVeGeomFrShader((*shader_ptr)->label, (*shader_ptr)->vertexShaderPath, (*shader_ptr)->geomShaderPath, (*shader_ptr)->fragmentShaderPath);
-    } else {
-        tempShader = shader_createVeFrShader((*shader_ptr)->label, (*shader_ptr)->vertexShaderPath, (*shader_ptr)->fragmentShaderPath);
+    // Ein noch laufender Neubau wird durch den aktuellen Stand ersetzt.
+    shader_submitBuild(shader);
+}
+
+void shader_reloadChangedShaders(void)
+{
+    if (!g_fileWatch)
+    {
+        return;
     }
 
-    if (tempShader != NULL)
+    int count;
+    const char* const* changes = filewatch_pollChanges(g_fileWatch, &count);
+    if (count == 0)
     {
-        shader_deleteShader(*shader_ptr);
-        *shader_ptr = tempShader;
-        fprintf(stdout, "Shader geladen: %s\n", tempShader->label);
-        return true;
+        return;
     }
-    else {
-        fprintf(stderr, "Fehler beim Laden von Shader: \n\t%s\n\t%s\n\t%s\n\t%s\n\t%s\n", (*shader_ptr)->vertexShaderPath,
-                (*shader_ptr)->tescShaderPath, (*shader_ptr)->teseShaderPath, (*shader_ptr)->geomShaderPath, (*shader_ptr)->fragmentShaderPath);
-        return false;
+
+    // Nur Programme, die eine der Dateien verwenden, werden neu übersetzt.
+    // Wie bei shader_recompileShader bleibt das alte Programm aktiv, bis das
+    // neue fertig ist.
+    for (size_t i = 0; i < stbds_arrlenu(g_shaders); i++)
+    {
+        if (shader_dependsOn(g_shaders[i], changes, count))
+        {
+            shader_recompileShader(g_shaders[i]);
+        }
     }
 }
 
@@ -321,6 +1164,9 @@ void shader_deleteShader(Shader* shader)
         glDeleteProgram(shader->id);
     }
 
+    // Ein noch laufender Neubau wird verworfen.
+    shader_discardBuild(&shader->build);
+
     // Wenn noch Dateien angehängt sind, müssen diese gelöscht werden.
     if (shader->shaderFiles)
     {
@@ -338,9 +1184,27 @@ void shader_deleteShader(Shader* shader)
     if (shader->teseShaderPath) { free(shader->teseShaderPath); }
     if (shader->tescShaderPath) { free(shader->tescShaderPath); }
     if (shader->geomShaderPath) { free(shader->geomShaderPath); }
+    if (shader->defines) { free(shader->defines); }
 
     // Uniform Hashmap freigeben.
     stbds_shfree(shader->uniforms);
+    shader_freeDependencies(shader);
+
+    // Mit dem letzten Shader wird auch die Überwachung beendet.
+    for (size_t i = 0; i < stbds_arrlenu(g_shaders); i++)
+    {
+        if (g_shaders[i] == shader)
+        {
+            stbds_arrdelswap(g_shaders, i);
+            break;
+        }
+    }
+    if (stbds_arrlenu(g_shaders) == 0)
+    {
+        stbds_arrfree(g_shaders);
+        filewatch_deleteFileWatch(g_fileWatch);
+        g_fileWatch = NULL;
+    }
 
     // Zum Schluss kann der Speicher wieder freigegeben werden.
     free(shader);
@@ -348,100 +1212,114 @@ void shader_deleteShader(Shader* shader)
 
 Shader* shader_createVeFrShader(const char* label, const char* vert, const char* frag)
 {
-    // Zuerst werden alle benötigten Bestandteile des Shaders angelegt,
-    // egal ob einer Fehler verursacht.
-    Shader* newShader = shader_createShader(false, false);
-    bool vertOk = shader_attachShaderFile(newShader, GL_VERTEX_SHADER, vert);
-    bool fragOk = shader_attachShaderFile(newShader, GL_FRAGMENT_SHADER, frag);
+    return shader_createProgram(label, vert, NULL, NULL, NULL, frag, NULL);
+}
 
-    // Danach wird auf mögliche Fehler geprüft.
-    if (vertOk && fragOk)
-    {
-        // Wenn keine Fehler aufgetreten sind, kann der Shader gebaut werden.
-        if (shader_buildShader(newShader))
-        {
-            // Wenn dies erfolgreich war, geben wir dem neuen Shader ein Label
-            // und geben dann die ID zurück.
-            common_labelObjectByType(GL_PROGRAM, newShader->id, label);
+Shader* shader_createVeGeomFrShader(const char* label, const char* vert, const char* geom, const char* frag)
+{
+    return shader_createProgram(label, vert, NULL, NULL, geom, frag, NULL);
+}
 
-            newShader->label = strdup(label);
-            newShader->vertexShaderPath = strdup(vert);
-            newShader->fragmentShaderPath = strdup(frag);
+Shader* shader_createVeTessFrShader(const char* label,
+                                    const char* vert, const char* tesc,
+                                    const char* tese, const char* frag)
+{
+    return shader_createProgram(label, vert, tesc, tese, NULL, frag, NULL);
+}
 
-            return newShader;
+ShaderVariants* shader_createVariants(const char* label,
+                                      const char* vert, const char* tesc,
+                                      const char* tese, const char* geom,
+                                      const char* frag,
+                                      const char* const* defineNames,
+                                      int defineCount)
+{
+    ShaderVariants* variants = malloc(sizeof(ShaderVariants));
+    variants->label = strdup(label);
+    variants->vertexShaderPath = strdup(vert);
+    variants->tescShaderPath = tesc ? strdup(tesc) : NULL;
+    variants->teseShaderPath = tese ? strdup(tese) : NULL;
+    variants->geomShaderPath = geom ? strdup(geom) : NULL;
+    variants->fragmentShaderPath = strdup(frag);
+
+    variants->defineCount = defineCount;
+    variants->defineNames = malloc(sizeof(char*) * defineCount);
+    variants->keyMask = 0;
+    for (int i = 0; i < defineCount; i++)
+    {
+        variants->defineNames[i] = defineNames[i] ? strdup(defineNames[i]) : NULL;
+        if (defineNames[i])
+        {
+            variants->keyMask |= 1u << i;
         }
     }
 
-    // Sollte ein Problem aufgetreten sein, wird der Shader wieder gelöscht und
-    // NULL zurückgegeben.
-    shader_deleteShader(newShader);
-    return NULL;
+    variants->variants = NULL;
+
+    return variants;
 }
 
-Shader* shader_createVeGeomFrShader(const char* label, const char* vert, const char* geom, const char* frag)
+Shader* shader_getVariant(ShaderVariants* variants, unsigned int key)
 {
-    Shader* newShader = shader_createShader(false, true);
-    bool vertOk = shader_attachShaderFile(newShader, GL_VERTEX_SHADER, vert);
-    bool geomOk = shader_attachShaderFile(newShader, GL_GEOMETRY_SHADER, geom);
-    bool fragOk = shader_attachShaderFile(newShader, GL_FRAGMENT_SHADER, frag);
+    // Bits ohne Define ändern den Quellcode nicht und dürfen daher keine
+    // eigene Variante erzeugen.
+    key &= variants->keyMask;
 
-    // Danach wird auf mögliche Fehler geprüft.
-    if (vertOk && geomOk && fragOk)
+    ptrdiff_t index = stbds_hmgeti(variants->variants, key);
+    if (index < 0)
     {
-        // Wenn keine Fehler aufgetreten sind, kann der Shader gebaut werden.
-        if (shader_buildShader(newShader))
-        {
-            // Wenn dies erfolgreich war, geben wir dem neuen Shader ein Label
-            // und geben dann die ID zurück.
-            common_labelObjectByType(GL_PROGRAM, newShader->id, label);
-            newShader->label = strdup(label);
-            newShader->vertexShaderPath = strdup(vert);
-            newShader->fragmentShaderPath = strdup(frag);
-            newShader->geomShaderPath = strdup(geom);
-            return newShader;
-        }
+        // Eine neue Variante wird sofort benötigt, daher wird auf sie
+        // gewartet. Auch fehlgeschlagene Varianten werden gemerkt, damit der
+        // Fehler nicht in jedem Frame erneut ausgegeben wird. Sie werden neu
+        // gebaut, sobald sich ihre Dateien ändern.
+        Shader* shader = shader_createVariant(variants, key);
+        shader_updateBuild(shader, true);
+        stbds_hmput(variants->variants, key, shader);
+
+        return shader->linked ? shader : NULL;
     }
 
-    // Sollte ein Problem aufgetreten sein, wird der Shader wieder gelöscht und
-    // NULL zurückgegeben.
-    shader_deleteShader(newShader);
-    return NULL;
+    // Eine zuvor fehlerhafte Variante wird erst verwendet, wenn ein neuer
+    // Versuch fertig ist.
+    Shader* shader = variants->variants[index].value;
+    return shader_updateBuild(shader, false) ? shader : NULL;
 }
 
-Shader* shader_createVeTessFrShader(const char* label,
-                                    const char* vert, const char* tesc,
-                                    const char* tese, const char* frag)
+void shader_recompileVariants(ShaderVariants* variants)
 {
-    // Zuerst werden alle benötigten Bestandteile des Shaders angelegt,
-    // egal ob einer Fehler verursacht.
-    Shader* newShader = shader_createShader(true, false);
-    bool vertOk = shader_attachShaderFile(newShader, GL_VERTEX_SHADER, vert);
-    bool tescOk = shader_attachShaderFile(newShader, GL_TESS_CONTROL_SHADER, tesc);
-    bool teseOk = shader_attachShaderFile(newShader, GL_TESS_EVALUATION_SHADER, tese);
-    bool fragOk = shader_attachShaderFile(newShader, GL_FRAGMENT_SHADER, frag);
+    // Zuvor fehlerhafte Varianten bekommen dabei eine neue Chance.
+    for (size_t i = 0; i < stbds_hmlenu(variants->variants); i++)
+    {
+        shader_recompileShader(variants->variants[i].value);
+    }
+}
 
-    // Danach wird auf mögliche Fehler geprüft.
-    if (vertOk && tescOk && teseOk && fragOk)
+void shader_deleteVariants(ShaderVariants* variants)
+{
+    if (!variants)
     {
-        // Wenn keine Fehler aufgetreten sind, kann der Shader gebaut werden.
-        if (shader_buildShader(newShader))
-        {
-            // Wenn dies erfolgreich war, geben wir dem neuen Shader ein Label
-            // und geben dann die ID zurück.
-            common_labelObjectByType(GL_PROGRAM, newShader->id, label);
-            newShader->label = strdup(label);
-            newShader->vertexShaderPath = strdup(vert);
-            newShader->fragmentShaderPath = strdup(frag);
-            newShader->teseShaderPath = strdup(tese);
-            newShader->tescShaderPath = strdup(tesc);
-            return newShader;
-        }
+        return;
+    }
+
+    for (size_t i = 0; i < stbds_hmlenu(variants->variants); i++)
+    {
+        shader_deleteShader(variants->variants[i].value);
     }
+    stbds_hmfree(variants->variants);
 
-    // Sollte ein Problem aufgetreten sein, wird der Shader wieder gelöscht und
-    // NULL zurückgegeben.
-    shader_deleteShader(newShader);
-    return NULL;
+    for (int i = 0; i < variants->defineCount; i++)
+    {
+        free(variants->defineNames[i]);
+    }
+    free(variants->defineNames);
+
+    free(variants->label);
+    free(variants->vertexShaderPath);
+    free(variants->tescShaderPath);
+    free(variants->teseShaderPath);
+    free(variants->geomShaderPath);
+    free(variants->fragmentShaderPath);
+    free(variants);
 }
 
 void shader_setMat4(Shader* shader, char* name, mat4* mat)
@@ -474,6 +1352,12 @@ void shader_setVec4(Shader* shader, char* name, vec4* vec4)
     glUniform4fv(location, 1, (float*) vec4);
 }
 
+void shader_setVec4Array(Shader* shader, char* name, vec4* vec4, int count)
+{
+    GLint location = shader_getUniformLocation(shader, name);
+    glUniform4fv(location, count, (float*) vec4);
+}
+
 void shader_setInt(Shader* shader, char* name, int val)
 {
     GLint location = shader_getUniformLocation(shader, name);
@@ -492,6 +1376,20 @@ void shader_setBool(Shader* shader, char* name, bool val)
     glUniform1i(location, val);
 }
 
+void shader_setUniformBlock(Shader* shader, char* name, GLuint binding)
+{
+    GLuint index = glGetUniformBlockIndex(shader->id, name);
+    if (index != GL_INVALID_INDEX)
+    {
+        glUniformBlockBinding(shader->id, index, binding);
+    }
+}
+
+void shader_getCacheStats(ShaderCacheStats* stats)
+{
+    *stats = g_cacheStats;
+}
+
 bool shader_getUseTessellation(Shader* shader) {
     return shader->useTesselation;
 }
@@ -16,6 +16,23 @@
 struct Shader;
 typedef struct Shader Shader;
 
+// Sammlung von Varianten eines Shaders, die sich nur in ihren Defines
+// unterscheiden. Jedes Bit des Schlüssels steht für ein Define.
+struct ShaderVariants;
+typedef struct ShaderVariants ShaderVariants;
+
+// Statistik über das Anlegen aller Programme seit dem Start. Gelinkte
+// Programme werden im Verzeichnis shadercache abgelegt und beim nächsten
+// Start von dort geladen, solange Quellcode, Defines und Treiber gleich sind.
+typedef struct
+{
+    int cachedPrograms;   // aus dem Cache geladene Programme
+    int compiledPrograms; // aus dem Quellcode übersetzte Programme
+    int rejectedPrograms; // Einträge, die nicht geladen werden konnten
+    int reloadedPrograms; // Programme, die ein bestehendes Programm ersetzt haben
+    double loadTime;      // gesamte Zeit zum Anlegen in Millisekunden
+} ShaderCacheStats;
+
 //////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
 
 /**
@@ -28,7 +45,8 @@ Shader* shader_createShader(bool useTessellation, bool useGeometrie);
 /**
  * Hängt eine GLSL Datei an einen bestehenden Shader an.
  * Der Code wird dabei auch sofort übersetzt und nur bei erfolg an den
- * Shader gehängt.
+ * Shader gehängt. Zeilen der Form #include "datei" werden vorher durch den
+ * Inhalt der Datei relativ zum Verzeichnis von file ersetzt.
  *
  * Bei Misserfolg gibt die Funktion eine Fehlermeldung aus.
  *
@@ -52,7 +70,9 @@ bool shader_buildShader(Shader* shader);
 
 /**
  * Aktiviert einen Shader für die Benutzung.
- * Der Shader muss bereits gebaut worden sein.
+ * Der Shader muss bereits gebaut worden sein. Wird gerade ein neues Programm
+ * für ihn übersetzt, wird es übernommen, sobald es fertig ist. Gewartet wird
+ * nur, wenn der Shader noch gar kein Programm hat.
  *
  * @param shader der Shader, der genutzt werden soll.
  */
@@ -61,17 +81,27 @@ void shader_useShader(Shader* shader);
 /**
  * Rekompiliert einen bestehenden Shader.
  *
- * Diese Funktion lädt die zuvor angehängten Shader-Dateien neu, kompiliert sie
- * erneut und verlinkt den Shader. Sie ermöglicht es, Änderungen an den
+ * Diese Funktion lädt die zuvor angehängten Shader-Dateien neu und übergibt
+ * sie zum Übersetzen an den Treiber, ohne auf das Ergebnis zu warten. Das
+ * bisherige Programm bleibt aktiv, bis das neue bei einem späteren Aufruf von
+ * shader_useShader fertig ist. Sie ermöglicht es, Änderungen an den
  * Shader-Quellcodes während der Laufzeit zu übernehmen, ohne das Programm neu
  * zu starten.
  *
- * Bei Misserfolg gibt die Funktion eine Fehlermeldung aus.
+ * Bei Misserfolg wird eine Fehlermeldung ausgegeben, sobald das neue Programm
+ * fertig ist. Das alte Programm bleibt dann erhalten.
  *
  * @param shader der Shader, der neu kompiliert werden soll.
- * @return true, wenn die Operation erfolgreich war, false wenn nicht.
  */
-bool shader_recompileShader(Shader** shader_ptr);
+void shader_recompileShader(Shader* shader);
+
+/**
+ * Übersetzt alle Shader neu, deren Dateien oder eingebundene Dateien sich
+ * seit dem letzten Aufruf geändert haben, ohne auf den Treiber zu warten.
+ * Die Dateien werden dazu beim Bauen jedes Shaders in die Überwachung
+ * aufgenommen (siehe filewatch.h). Kann in jedem Frame aufgerufen werden.
+ */
+void shader_reloadChangedShaders(void);
 
 /**
  * Löscht einen bestehenden Shader und gibt alle Ressourcen wieder frei.
@@ -86,10 +116,11 @@ void shader_deleteShader(Shader* shader);
  * Hilfsfunktion zum Anlegen eines Shaders, der aus einem Vertex- und
  * einem Fragmentshader besteht.
  *
- * Bei Misserfolg gibt die Funktion eine Fehlermeldung aus.
+ * Die Dateien werden nur an den Treiber übergeben, damit mehrere Shader
+ * gleichzeitig übersetzt werden können. Fehler werden bei der ersten
+ * Benutzung ausgegeben.
  *
- * @return ein Shader, der aus den übergebenen Dateien gebaut wurde oder NULL
- *         wenn etwas schief gegangen ist.
+ * @return ein Shader, der aus den übergebenen Dateien gebaut wird.
  */
 Shader* shader_createVeFrShader(const char* label, const char* vert, const char* frag);
 
@@ -97,17 +128,78 @@ Shader* shader_createVeFrShader(const char* label, const char* vert, const char*
  * Hilfsfunktion zum Anlegen eines Shaders, der aus einem Vertex- ,
  * Tessellation- und einem Fragmentshader besteht.
  *
- * Bei Misserfolg gibt die Funktion eine Fehlermeldung aus.
+ * Die Dateien werden nur an den Treiber übergeben, damit mehrere Shader
+ * gleichzeitig übersetzt werden können. Fehler werden bei der ersten
+ * Benutzung ausgegeben.
  *
- * @return ein Shader, der aus den übergebenen Dateien gebaut wurde oder NULL
- *         wenn etwas schief gegangen ist.
+ * @return ein Shader, der aus den übergebenen Dateien gebaut wird.
  */
 Shader* shader_createVeTessFrShader(const char* label,
                                     const char* vert, const char* tesc,
                                     const char* tese, const char* frag);
 
+/**
+ * Hilfsfunktion zum Anlegen eines Shaders, der aus einem Vertex-, Geometry-
+ * und einem Fragmentshader besteht. Wie shader_createVeFrShader.
+ *
+ * @return ein Shader, der aus den übergebenen Dateien gebaut wird.
+ */
 Shader* shader_createVeGeomFrShader(const char* label, const char* vert, const char* geom, const char* frag);
 
+/**
+ * Legt eine leere Sammlung von Shader-Varianten an. Die Varianten werden erst
+ * bei ihrer ersten Anfrage gebaut. Nicht benötigte Stufen werden als NULL
+ * übergeben.
+ *
+ * @param label der Name der Varianten für Debugger und Meldungen
+ * @param vert der Vertex Shader
+ * @param tesc der Tessellation Control Shader oder NULL
+ * @param tese der Tessellation Evaluation Shader oder NULL
+ * @param geom der Geometry Shader oder NULL
+ * @param frag der Fragment Shader
+ * @param defineNames der Name des Defines für jedes Bit des Schlüssels, NULL
+ *        für Bits, die den Shader nicht verändern
+ * @param defineCount die Anzahl der Bits
+ * @return die neue Sammlung
+ */
+ShaderVariants* shader_createVariants(const char* label,
+                                      const char* vert, const char* tesc,
+                                      const char* tese, const char* geom,
+                                      const char* frag,
+                                      const char* const* defineNames,
+                                      int defineCount);
+
+/**
+ * Liefert die Variante zu einem Schlüssel. Beim ersten Zugriff wird sie mit
+ * einem #define für jedes gesetzte Bit gebaut und danach wiederverwendet.
+ * Nur auf neue Varianten wird gewartet, neu übersetzte bestehende Varianten
+ * werden wie bei shader_useShader erst übernommen, wenn sie fertig sind.
+ *
+ * Bei Misserfolg gibt die Funktion einmalig eine Fehlermeldung aus.
+ *
+ * @param variants die Sammlung der Varianten
+ * @param key der Schlüssel der Variante
+ * @return die Variante oder NULL, wenn sie nicht gebaut werden konnte
+ */
+Shader* shader_getVariant(ShaderVariants* variants, unsigned int key);
+
+/**
+ * Rekompiliert alle bisher angefragten Varianten aus ihren Dateien wie
+ * shader_recompileShader, ohne auf den Treiber zu warten. Varianten, die
+ * zuvor fehlgeschlagen sind, werden erneut versucht und bis sie fertig sind
+ * als NULL geliefert.
+ *
+ * @param variants die Sammlung der Varianten
+ */
+void shader_recompileVariants(ShaderVariants* variants);
+
+/**
+ * Löscht alle Varianten samt der Sammlung.
+ *
+ * @param variants die zu löschende Sammlung
+ */
+void shader_deleteVariants(ShaderVariants* variants);
+
 /**
  * Übergibt eine 4x4 Matrix an einen Shader über eine Uniform-Variable.
  * Der Shader muss zuvor mit shader_useShader aktiviert worden sein!
@@ -160,6 +252,17 @@ void shader_setVec3(Shader* shader, char* name, vec3* vec3);
  */
 void shader_setVec4(Shader* shader, char* name, vec4* vec4);
 
+/**
+ * Übergibt mehrere 4D Vektoren an ein Array im Shader.
+ * Der Shader muss zuvor mit shader_useShader aktiviert worden sein!
+ *
+ * @param shader der Shader, bei dem die Uniform Variable gesetzt werden soll
+ * @param name der Name der Uniform Variable
+ * @param vec4 die 4D Vektoren
+ * @param count die Anzahl der Vektoren
+ */
+void shader_setVec4Array(Shader* shader, char* name, vec4* vec4, int count);
+
 /**
  * Übergibt einen Integer an einen Shader über eine Uniform-Variable.
  * Der Shader muss zuvor mit shader_useShader aktiviert worden sein!
@@ -190,6 +293,24 @@ void shader_setFloat(Shader* shader, char* name, float val);
  */
 void shader_setBool(Shader* shader, char* name, bool val);
 
+/**
+ * Verknüpft einen Uniform Block des Shaders mit einem Binding-Punkt, an den
+ * mit glBindBufferBase ein Uniform Buffer gebunden wird.
+ *
+ * @param shader der Shader, in dem der Uniform Block liegt
+ * @param name der Name des Uniform Blocks
+ * @param binding der Binding-Punkt
+ */
+void shader_setUniformBlock(Shader* shader, char* name, GLuint binding);
+
+/**
+ * Liefert die Statistik über das Anlegen der Programme. Da Varianten erst bei
+ * ihrer ersten Anfrage gebaut werden, wächst sie auch nach dem Start weiter.
+ *
+ * @param stats Ausgabeparameter für die Statistik
+ */
+void shader_getCacheStats(ShaderCacheStats* stats);
+
 /**
  * Getter für Flag, ob Tessellation benutzt wird
  * @param shader Shader mit Flag
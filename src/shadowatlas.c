@@ -0,0 +1,377 @@
+/**
+ * Modul für einen gemeinsamen Schatten-Atlas aller Punktlichter.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#include "shadowatlas.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+
+////////////////////////////////// KONSTANTEN //////////////////////////////////
+
+// Anzahl der Würfelseiten eines Slots
+#define SHADOWATLAS_FACES 6
+
+// Kantenlänge des Atlas in Kacheln der kleinsten Größe
+#define SHADOWATLAS_MIN_TILES (SHADOWATLAS_SIZE / SHADOWATLAS_MIN_FACE_SIZE)
+
+////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
+
+// Ein Licht, das einen Slot anfordert
+typedef struct
+{
+    int index;
+    float radius;
+} ShadowAtlasRequest;
+
+struct ShadowAtlas
+{
+    GLuint fbo;
+    GLuint depthMap;
+    bool use16Bit;
+
+    ShadowAtlasSlot slots[SHADOWATLAS_MAX_SLOTS];
+    vec4 slotData[SHADOWATLAS_MAX_SLOTS]; // Kopie der Slots für den Shader
+    int slotCount;
+    int usedTiles;                        // belegte Kacheln der kleinsten Größe
+
+    vec3 renderedPositions[SHADOWATLAS_MAX_SLOTS]; // Lichtposition beim letzten Rendern
+    bool validSlots[SHADOWATLAS_MAX_SLOTS];        // Inhalt des Slots ist aktuell
+
+    int* lightSlots;                      // Slot jedes Lichts oder -1
+    int lightCount;
+    int lightCapacity;
+
+    ShadowAtlasRequest* requests;         // Lichter sortiert nach Radius
+    int requestCapacity;
+};
+
+////////////////////////////// LOKALE FUNKTIONEN ///////////////////////////////
+
+/**
+ * Vergrößert ein Array, falls es nicht mindestens count Elemente fasst.
+ *
+ * @param array das Array
+ * @param capacity die aktuelle Kapazität in Elementen
+ * @param count die benötigte Anzahl an Elementen
+ * @param elementSize die Größe eines Elements in Bytes
+ */
+static void shadowatlas_reserve(void** array, int* capacity, int count, size_t elementSize)
+{
+    if (count <= *capacity)
+    {
+        return;
+    }
+
+    int newCapacity = *capacity > 0 ? *capacity : 64;
+    while (newCapacity < count)
+    {
+        newCapacity *= 2;
+    }
+
+    *array = realloc(*array, elementSize * newCapacity);
+    *capacity = newCapacity;
+}
+
+/**
+ * Liefert jedes zweite Bit eines Z-Order-Index, also eine der beiden
+ * Koordinaten. Der Shader verwendet dieselbe Rechnung.
+ *
+ * @param v der Z-Order-Index, für y um ein Bit nach rechts verschoben
+ * @return die Koordinate in Kacheln
+ */
+static int shadowatlas_compactBits(unsigned int v)
+{
+    v &= 0x55555555u;
+    v = (v | (v >> 1)) & 0x33333333u;
+    v = (v | (v >> 2)) & 0x0F0F0F0Fu;
+    v = (v | (v >> 4)) & 0x00FF00FFu;
+    v = (v | (v >> 8)) & 0x0000FFFFu;
+    return (int) v;
+}
+
+/**
+ * Anzahl der kleinsten Kacheln, die eine Würfelseite belegt.
+ *
+ * @param faceSize die Kantenlänge der Würfelseite
+ * @return die Anzahl der Kacheln
+ */
+static int shadowatlas_tilesPerFace(int faceSize)
+{
+    int tiles = faceSize / SHADOWATLAS_MIN_FACE_SIZE;
+    return tiles * tiles;
+}
+
+/**
+ * Vergleicht zwei Anforderungen nach absteigendem Radius. Bei gleichem Radius
+ * entscheidet der Index, damit die Zuteilung stabil bleibt.
+ */
+static int shadowatlas_compareRequests(const void* a, const void* b)
+{
+    const ShadowAtlasRequest* ra = a;
+    const ShadowAtlasRequest* rb = b;
+
+    if (ra->radius != rb->radius)
+    {
+        return ra->radius > rb->radius ? -1 : 1;
+    }
+    return ra->index - rb->index;
+}
+
+/**
+ * Legt die Tiefentextur im gewünschten Format an und hängt sie an den
+ * Framebuffer.
+ *
+ * @param atlas der Atlas
+ */
+static void shadowatlas_createDepthMap(ShadowAtlas* atlas)
+{
+    glGenTextures(1, &atlas->depthMap);
+    glBindTexture(GL_TEXTURE_2D, atlas->depthMap);
+    glTexImage2D(GL_TEXTURE_2D, 0,
+                 atlas->use16Bit ? GL_DEPTH_COMPONENT16 : GL_DEPTH_COMPONENT32F,
+                 SHADOWATLAS_SIZE, SHADOWATLAS_SIZE, 0, GL_DEPTH_COMPONENT,
+                 atlas->use16Bit ? GL_UNSIGNED_SHORT : GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    common_labelObjectByType(GL_TEXTURE, atlas->depthMap, "Point Shadow Atlas");
+
+    glBindFramebuffer(GL_FRAMEBUFFER, atlas->fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, atlas->depthMap, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+ShadowAtlas* shadowatlas_createShadowAtlas(bool use16Bit)
+{
+    ShadowAtlas* atlas = malloc(sizeof(ShadowAtlas));
+    memset(atlas, 0, sizeof(ShadowAtlas));
+    atlas->use16Bit = use16Bit;
+
+    glGenFramebuffers(1, &atlas->fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, atlas->fbo);
+    common_labelObjectByType(GL_FRAMEBUFFER, atlas->fbo, "Point Shadow Atlas FBO");
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    shadowatlas_createDepthMap(atlas);
+
+    return atlas;
+}
+
+void shadowatlas_assignSlots(ShadowAtlas* atlas, PointLight** lights, int count)
+{
+    shadowatlas_reserve((void**) &atlas->lightSlots, &atlas->lightCapacity, count, sizeof(int));
+    shadowatlas_reserve((void**) &atlas->requests, &atlas->requestCapacity, count, sizeof(ShadowAtlasRequest));
+    atlas->lightCount = count;
+
+    for (int i = 0; i < count; i++)
+    {
+        atlas->lightSlots[i] = -1;
+        atlas->requests[i].index = i;
+        atlas->requests[i].radius = light_calcPointLightRadius(lights[i]);
+    }
+    qsort(atlas->requests, count, sizeof(ShadowAtlasRequest), shadowatlas_compareRequests);
+
+    // Gewünschte Auflösung aus dem Radius. Da die Lichter nach dem Radius
+    // sortiert sind, fallen auch die Kantenlängen monoton.
+    int slotCount = utils_minInt(count, SHADOWATLAS_MAX_SLOTS);
+    int usedTiles = 0;
+    for (int i = 0; i < slotCount; i++)
+    {
+        int faceSize = SHADOWATLAS_MIN_FACE_SIZE;
+        while (faceSize < SHADOWATLAS_MAX_FACE_SIZE
+               && faceSize < atlas->requests[i].radius * SHADOWATLAS_TEXELS_PER_UNIT)
+        {
+            faceSize *= 2;
+        }
+
+        atlas->slots[i].faceSize = faceSize;
+        usedTiles += SHADOWATLAS_FACES * shadowatlas_tilesPerFace(faceSize);
+    }
+
+    // Budget einhalten: zuerst das letzte der größten Lichter halbieren, damit
+    // die Reihenfolge erhalten bleibt, erst danach Lichter streichen.
+    while (usedTiles > SHADOWATLAS_MIN_TILES * SHADOWATLAS_MIN_TILES)
+    {
+        int largest = atlas->slots[0].faceSize;
+        if (largest > SHADOWATLAS_MIN_FACE_SIZE)
+        {
+            int last = 0;
+            while (last + 1 < slotCount && atlas->slots[last + 1].faceSize == largest)
+            {
+                last++;
+            }
+
+            usedTiles -= SHADOWATLAS_FACES * (shadowatlas_tilesPerFace(largest) - shadowatlas_tilesPerFace(largest / 2));
+            atlas->slots[last].faceSize = largest / 2;
+        }
+        else
+        {
+            slotCount--;
+            usedTiles -= SHADOWATLAS_FACES;
+        }
+    }
+
+    // Kacheln absteigend nach Größe entlang der Z-Order-Kurve vergeben. Jede
+    // Position ist dabei ein Vielfaches der aktuellen Kachelgröße.
+    int nextTile = 0;
+    for (int i = 0; i < slotCount; i++)
+    {
+        ShadowAtlasSlot* slot = &atlas->slots[i];
+        const int tiles = shadowatlas_tilesPerFace(slot->faceSize);
+
+        slot->lightIndex = atlas->requests[i].index;
+        slot->firstTile = nextTile / tiles;
+        slot->zFar = shadowatlas_calcZFar(atlas->requests[i].radius);
+        nextTile += SHADOWATLAS_FACES * tiles;
+
+        atlas->slotData[i][0] = (float) slot->firstTile;
+        atlas->slotData[i][1] = (float) slot->faceSize;
+        atlas->slotData[i][2] = slot->zFar;
+        atlas->slotData[i][3] = 0.0f;
+
+        atlas->lightSlots[slot->lightIndex] = i;
+    }
+
+    atlas->slotCount = slotCount;
+    atlas->usedTiles = usedTiles;
+    shadowatlas_invalidateSlots(atlas);
+}
+
+void shadowatlas_setUse16Bit(ShadowAtlas* atlas, bool use16Bit)
+{
+    if (atlas->use16Bit == use16Bit)
+    {
+        return;
+    }
+
+    glDeleteTextures(1, &atlas->depthMap);
+    atlas->use16Bit = use16Bit;
+    shadowatlas_createDepthMap(atlas);
+    shadowatlas_invalidateSlots(atlas);
+}
+
+bool shadowatlas_getUse16Bit(const ShadowAtlas* atlas)
+{
+    return atlas->use16Bit;
+}
+
+int shadowatlas_getSlotCount(const ShadowAtlas* atlas)
+{
+    return atlas->slotCount;
+}
+
+const ShadowAtlasSlot* shadowatlas_getSlot(const ShadowAtlas* atlas, int slot)
+{
+    return &atlas->slots[slot];
+}
+
+int shadowatlas_getLightSlot(const ShadowAtlas* atlas, int lightIndex)
+{
+    if (lightIndex < 0 || lightIndex >= atlas->lightCount)
+    {
+        return -1;
+    }
+
+    return atlas->lightSlots[lightIndex];
+}
+
+float shadowatlas_calcZFar(float radius)
+{
+    return glm_max(radius, SHADOWATLAS_MIN_Z_FAR);
+}
+
+bool shadowatlas_isSlotValid(const ShadowAtlas* atlas, int slot, vec3 position, float radius)
+{
+    return atlas->validSlots[slot]
+           && atlas->slots[slot].zFar == shadowatlas_calcZFar(radius)
+           && glm_vec3_eqv((float*) atlas->renderedPositions[slot], position);
+}
+
+void shadowatlas_validateSlot(ShadowAtlas* atlas, int slot, vec3 position, float radius)
+{
+    glm_vec3_copy(position, atlas->renderedPositions[slot]);
+    atlas->validSlots[slot] = true;
+
+    atlas->slots[slot].zFar = shadowatlas_calcZFar(radius);
+    atlas->slotData[slot][2] = atlas->slots[slot].zFar;
+}
+
+void shadowatlas_invalidateSlots(ShadowAtlas* atlas)
+{
+    memset(atlas->validSlots, 0, sizeof(atlas->validSlots));
+}
+
+void shadowatlas_bindForRendering(ShadowAtlas* atlas, int slot)
+{
+    const ShadowAtlasSlot* s = &atlas->slots[slot];
+
+    glBindFramebuffer(GL_FRAMEBUFFER, atlas->fbo);
+    glEnable(GL_SCISSOR_TEST);
+
+    for (int face = 0; face < SHADOWATLAS_FACES; face++)
+    {
+        const unsigned int tile = (unsigned int) (s->firstTile + face);
+        const int x = shadowatlas_compactBits(tile) * s->faceSize;
+        const int y = shadowatlas_compactBits(tile >> 1) * s->faceSize;
+
+        glViewportIndexedf(face, (float) x, (float) y, (float) s->faceSize, (float) s->faceSize);
+
+        // Nur die Kacheln dieses Slots leeren, die übrigen Lichter behalten
+        // ihre Schatten.
+        glScissor(x, y, s->faceSize, s->faceSize);
+        glClear(GL_DEPTH_BUFFER_BIT);
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+}
+
+void shadowatlas_bindShadowAtlas(ShadowAtlas* atlas, Shader* shader, int unit)
+{
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, atlas->depthMap);
+    shader_setInt(shader, "u_shadowAtlas", unit);
+
+    if (atlas->slotCount > 0)
+    {
+        shader_setVec4Array(shader, "u_shadowSlots", atlas->slotData, atlas->slotCount);
+    }
+}
+
+void shadowatlas_getStats(const ShadowAtlas* atlas, ShadowAtlasStats* stats)
+{
+    stats->slotCount = atlas->slotCount;
+    stats->requestedLights = atlas->lightCount;
+    stats->minFaceSize = atlas->slotCount > 0 ? atlas->slots[atlas->slotCount - 1].faceSize : 0;
+    stats->maxFaceSize = atlas->slotCount > 0 ? atlas->slots[0].faceSize : 0;
+    stats->occupancy = (float) atlas->usedTiles / (float) (SHADOWATLAS_MIN_TILES * SHADOWATLAS_MIN_TILES);
+    stats->megabytes = (double) SHADOWATLAS_SIZE * SHADOWATLAS_SIZE * (atlas->use16Bit ? 2 : 4)
+                       / (1024.0 * 1024.0);
+    stats->use16Bit = atlas->use16Bit;
+}
+
+void shadowatlas_deleteShadowAtlas(ShadowAtlas* atlas)
+{
+    if (atlas == NULL)
+    {
+        return;
+    }
+
+    glDeleteFramebuffers(1, &atlas->fbo);
+    glDeleteTextures(1, &atlas->depthMap);
+
+    free(atlas->lightSlots);
+    free(atlas->requests);
+    free(atlas);
+}
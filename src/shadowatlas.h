@@ -0,0 +1,214 @@
+/**
+ * Modul für einen gemeinsamen Schatten-Atlas aller Punktlichter.
+ *
+ * Statt für jedes Punktlicht eine eigene Cube Map samt Framebuffer anzulegen,
+ * werden alle Würfelseiten als quadratische Kacheln aus einer einzigen
+ * Tiefentextur fester Größe vergeben. Jedes Licht belegt einen Slot aus sechs
+ * gleich großen Kacheln, deren Kantenlänge sich nach dem Radius des Lichts
+ * richtet. Passen nicht alle Lichter in den Atlas, werden zuerst die größten
+ * Kacheln halbiert und zuletzt die kleinsten Lichter ohne Schatten gelassen.
+ * Der Speicherbedarf hängt dadurch nicht mehr von der Szene ab.
+ *
+ * Der Atlas merkt sich für jeden Slot, von welcher Lichtposition aus er
+ * zuletzt gerendert wurde. Nur Slots, deren Licht sich bewegt hat oder die
+ * ausdrücklich verworfen wurden, müssen neu gerendert werden.
+ *
+ * Die Kacheln werden der Größe nach absteigend entlang einer Z-Order-Kurve
+ * vergeben. Dadurch liegt jede Kachel ohne Verschnitt an einer durch ihre
+ * Größe teilbaren Position, und der Shader kann die Lage aller sechs Seiten
+ * aus dem Index der ersten Kachel und der Kantenlänge berechnen.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#ifndef SHADOWATLAS_H
+#define SHADOWATLAS_H
+
+#include "common.h"
+#include "light.h"
+#include "shader.h"
+
+// Kantenlänge des Atlas in Texeln
+#define SHADOWATLAS_SIZE 4096
+
+// Größte und kleinste Kantenlänge einer Würfelseite in Texeln
+#define SHADOWATLAS_MAX_FACE_SIZE 512
+#define SHADOWATLAS_MIN_FACE_SIZE 64
+
+// Gewünschte Auflösung einer Würfelseite pro Einheit des Lichtradius
+#define SHADOWATLAS_TEXELS_PER_UNIT 32.0f
+
+// Maximale Anzahl der Lichter im Atlas, muss zum Shader passen
+#define SHADOWATLAS_MAX_SLOTS 64
+
+// Near-Plane der Würfelseiten und kleinste Entfernung, auf die die Tiefe
+// normiert wird. Sonst wird die Tiefe auf den Radius des Lichts normiert.
+#define SHADOWATLAS_Z_NEAR 0.1f
+#define SHADOWATLAS_MIN_Z_FAR 1.0f
+
+//////////////////////////// ÖFFENTLICHE DATENTYPEN ////////////////////////////
+
+// Opaker Datentyp für den Schatten-Atlas
+struct ShadowAtlas;
+typedef struct ShadowAtlas ShadowAtlas;
+
+// Ein Slot des Atlas, also die sechs Würfelseiten eines Lichts
+typedef struct {
+    int lightIndex; // Index des Lichts in der Liste der Zuteilung
+    int faceSize;   // Kantenlänge einer Würfelseite in Texeln
+    int firstTile;  // Z-Order-Index der ersten Seite in Kacheln dieser Größe
+    float zFar;     // Entfernung, auf die die Tiefe normiert ist
+} ShadowAtlasSlot;
+
+// Belegung des Atlas nach der letzten Zuteilung
+typedef struct {
+    int slotCount;         // Lichter mit Schatten
+    int requestedLights;   // Lichter, die Schatten angefordert haben
+    int minFaceSize;       // kleinste vergebene Kantenlänge
+    int maxFaceSize;       // größte vergebene Kantenlänge
+    float occupancy;       // belegter Anteil des Atlas zwischen 0 und 1
+    double megabytes;      // Speicherbedarf der Tiefentextur in MB
+    bool use16Bit;         // 16 statt 32 Bit Tiefe
+} ShadowAtlasStats;
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+/**
+ * Erzeugt einen neuen Schatten-Atlas ohne belegte Slots.
+ *
+ * @param use16Bit true, wenn die Tiefe mit 16 statt 32 Bit gespeichert wird
+ * @return der neue Atlas
+ */
+ShadowAtlas* shadowatlas_createShadowAtlas(bool use16Bit);
+
+/**
+ * Verteilt den Atlas neu auf die übergebenen Punktlichter. Lichter mit
+ * größerem Radius werden dabei bevorzugt. Der Inhalt aller Schattenkarten ist
+ * danach ungültig und muss neu gerendert werden.
+ *
+ * @param atlas der Atlas
+ * @param lights die Punktlichter
+ * @param count die Anzahl der Punktlichter
+ */
+void shadowatlas_assignSlots(ShadowAtlas* atlas, PointLight** lights, int count);
+
+/**
+ * Legt die Tiefentextur mit einem anderen Format neu an. Die Slots bleiben
+ * erhalten, ihr Inhalt muss aber neu gerendert werden.
+ *
+ * @param atlas der Atlas
+ * @param use16Bit true, wenn die Tiefe mit 16 statt 32 Bit gespeichert wird
+ */
+void shadowatlas_setUse16Bit(ShadowAtlas* atlas, bool use16Bit);
+
+/**
+ * Gibt zurück, ob die Tiefe mit 16 Bit gespeichert wird.
+ *
+ * @param atlas der Atlas
+ * @return true bei 16 Bit, false bei 32 Bit
+ */
+bool shadowatlas_getUse16Bit(const ShadowAtlas* atlas);
+
+/**
+ * Liefert die Anzahl der belegten Slots.
+ *
+ * @param atlas der Atlas
+ * @return die Anzahl der Lichter mit Schatten
+ */
+int shadowatlas_getSlotCount(const ShadowAtlas* atlas);
+
+/**
+ * Liefert einen belegten Slot.
+ *
+ * @param atlas der Atlas
+ * @param slot der Index des Slots
+ * @return der Slot
+ */
+const ShadowAtlasSlot* shadowatlas_getSlot(const ShadowAtlas* atlas, int slot);
+
+/**
+ * Liefert den Slot eines Lichts aus der letzten Zuteilung.
+ *
+ * @param atlas der Atlas
+ * @param lightIndex der Index des Lichts
+ * @return der Index des Slots oder -1, wenn das Licht keinen Schatten hat
+ */
+int shadowatlas_getLightSlot(const ShadowAtlas* atlas, int lightIndex);
+
+/**
+ * Liefert die Entfernung, auf die die Tiefe eines Lichts mit dem übergebenen
+ * Radius normiert wird.
+ *
+ * @param radius der Radius des Lichts
+ * @return die Far-Plane der Würfelseiten
+ */
+float shadowatlas_calcZFar(float radius);
+
+/**
+ * Prüft, ob der Inhalt eines Slots noch zu Position und Radius seines Lichts
+ * passt.
+ *
+ * @param atlas der Atlas
+ * @param slot der Index des Slots
+ * @param position die aktuelle Position des Lichts
+ * @param radius der aktuelle Radius des Lichts
+ * @return true, wenn der Slot nicht neu gerendert werden muss
+ */
+bool shadowatlas_isSlotValid(const ShadowAtlas* atlas, int slot, vec3 position, float radius);
+
+/**
+ * Merkt sich, dass ein Slot von der übergebenen Position und mit dem
+ * übergebenen Radius gerendert wurde. Der Radius bestimmt die Entfernung, auf
+ * die die Tiefe des Slots normiert ist.
+ *
+ * @param atlas der Atlas
+ * @param slot der Index des Slots
+ * @param position die Position des Lichts beim Rendern
+ * @param radius der Radius des Lichts beim Rendern
+ */
+void shadowatlas_validateSlot(ShadowAtlas* atlas, int slot, vec3 position, float radius);
+
+/**
+ * Verwirft den Inhalt aller Slots, z.B. wenn sich die Geometrie ändert.
+ *
+ * @param atlas der Atlas
+ */
+void shadowatlas_invalidateSlots(ShadowAtlas* atlas);
+
+/**
+ * Bindet den Atlas zum Rendern eines Slots. Jede der sechs Würfelseiten
+ * bekommt einen eigenen Viewport, den der Geometry Shader über
+ * gl_ViewportIndex auswählt. Die Kacheln des Slots werden dabei geleert.
+ *
+ * @param atlas der Atlas
+ * @param slot der Index des Slots
+ */
+void shadowatlas_bindForRendering(ShadowAtlas* atlas, int slot);
+
+/**
+ * Bindet die Tiefentextur und übergibt die Lage aller Slots an den Shader
+ * (u_shadowAtlas, u_shadowSlots).
+ *
+ * @param atlas der Atlas
+ * @param shader der Shader, der die Schatten auswertet
+ * @param unit die Textur-Einheit für den Atlas
+ */
+void shadowatlas_bindShadowAtlas(ShadowAtlas* atlas, Shader* shader, int unit);
+
+/**
+ * Liefert die Belegung des Atlas.
+ *
+ * @param atlas der Atlas
+ * @param stats Ausgabeparameter für die Belegung
+ */
+void shadowatlas_getStats(const ShadowAtlas* atlas, ShadowAtlasStats* stats);
+
+/**
+ * Löscht den Atlas samt Tiefentextur und Framebuffer.
+ *
+ * @param atlas der zu löschende Atlas
+ */
+void shadowatlas_deleteShadowAtlas(ShadowAtlas* atlas);
+
+#endif // SHADOWATLAS_H
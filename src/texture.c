@@ -14,6 +14,7 @@
 #include <stb/stb_ds.h>
 
 #include "utils.h"
+#include "thread.h"
 
 // Wir prüfen ersteinaml, ob die Extension überhaupt gesetzt ist. Das heißt
 // nicht, dass sie geladen wurde, nur dass sie überhaupt definiert ist.
@@ -30,7 +31,11 @@
 #define FOURCC_ATI2 0x32495441 //(MAKEFOURCC('A','T','I','2'))
 
 // Maximale Länge des Screenshot-Dateinamens
-#define SCREENSHOT_FILENAME_SIZE 40
+#define SCREENSHOT_FILENAME_SIZE 64
+
+// Maximale Anzahl an Screenshots, die gleichzeitig ausgelesen bzw. kodiert
+// werden können
+#define SCREENSHOT_MAX_PENDING 4
 
 #define CUBEMAP_FACE_COUNT 6
 
@@ -77,8 +82,115 @@ int g_textureCount = 0;
 
 static TextureCache* g_textureCache = NULL;
 
+// Zustand eines asynchronen Screenshots
+typedef enum {
+    SCREENSHOT_STATE_FREE,     // Slot ist unbenutzt
+    SCREENSHOT_STATE_READBACK, // GPU kopiert noch in den PBO
+    SCREENSHOT_STATE_ENCODING  // Worker-Thread schreibt die PNG-Datei
+} ScreenshotState;
+
+// Ein Screenshot, der über einen Pixel-Buffer ausgelesen wird
+typedef struct {
+    ScreenshotState state;
+    GLuint pbo;          // Pixel-Buffer, in den die GPU schreibt
+    GLsync fence;        // Fence hinter dem glReadPixels
+    int width;
+    int height;
+    char filename[SCREENSHOT_FILENAME_SIZE];
+    void* mappedData;    // gemappter Speicher des PBO während des Kodierens
+    Thread* worker;      // Thread, der die PNG-Datei schreibt
+    bool encoded;        // wird vom Worker gesetzt, geschützt durch Mutex
+} Screenshot;
+
+static Screenshot g_screenshots[SCREENSHOT_MAX_PENDING];
+
+// Schützt die encoded-Flags der Screenshots
+static Mutex* g_screenshotMutex = NULL;
+
+// Laufende Nummer der Screenshots seit dem Programmstart
+static int g_screenshotNumber = 0;
+
 ////////////////////////////// LOKALE FUNKTIONEN ///////////////////////////////
 
+/**
+ * Läuft in einem Worker-Thread und schreibt die Bilddaten eines Screenshots
+ * als PNG-Datei. Dadurch blockiert das Kodieren nicht den Render-Thread.
+ *
+ * @param arg der Screenshot, dessen PBO bereits gemappt ist
+ */
+static void texture_encodeScreenshot(void* arg)
+{
+    Screenshot* shot = arg;
+
+    // Sollte es zu einem Fehler kommen, wird eine Fehlermeldung ausgegeben.
+    if (!stbi_write_png(shot->filename, shot->width, shot->height, 3, shot->mappedData, 0)) {
+        fprintf(stderr, "Error on saving screenshot: Could not write file!");
+    }
+
+    thread_lockMutex(g_screenshotMutex);
+    shot->encoded = true;
+    thread_unlockMutex(g_screenshotMutex);
+}
+
+/**
+ * Mappt den PBO eines fertig ausgelesenen Screenshots und übergibt ihn einem
+ * Worker-Thread zum Kodieren. Kann kein Thread gestartet werden, wird direkt
+ * auf dem aktuellen Thread kodiert.
+ *
+ * @param shot der Screenshot, dessen Fence bereits signalisiert wurde
+ */
+static void texture_startScreenshotEncoding(Screenshot* shot)
+{
+    glDeleteSync(shot->fence);
+    shot->fence = NULL;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, shot->pbo);
+    shot->mappedData = glMapBufferRange(
+        GL_PIXEL_PACK_BUFFER, 0,
+        shot->width * shot->height * 3,
+        GL_MAP_READ_BIT
+    );
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (!shot->mappedData)
+    {
+        fprintf(stderr, "Error on saving screenshot: Could not map pixel buffer!");
+        shot->state = SCREENSHOT_STATE_FREE;
+        return;
+    }
+
+    shot->encoded = false;
+    shot->state = SCREENSHOT_STATE_ENCODING;
+    shot->worker = thread_createThread(texture_encodeScreenshot, shot);
+    if (!shot->worker)
+    {
+        texture_encodeScreenshot(shot);
+    }
+}
+
+/**
+ * Schließt einen kodierten Screenshot ab. Wartet auf den Worker-Thread und
+ * gibt den gemappten Speicher wieder frei. Der PBO bleibt für den nächsten
+ * Screenshot erhalten.
+ *
+ * @param shot der Screenshot, der abgeschlossen werden soll
+ */
+static void texture_finishScreenshotEncoding(Screenshot* shot)
+{
+    if (shot->worker)
+    {
+        thread_joinThread(shot->worker);
+        shot->worker = NULL;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, shot->pbo);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    shot->mappedData = NULL;
+    shot->state = SCREENSHOT_STATE_FREE;
+}
+
 /**
  * Lädt eine DDS Textur aus einer Datei.
  * Diese Funktion modifiziert das übergebene Textur-Objekt und gibt deshalb
@@ -458,41 +570,115 @@ void texture_EmptyTextureCache(void) {
 }
 
 void texture_saveScreenshot(ProgContext *ctx) {
-    // Wir brauchen die Größe des Framebuffers.
-    int width = ctx->winData->width;
-    int height = ctx->winData->height;
+    // Einen freien Slot für den Screenshot suchen.
+    Screenshot* shot = NULL;
+    for (int i = 0; i < SCREENSHOT_MAX_PENDING && !shot; i++) {
+        if (g_screenshots[i].state == SCREENSHOT_STATE_FREE) {
+            shot = &g_screenshots[i];
+        }
+    }
 
-    // Als nächstes muss der notwendige Speicher für die Bilddaten reserviert
-    // werden.
-    char *imageData = malloc(width * height * 3);
+    if (!shot) {
+        fprintf(stderr, "Error on saving screenshot: Too many pending screenshots!\n");
+        return;
+    }
+
+    if (!g_screenshotMutex) {
+        g_screenshotMutex = thread_createMutex();
+    }
+
+    // Wir brauchen die Größe des Framebuffers.
+    shot->width = ctx->winData->width;
+    shot->height = ctx->winData->height;
+
+    // Die Bilddaten landen nicht im Hauptspeicher, sondern in einem
+    // Pixel-Buffer. Dadurch kehrt glReadPixels sofort zurück und die GPU
+    // kopiert asynchron.
+    if (!shot->pbo) {
+        glGenBuffers(1, &shot->pbo);
+        common_labelObjectByType(GL_BUFFER, shot->pbo, "Screenshot PBO");
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, shot->pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, shot->width * shot->height * 3, NULL, GL_STREAM_READ);
 
     // Die folgende Anweisung entfernt ein mögliches Padding der Daten.
     glPixelStorei(GL_PACK_ALIGNMENT, 1);
 
-    // Mit glReadPixels können wir den aktiven Framebuffer auslesen.
-    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, imageData);
+    // Mit glReadPixels können wir den aktiven Framebuffer auslesen. Der
+    // letzte Parameter ist bei gebundenem PBO ein Offset in den Buffer.
+    glReadPixels(0, 0, shot->width, shot->height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // Über die Fence erfahren wir später, wann die Kopie fertig ist.
+    shot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 
     // Als nächstes muss der Dateiname des neuen Screenshots bestimmt werden.
-    char filename[SCREENSHOT_FILENAME_SIZE];
+    // Die Uhrzeit hat nur Sekunden, mehrere Screenshots in derselben Sekunde
+    // würden sonst gleichzeitig in dieselbe Datei geschrieben. Daher bekommt
+    // jeder Screenshot zusätzlich eine laufende Nummer.
+    char timestamp[SCREENSHOT_FILENAME_SIZE];
     time_t now = time(NULL);
-    strftime(
-        filename,
-        SCREENSHOT_FILENAME_SIZE - 1,
-        "screenshot_%Y-%m-%d_%H-%M-%S.png",
-        localtime(&now)
-    );
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d_%H-%M-%S", localtime(&now));
+    snprintf(shot->filename, SCREENSHOT_FILENAME_SIZE, "screenshot_%s_%03d.png",
+             timestamp, g_screenshotNumber++);
 
     // Wir aktivieren hier vertikales Spiegeln, falls eine andere Funktion es
     // zuvor deaktiviert hat. Die Spiegelung ist nötig, da OpenGL ein anderes
     // Koordinatensystem als PNG bzw. stb_image_write verwendet.
     stbi_flip_vertically_on_write(true);
 
-    // Als nächstes schreiben wir die Bilddaten. Sollte es zu einem Fehler
-    // kommen, wird eine Fehlermeldung ausgegeben.
-    if (!stbi_write_png(filename, width, height, 3, imageData, 0)) {
-        fprintf(stderr, "Error on saving screenshot: Could not write file!");
+    shot->state = SCREENSHOT_STATE_READBACK;
+}
+
+void texture_updateScreenshots(void) {
+    for (int i = 0; i < SCREENSHOT_MAX_PENDING; i++) {
+        Screenshot* shot = &g_screenshots[i];
+
+        if (shot->state == SCREENSHOT_STATE_READBACK) {
+            // Nur nachsehen, ob die GPU fertig ist, niemals warten.
+            GLenum result = glClientWaitSync(shot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+                texture_startScreenshotEncoding(shot);
+            } else if (result == GL_WAIT_FAILED) {
+                fprintf(stderr, "Error on saving screenshot: Waiting for readback failed!\n");
+                glDeleteSync(shot->fence);
+                shot->fence = NULL;
+                shot->state = SCREENSHOT_STATE_FREE;
+            }
+        } else if (shot->state == SCREENSHOT_STATE_ENCODING) {
+            thread_lockMutex(g_screenshotMutex);
+            bool encoded = shot->encoded;
+            thread_unlockMutex(g_screenshotMutex);
+
+            if (encoded) {
+                texture_finishScreenshotEncoding(shot);
+            }
+        }
     }
+}
 
-    // Zum Schluss muss noch der belegte Speicher wieder freigegeben werden.
-    free(imageData);
+void texture_finishScreenshots(void) {
+    for (int i = 0; i < SCREENSHOT_MAX_PENDING; i++) {
+        Screenshot* shot = &g_screenshots[i];
+
+        // Beim Beenden blockierend auf alle offenen Screenshots warten, damit
+        // keine Datei verloren geht.
+        if (shot->state == SCREENSHOT_STATE_READBACK) {
+            glClientWaitSync(shot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            texture_startScreenshotEncoding(shot);
+        }
+        if (shot->state == SCREENSHOT_STATE_ENCODING) {
+            texture_finishScreenshotEncoding(shot);
+        }
+
+        if (shot->pbo) {
+            glDeleteBuffers(1, &shot->pbo);
+            shot->pbo = 0;
+        }
+    }
+
+    if (g_screenshotMutex) {
+        thread_deleteMutex(g_screenshotMutex);
+        g_screenshotMutex = NULL;
+    }
 }
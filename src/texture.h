@@ -62,10 +62,29 @@ void texture_deleteTexture(GLuint textureId);
  * Datum und die aktuelle Uhrzeit eingesetzt wird.
  * Es wird grundsätzlich der aktive Framebuffer ausgelesen.
  *
+ * Das Auslesen erfolgt asynchron über einen Pixel-Buffer, die PNG-Datei wird
+ * in einem Worker-Thread geschrieben. Damit der Screenshot fertig wird, muss
+ * texture_updateScreenshots regelmäßig aufgerufen werden.
+ *
  * @param ctx der aktuelle Programmkontext
  */
 void texture_saveScreenshot(ProgContext* ctx);
 
+/**
+ * Treibt ausstehende Screenshots voran. Sobald die GPU einen Pixel-Buffer
+ * gefüllt hat, wird er gemappt und an einen Worker-Thread übergeben. Fertig
+ * kodierte Screenshots werden aufgeräumt. Blockiert nie und sollte einmal
+ * pro Frame aufgerufen werden.
+ */
+void texture_updateScreenshots(void);
+
+/**
+ * Wartet blockierend auf alle ausstehenden Screenshots und gibt die dafür
+ * genutzten Ressourcen frei. Muss vor dem Löschen des OpenGL-Kontexts
+ * aufgerufen werden.
+ */
+void texture_finishScreenshots(void);
+
 /**
  * Leert den Textur-Cache.
  */
@@ -0,0 +1,202 @@
+/**
+ * Dünne Abstraktion über die Threading-Primitive des Betriebssystems
+ * (Win32 bzw. pthreads). Wird für Arbeiten genutzt, die nicht auf dem
+ * Render-Thread laufen sollen, z.B. das Kodieren von Screenshots.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#include "thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+////////////////////////////// LOKALE DATENTYPEN ///////////////////////////////
+
+struct Thread {
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    ThreadFunc func;
+    void* arg;
+};
+
+struct Mutex {
+#ifdef _WIN32
+    CRITICAL_SECTION handle;
+#else
+    pthread_mutex_t handle;
+#endif
+};
+
+struct Condition {
+#ifdef _WIN32
+    CONDITION_VARIABLE handle;
+#else
+    pthread_cond_t handle;
+#endif
+};
+
+////////////////////////////// LOKALE FUNKTIONEN ///////////////////////////////
+
+/**
+ * Einstiegspunkt aller Threads. Ruft nur die eigentliche Funktion auf.
+ *
+ * @param param der Thread, der gestartet wurde
+ */
+#ifdef _WIN32
+static DWORD WINAPI thread_entry(LPVOID param)
+#else
+static void* thread_entry(void* param)
+#endif
+{
+    Thread* thread = param;
+    thread->func(thread->arg);
+
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+Thread* thread_createThread(ThreadFunc func, void* arg)
+{
+    Thread* thread = malloc(sizeof(Thread));
+    thread->func = func;
+    thread->arg = arg;
+
+#ifdef _WIN32
+    thread->handle = CreateThread(NULL, 0, thread_entry, thread, 0, NULL);
+    bool success = thread->handle != NULL;
+#else
+    bool success = pthread_create(&thread->handle, NULL, thread_entry, thread) == 0;
+#endif
+
+    if (!success)
+    {
+        fprintf(stderr, "Error: Could not create thread!\n");
+        free(thread);
+        return NULL;
+    }
+
+    return thread;
+}
+
+void thread_joinThread(Thread* thread)
+{
+#ifdef _WIN32
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+
+    free(thread);
+}
+
+Mutex* thread_createMutex(void)
+{
+    Mutex* mutex = malloc(sizeof(Mutex));
+
+#ifdef _WIN32
+    InitializeCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_init(&mutex->handle, NULL);
+#endif
+
+    return mutex;
+}
+
+void thread_lockMutex(Mutex* mutex)
+{
+#ifdef _WIN32
+    EnterCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_lock(&mutex->handle);
+#endif
+}
+
+void thread_unlockMutex(Mutex* mutex)
+{
+#ifdef _WIN32
+    LeaveCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_unlock(&mutex->handle);
+#endif
+}
+
+void thread_deleteMutex(Mutex* mutex)
+{
+#ifdef _WIN32
+    DeleteCriticalSection(&mutex->handle);
+#else
+    pthread_mutex_destroy(&mutex->handle);
+#endif
+
+    free(mutex);
+}
+
+Condition* thread_createCondition(void)
+{
+    Condition* cond = malloc(sizeof(Condition));
+
+#ifdef _WIN32
+    InitializeConditionVariable(&cond->handle);
+#else
+    pthread_cond_init(&cond->handle, NULL);
+#endif
+
+    return cond;
+}
+
+void thread_waitCondition(Condition* cond, Mutex* mutex)
+{
+#ifdef _WIN32
+    SleepConditionVariableCS(&cond->handle, &mutex->handle, INFINITE);
+#else
+    pthread_cond_wait(&cond->handle, &mutex->handle);
+#endif
+}
+
+void thread_signalCondition(Condition* cond)
+{
+#ifdef _WIN32
+    WakeConditionVariable(&cond->handle);
+#else
+    pthread_cond_signal(&cond->handle);
+#endif
+}
+
+void thread_broadcastCondition(Condition* cond)
+{
+#ifdef _WIN32
+    WakeAllConditionVariable(&cond->handle);
+#else
+    pthread_cond_broadcast(&cond->handle);
+#endif
+}
+
+void thread_deleteCondition(Condition* cond)
+{
+#ifndef _WIN32
+    // Unter Windows müssen Bedingungsvariablen nicht gelöscht werden.
+    pthread_cond_destroy(&cond->handle);
+#endif
+
+    free(cond);
+}
@@ -0,0 +1,109 @@
+/**
+ * Dünne Abstraktion über die Threading-Primitive des Betriebssystems
+ * (Win32 bzw. pthreads). Wird für Arbeiten genutzt, die nicht auf dem
+ * Render-Thread laufen sollen, z.B. das Kodieren von Screenshots.
+ *
+ * Copyright (C) 2020, FH Wedel
+ * Autor: Nicolas Hollmann, stud105751, stud104645
+ */
+
+#ifndef THREAD_H
+#define THREAD_H
+
+#include <stdbool.h>
+
+//////////////////////////// ÖFFENTLICHE DATENTYPEN ////////////////////////////
+
+// Funktion, die in einem eigenen Thread ausgeführt wird.
+typedef void (*ThreadFunc)(void* arg);
+
+// Die folgenden Typen sind opak, damit die Systemheader (z.B. windows.h)
+// nicht in den restlichen Modulen landen.
+typedef struct Thread Thread;
+typedef struct Mutex Mutex;
+typedef struct Condition Condition;
+
+//////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
+
+/**
+ * Startet einen neuen Thread, der die übergebene Funktion ausführt.
+ *
+ * @param func die Funktion, die im Thread ausgeführt werden soll
+ * @param arg das Argument, das an die Funktion übergeben wird
+ * @return der gestartete Thread oder NULL im Fehlerfall
+ */
+Thread* thread_createThread(ThreadFunc func, void* arg);
+
+/**
+ * Wartet, bis sich der Thread beendet hat und gibt sein Handle frei.
+ *
+ * @param thread der Thread, auf den gewartet werden soll
+ */
+void thread_joinThread(Thread* thread);
+
+/**
+ * Erzeugt einen neuen Mutex.
+ *
+ * @return der neue Mutex
+ */
+Mutex* thread_createMutex(void);
+
+/**
+ * Sperrt einen Mutex. Blockiert, bis er verfügbar ist.
+ *
+ * @param mutex der zu sperrende Mutex
+ */
+void thread_lockMutex(Mutex* mutex);
+
+/**
+ * Gibt einen gesperrten Mutex wieder frei.
+ *
+ * @param mutex der freizugebende Mutex
+ */
+void thread_unlockMutex(Mutex* mutex);
+
+/**
+ * Löscht einen Mutex. Er darf dabei nicht gesperrt sein.
+ *
+ * @param mutex der zu löschende Mutex
+ */
+void thread_deleteMutex(Mutex* mutex);
+
+/**
+ * Erzeugt eine neue Bedingungsvariable.
+ *
+ * @return die neue Bedingungsvariable
+ */
+Condition* thread_createCondition(void);
+
+/**
+ * Wartet auf die Bedingungsvariable. Der Mutex muss gesperrt sein, wird
+ * während des Wartens freigegeben und danach wieder gesperrt.
+ *
+ * @param cond die Bedingungsvariable
+ * @param mutex der zugehörige, gesperrte Mutex
+ */
+void thread_waitCondition(Condition* cond, Mutex* mutex);
+
+/**
+ * Weckt einen Thread, der auf die Bedingungsvariable wartet.
+ *
+ * @param cond die Bedingungsvariable
+ */
+void thread_signalCondition(Condition* cond);
+
+/**
+ * Weckt alle Threads, die auf die Bedingungsvariable warten.
+ *
+ * @param cond die Bedingungsvariable
+ */
+void thread_broadcastCondition(Condition* cond);
+
+/**
+ * Löscht eine Bedingungsvariable.
+ *
+ * @param cond die zu löschende Bedingungsvariable
+ */
+void thread_deleteCondition(Condition* cond);
+
+#endif // THREAD_H
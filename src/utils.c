@@ -11,9 +11,21 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <corecrt_math.h>
 #include <corecrt_math_defines.h>
 #include <assert.h>
+#include <errno.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
 
 //////////////////////////// ÖFFENTLICHE FUNKTIONEN ////////////////////////////
 
@@ -39,7 +51,7 @@ char* utils_getResourcePath(const char* path)
     return resPath;
 }
 
-char* utils_readFile(const char* filename)
+char* utils_tryReadFile(const char* filename)
 {
     // Zuerst muss die Datei geöffnet werden.
     FILE* f = fopen(filename, "rb");
@@ -50,7 +62,7 @@ char* utils_readFile(const char* filename)
             "Error: Could not open file \"%s\" for reading.\n",
             filename
         );
-        exit(EXIT_FAILURE);
+        return NULL;
     }
 
     // Als nächstes wird die Größe der Datei bestimmt, in dem der Lesecursor
@@ -70,7 +82,8 @@ char* utils_readFile(const char* filename)
             "Error: Could not acquire memory to read the file \"%s\".\n",
             filename
         );
-        exit(EXIT_FAILURE);
+        fclose(f);
+        return NULL;
     }
 
     // Als nächstes wird der gesammte Inhalt
@@ -79,7 +92,8 @@ char* utils_readFile(const char* filename)
     {
         free(content);
         fprintf(stderr, "Error: Could not read the file \"%s\".\n", filename);
-        exit(EXIT_FAILURE);
+        fclose(f);
+        return NULL;
     }
 
     // Zum Schluss wird die Datei geschlossen und an das Ende des
@@ -89,6 +103,18 @@ char* utils_readFile(const char* filename)
     return content;
 }
 
+char* utils_readFile(const char* filename)
+{
+    // Ohne den Inhalt der Datei kann das Programm nicht weiterlaufen.
+    char* content = utils_tryReadFile(filename);
+    if (content == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return content;
+}
+
 bool utils_hasSuffix(const char* subject, const char* suffix)
 {
     // Zuerst benötigen wir die Längen der beiden Strings.
@@ -220,6 +246,32 @@ int utils_minInt(int a, int b)
     return a < b ? a : b;
 }
 
+double utils_getTime(void)
+{
+    // Die Uhrzeit des Systems kann springen, z.B. durch NTP. Für Zeitmessungen
+    // wird daher eine monotone Uhr genutzt.
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double) counter.QuadPart / (double) frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+#endif
+}
+
+bool utils_createDirectory(const char* path)
+{
+#ifdef _WIN32
+    int result = _mkdir(path);
+#else
+    int result = mkdir(path, 0755);
+#endif
+    return result == 0 || errno == EEXIST;
+}
+
 void utils_createCube(GLuint* VAO, GLuint* VBO, GLsizei* vertexCount)
 {
     static const float cubeVertices[] = {
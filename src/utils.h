@@ -52,6 +52,15 @@ char* utils_getResourcePath(const char* path);
  */
 char* utils_readFile(const char* filename);
 
+/**
+ * Liest wie utils_readFile eine Datei ein, beendet das Programm aber nicht,
+ * wenn sie sich nicht lesen lässt. Der Fehler wird auf stderr gemeldet.
+ *
+ * @param filename der Dateiname der einzulesenden Datei
+ * @return der Inhalt der eingelesenen Datei oder NULL
+ */
+char* utils_tryReadFile(const char* filename);
+
 /**
  * Prüft, ob ein Suffix am Ende eines Stringes zu finden ist.
  * Diese Funktion kann zum Beispiel genutzt werden, um Dateiendungen
@@ -120,6 +129,24 @@ int utils_maxInt(int a, int b);
  */
 int utils_minInt(int a, int b);
 
+/**
+ * Gibt die Zeit einer monotonen Uhr in Sekunden zurück, geeignet für
+ * Zeitmessungen, aber nicht als Uhrzeit. Im Gegensatz zu glfwGetTime
+ * funktioniert das auch ohne GLFW, z.B. im Headless-Modus mit EGL.
+ *
+ * @return die aktuelle Zeit in Sekunden seit einem beliebigen Startpunkt
+ */
+double utils_getTime(void);
+
+/**
+ * Legt ein Verzeichnis an, falls es noch nicht existiert. Übergeordnete
+ * Verzeichnisse werden nicht angelegt.
+ *
+ * @param path der Pfad des Verzeichnisses
+ * @return true, wenn das Verzeichnis danach existiert, false wenn nicht
+ */
+bool utils_createDirectory(const char* path);
+
 /**
  * Erstellt einen Einheitswürfel und initialisiert ein Vertex Array Object (VAO)
  * und ein Vertex Buffer Object (VBO), die die Würfelgeometrie enthalten.
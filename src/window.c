@@ -13,6 +13,9 @@
 #include "gui.h"
 #include "input.h"
 #include "utils.h"
+#include "texture.h"
+#include "recorder.h"
+#include "profiler.h"
 
 ////////////////////////////////// KONSTANTEN //////////////////////////////////
 
@@ -390,15 +393,27 @@ void window_mainloop(ProgContext* ctx)
         // Eingaben verarbeiten.
         input_process(ctx);
 
+        // GPU-Zeiten der Render-Scopes nur messen, solange sie angezeigt
+        // werden.
+        profiler_setEnabled(ctx->input->showStats);
+        profiler_beginFrame();
+
         // Szene zeichnen
         rendering_draw(ctx);
 
+        // Frame für eine laufende Aufnahme auslesen, bevor die GUI
+        // darüber gezeichnet wird.
+        recorder_captureFrame(ctx);
+
         // GUI Zeichnen
         gui_render(ctx);
 
         // Back- und Frontbuffer tauschen um den neuen Frame anzuzeigen.
         glfwSwapBuffers(ctx->window);
 
+        // Ausstehende Screenshots abarbeiten.
+        texture_updateScreenshots();
+
         // FPS Timer updaten.
         window_updateFpsTimer(ctx);
     }
@@ -451,6 +466,9 @@ void window_updateFullscreen(ProgContext* ctx)
 void window_cleanup(ProgContext* ctx)
 {
     // Alle Module Stück für Stück löschen.
+    texture_finishScreenshots();
+    recorder_stop();
+    profiler_cleanup();
     input_cleanup(ctx);
     rendering_cleanup(ctx);
     gui_cleanup(ctx);